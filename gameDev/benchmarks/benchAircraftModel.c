@@ -0,0 +1,104 @@
+/**
+ * @file benchAircraftModel.c
+ * @brief Measures what compiling the aircraft constants once saves on every physics tick.
+ *
+ * Runs the same steady-state tick twice for every aircraft in the data file:
+ * - once with the model compiled up front (what the simulator does),
+ * - once recompiling the model before every tick (what the physics used to derive per tick).
+ *
+ * The difference between the two is the per-tick saving.
+ *
+ * Usage: ./build/bench_aircraft_model [ticks]
+ */
+
+// Include header files
+#include "aircraft.h"
+#include "aircraftData.h"
+#include "aircraftModel.h"
+#include "physics.h"
+#include "menu.h"
+#include "utils.h"
+
+// Include standard libraries
+#include <stdio.h>
+#include <stdlib.h>
+
+#define FILE_PATH "data/aircraftData.txt" // Same data file the simulator uses
+#define DEFAULT_TICKS 200000 // Ticks per measurement
+#define DELTA_TIME (1.0f / (float)TARGET_FPS) // Fixed step
+#define REPEATS 7 // Best of N runs, filters out scheduler noise
+
+// Sink so the compiler can't drop the work
+static volatile float sink;
+
+// Reset the aircraft to the same cruise state so every tick costs the same and no limit warnings fire
+static void resetState(AircraftState *aircraft, const AircraftState *cruise) {
+    *aircraft = *cruise;
+}
+
+// Runs `ticks` physics ticks and returns the mean time per tick in nanoseconds
+static double runTicks(const AircraftData *data, const AircraftState *cruise, long ticks, int recompileEveryTick) {
+    CompiledAircraftModel model;
+    compileAircraftModel(data, &model);
+
+    AircraftState aircraft;
+    float simulationTime = 0.0f;
+
+    long start = getTimeMicroseconds();
+    for (long i = 0; i < ticks; i++) {
+        resetState(&aircraft, cruise);
+        simulationTime += DELTA_TIME; // New time every tick so updatePhysicsData() always runs
+
+        if (recompileEveryTick) {
+            compileAircraftModel(data, &model); // Per-tick derivation, as before the model existed
+        }
+
+        updatePhysics(&aircraft, DELTA_TIME, simulationTime, &model);
+        sink = aircraft.vx;
+    }
+    long elapsed = getTimeMicroseconds() - start;
+
+    return (double)elapsed * 1000.0 / (double)ticks;
+}
+
+int main(int argc, char *argv[]) {
+    long ticks = (argc > 1) ? atol(argv[1]) : DEFAULT_TICKS;
+    if (ticks <= 0) {
+        ticks = DEFAULT_TICKS;
+    }
+
+    Aircraft aircraftList[MAX_AIRCRAFT];
+    int aircraftCount = 0;
+    if (!loadAircraftNames(FILE_PATH, aircraftList, &aircraftCount)) {
+        return 1;
+    }
+
+    printf("%-10s %16s %16s %16s\n", "aircraft", "compiled ns/tick", "per-tick ns/tick", "saved ns/tick");
+
+    for (int i = 0; i < aircraftCount; i++) {
+        AircraftData data = {0};
+        getAircraftDataByName(FILE_PATH, aircraftList[i].name, &data);
+
+        // Cruise state at 5 km, 250 m/s, throttle at 80%
+        AircraftState cruise;
+        initAircraft(&cruise, &data);
+        cruise.y = 5000.0f;
+        cruise.vx = 250.0f;
+        cruise.controls.throttle = 0.8f;
+
+        runTicks(&data, &cruise, ticks / 10, 0); // Warm up caches and branch predictors
+
+        double compiled = 1e30;
+        double perTick = 1e30;
+        for (int r = 0; r < REPEATS; r++) { // Alternate the two so drift hits both equally
+            double c = runTicks(&data, &cruise, ticks, 0);
+            double p = runTicks(&data, &cruise, ticks, 1);
+            if (c < compiled) compiled = c;
+            if (p < perTick) perTick = p;
+        }
+
+        printf("%-10s %16.1f %16.1f %16.1f\n", data.name, compiled, perTick, perTick - compiled);
+    }
+
+    return 0;
+}
@@ -0,0 +1,237 @@
+/**
+ * @file benchHudRasterizer.c
+ * @brief Compares SDL's software renderer with the CPU rasterizer on the same HUD frames.
+ *
+ * Both draw into the same offscreen surface through SDL's software renderer, so there is no GPU and no
+ * window involved:
+ * - "sdl": the render batch issues its SDL calls (what the HUD does without the rasterizer),
+ * - "cpu": the render batch draws into the rasterizer's framebuffer, which is uploaded and copied once.
+ *
+ * Every frame is a full redraw (the worst case, the HUD usually redraws a few regions). The two results
+ * are compared pixel by pixel afterwards, glyph edges may differ by rounding.
+ *
+ * Usage: ./build/bench_hud_rasterizer [frames]
+ */
+
+// Include header files
+#include "2Drenderer.h"
+#include "fontManager.h"
+#include "rasterizer.h"
+#include "renderBatch.h"
+#include "utils.h"
+
+// Include standard libraries
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FONT_PATH "fonts/Oswald/Oswald-Medium.ttf" // Same font the HUD uses
+#define WIDTH 1000 // HUD size
+#define HEIGHT 600
+#define DEFAULT_FRAMES 200 // Frames per measurement
+#define REPEATS 5 // Best of N runs, filters out scheduler noise
+#define TEXT_LINES 22 // Lines on the text mode page
+
+typedef enum {
+    FRAME_TEXT,     // text mode: a page of flight info
+    FRAME_GAUGES,   // visual mode: two gauges and the throttle bar
+    FRAME_FULL,     // both
+    FRAMES
+} FrameKind;
+
+static const char *frameNames[FRAMES] = {"text", "gauges", "full"};
+
+static int font = -1;
+static int smallFont = -1;
+static int bigFont = -1;
+
+static void recordText(int frame) {
+    const SDL_Color white = {255, 255, 255, 255};
+    char line[96];
+
+    for (int i = 0; i < TEXT_LINES; i++) {
+        snprintf(line, sizeof(line), "Parameter %02d: %10.2f km/h  (%d)", i, (double)i * 123.45 + frame, frame);
+        drawText(font, line, 20, 20 + i * 25, white);
+    }
+}
+
+static void recordGauge(int cx, int cy, int radius, int ticks, float value) {
+    const SDL_Color green = {0, 255, 0, 255};
+    const SDL_Color white = {255, 255, 255, 255};
+    char number[16];
+
+    drawCircle(NULL, cx, cy, radius);
+    drawTicks(NULL, cx, cy, radius, ticks, -70.0f, 250.0f);
+    for (int i = 0; i < ticks; i++) {
+        snprintf(number, sizeof(number), "%d", i * 100);
+        drawText(smallFont, number, cx - radius + 40 + (i % 8) * 20, cy - radius + 50 + (i / 8) * 30, green);
+    }
+    drawNeedle(NULL, cx, cy, radius, value, (float)(ticks - 1) * 100.0f, -70.0f, 250.0f);
+
+    snprintf(number, sizeof(number), "%.2f", (double)value / 1000.0);
+    drawText(bigFont, number, cx - 50, cy + 40, white);
+}
+
+static void recordThrottle(int x, int y, float throttle) {
+    const SDL_Rect border = {x, y, 100, 350};
+    const SDL_Rect background = {x + 3, y + 3, 94, 344};
+    const SDL_Rect filled = {x + 3, y + 347 - (int)(344.0f * throttle), 94, (int)(344.0f * throttle)};
+
+    batchRect(BATCH_LAYER_SHAPES, &border, (SDL_Color){0, 255, 0, 255});
+    batchFillRect(BATCH_LAYER_BACKGROUND, &background, (SDL_Color){0, 0, 0, 255});
+    batchFillRect(BATCH_LAYER_SHAPES, &filled, (SDL_Color){0, 255, 0, 255});
+    drawText(font, "80%", x + 35, y - 30, (SDL_Color){255, 255, 255, 255});
+}
+
+// Record one frame, the values change with the frame number like a live HUD's would
+static void recordFrame(FrameKind kind, int frame) {
+    if (kind == FRAME_TEXT || kind == FRAME_FULL) {
+        recordText(frame);
+    }
+    if (kind == FRAME_GAUGES || kind == FRAME_FULL) {
+        recordGauge(600, 200, 150, 26, (float)(frame % 2500));
+        recordGauge(850, 450, 120, 5, (float)(frame % 400));
+        recordThrottle(430, 220, 0.8f);
+    }
+    flushText();
+}
+
+// Draws `frames` frames and returns the mean time per frame in milliseconds
+static double runFrames(SDL_Renderer *renderer, FrameKind kind, int frames, int rasterize) {
+    const SDL_Rect screen = {0, 0, WIDTH, HEIGHT};
+
+    long start = getTimeMicroseconds();
+    for (int i = 0; i < frames; i++) {
+        if (rasterize) {
+            setRasterClip(NULL);
+            rasterFillRect(&screen, (SDL_Color){0, 0, 0, 255});
+        }
+        else {
+            SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+            SDL_RenderClear(renderer);
+        }
+
+        recordFrame(kind, i);
+        finishRenderBatchFrame();
+
+        if (rasterize) {
+            presentRasterFrame(&screen, 1);
+        }
+        SDL_RenderFlush(renderer); // SDL queues the calls, make it draw them
+    }
+    long elapsed = getTimeMicroseconds() - start;
+
+    return (double)elapsed / 1000.0 / (double)frames;
+}
+
+static double measure(SDL_Renderer *renderer, FrameKind kind, int frames, int rasterize) {
+    if (rasterize && !initRasterizer(renderer, WIDTH, HEIGHT)) {
+        return -1.0;
+    }
+
+    runFrames(renderer, kind, frames / 10 + 1, rasterize); // Warm up caches and the glyph atlases
+
+    double best = 1e30;
+    for (int r = 0; r < REPEATS; r++) {
+        double t = runFrames(renderer, kind, frames, rasterize);
+        if (t < best) best = t;
+    }
+
+    // draw frame 0 once more so both backends leave the same frame behind
+    runFrames(renderer, kind, 1, rasterize);
+
+    if (rasterize) {
+        destroyRasterizer();
+    }
+    return best;
+}
+
+// Number of pixels that differ, and the biggest difference of a colour channel
+static int comparePixels(const Uint32 *a, const Uint32 *b, int count, int *maxDifference) {
+    int differing = 0;
+    *maxDifference = 0;
+
+    for (int i = 0; i < count; i++) {
+        if (a[i] == b[i]) {
+            continue;
+        }
+        differing++;
+        for (int shift = 0; shift < 24; shift += 8) {
+            int difference = abs((int)((a[i] >> shift) & 0xFF) - (int)((b[i] >> shift) & 0xFF));
+            if (difference > *maxDifference) *maxDifference = difference;
+        }
+    }
+
+    return differing;
+}
+
+int main(int argc, char *argv[]) {
+    int frames = (argc > 1) ? atoi(argv[1]) : DEFAULT_FRAMES;
+    if (frames <= 0) {
+        frames = DEFAULT_FRAMES;
+    }
+
+    if (TTF_Init() != 0) {
+        printf("Failed to initialize SDL_ttf: %s\n", TTF_GetError());
+        return 1;
+    }
+
+    // An offscreen surface with SDL's software renderer, the same for both backends
+    SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, WIDTH, HEIGHT, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer *renderer = (surface != NULL) ? SDL_CreateSoftwareRenderer(surface) : NULL;
+    Uint32 *reference = malloc((size_t)WIDTH * HEIGHT * sizeof(Uint32));
+    if (renderer == NULL || reference == NULL) {
+        printf("Failed to create the software renderer: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    initRenderBatch(renderer);
+    SDL_setenv("HUD_TEXT_WORKERS", "0", 1); // glyphs rasterized on first use, so both backends draw the same text from frame 0
+    initFontManager(renderer);
+    font = loadFont(FONT_PATH, 18);
+    smallFont = loadFont(FONT_PATH, 12);
+    bigFont = loadFont(FONT_PATH, 50);
+    if (font < 0 || smallFont < 0 || bigFont < 0) {
+        printf("Failed to load %s, run the benchmark from the build folder.\n", FONT_PATH);
+        return 1;
+    }
+
+    printf("%-8s %12s %12s %9s %14s %9s\n", "frame", "sdl ms/frame", "cpu ms/frame", "speedup", "pixels differ", "max diff");
+
+    for (int kind = 0; kind < FRAMES; kind++) {
+        double sdl = measure(renderer, (FrameKind)kind, frames, 0);
+        SDL_LockSurface(surface);
+        for (int y = 0; y < HEIGHT; y++) {
+            memcpy(&reference[y * WIDTH], (const Uint8 *)surface->pixels + y * surface->pitch, WIDTH * sizeof(Uint32));
+        }
+        SDL_UnlockSurface(surface);
+
+        double cpu = measure(renderer, (FrameKind)kind, frames, 1);
+        if (cpu < 0.0) {
+            printf("Failed to start the rasterizer.\n");
+            return 1;
+        }
+
+        // compare the last frame of both
+        int maxDifference = 0;
+        int differing = 0;
+        SDL_LockSurface(surface);
+        for (int y = 0; y < HEIGHT; y++) {
+            int rowMax = 0;
+            differing += comparePixels(&reference[y * WIDTH], (const Uint32 *)(const void *)((const Uint8 *)surface->pixels + y * surface->pitch), WIDTH, &rowMax);
+            if (rowMax > maxDifference) maxDifference = rowMax;
+        }
+        SDL_UnlockSurface(surface);
+
+        printf("%-8s %12.3f %12.3f %8.1fx %14d %9d\n", frameNames[kind], sdl, cpu, sdl / cpu, differing, maxDifference);
+    }
+
+    destroyFontManager();
+    destroyRenderBatch();
+    SDL_DestroyRenderer(renderer);
+    SDL_FreeSurface(surface);
+    free(reference);
+    TTF_Quit();
+
+    return 0;
+}
@@ -0,0 +1,388 @@
+/**
+ * @file benchIntegrators.c
+ * @brief Trajectory error against cost of the physics integrators at several step sizes.
+ *
+ * Four reference maneuvers are flown with fixed controls: a full throttle climb, a dive through Mach 1, an
+ * afterburner acceleration and a climb until the fuel runs out. The reference solution of every maneuver is
+ * RK4 at REFERENCE_RATE steps per second, its own error is estimated by flying it again at half the rate.
+ *
+ * Every integrator of updatePhysics() (RK4, Heun, Euler) then flies every maneuver at 15 to 240 steps per
+ * second. The position is compared with the reference once per simulated second (RMS and max distance),
+ * the velocity at the end. The cost is counted in force evaluations (computeAcceleration() calls) per
+ * simulated second and measured in ns per simulated second.
+ *
+ * A configuration is on the Pareto front when no other one is both cheaper and more accurate (by its worst
+ * maneuver in the summary). The table is printed and written to bench_integrators.csv, --budget prints the
+ * cheapest configuration whose worst position error stays within the budget.
+ *
+ * Turbulence and the weather simulation are off, so every run of a maneuver sees the same air. Positions
+ * are integrated in double here, so the reference isn't limited by float rounding of the position. The
+ * velocity stays float, which is why the reference isn't any finer: above a few thousand steps per second
+ * the velocity increments drown in rounding (first on the speed limiter in the climb).
+ *
+ * Usage: ./build/bench_integrators [--aircraft name] [--budget meters] [--out file.csv]
+ */
+
+// Include header files
+#include "aircraft.h"
+#include "aircraftData.h"
+#include "aircraftModel.h"
+#include "physics.h"
+#include "menu.h"
+#include "utils.h"
+
+// Include standard libraries
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FILE_PATH "data/aircraftData.txt" // Same data file the simulator uses
+#define DEFAULT_OUTPUT "bench_integrators.csv"
+#define REFERENCE_RATE 1920 // Reference steps per second, 32 per simulator tick (finer only adds float rounding)
+#define MAX_DURATION 60 // s
+#define REPEATS 3 // Best of N timings
+
+/* ##### MANEUVERS ##### */
+
+typedef struct {
+    const char *name;
+    int duration;       // s
+    float altitude;     // m
+    float speed;        // m/s, the velocity magnitude (the physics takes it as IAS)
+    float pitch;        // rad, held for the whole maneuver
+    float throttle;     // above 1 is afterburner
+    float fuel;         // kg at the start, negative for full tanks
+} Maneuver;
+
+static const Maneuver maneuvers[] = {
+    {"climb", 60, 3000.0f, 230.0f, 0.15f, 1.0f, -1.0f},
+    {"dive-mach1", 40, 11000.0f, 150.0f, -0.25f, 1.01f, -1.0f},
+    {"afterburner", 60, 8000.0f, 180.0f, 0.03f, 1.01f, -1.0f},
+    {"fuel-exhaustion", 60, 6000.0f, 230.0f, 0.05f, 1.01f, 40.0f},
+};
+
+#define MANEUVERS ((int)(sizeof(maneuvers) / sizeof(maneuvers[0])))
+
+/* ##### CONFIGURATIONS ##### */
+
+typedef struct {
+    const char *name;
+    PhysicsIntegrator integrator;
+    int stages; // computeAcceleration() calls per step
+} Integrator;
+
+static const Integrator integrators[] = {
+    {"rk4", INTEGRATOR_RK4, 4},
+    {"heun", INTEGRATOR_HEUN, 2},
+    {"euler", INTEGRATOR_EULER, 1},
+};
+
+#define INTEGRATORS ((int)(sizeof(integrators) / sizeof(integrators[0])))
+
+static const int stepRates[] = {15, 30, 60, 120, 240}; // steps per second, 60 is the simulation thread's
+#define STEP_RATES ((int)(sizeof(stepRates) / sizeof(stepRates[0])))
+
+#define CONFIGURATIONS (INTEGRATORS * STEP_RATES)
+
+/* ##### FLYING ##### */
+
+typedef struct {
+    double x, y, z;
+} Position;
+
+typedef struct {
+    Position track[MAX_DURATION + 1];   // once per simulated second, track[0] is the start
+    Vector3 finalVelocity;
+    float minMach, maxMach;
+    float finalFuel;
+    int diverged;                       // crashed or NaN before the end
+} Flight;
+
+static const CompiledAircraftModel *model = NULL;
+static AircraftState initial;
+
+static void applyControls(AircraftState *aircraft, const Maneuver *maneuver) {
+    aircraft->yaw = 0.0f;
+    aircraft->pitch = maneuver->pitch;
+    aircraft->roll = 0.0f;
+    aircraft->controls.throttle = maneuver->throttle;
+    aircraft->controls.afterburner = (maneuver->throttle > 1);
+}
+
+static void fly(const Maneuver *maneuver, PhysicsIntegrator integrator, int stepsPerSecond, Flight *flight) {
+    AircraftState aircraft = initial;
+    aircraft.y = maneuver->altitude;
+    aircraft.vx = maneuver->speed;
+    if (maneuver->fuel >= 0.0f) {
+        aircraft.currentMass -= aircraft.fuel - maneuver->fuel;
+        aircraft.fuel = maneuver->fuel;
+    }
+    applyControls(&aircraft, maneuver);
+    initEngineState(&aircraft.engine, aircraft.controls.throttle);
+
+    PhysicsData physics = {0};
+    Position position = {aircraft.x, aircraft.y, aircraft.z};
+    const float deltaTime = 1.0f / (float)stepsPerSecond;
+
+    setPhysicsIntegrator(integrator);
+    flight->track[0] = position;
+    flight->minMach = 1e30f;
+    flight->maxMach = 0.0f;
+    flight->diverged = 0;
+
+    for (int second = 1; second <= maneuver->duration; second++) {
+        for (int step = 0; step < stepsPerSecond && !flight->diverged; step++) {
+            long tick = (long)(second - 1) * stepsPerSecond + step + 1;
+            float simulationTime = (float)((double)tick / (double)stepsPerSecond);
+
+            applyControls(&aircraft, maneuver);
+            updateAircraftPhysics(&physics, &aircraft, deltaTime, simulationTime, model);
+
+            // updateAircraftState() in double
+            position.x += (double)aircraft.vx * (double)deltaTime;
+            position.y += (double)aircraft.vy * (double)deltaTime;
+            position.z += (double)aircraft.vz * (double)deltaTime;
+            aircraft.x = (float)position.x;
+            aircraft.y = (float)position.y;
+            aircraft.z = (float)position.z;
+
+            if (!(aircraft.y > 0.0f)) { // also catches NaN
+                flight->diverged = 1;
+            }
+            flight->minMach = fminf(flight->minMach, physics.machNumber);
+            flight->maxMach = fmaxf(flight->maxMach, physics.machNumber);
+        }
+        flight->track[second] = position;
+    }
+
+    flight->finalVelocity = (Vector3){aircraft.vx, aircraft.vy, aircraft.vz};
+    flight->finalFuel = aircraft.fuel;
+    setPhysicsIntegrator(INTEGRATOR_RK4);
+}
+
+/* ##### ERRORS ##### */
+
+typedef struct {
+    double rmsError;        // m, position over the whole maneuver
+    double maxError;        // m
+    double finalSpeedError; // m/s, length of the velocity difference at the end
+} Errors;
+
+static Errors compareFlights(const Flight *flight, const Flight *reference, int duration) {
+    Errors errors = {0.0, 0.0, 0.0};
+    if (flight->diverged) {
+        errors.rmsError = errors.maxError = errors.finalSpeedError = INFINITY;
+        return errors;
+    }
+
+    for (int second = 1; second <= duration; second++) {
+        double dx = flight->track[second].x - reference->track[second].x;
+        double dy = flight->track[second].y - reference->track[second].y;
+        double dz = flight->track[second].z - reference->track[second].z;
+        double distanceSquared = dx * dx + dy * dy + dz * dz;
+
+        errors.rmsError += distanceSquared;
+        errors.maxError = fmax(errors.maxError, sqrt(distanceSquared));
+    }
+    errors.rmsError = sqrt(errors.rmsError / duration);
+
+    double vx = (double)flight->finalVelocity.x - (double)reference->finalVelocity.x;
+    double vy = (double)flight->finalVelocity.y - (double)reference->finalVelocity.y;
+    double vz = (double)flight->finalVelocity.z - (double)reference->finalVelocity.z;
+    errors.finalSpeedError = sqrt(vx * vx + vy * vy + vz * vz);
+
+    return errors;
+}
+
+/* ##### RESULTS ##### */
+
+typedef struct {
+    const Integrator *integrator;
+    int stepsPerSecond;
+    int evaluationsPerSecond;   // force evaluations per simulated second
+    double nsPerSecond;         // wall time per simulated second
+    Errors errors;
+    int pareto;
+} Result;
+
+static Result results[MANEUVERS + 1][CONFIGURATIONS]; // the last row is the worst maneuver of every configuration
+
+// Marks the configurations no other one beats on both cost and max error
+static void markParetoFront(Result *row) {
+    for (int i = 0; i < CONFIGURATIONS; i++) {
+        row[i].pareto = isfinite(row[i].errors.maxError);
+        for (int j = 0; j < CONFIGURATIONS && row[i].pareto; j++) {
+            int cheaperOrEqual = row[j].evaluationsPerSecond <= row[i].evaluationsPerSecond;
+            int betterOrEqual = row[j].errors.maxError <= row[i].errors.maxError;
+            int strictly = row[j].evaluationsPerSecond < row[i].evaluationsPerSecond || row[j].errors.maxError < row[i].errors.maxError;
+            if (j != i && cheaperOrEqual && betterOrEqual && strictly) {
+                row[i].pareto = 0;
+            }
+        }
+    }
+}
+
+static int compareCost(const void *a, const void *b) {
+    const Result *left = a;
+    const Result *right = b;
+    if (left->evaluationsPerSecond != right->evaluationsPerSecond) {
+        return left->evaluationsPerSecond - right->evaluationsPerSecond;
+    }
+    return (left->errors.maxError < right->errors.maxError) ? -1 : (left->errors.maxError > right->errors.maxError);
+}
+
+static int writeResults(const char *path) {
+    FILE *file = fopen(path, "w");
+    if (file == NULL) {
+        printf("Failed to write %s\n", path);
+        return 0;
+    }
+
+    fprintf(file, "maneuver,integrator,stepsPerSecond,forceEvaluationsPerSecond,nsPerSimulatedSecond,rmsPositionErrorM,maxPositionErrorM,finalSpeedErrorMs,pareto\n");
+    for (int m = 0; m <= MANEUVERS; m++) {
+        for (int c = 0; c < CONFIGURATIONS; c++) {
+            const Result *result = &results[m][c];
+            fprintf(file, "%s,%s,%d,%d,%.0f,%.6g,%.6g,%.6g,%d\n", (m < MANEUVERS) ? maneuvers[m].name : "all",
+                    result->integrator->name, result->stepsPerSecond, result->evaluationsPerSecond, result->nsPerSecond,
+                    result->errors.rmsError, result->errors.maxError, result->errors.finalSpeedError, result->pareto);
+        }
+    }
+
+    fclose(file);
+    return 1;
+}
+
+/* ##### MAIN ##### */
+
+int main(int argc, char *argv[]) {
+    const char *aircraftName = NULL;
+    const char *outputPath = DEFAULT_OUTPUT;
+    double budget = -1.0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--aircraft") == 0 && i + 1 < argc) {
+            aircraftName = argv[++i];
+        }
+        else if (strcmp(argv[i], "--budget") == 0 && i + 1 < argc) {
+            budget = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            outputPath = argv[++i];
+        }
+        else {
+            printf("Usage: %s [--aircraft name] [--budget meters] [--out file.csv]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // The fastest aircraft unless one is named, the dive has to get through Mach 1
+    static AircraftData catalog[MAX_AIRCRAFT];
+    int aircraftCount = loadAircraftCatalog(FILE_PATH, catalog, MAX_AIRCRAFT);
+    AircraftData *data = NULL;
+    for (int i = 0; i < aircraftCount; i++) {
+        if (aircraftName != NULL ? strcmp(catalog[i].name, aircraftName) == 0 : (data == NULL || catalog[i].maxSpeed > data->maxSpeed)) {
+            data = &catalog[i];
+        }
+    }
+    if (data == NULL) {
+        printf("No aircraft %s in %s, run the benchmark from the build folder.\n", (aircraftName != NULL) ? aircraftName : "at all", FILE_PATH);
+        return 1;
+    }
+
+    CompiledAircraftModel compiled;
+    if (!compileAircraftModel(data, &compiled)) {
+        return 1;
+    }
+    model = &compiled;
+    initAircraft(&initial, data);
+    initial.hasAfterburner = (data->afterburnerThrust != 0);
+
+    static Flight reference, halfReference, flight;
+    double worstReferenceError = 0.0;
+
+    printf("%s, reference: RK4 at %d steps/s\n\n", data->name, REFERENCE_RATE);
+    printf("%-16s %9s %9s %9s %9s %16s\n", "maneuver", "min Mach", "max Mach", "end fuel", "end alt", "reference error");
+
+    for (int m = 0; m < MANEUVERS; m++) {
+        const Maneuver *maneuver = &maneuvers[m];
+
+        fly(maneuver, INTEGRATOR_RK4, REFERENCE_RATE, &reference);
+        fly(maneuver, INTEGRATOR_RK4, REFERENCE_RATE / 2, &halfReference);
+        Errors referenceError = compareFlights(&halfReference, &reference, maneuver->duration);
+        worstReferenceError = fmax(worstReferenceError, referenceError.maxError);
+
+        printf("%-16s %9.2f %9.2f %7.0fkg %8.0fm %14.3gm%s\n", maneuver->name, (double)reference.minMach, (double)reference.maxMach,
+               (double)reference.finalFuel, reference.track[maneuver->duration].y, referenceError.maxError, reference.diverged ? " (crashed)" : "");
+
+        for (int i = 0; i < INTEGRATORS; i++) {
+            for (int s = 0; s < STEP_RATES; s++) {
+                Result *result = &results[m][i * STEP_RATES + s];
+                result->integrator = &integrators[i];
+                result->stepsPerSecond = stepRates[s];
+                result->evaluationsPerSecond = integrators[i].stages * stepRates[s];
+
+                long best = -1;
+                for (int r = 0; r < REPEATS; r++) {
+                    long start = getTimeMicroseconds();
+                    fly(maneuver, integrators[i].integrator, stepRates[s], &flight);
+                    long elapsed = getTimeMicroseconds() - start;
+                    if (best < 0 || elapsed < best) best = elapsed;
+                }
+                result->nsPerSecond = (double)best * 1000.0 / maneuver->duration;
+                result->errors = compareFlights(&flight, &reference, maneuver->duration);
+            }
+        }
+        markParetoFront(results[m]);
+    }
+
+    // Summary: every configuration by its worst maneuver
+    for (int c = 0; c < CONFIGURATIONS; c++) {
+        Result *summary = &results[MANEUVERS][c];
+        *summary = results[0][c];
+        for (int m = 1; m < MANEUVERS; m++) {
+            summary->nsPerSecond = fmax(summary->nsPerSecond, results[m][c].nsPerSecond);
+            summary->errors.rmsError = fmax(summary->errors.rmsError, results[m][c].errors.rmsError);
+            summary->errors.maxError = fmax(summary->errors.maxError, results[m][c].errors.maxError);
+            summary->errors.finalSpeedError = fmax(summary->errors.finalSpeedError, results[m][c].errors.finalSpeedError);
+        }
+    }
+    markParetoFront(results[MANEUVERS]);
+
+    static Result sorted[CONFIGURATIONS];
+    memcpy(sorted, results[MANEUVERS], sizeof(sorted));
+    qsort(sorted, CONFIGURATIONS, sizeof(Result), compareCost);
+
+    printf("\nWorst maneuver per configuration, cheapest first (* = Pareto front),\n");
+    printf("position errors below about %.2g m are within the reference's own error\n", worstReferenceError);
+    printf("%-6s %7s %12s %12s %14s %14s %14s\n", "scheme", "steps/s", "evals/sim s", "us/sim s", "max pos err m", "rms pos err m", "end speed m/s");
+    for (int c = 0; c < CONFIGURATIONS; c++) {
+        const Result *result = &sorted[c];
+        printf("%-6s %7d %12d %12.1f %14.4g %14.4g %14.4g%s\n", result->integrator->name, result->stepsPerSecond, result->evaluationsPerSecond,
+               result->nsPerSecond / 1000.0, result->errors.maxError, result->errors.rmsError, result->errors.finalSpeedError,
+               result->pareto ? " *" : "");
+    }
+
+    if (budget >= 0.0) {
+        const Result *cheapest = NULL;
+        for (int c = 0; c < CONFIGURATIONS && cheapest == NULL; c++) {
+            if (sorted[c].errors.maxError <= budget) {
+                cheapest = &sorted[c];
+            }
+        }
+        if (cheapest != NULL) {
+            printf("\nCheapest within %.3g m: %s at %d steps/s (%d force evaluations per simulated second)\n", budget,
+                   cheapest->integrator->name, cheapest->stepsPerSecond, cheapest->evaluationsPerSecond);
+        }
+        else {
+            printf("\nNo configuration stays within %.3g m\n", budget);
+        }
+    }
+
+    if (!writeResults(outputPath)) {
+        return 1;
+    }
+    printf("\nWrote %s\n", outputPath);
+
+    return 0;
+}
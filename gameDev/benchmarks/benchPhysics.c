@@ -0,0 +1,469 @@
+/**
+ * @file benchPhysics.c
+ * @brief Measures the cost per call (ns) of the hot functions of physics.c across the flight envelope.
+ *
+ * Every function is called on states sampled from six regimes, subsonic/transonic/supersonic below and
+ * above the tropopause, and on a mix of all of them (the branches then stop being predictable):
+ * - the number of calls per batch is doubled until a batch takes 10 ms (this also warms up caches and branch predictors),
+ * - then REPEATS batches are timed, their mean, min and standard deviation are reported,
+ * - the cost of the loop itself (and for updatePhysics() of copying the state it changes) is measured the same way and subtracted.
+ *
+ * The process is pinned to one CPU so the batches don't migrate between cores. The results are written to
+ * bench_physics.json, --compare prints the change between two such files, changes bigger than twice the
+ * combined standard deviation are marked.
+ *
+ * Usage: ./build/bench_physics [--aircraft name] [--cpu n] [--out file.json]
+ *        ./build/bench_physics --compare base.json new.json
+ */
+
+#define _GNU_SOURCE // sched_setaffinity() and sched_getcpu()
+
+// Include header files
+#include "aircraft.h"
+#include "aircraftData.h"
+#include "aircraftModel.h"
+#include "physics.h"
+#include "menu.h"
+#include "utils.h"
+
+// Include standard libraries
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#define FILE_PATH "data/aircraftData.txt" // Same data file the simulator uses
+#define DEFAULT_OUTPUT "bench_physics.json"
+#define DELTA_TIME (1.0f / (float)TARGET_FPS) // Fixed step
+#define SAMPLES 64 // States per regime, a power of two. Few enough to stay in L1, like the one state the simulator works on
+#define SAMPLE_MASK (SAMPLES - 1)
+#define MIN_BATCH_MICROSECONDS 10000 // Calibrated batch length, long against the timer resolution
+#define REPEATS 15 // Timed batches per function and regime
+#define MAX_COMPARED 128 // Results read from a file in --compare
+
+/**
+ * @brief Keeps a result alive and in memory, like DoNotOptimize() in Google Benchmark.
+ *
+ * The empty asm takes the address and clobbers memory, so the compiler has to store the result and can't drop
+ * or hoist the call that produced it.
+ */
+static void doNotOptimize(const void *value) {
+#if defined(__GNUC__)
+    __asm__ volatile("" : : "r"(value) : "memory");
+#else
+    static volatile char sink; // compilers without inline asm
+    sink = *(const volatile char *)value;
+#endif
+}
+
+/* ##### SAMPLED STATES ##### */
+
+typedef struct {
+    const char *name;
+    float minMach, maxMach;
+    float minAltitude, maxAltitude; // m, the tropopause is at 11 km
+} Regime;
+
+static const Regime regimes[] = {
+    {"subsonic-low", 0.3f, 0.8f, 1000.0f, 10000.0f},
+    {"subsonic-high", 0.5f, 0.8f, 11500.0f, 18000.0f},
+    {"transonic-low", 0.8f, 1.2f, 1000.0f, 10000.0f},
+    {"transonic-high", 0.8f, 1.2f, 11500.0f, 18000.0f},
+    {"supersonic-low", 1.2f, 1.6f, 1000.0f, 10000.0f},
+    {"supersonic-high", 1.2f, 2.0f, 11500.0f, 18000.0f},
+};
+
+#define REGIMES ((int)(sizeof(regimes) / sizeof(regimes[0])))
+#define SETS (REGIMES + 1) // the last set mixes all regimes
+
+typedef struct {
+    AircraftState aircraft;
+    PhysicsData physics; // updatePhysicsData() of the state, what the functions read from
+} Sample;
+
+static Sample samples[SETS][SAMPLES];
+static const CompiledAircraftModel *model = NULL;
+
+// Fixed seed, every run measures the same states
+static unsigned int randomState = 0x2545F491u;
+
+static float randomFloat(float min, float max) {
+    // xorshift32
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+
+    return min + (max - min) * (float)(randomState >> 8) / 16777216.0f;
+}
+
+static void makeSample(Sample *sample, const Regime *regime, const AircraftState *initial) {
+    AircraftState *aircraft = &sample->aircraft;
+    *aircraft = *initial;
+
+    aircraft->x = randomFloat(-50000.0f, 50000.0f);
+    aircraft->y = randomFloat(regime->minAltitude, regime->maxAltitude);
+    aircraft->z = randomFloat(-50000.0f, 50000.0f);
+    aircraft->yaw = randomFloat(0.0f, 2.0f * PI);
+    aircraft->pitch = randomFloat(-0.17f, 0.17f); // +-10°
+    aircraft->roll = randomFloat(-1.05f, 1.05f); // +-60°
+
+    aircraft->controls.throttle = randomFloat(0.5f, 1.0f);
+    initEngineState(&aircraft->engine, aircraft->controls.throttle);
+
+    // speed from the local speed of sound, flying a little below the nose. The velocity is taken as IAS
+    // (calculateTAS()), so it's scaled by sqrt(density ratio) for the Mach number to come out as sampled.
+    PhysicsData atmosphere = {0};
+    atmosphere.tropopauseAltitude = getTropopause();
+    atmosphere.temperatureKelvin = getTemperatureKelvin(aircraft->y, &atmosphere);
+    float densityRatio = getAirDensity(aircraft->y, &atmosphere) / SEA_LEVEL_AIR_DENSITY;
+    float speed = randomFloat(regime->minMach, regime->maxMach) * calculateSpeedOfSound(aircraft->y, &atmosphere) * sqrtf(densityRatio);
+    float flightPath = aircraft->pitch - randomFloat(0.02f, 0.1f);
+
+    aircraft->vx = speed * cosf(flightPath) * cosf(aircraft->yaw);
+    aircraft->vy = speed * sinf(flightPath);
+    aircraft->vz = speed * cosf(flightPath) * sinf(aircraft->yaw);
+
+    sample->physics = (PhysicsData){0};
+    updatePhysicsData(&sample->physics, aircraft->y, aircraft, model, 1.0f);
+}
+
+static void makeSamples(const AircraftState *initial) {
+    for (int regime = 0; regime < REGIMES; regime++) {
+        for (int i = 0; i < SAMPLES; i++) {
+            makeSample(&samples[regime][i], &regimes[regime], initial);
+        }
+    }
+
+    // the mixed set takes its states round robin from the regimes
+    for (int i = 0; i < SAMPLES; i++) {
+        samples[REGIMES][i] = samples[i % REGIMES][i];
+    }
+}
+
+/* ##### MEASURED CALLS ##### */
+
+static AircraftState scratchAircraft;
+static PhysicsData scratchPhysics;
+static float simulationTime = 0.0f;
+
+static void callLoop(Sample *sample) {
+    doNotOptimize(sample);
+}
+
+static void callCopyState(Sample *sample) {
+    scratchAircraft = sample->aircraft;
+    doNotOptimize(&scratchAircraft);
+}
+
+static void callUpdatePhysicsData(Sample *sample) {
+    updatePhysicsData(&scratchPhysics, sample->aircraft.y, &sample->aircraft, model, 1.0f);
+    doNotOptimize(&scratchPhysics);
+}
+
+static void callComputeAcceleration(Sample *sample) {
+    Vector3 velocity = {sample->aircraft.vx, sample->aircraft.vy, sample->aircraft.vz};
+    Vector3 acceleration = computeAcceleration(velocity, &sample->aircraft, model, &sample->physics);
+    doNotOptimize(&acceleration);
+}
+
+static void callUpdatePhysics(Sample *sample) {
+    scratchAircraft = sample->aircraft;
+
+    // new time every call so the physics data is always updated, wrapped before float steps get too coarse
+    simulationTime += DELTA_TIME;
+    if (simulationTime > 3600.0f) {
+        simulationTime = DELTA_TIME;
+    }
+
+    updatePhysics(&scratchAircraft, DELTA_TIME, simulationTime, model);
+    doNotOptimize(&scratchAircraft);
+}
+
+static void callGetAirDensity(Sample *sample) {
+    float density = getAirDensity(sample->aircraft.y, &sample->physics);
+    doNotOptimize(&density);
+}
+
+static void callCalculateDragCoefficient(Sample *sample) {
+    float coefficient = calculateDragCoefficient(sample->physics.trueAirspeed, C_D0, model, &sample->physics);
+    doNotOptimize(&coefficient);
+}
+
+static void callComputeLiftForceComponents(Sample *sample) {
+    Vector3 lift = computeLiftForceComponents(&sample->aircraft, model->wingArea, sample->physics.liftCoefficient, &sample->physics);
+    doNotOptimize(&lift);
+}
+
+static void callGetRightWingDirection(Sample *sample) {
+    Vector3 right = getRightWingDirection(&sample->aircraft, &sample->physics);
+    doNotOptimize(&right);
+}
+
+static void callCalculateThrust(Sample *sample) {
+    float thrust = calculateThrust(model, &sample->aircraft.engine, &sample->physics);
+    doNotOptimize(&thrust);
+}
+
+typedef struct {
+    const char *name;
+    void (*call)(Sample *sample);
+    int baseline; // index of the entry subtracted from this one, -1 for none
+} BenchFunction;
+
+// The baselines come before the entries using them
+static const BenchFunction functions[] = {
+    {"(loop)", callLoop, -1},
+    {"(copy state)", callCopyState, -1},
+    {"updatePhysicsData", callUpdatePhysicsData, 0},
+    {"computeAcceleration", callComputeAcceleration, 0},
+    {"updatePhysics", callUpdatePhysics, 1},
+    {"getAirDensity", callGetAirDensity, 0},
+    {"calculateDragCoefficient", callCalculateDragCoefficient, 0},
+    {"computeLiftForceComponents", callComputeLiftForceComponents, 0},
+    {"getRightWingDirection", callGetRightWingDirection, 0},
+    {"calculateThrust", callCalculateThrust, 0},
+};
+
+#define FUNCTIONS ((int)(sizeof(functions) / sizeof(functions[0])))
+
+/* ##### MEASUREMENT ##### */
+
+typedef struct {
+    double mean, min, stddev; // ns per call
+} Result;
+
+static Result results[FUNCTIONS][SETS];
+
+// Runs `calls` calls over the set and returns the elapsed time in microseconds
+static long runCalls(const BenchFunction *function, Sample *set, long calls) {
+    long start = getTimeMicroseconds();
+    for (long i = 0; i < calls; i++) {
+        function->call(&set[i & SAMPLE_MASK]);
+    }
+    return getTimeMicroseconds() - start;
+}
+
+static Result measure(const BenchFunction *function, Sample *set) {
+    // calibrate (and warm up): double the calls until a batch is long enough
+    long calls = SAMPLES;
+    while (runCalls(function, set, calls) < MIN_BATCH_MICROSECONDS && calls < (1L << 40)) {
+        calls *= 2;
+    }
+
+    double times[REPEATS];
+    Result result = {0.0, 1e30, 0.0};
+    for (int r = 0; r < REPEATS; r++) {
+        times[r] = (double)runCalls(function, set, calls) * 1000.0 / (double)calls;
+        result.mean += times[r];
+        if (times[r] < result.min) result.min = times[r];
+    }
+    result.mean /= REPEATS;
+
+    for (int r = 0; r < REPEATS; r++) {
+        result.stddev += (times[r] - result.mean) * (times[r] - result.mean);
+    }
+    result.stddev = sqrt(result.stddev / (REPEATS - 1));
+
+    return result;
+}
+
+// Pins the process to `cpu`, or to the one it runs on when `cpu` is negative. Returns the CPU or -1.
+static int pinToCpu(int cpu) {
+#ifdef __linux__
+    if (cpu < 0) {
+        cpu = sched_getcpu();
+    }
+    if (cpu >= 0 && cpu < CPU_SETSIZE) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET((size_t)cpu, &set);
+        if (sched_setaffinity(0, sizeof(set), &set) == 0) {
+            return cpu;
+        }
+    }
+#else
+    (void)cpu;
+#endif
+    return -1;
+}
+
+static int writeResults(const char *path, const char *aircraftName, int cpu) {
+    FILE *file = fopen(path, "w");
+    if (file == NULL) {
+        printf("Failed to write %s\n", path);
+        return 0;
+    }
+
+    fprintf(file, "{\n  \"benchmark\": \"physics\",\n  \"aircraft\": \"%s\",\n  \"cpu\": %d,\n", aircraftName, cpu);
+    fprintf(file, "  \"samples\": %d,\n  \"repetitions\": %d,\n  \"results\": [\n", SAMPLES, REPEATS);
+
+    for (int f = 0; f < FUNCTIONS; f++) {
+        for (int s = 0; s < SETS; s++) {
+            const Result *result = &results[f][s];
+            // one result per line, --compare reads them back line by line
+            fprintf(file, "    {\"function\": \"%s\", \"regime\": \"%s\", \"meanNs\": %.3f, \"minNs\": %.3f, \"stddevNs\": %.3f}%s\n",
+                    functions[f].name, (s < REGIMES) ? regimes[s].name : "envelope", result->mean, result->min, result->stddev,
+                    (f == FUNCTIONS - 1 && s == SETS - 1) ? "" : ",");
+        }
+    }
+
+    fprintf(file, "  ]\n}\n");
+    fclose(file);
+    return 1;
+}
+
+/* ##### COMPARISON ##### */
+
+typedef struct {
+    char function[64];
+    char regime[32];
+    Result result;
+} NamedResult;
+
+// Reads the result lines of a file written by writeResults(), returns how many were read or -1
+static int readResults(const char *path, NamedResult *read, int capacity) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        printf("Failed to open %s\n", path);
+        return -1;
+    }
+
+    char line[256];
+    int count = 0;
+    while (count < capacity && fgets(line, sizeof(line), file) != NULL) {
+        NamedResult *entry = &read[count];
+        if (sscanf(line, " {\"function\": \"%63[^\"]\", \"regime\": \"%31[^\"]\", \"meanNs\": %lf, \"minNs\": %lf, \"stddevNs\": %lf",
+                   entry->function, entry->regime, &entry->result.mean, &entry->result.min, &entry->result.stddev) == 5) {
+            count++;
+        }
+    }
+
+    fclose(file);
+    return count;
+}
+
+static int compareFiles(const char *basePath, const char *newPath) {
+    static NamedResult base[MAX_COMPARED];
+    static NamedResult current[MAX_COMPARED];
+
+    int baseCount = readResults(basePath, base, MAX_COMPARED);
+    int currentCount = readResults(newPath, current, MAX_COMPARED);
+    if (baseCount < 0 || currentCount < 0) {
+        return 1;
+    }
+
+    printf("%-28s %-16s %10s %10s %9s\n", "function", "regime", "base ns", "new ns", "change");
+
+    int significant = 0;
+    for (int i = 0; i < currentCount; i++) {
+        const NamedResult *now = &current[i];
+        const NamedResult *before = NULL;
+        for (int j = 0; j < baseCount && before == NULL; j++) {
+            if (strcmp(base[j].function, now->function) == 0 && strcmp(base[j].regime, now->regime) == 0) {
+                before = &base[j];
+            }
+        }
+        if (before == NULL) {
+            printf("%-28s %-16s %10s %10.2f %9s\n", now->function, now->regime, "-", now->result.mean, "new");
+            continue;
+        }
+
+        double difference = now->result.mean - before->result.mean;
+        double noise = 2.0 * sqrt(before->result.stddev * before->result.stddev + now->result.stddev * now->result.stddev);
+        int marked = fabs(difference) > noise;
+        significant += marked;
+
+        printf("%-28s %-16s %10.2f %10.2f %+8.1f%%%s\n", now->function, now->regime, before->result.mean, now->result.mean,
+               (before->result.mean > 0.0) ? 100.0 * difference / before->result.mean : 0.0, marked ? " *" : "");
+    }
+
+    printf("\n%d of %d changes bigger than twice the combined standard deviation (*)\n", significant, currentCount);
+    return 0;
+}
+
+/* ##### MAIN ##### */
+
+int main(int argc, char *argv[]) {
+    const char *aircraftName = NULL;
+    const char *outputPath = DEFAULT_OUTPUT;
+    int cpu = -1;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--compare") == 0 && i + 2 < argc) {
+            return compareFiles(argv[i + 1], argv[i + 2]);
+        }
+        else if (strcmp(argv[i], "--aircraft") == 0 && i + 1 < argc) {
+            aircraftName = argv[++i];
+        }
+        else if (strcmp(argv[i], "--cpu") == 0 && i + 1 < argc) {
+            cpu = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            outputPath = argv[++i];
+        }
+        else {
+            printf("Usage: %s [--aircraft name] [--cpu n] [--out file.json]\n       %s --compare base.json new.json\n", argv[0], argv[0]);
+            return 1;
+        }
+    }
+
+    Aircraft aircraftList[MAX_AIRCRAFT];
+    int aircraftCount = 0;
+    if (!loadAircraftNames(FILE_PATH, aircraftList, &aircraftCount) || aircraftCount == 0) {
+        return 1;
+    }
+    if (aircraftName == NULL) {
+        aircraftName = aircraftList[0].name;
+    }
+
+    static AircraftData data;
+    getAircraftDataByName(FILE_PATH, aircraftName, &data);
+
+    CompiledAircraftModel compiled;
+    if (!compileAircraftModel(&data, &compiled)) {
+        printf("No aircraft called %s in %s\n", aircraftName, FILE_PATH);
+        return 1;
+    }
+    model = &compiled;
+
+    AircraftState initial;
+    initAircraft(&initial, &data);
+    makeSamples(&initial);
+
+    cpu = pinToCpu(cpu);
+    if (cpu >= 0) {
+        printf("%s, pinned to CPU %d\n\n", data.name, cpu);
+    }
+    else {
+        printf("%s, not pinned to a CPU\n\n", data.name);
+    }
+
+    printf("%-28s %-16s %10s %10s %10s\n", "function", "regime", "mean ns", "min ns", "stddev ns");
+
+    for (int f = 0; f < FUNCTIONS; f++) {
+        for (int s = 0; s < SETS; s++) {
+            Result result = measure(&functions[f], samples[s]);
+
+            if (functions[f].baseline >= 0) {
+                const Result *baseline = &results[functions[f].baseline][s];
+                result.mean -= baseline->mean;
+                result.min -= baseline->min;
+                result.stddev = sqrt(result.stddev * result.stddev + baseline->stddev * baseline->stddev);
+            }
+            results[f][s] = result;
+
+            printf("%-28s %-16s %10.2f %10.2f %10.2f\n", functions[f].name, (s < REGIMES) ? regimes[s].name : "envelope",
+                   result.mean, result.min, result.stddev);
+        }
+    }
+
+    if (!writeResults(outputPath, data.name, cpu)) {
+        return 1;
+    }
+    printf("\nWrote %s\n", outputPath);
+
+    return 0;
+}
@@ -0,0 +1,283 @@
+/**
+ * @file benchRender.c
+ * @brief Measures what the HUD costs per frame, on SDL's software renderer so it runs without a GPU or a display.
+ *
+ * The real HUD (initTextRenderer() and renderFlightInfo()) is driven with a synthetic flight: a climbing,
+ * banking turn with the throttle and speed moving, so the numbers change every frame like in flight.
+ * Every HUD page is measured with both backends:
+ * - "sdl": the render batch issues SDL calls to the software renderer,
+ * - "cpu": the render batch draws into the CPU rasterizer's framebuffer.
+ *
+ * Frames are paced at TARGET_FPS like the main loop, so the widgets' update rates and the change detection
+ * behave as in flight; only renderFlightInfo() itself is timed. Reported per page and backend: mean, median
+ * and 99th percentile frame time, frames actually redrawn, SDL draw calls and state changes per frame and
+ * textures created while measuring (there should be none). The results are printed and written as JSON.
+ *
+ * SDL_VIDEODRIVER defaults to "dummy" (set it to "offscreen" or a real driver to override).
+ *
+ * Usage: ./build/bench_render [frames] [output.json]
+ */
+
+// Include header files
+#include "2Drenderer.h"
+#include "aircraft.h"
+#include "aircraftData.h"
+#include "menu.h"
+#include "renderBatch.h"
+#include "simulation.h"
+#include "utils.h"
+
+// Include standard libraries
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define FILE_PATH "data/aircraftData.txt" // Same data file the simulator uses
+#define DEFAULT_OUTPUT "bench_render.json"
+#define DEFAULT_FRAMES 300 // Measured frames per page and backend (5 s at 60 FPS)
+#define WARMUP_FRAMES 60 // Frames before measuring: the widget tree, caches and glyphs
+#define FRAME_SECONDS (1.0f / (float)TARGET_FPS)
+
+typedef enum {
+    PAGE_TEXT,      // text mode: the flight info page
+    PAGE_VISUAL,    // visual mode: gauges, tapes, attitude indicator, ground track map
+    PAGE_DEBUG,     // text mode with the debug overlay and the strip charts
+    PAGE_TACTICAL,  // tactical display with the synthetic traffic
+    PAGES
+} HudPage;
+
+static const char *pageNames[PAGES] = {"text", "visual", "debug", "tactical"};
+static const char *backendNames[] = {"sdl", "cpu"};
+
+typedef struct {
+    double meanMs;
+    double p50Ms;
+    double p99Ms;
+    double maxMs;
+    int redrawn;            // frames that weren't skipped by the change detection
+    double drawCalls;       // per frame
+    double stateChanges;    // per frame
+    int textures;           // created while measuring
+} PageResult;
+
+// The HUD's modes as toggled so far, it starts in text mode with the controls shown
+static int textMode = 1;
+static int debugMode = 0;
+static int tacticalMode = 0;
+
+static void pressKey(SDL_Keycode key) {
+    SDL_Event event;
+    memset(&event, 0, sizeof(event));
+    event.type = SDL_KEYDOWN;
+    event.key.keysym.sym = key;
+    toggleModes(event);
+}
+
+static void showPage(HudPage page) {
+    const int text = (page == PAGE_TEXT || page == PAGE_DEBUG);
+    const int debug = (page == PAGE_DEBUG);
+    const int tactical = (page == PAGE_TACTICAL);
+
+    if (textMode != text) {
+        pressKey(SDLK_m);
+        textMode = text;
+    }
+    if (debugMode != debug) {
+        pressKey(SDLK_p);
+        debugMode = debug;
+    }
+    if (tacticalMode != tactical) {
+        pressKey(SDLK_t);
+        tacticalMode = tactical;
+    }
+}
+
+// A banking, climbing turn at cruise speed, everything the HUD shows changes smoothly
+static void fillSnapshot(SimulationSnapshot *snapshot, const AircraftState *initial, const AircraftData *data, unsigned frame) {
+    const float t = (float)frame * FRAME_SECONDS;
+    const float speed = 220.0f + 30.0f * sinf(0.1f * t); // m/s
+    const float yaw = fmodf(0.05f * t, 2.0f * (float)M_PI);
+
+    memset(snapshot, 0, sizeof(*snapshot));
+    AircraftState *aircraft = &snapshot->aircraft;
+    *aircraft = *initial;
+    aircraft->x = 3000.0f * sinf(0.05f * t);
+    aircraft->z = 3000.0f * (1.0f - cosf(0.05f * t));
+    aircraft->y = 3000.0f + 500.0f * sinf(0.03f * t);
+    aircraft->vx = speed * cosf(yaw);
+    aircraft->vy = 15.0f * cosf(0.03f * t);
+    aircraft->vz = speed * sinf(yaw);
+    aircraft->yaw = yaw;
+    aircraft->pitch = 0.1f * sinf(0.3f * t);
+    aircraft->roll = 0.5f * sinf(0.2f * t);
+    aircraft->AoA = 3.0f + sinf(0.3f * t);
+    aircraft->controls.throttle = 0.7f + 0.2f * sinf(0.07f * t);
+    aircraft->thrust = (float)data->thrust * aircraft->controls.throttle;
+    aircraft->fuel = fmaxf(initial->fuel - 2.0f * t, 0.0f);
+
+    snapshot->simulationTime = t;
+    snapshot->tick = frame;
+    snapshot->trueAirspeed = speed;
+    snapshot->velocityMagnitude = speed;
+    snapshot->machNumber = speed / 330.0f;
+    snapshot->thrust = aircraft->thrust;
+    snapshot->totalDrag = 0.9f * aircraft->thrust;
+    snapshot->dragCoefficient = 0.02f + 0.002f * sinf(0.3f * t);
+    snapshot->parasiticDrag = 0.6f * snapshot->totalDrag;
+    snapshot->inducedDrag = 0.4f * snapshot->totalDrag;
+    snapshot->windVector = (Vector3){5.0f + sinf(t), 0.0f, 3.0f * cosf(0.5f * t)};
+    snapshot->temperatureDeviation = 2.0f;
+}
+
+static int compareDoubles(const void *a, const void *b) {
+    const double x = *(const double *)a;
+    const double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Runs the page for `count` frames starting at `frame`, returns the next frame number
+static unsigned runFrames(HudPage page, const AircraftState *initial, const AircraftData *data, unsigned frame, int count, double *times, PageResult *result) {
+    const double ticksPerMs = (double)SDL_GetPerformanceFrequency() / 1000.0;
+    SimulationSnapshot snapshot;
+    showPage(page);
+
+    const RenderBatchStats before = getRenderBatchTotals();
+    if (result != NULL) {
+        memset(result, 0, sizeof(*result));
+    }
+
+    for (int i = 0; i < count; i++, frame++) {
+        const long frameStart = getTimeMicroseconds();
+        fillSnapshot(&snapshot, initial, data, frame);
+        SDL_PumpEvents();
+
+        const int drawCalls = getRenderBatchTotals().drawCalls;
+        const Uint64 start = SDL_GetPerformanceCounter();
+        renderFlightInfo(&snapshot, data, (float)TARGET_FPS);
+        const Uint64 end = SDL_GetPerformanceCounter();
+
+        if (times != NULL) {
+            times[i] = (double)(end - start) / ticksPerMs;
+        }
+        if (result != NULL && getRenderBatchTotals().drawCalls > drawCalls) {
+            result->redrawn++;
+        }
+
+        // the rest of the frame is the main loop's, wait for it like the main loop does
+        const long left = FRAME_TIME_MICROSECONDS - (getTimeMicroseconds() - frameStart);
+        if (left > 1000) {
+            SDL_Delay((Uint32)(left / 1000));
+        }
+    }
+
+    if (result != NULL && times != NULL && count > 0) {
+        const RenderBatchStats after = getRenderBatchTotals();
+        double sum = 0.0;
+        for (int i = 0; i < count; i++) {
+            sum += times[i];
+        }
+        qsort(times, (size_t)count, sizeof(double), compareDoubles);
+
+        result->meanMs = sum / (double)count;
+        result->p50Ms = times[count / 2];
+        result->p99Ms = times[(count * 99) / 100];
+        result->maxMs = times[count - 1];
+        result->drawCalls = (double)(after.drawCalls - before.drawCalls) / (double)count;
+        result->stateChanges = (double)(after.stateChanges - before.stateChanges) / (double)count;
+        result->textures = after.textures - before.textures;
+    }
+
+    return frame;
+}
+
+static int writeJson(const char *path, const char *videoDriver, const char *aircraftName, int frames, PageResult results[][PAGES], int backends) {
+    FILE *file = fopen(path, "w");
+    if (file == NULL) {
+        return 0;
+    }
+
+    fprintf(file, "{\n");
+    fprintf(file, "  \"benchmark\": \"bench_render\",\n");
+    fprintf(file, "  \"timestamp\": %lld,\n", (long long)time(NULL));
+    fprintf(file, "  \"videoDriver\": \"%s\",\n", videoDriver);
+    fprintf(file, "  \"aircraft\": \"%s\",\n", aircraftName);
+    fprintf(file, "  \"frames\": %d,\n", frames);
+    fprintf(file, "  \"frameRate\": %d,\n", TARGET_FPS);
+    fprintf(file, "  \"results\": [\n");
+    for (int backend = 0; backend < backends; backend++) {
+        for (int page = 0; page < PAGES; page++) {
+            const PageResult *r = &results[backend][page];
+            fprintf(file, "    {\"backend\": \"%s\", \"page\": \"%s\", \"meanMs\": %.4f, \"p50Ms\": %.4f, \"p99Ms\": %.4f, \"maxMs\": %.4f, "
+                          "\"redrawnFrames\": %d, \"drawCallsPerFrame\": %.2f, \"stateChangesPerFrame\": %.2f, \"texturesCreated\": %d}%s\n",
+                    backendNames[backend], pageNames[page], r->meanMs, r->p50Ms, r->p99Ms, r->maxMs,
+                    r->redrawn, r->drawCalls, r->stateChanges, r->textures,
+                    (backend == backends - 1 && page == PAGES - 1) ? "" : ",");
+        }
+    }
+    fprintf(file, "  ]\n}\n");
+
+    return fclose(file) == 0;
+}
+
+int main(int argc, char *argv[]) {
+    int frames = (argc > 1) ? atoi(argv[1]) : DEFAULT_FRAMES;
+    const char *output = (argc > 2) ? argv[2] : DEFAULT_OUTPUT;
+    if (frames <= 0) {
+        frames = DEFAULT_FRAMES;
+    }
+
+    // Headless: no window on screen, SDL's software renderer
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", 0);
+    SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+
+    Aircraft aircraftList[MAX_AIRCRAFT];
+    int aircraftCount = 0;
+    if (!loadAircraftNames(FILE_PATH, aircraftList, &aircraftCount) || aircraftCount == 0) {
+        printf("Failed to load %s, run the benchmark from the build folder.\n", FILE_PATH);
+        return 1;
+    }
+    AircraftData data = {0};
+    getAircraftDataByName(FILE_PATH, aircraftList[0].name, &data);
+    AircraftState initial;
+    initAircraft(&initial, &data);
+
+    double *times = malloc((size_t)frames * sizeof(double));
+    if (times == NULL) {
+        return 1;
+    }
+
+    static PageResult results[2][PAGES];
+    char videoDriver[32] = "none";
+    unsigned frame = 0;
+
+    printf("%-8s %-9s %9s %9s %9s %9s %8s %11s %13s %9s\n", "backend", "page", "mean ms", "p50 ms", "p99 ms", "max ms", "redrawn", "draw calls", "state changes", "textures");
+
+    for (int backend = 0; backend < 2; backend++) {
+        SDL_setenv("HUD_RENDERER", backendNames[backend], 1);
+        initTextRenderer();
+        if (SDL_GetCurrentVideoDriver() != NULL) {
+            snprintf(videoDriver, sizeof(videoDriver), "%s", SDL_GetCurrentVideoDriver());
+        }
+
+        for (int page = 0; page < PAGES; page++) {
+            frame = runFrames((HudPage)page, &initial, &data, frame, WARMUP_FRAMES, NULL, NULL);
+            frame = runFrames((HudPage)page, &initial, &data, frame, frames, times, &results[backend][page]);
+
+            const PageResult *r = &results[backend][page];
+            printf("%-8s %-9s %9.3f %9.3f %9.3f %9.3f %8d %11.1f %13.1f %9d\n", backendNames[backend], pageNames[page],
+                   r->meanMs, r->p50Ms, r->p99Ms, r->maxMs, r->redrawn, r->drawCalls, r->stateChanges, r->textures);
+        }
+
+        destroyTextRenderer();
+    }
+
+    free(times);
+    if (!writeJson(output, videoDriver, data.name, frames, results, 2)) {
+        printf("Failed to write %s\n", output);
+        return 1;
+    }
+    printf("Video driver %s, results written to %s\n", videoDriver, output);
+    return 0;
+}
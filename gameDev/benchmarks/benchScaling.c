@@ -0,0 +1,472 @@
+/**
+ * @file benchScaling.c
+ * @brief Measures how the whole simulation step scales with the number of aircraft and threads.
+ *
+ * Every tick runs the real pipeline: the weather is updated once (wind field, weather simulation snapshots),
+ * then every aircraft gets its controls from a schedule and is stepped like the simulation thread steps the
+ * player (engine spool, Dryden turbulence, RK4 physics with its own PhysicsData, fuel burn, position). The
+ * aircraft are split into one contiguous chunk per thread, the threads meet at the end of every tick.
+ *
+ * For 1, 10, 100, 1000 and 10 000 aircraft on 1, 2, 4, ... threads it reports simulated seconds per wall
+ * second, ns per aircraft tick, the parallel efficiency (throughput / (threads * single thread throughput))
+ * and the memory per aircraft (its state, physics data and turbulence slot plus its share of the compiled
+ * airframes). The results are written to bench_scaling.json.
+ *
+ * The aircraft fly the airframes of the catalog in turn. gen_aircraft_catalog writes catalogs with thousands
+ * of distinct airframes.
+ *
+ * Usage: ./build/bench_scaling [--catalog file] [--threads n] [--out file.json]
+ */
+
+// Include header files
+#include "aircraft.h"
+#include "aircraftData.h"
+#include "aircraftModel.h"
+#include "physics.h"
+#include "simulation.h"
+#include "weather.h"
+#include "utils.h"
+
+// Include standard libraries
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEFAULT_CATALOG "data/aircraftData.txt" // Same data file the simulator uses
+#define DEFAULT_OUTPUT "bench_scaling.json"
+#define DELTA_TIME (1.0f / (float)SIMULATION_RATE) // Fixed step of the simulation thread
+#define MAX_FLEET 10000 // Biggest fleet, also the most airframes loaded from a catalog
+#define MAX_THREADS 16
+#define WORK_PER_RUN 1000000L // Aircraft ticks per measurement
+#define MIN_TICKS 120 // 2 simulated seconds
+#define MAX_TICKS 36000 // 10 simulated minutes, the schedules are written for that long
+#define REPEATS 3 // Best of N runs, filters out scheduler noise
+
+static const int fleetSizes[] = {1, 10, 100, 1000, 10000};
+#define FLEET_SIZES ((int)(sizeof(fleetSizes) / sizeof(fleetSizes[0])))
+
+static const int threadSteps[] = {1, 2, 4, 8, MAX_THREADS};
+#define THREAD_STEPS ((int)(sizeof(threadSteps) / sizeof(threadSteps[0])))
+
+/* ##### CONTROL SCHEDULES ##### */
+
+typedef enum {
+    SCHEDULE_CRUISE,            // level, constant heading, 80% throttle
+    SCHEDULE_CLIMB,             // full throttle climb for two minutes, then level off
+    SCHEDULE_TURN,              // gently banked constant rate turn
+    SCHEDULE_THROTTLE_STEPS,    // throttle steps between 70% and afterburner every 20 s, gentle pitch oscillation
+    SCHEDULES
+} ScheduleKind;
+
+typedef struct {
+    ScheduleKind kind;
+    float heading;  // rad
+    float phase;    // s, so the fleet doesn't step its throttles in unison
+} ControlSchedule;
+
+// The controls of the schedule at `time`, applied like the simulation thread applies the player's
+static void applySchedule(AircraftState *aircraft, const ControlSchedule *schedule, float time) {
+    float pitch = 0.02f;
+    float roll = 0.0f;
+    float yaw = schedule->heading;
+    float throttle = 0.8f;
+
+    switch (schedule->kind) {
+        case SCHEDULE_CRUISE:
+            break;
+        case SCHEDULE_CLIMB:
+            pitch = (time < 120.0f) ? 0.12f : 0.02f;
+            throttle = (time < 120.0f) ? 1.0f : 0.8f;
+            break;
+        case SCHEDULE_TURN:
+            pitch = 0.04f;
+            roll = 0.2f; // steeper banks diverge in the current physics
+            yaw = schedule->heading + 0.03f * time;
+            throttle = 0.9f;
+            break;
+        case SCHEDULE_THROTTLE_STEPS:
+            pitch = 0.02f + 0.05f * sinf(0.2f * (time + schedule->phase));
+            throttle = ((int)((time + schedule->phase) / 20.0f) % 3 == 2) ? 1.01f : 0.7f;
+            break;
+        case SCHEDULES:
+        default:
+            break;
+    }
+
+    aircraft->yaw = yaw;
+    aircraft->pitch = pitch;
+    aircraft->roll = roll;
+    aircraft->controls.throttle = throttle;
+    aircraft->controls.afterburner = (throttle > 1);
+}
+
+/* ##### FLEET ##### */
+
+static AircraftData *catalog = NULL;
+static CompiledAircraftModel *models = NULL; // one per airframe
+static int airframeCount = 0;
+
+static AircraftState *initialStates = NULL;
+static AircraftState *states = NULL;
+static PhysicsData *physicsData = NULL;
+static ControlSchedule *schedules = NULL;
+
+static float simulationTime = 0.0f;
+
+// Fixed seed, every run flies the same fleet
+static unsigned int randomState = 0x9E3779B9u;
+
+static float randomFloat(float min, float max) {
+    // xorshift32
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+
+    return min + (max - min) * (float)(randomState >> 8) / 16777216.0f;
+}
+
+static int loadFleet(const char *catalogPath) {
+    catalog = malloc(MAX_FLEET * sizeof(AircraftData));
+    initialStates = malloc(MAX_FLEET * sizeof(AircraftState));
+    states = malloc(MAX_FLEET * sizeof(AircraftState));
+    physicsData = malloc(MAX_FLEET * sizeof(PhysicsData));
+    schedules = malloc(MAX_FLEET * sizeof(ControlSchedule));
+    if (catalog == NULL || initialStates == NULL || states == NULL || physicsData == NULL || schedules == NULL) {
+        printf("Failed to allocate %d aircraft.\n", MAX_FLEET);
+        return 0;
+    }
+
+    airframeCount = loadAircraftCatalog(catalogPath, catalog, MAX_FLEET);
+    if (airframeCount == 0) {
+        printf("No aircraft in %s, run the benchmark from the build folder.\n", catalogPath);
+        return 0;
+    }
+
+    // One compiled model per airframe, shared by every aircraft flying it
+    models = malloc((size_t)airframeCount * sizeof(CompiledAircraftModel));
+    if (models == NULL) {
+        printf("Failed to allocate %d compiled aircraft.\n", airframeCount);
+        return 0;
+    }
+    for (int i = 0; i < airframeCount; i++) {
+        if (!compileAircraftModel(&catalog[i], &models[i])) {
+            printf("Failed to compile %s.\n", catalog[i].name);
+            return 0;
+        }
+    }
+
+    // Aircraft i flies airframe i % airframeCount, spread around the player like the synthetic traffic
+    for (int i = 0; i < MAX_FLEET; i++) {
+        AircraftState *aircraft = &initialStates[i];
+        const AircraftData *data = &catalog[i % airframeCount];
+
+        initAircraft(aircraft, &catalog[i % airframeCount]);
+        aircraft->hasAfterburner = (data->afterburnerThrust != 0);
+        aircraft->turbulenceSlot = i;
+
+        schedules[i].kind = (ScheduleKind)(i % SCHEDULES);
+        schedules[i].heading = randomFloat(0.0f, 2.0f * PI);
+        schedules[i].phase = randomFloat(0.0f, 60.0f);
+
+        float speed = randomFloat(180.0f, 260.0f);
+        aircraft->x = randomFloat(-40000.0f, 40000.0f);
+        aircraft->y = randomFloat(2000.0f, 9000.0f);
+        aircraft->z = randomFloat(-40000.0f, 40000.0f);
+        aircraft->vx = speed * cosf(schedules[i].heading);
+        aircraft->vy = 0.0f;
+        aircraft->vz = speed * sinf(schedules[i].heading);
+
+        applySchedule(aircraft, &schedules[i], 0.0f);
+        initEngineState(&aircraft->engine, aircraft->controls.throttle);
+    }
+
+    return 1;
+}
+
+static void freeFleet(void) {
+    free(catalog);
+    free(models);
+    free(initialStates);
+    free(states);
+    free(physicsData);
+    free(schedules);
+}
+
+// Steps aircraft [first, last) by one tick
+static void stepAircraft(int first, int last, float time) {
+    for (int i = first; i < last; i++) {
+        AircraftState *aircraft = &states[i];
+        if (aircraft->y <= 0.0f) {
+            continue; // crashed, the simulation thread stops there too
+        }
+
+        applySchedule(aircraft, &schedules[i], time);
+        updateAircraftPhysics(&physicsData[i], aircraft, DELTA_TIME, time, &models[i % airframeCount]);
+        updateAircraftState(aircraft, DELTA_TIME);
+    }
+}
+
+/* ##### THREADS ##### */
+
+typedef struct {
+    int first, last;    // chunk of the fleet
+    SDL_sem *start;     // posted once per tick
+    SDL_Thread *thread;
+} Worker;
+
+static Worker workers[MAX_THREADS];
+static SDL_sem *chunksDone = NULL;
+static SDL_atomic_t quitWorkers;
+static float tickTime; // written before the workers are started, read after
+
+static int workerFunction(void *data) {
+    Worker *worker = data;
+
+    while (1) {
+        SDL_SemWait(worker->start);
+        if (SDL_AtomicGet(&quitWorkers)) {
+            break;
+        }
+
+        stepAircraft(worker->first, worker->last, tickTime);
+        SDL_SemPost(chunksDone);
+    }
+
+    return 0;
+}
+
+static void stopWorkers(int threads) {
+    SDL_AtomicSet(&quitWorkers, 1);
+    for (int t = 1; t < threads; t++) {
+        if (workers[t].thread != NULL) {
+            SDL_SemPost(workers[t].start);
+            SDL_WaitThread(workers[t].thread, NULL);
+            workers[t].thread = NULL;
+        }
+        if (workers[t].start != NULL) {
+            SDL_DestroySemaphore(workers[t].start);
+            workers[t].start = NULL;
+        }
+    }
+
+    if (chunksDone != NULL) {
+        SDL_DestroySemaphore(chunksDone);
+        chunksDone = NULL;
+    }
+}
+
+// Splits the fleet into `threads` chunks, the calling thread takes the first one
+static int startWorkers(int fleetSize, int threads) {
+    SDL_AtomicSet(&quitWorkers, 0);
+
+    for (int t = 0; t < threads; t++) {
+        workers[t].first = (int)((long)fleetSize * t / threads);
+        workers[t].last = (int)((long)fleetSize * (t + 1) / threads);
+        workers[t].start = NULL;
+        workers[t].thread = NULL;
+    }
+    if (threads == 1) {
+        return 1;
+    }
+
+    chunksDone = SDL_CreateSemaphore(0);
+    if (chunksDone == NULL) {
+        printf("Failed to create a semaphore: %s\n", SDL_GetError());
+        return 0;
+    }
+    for (int t = 1; t < threads; t++) {
+        workers[t].start = SDL_CreateSemaphore(0);
+        workers[t].thread = (workers[t].start != NULL) ? SDL_CreateThread(workerFunction, "fleet", &workers[t]) : NULL;
+        if (workers[t].thread == NULL) {
+            printf("Failed to start thread %d: %s\n", t, SDL_GetError());
+            stopWorkers(threads);
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/* ##### MEASUREMENT ##### */
+
+typedef struct {
+    int fleetSize;
+    int threads;
+    int ticks;
+    double wallSeconds;
+    double simSecondsPerSecond;
+    double nsPerAircraftTick;
+    double efficiency;
+    double bytesPerAircraft;
+    int crashed;
+} Result;
+
+// Flies the fleet for `ticks` ticks, returns the wall time in microseconds or -1
+static long runFleet(int fleetSize, int threads, int ticks, int *crashed) {
+    // Same start for every run: the initial states, fresh physics data, turbulence and weather
+    memcpy(states, initialStates, (size_t)fleetSize * sizeof(AircraftState));
+    memset(physicsData, 0, (size_t)fleetSize * sizeof(PhysicsData));
+    simulationTime = 0.0f;
+    if (!initWeather(fleetSize, TURBULENCE_LIGHT)) {
+        return -1;
+    }
+    if (!startWorkers(fleetSize, threads)) {
+        freeWeather();
+        return -1;
+    }
+
+    long start = getTimeMicroseconds();
+    for (int tick = 0; tick < ticks; tick++) {
+        simulationTime += DELTA_TIME;
+        updateWeather(simulationTime, states[0].x, states[0].z); // once per tick, around the first aircraft
+
+        tickTime = simulationTime;
+        for (int t = 1; t < threads; t++) {
+            SDL_SemPost(workers[t].start);
+        }
+        stepAircraft(workers[0].first, workers[0].last, simulationTime);
+        for (int t = 1; t < threads; t++) {
+            SDL_SemWait(chunksDone);
+        }
+    }
+    long elapsed = getTimeMicroseconds() - start;
+
+    stopWorkers(threads);
+    freeWeather();
+
+    *crashed = 0;
+    for (int i = 0; i < fleetSize; i++) {
+        *crashed += (states[i].y <= 0.0f);
+    }
+    return elapsed;
+}
+
+static double bytesPerAircraft(int fleetSize) {
+    // state, physics data and the turbulence slot (u, v, w and the noise generator)
+    double perAircraft = (double)(sizeof(AircraftState) + sizeof(PhysicsData) + 3 * sizeof(float) + sizeof(uint32_t));
+
+    // the airframes it uses, shared with the rest of the fleet
+    int airframes = (fleetSize < airframeCount) ? fleetSize : airframeCount;
+    double shared = (double)airframes * (double)(sizeof(CompiledAircraftModel) + sizeof(AircraftData));
+
+    return perAircraft + shared / (double)fleetSize;
+}
+
+static int writeResults(const char *path, const char *catalogPath, int maxThreads, const Result *results, int count) {
+    FILE *file = fopen(path, "w");
+    if (file == NULL) {
+        printf("Failed to write %s\n", path);
+        return 0;
+    }
+
+    fprintf(file, "{\n  \"benchmark\": \"scaling\",\n  \"catalog\": \"%s\",\n  \"airframes\": %d,\n", catalogPath, airframeCount);
+    fprintf(file, "  \"maxThreads\": %d,\n  \"deltaTime\": %.6f,\n  \"results\": [\n", maxThreads, (double)DELTA_TIME);
+
+    for (int i = 0; i < count; i++) {
+        const Result *result = &results[i];
+        fprintf(file, "    {\"aircraft\": %d, \"threads\": %d, \"ticks\": %d, \"wallSeconds\": %.4f, \"simSecondsPerSecond\": %.2f, "
+                      "\"nsPerAircraftTick\": %.1f, \"efficiency\": %.3f, \"bytesPerAircraft\": %.0f, \"crashed\": %d}%s\n",
+                result->fleetSize, result->threads, result->ticks, result->wallSeconds, result->simSecondsPerSecond,
+                result->nsPerAircraftTick, result->efficiency, result->bytesPerAircraft, result->crashed, (i == count - 1) ? "" : ",");
+    }
+
+    fprintf(file, "  ]\n}\n");
+    fclose(file);
+    return 1;
+}
+
+int main(int argc, char *argv[]) {
+    const char *catalogPath = DEFAULT_CATALOG;
+    const char *outputPath = DEFAULT_OUTPUT;
+    int maxThreads = SDL_GetCPUCount();
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--catalog") == 0 && i + 1 < argc) {
+            catalogPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            maxThreads = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            outputPath = argv[++i];
+        }
+        else {
+            printf("Usage: %s [--catalog file] [--threads n] [--out file.json]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (maxThreads < 1) {
+        maxThreads = 1;
+    }
+    if (maxThreads > MAX_THREADS) {
+        maxThreads = MAX_THREADS;
+    }
+
+    if (!loadFleet(catalogPath)) {
+        freeFleet();
+        return 1;
+    }
+
+    static Result results[FLEET_SIZES * THREAD_STEPS];
+    int resultCount = 0;
+
+    printf("%d airframes from %s, up to %d threads\n\n", airframeCount, catalogPath, maxThreads);
+    printf("%8s %7s %7s %12s %16s %11s %14s %8s\n", "aircraft", "threads", "ticks", "sim s/wall s", "ns/aircraft-tick", "efficiency", "bytes/aircraft", "crashed");
+
+    for (int f = 0; f < FLEET_SIZES; f++) {
+        const int fleetSize = fleetSizes[f];
+        long ticks = WORK_PER_RUN / fleetSize;
+        ticks = (ticks < MIN_TICKS) ? MIN_TICKS : (ticks > MAX_TICKS) ? MAX_TICKS : ticks;
+
+        double singleThread = 0.0; // simulated seconds per wall second on one thread
+        int previousThreads = 0;
+        for (int c = 0; c < THREAD_STEPS; c++) {
+            // clamped to the maximum (so it's always measured) and to one aircraft per thread
+            int threads = (threadSteps[c] < maxThreads) ? threadSteps[c] : maxThreads;
+            threads = (threads < fleetSize) ? threads : fleetSize;
+            if (threads == previousThreads) {
+                continue;
+            }
+            previousThreads = threads;
+
+            Result *result = &results[resultCount];
+            long best = -1;
+            for (int r = 0; r < REPEATS; r++) {
+                long elapsed = runFleet(fleetSize, threads, (int)ticks, &result->crashed);
+                if (elapsed < 0) {
+                    freeFleet();
+                    return 1;
+                }
+                if (best < 0 || elapsed < best) best = elapsed;
+            }
+            if (best < 1) {
+                best = 1;
+            }
+
+            result->fleetSize = fleetSize;
+            result->threads = threads;
+            result->ticks = (int)ticks;
+            result->wallSeconds = (double)best / 1000000.0;
+            result->simSecondsPerSecond = (double)ticks * (double)DELTA_TIME / result->wallSeconds;
+            result->nsPerAircraftTick = (double)best * 1000.0 / ((double)ticks * (double)fleetSize);
+            if (threads == 1) {
+                singleThread = result->simSecondsPerSecond;
+            }
+            result->efficiency = (singleThread > 0.0) ? result->simSecondsPerSecond / ((double)threads * singleThread) : 0.0;
+            result->bytesPerAircraft = bytesPerAircraft(fleetSize);
+
+            printf("%8d %7d %7d %12.1f %16.1f %10.0f%% %14.0f %8d\n", fleetSize, threads, result->ticks, result->simSecondsPerSecond,
+                   result->nsPerAircraftTick, 100.0 * result->efficiency, result->bytesPerAircraft, result->crashed);
+            resultCount++;
+        }
+    }
+
+    int written = writeResults(outputPath, catalogPath, maxThreads, results, resultCount);
+    if (written) {
+        printf("\nWrote %s\n", outputPath);
+    }
+
+    freeFleet();
+    return written ? 0 : 1;
+}
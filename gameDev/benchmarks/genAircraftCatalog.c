@@ -0,0 +1,116 @@
+/**
+ * @file genAircraftCatalog.c
+ * @brief Writes a synthetic aircraft catalog in the format of data/aircraftData.txt.
+ *
+ * Every synthetic airframe is one of the real ones varied within plausible limits:
+ * - scaled in size (wing span and area with the length, mass, fuel and thrust with the volume),
+ * - thrust-to-weight, drag, speeds, ceiling, sweep and the transonic constants jittered by a few percent.
+ *
+ * So thousands of distinct airframes (each with its own compiled model) can be simulated, e.g. with
+ * bench_scaling --catalog.
+ *
+ * Usage: ./build/gen_aircraft_catalog [count] [output] [seed]
+ */
+
+// Include header files
+#include "aircraftData.h"
+#include "menu.h"
+
+// Include standard libraries
+#include <stdio.h>
+#include <stdlib.h>
+
+#define FILE_PATH "data/aircraftData.txt" // The real airframes the synthetic ones are based on
+#define DEFAULT_OUTPUT "data/syntheticAircraftData.txt"
+#define DEFAULT_COUNT 1000
+#define MAX_COUNT 99999 // Five digit suffix
+#define DEFAULT_SEED 0x51A7C0DEu
+
+static unsigned int randomState = DEFAULT_SEED;
+
+// Uniform in [min, max), xorshift32
+static float randomFloat(float min, float max) {
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+
+    return min + (max - min) * (float)(randomState >> 8) / 16777216.0f;
+}
+
+static void varyAircraft(const AircraftData *base, AircraftData *synthetic) {
+    *synthetic = *base;
+
+    const float length = randomFloat(0.85f, 1.2f); // size relative to the base airframe
+    const float volume = length * length * length;
+    const float thrustToWeight = randomFloat(0.85f, 1.15f);
+
+    synthetic->mass = base->mass * volume;
+    synthetic->wingArea = base->wingArea * length * length;
+    synthetic->wingSpan = base->wingSpan * length * randomFloat(0.95f, 1.05f); // aspect ratio +-10%
+    synthetic->sweepAngle = base->sweepAngle + randomFloat(-5.0f, 5.0f);
+    synthetic->thrust = (int)((float)base->thrust * volume * thrustToWeight);
+    synthetic->afterburnerThrust = (int)((float)base->afterburnerThrust * volume * thrustToWeight);
+    synthetic->maxSpeed = base->maxSpeed * randomFloat(0.9f, 1.1f);
+    synthetic->stallSpeed = base->stallSpeed * randomFloat(0.9f, 1.1f);
+    synthetic->serviceCeiling = base->serviceCeiling + (int)randomFloat(-1.0f, 2.0f); // km in the file
+    synthetic->fuelCapacity = (int)((float)base->fuelCapacity * volume);
+    synthetic->cd0 = base->cd0 * randomFloat(0.85f, 1.15f);
+    synthetic->maxAoA = base->maxAoA * randomFloat(0.9f, 1.1f);
+    synthetic->fuelBurn = base->fuelBurn * volume * thrustToWeight;
+    synthetic->afterburnerFuelBurn = base->afterburnerFuelBurn * volume * thrustToWeight;
+    synthetic->alpha = base->alpha * randomFloat(0.8f, 1.2f);
+    synthetic->kw = base->kw * randomFloat(0.8f, 1.2f);
+    synthetic->Md = base->Md + randomFloat(-0.03f, 0.03f);
+    if (synthetic->Md > 0.99f) {
+        synthetic->Md = 0.99f;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    int count = (argc > 1) ? atoi(argv[1]) : DEFAULT_COUNT;
+    const char *outputPath = (argc > 2) ? argv[2] : DEFAULT_OUTPUT;
+    if (argc > 3) {
+        randomState = (unsigned int)strtoul(argv[3], NULL, 0);
+    }
+    if (count <= 0 || count > MAX_COUNT) {
+        count = DEFAULT_COUNT;
+    }
+    if (randomState == 0) {
+        randomState = DEFAULT_SEED; // xorshift never leaves 0
+    }
+
+    AircraftData bases[MAX_AIRCRAFT];
+    int baseCount = loadAircraftCatalog(FILE_PATH, bases, MAX_AIRCRAFT);
+    if (baseCount == 0) {
+        printf("No aircraft in %s, run the generator from the build folder.\n", FILE_PATH);
+        return 1;
+    }
+
+    FILE *file = fopen(outputPath, "w");
+    if (file == NULL) {
+        printf("Failed to write %s\n", outputPath);
+        return 1;
+    }
+
+    // Same header and columns as the real data file
+    fprintf(file, "# name|empty_mass_kg|wing_area_m2|wing_span_m|sweep_angle_deg|thrust_n|thrust_ab_n|max_speed_kph|stall_speed_kph|service_ceiling_km|fuel_capacity_kg|Cd0|max_aoa_deg|fuel_burn_kgps|fuel_burn_ab_kgps|alpha|kw|md\n");
+
+    for (int i = 0; i < count; i++) {
+        const AircraftData *base = &bases[i % baseCount];
+        AircraftData synthetic;
+        varyAircraft(base, &synthetic);
+
+        // base name (up to 12 characters) and a number, fits MAX_NAME_LENGTH
+        fprintf(file, "%.12s-%05d|%.0f|%.2f|%.2f|%.0f|%d|%d|%.0f|%.0f|%d|%d|%.4f|%.1f|%.3f|%.3f|%.3f|%.2f|%.3f\n",
+                base->name, i, (double)synthetic.mass, (double)synthetic.wingArea, (double)synthetic.wingSpan,
+                (double)synthetic.sweepAngle, synthetic.thrust, synthetic.afterburnerThrust, (double)synthetic.maxSpeed,
+                (double)synthetic.stallSpeed, synthetic.serviceCeiling, synthetic.fuelCapacity, (double)synthetic.cd0,
+                (double)synthetic.maxAoA, (double)synthetic.fuelBurn, (double)synthetic.afterburnerFuelBurn,
+                (double)synthetic.alpha, (double)synthetic.kw, (double)synthetic.Md);
+    }
+
+    fclose(file);
+    printf("Wrote %d aircraft based on the %d in %s to %s\n", count, baseCount, FILE_PATH, outputPath);
+
+    return 0;
+}
@@ -18,6 +18,7 @@
 #include "aircraftData.h"
 #include "physics.h"
 #include "weather.h"
+#include "simulation.h"
 
 /*
     #########################################################
@@ -51,11 +52,16 @@ void calculateFlightParameters(AircraftState *aircraft, AircraftData *aircraftDa
 
 /**
  * @brief Initialize the text renderer.
+ *
+ * Without a GPU (SDL only offers its software renderer) the HUD is drawn by the CPU rasterizer
+ * (rasterizer.h). The environment variable HUD_RENDERER=cpu or HUD_RENDERER=sdl forces either backend.
  */
 void initTextRenderer(void);
 
 /**
- * @brief Render text on the screen.
+ * @brief Add a line of text to this frame's HUD.
+ *
+ * The text is drawn at the end of renderFlightInfo(), and only if it changed since the last frame.
  *
  * @param text The text to render.
  * @param x The x-coordinate of the text.
@@ -71,6 +77,11 @@ void renderText(const char *text, int x, int y, SDL_Color color);
  */
 void toggleModes(SDL_Event event);
 
+/**
+ * @brief Redraw the whole HUD on the next frame (window exposed, render targets lost, ...).
+ */
+void invalidateHUD(void);
+
 /**
  * @brief Destroy the text renderer and free resources.
  */
@@ -144,18 +155,28 @@ void drawNeedle(SDL_Renderer *localRenderer, int cx, int cy, int radius, float v
  */
 void machCounter(SDL_Renderer* localRenderer, int cx, int cy);
 
+/**
+ * @brief Throw away the cached gauge backgrounds, they're drawn again on the next frame.
+ *
+ * Call when the renderer loses its render targets (SDL_RENDER_TARGETS_RESET, SDL_RENDER_DEVICE_RESET).
+ */
+void invalidateGaugeLayers(void);
+
 /**
  * @brief Render the speed gauge.
  *
+ * The circle, ticks and numbers are drawn once into a texture and reused while the radius and
+ * maximum speed stay the same, every frame only the needle and the Mach number are drawn on top.
+ *
  * @param renderer The SDL renderer.
- * @param localFont The font to use for rendering text.
+ * @param localFont The font to use for rendering text (handle from loadFont()).
  * @param cx The x-coordinate of the gauge center.
  * @param cy The y-coordinate of the gauge center.
  * @param radius The radius of the gauge.
  * @param speed The current speed.
  * @param maxSpeed The maximum speed.
  */
-void renderSpeedGauge(SDL_Renderer* renderer, TTF_Font* localFont, int cx, int cy, int radius, float speed, float maxSpeed);
+void renderSpeedGauge(SDL_Renderer* renderer, int localFont, int cx, int cy, int radius, float speed, float maxSpeed);
 
 /*
     #########################################################
@@ -196,15 +217,17 @@ void renderHalfCircle(SDL_Renderer *localRenderer, int cx, int cy, int radius);
 /**
  * @brief Render the fuel gauge.
  *
+ * Like the speed gauge, only the needle and the fuel amount are drawn every frame.
+ *
  * @param localRenderer The SDL renderer.
- * @param localFont The font to use for rendering text.
+ * @param localFont The font to use for rendering text (handle from loadFont()).
  * @param cx The x-coordinate of the gauge center.
  * @param cy The y-coordinate of the gauge center.
  * @param radius The radius of the gauge.
  * @param fuel The current fuel level.
  * @param maxFuel The maximum fuel level.
  */
-void renderFuelGauge(SDL_Renderer* localRenderer, TTF_Font* localFont, int cx, int cy, int radius, float fuel, float maxFuel);
+void renderFuelGauge(SDL_Renderer* localRenderer, int localFont, int cx, int cy, int radius, float fuel, float maxFuel);
 
 /*
     #########################################################
@@ -217,11 +240,20 @@ void renderFuelGauge(SDL_Renderer* localRenderer, TTF_Font* localFont, int cx, i
 /**
  * @brief Render flight information on the screen.
  *
- * @param aircraft Pointer to the aircraft state.
+ * The HUD is a widget tree (hudWidgets.h) built on the first call. Every line reads its value at its own
+ * rate (FPS at 2 Hz, position at 10 Hz, ...) and is only formatted again when the value changes at the
+ * precision it's shown with.
+ *
+ * Every line and gauge is hashed by what it shows. Only the regions whose content changed since the
+ * last frame are redrawn (into a texture, or the rasterizer's framebuffer, that keeps the last frame), and if nothing changed the frame
+ * isn't cleared or presented at all.
+ *
+ * Only the snapshot is read (copied at the start of the call), never the live simulation state.
+ *
+ * @param snapshot The newest simulation snapshot.
  * @param aircraftData Pointer to the aircraft data.
  * @param fps The current frames per second.
- * @param simulationTime The current simulation time.
 */
-void renderFlightInfo(AircraftState *aircraft, AircraftData *aircraftData, float fps, float simulationTime);
+void renderFlightInfo(const SimulationSnapshot *snapshot, const AircraftData *aircraftData, float fps);
 
 #endif // TWOD_RENDERER_H
\ No newline at end of file
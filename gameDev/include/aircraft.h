@@ -9,6 +9,7 @@
 // Include controls.h for the aircraft controls structure
 #include "controls.h"
 #include "aircraftData.h"
+#include "engine.h"
 
 // Include stdbool for AircraftState boolean value
 #include <stdbool.h>
@@ -59,6 +60,12 @@ typedef struct AircraftControls AircraftControls;
  * @var AircraftState::hasAfterburner
  * Indicates if the aircraft has an afterburner.
  * 
+ * @var AircraftState::engine
+ * Engine spool and afterburner state.
+ * 
+ * @var AircraftState::turbulenceSlot
+ * Slot of the aircraft in the turbulence state (globalTurbulence).
+ * 
  * @var AircraftState::controls
  * Control inputs for the aircraft.
  */
@@ -85,6 +92,12 @@ typedef struct AircraftState {
     float thrust; // N
     bool hasAfterburner;
 
+    // Engine spool/afterburner (thrust lags the throttle)
+    EngineState engine;
+
+    // Slot in the turbulence filter state
+    int turbulenceSlot;
+
     // Fuel level (updated as fuel burns) (in kg)
     float fuel;
 
@@ -88,4 +88,16 @@ typedef struct {
  */
 void getAircraftDataByName(const char *filename, const char *aircraftName, AircraftData *aircraftData);
 
+/**
+ * @brief Loads every aircraft of a data file.
+ *
+ * Reads the file once, in file order, so it's also fast for catalogs with thousands of aircraft.
+ *
+ * @param filename The name of the file containing the aircraft data.
+ * @param aircraftData Array filled with the aircraft.
+ * @param maxAircraft Size of the array, further aircraft are ignored.
+ * @return The number of aircraft loaded, 0 if the file couldn't be read.
+ */
+int loadAircraftCatalog(const char *filename, AircraftData aircraftData[], int maxAircraft);
+
 #endif // AIRCRAFT_DATA_H
\ No newline at end of file
@@ -0,0 +1,63 @@
+/**
+ * @file aircraftModel.h
+ * @brief Per-aircraft constants derived once from AircraftData.
+ *
+ * Everything in here depends only on the airframe, so it is computed a single
+ * time after the aircraft is loaded instead of on every physics tick.
+ */
+
+#ifndef AIRCRAFT_MODEL_H
+#define AIRCRAFT_MODEL_H
+
+#include "aircraftData.h"
+
+/**
+ * @struct CompiledAircraftModel
+ * @brief Derived airframe constants in the order the force kernels read them.
+ *
+ * Fields are grouped by the kernel that consumes them (mass, lift, drag, engine, fuel),
+ * so a single tick walks the structure front to back.
+ */
+typedef struct CompiledAircraftModel {
+    // Mass (lift coefficient, computeAcceleration, updateVelocity)
+    float mass;                 ///< Empty mass in kg
+    float invMass;              ///< 1 / mass
+    float weight;               ///< mass * GRAVITY in N
+
+    // Wing (lift, induced drag)
+    float wingArea;             ///< Wing area in m^2
+    float aspectRatio;          ///< wingSpan^2 / wingArea
+    float inducedDragFactor;    ///< 1 / (PI * AR * OEF)
+
+    // Drag (drag coefficient, drag divergence)
+    float maxSpeedMs;           ///< Maximum speed in m/s
+    float invMaxSpeedMsSquared; ///< 1 / maxSpeedMs^2
+    float alpha;                ///< Transonic drag rise constant
+    float kw;                   ///< Supersonic wave drag constant
+    float Md;                   ///< Drag divergence Mach number
+
+    // Engine (thrust)
+    float dryThrust;            ///< Military thrust in N
+    float wetThrust;            ///< Afterburner thrust in N
+    float invSeaLevelDensity;   ///< 1 / sea level air density, the thrust derate divisor
+
+    // Fuel (fuel burn, mass update)
+    float fuelBurn;             ///< Fuel burn at 100% throttle in kg/s
+    float afterburnerFuelBurn;  ///< Fuel burn with afterburner in kg/s
+    float fuelCapacity;         ///< Fuel capacity in kg
+
+    const AircraftData *source; ///< The data this model was compiled from (name, display values)
+} CompiledAircraftModel;
+
+/**
+ * @brief Compile the derived constants for an aircraft.
+ *
+ * Call once after getAircraftDataByName(). The AircraftData must outlive the model.
+ *
+ * @param data Pointer to the loaded AircraftData structure.
+ * @param model Pointer to the CompiledAircraftModel to fill.
+ * @return 1 on success, 0 if the data can't produce a valid model (NULL pointers, zero mass or wing area).
+ */
+int compileAircraftModel(const AircraftData *data, CompiledAircraftModel *model);
+
+#endif // AIRCRAFT_MODEL_H
@@ -0,0 +1,46 @@
+/**
+ * @file attitudeIndicator.h
+ * @brief Attitude indicator (artificial horizon): sky/ground split, pitch ladder, bank scale and aircraft symbol.
+ *
+ * All of it is built once as triangles around the middle of the gauge. Every frame the vertices are only
+ * rotated by the roll and moved by the pitch with one 2x2 matrix (SSE2, two vertices per instruction):
+ * the horizon and the ladder are moved by the pitch and rotated, the bank scale is only rotated, the bank
+ * pointer and the aircraft symbol stay where they are. That's one sine and one cosine per frame, however many
+ * tick marks there are. Everything is one SDL_RenderGeometry() call clipped to the gauge's rectangle.
+ */
+
+#ifndef ATTITUDE_INDICATOR_H
+#define ATTITUDE_INDICATOR_H
+
+// Include necessary libraries
+#include <SDL2/SDL.h>
+
+/**
+ * @def ATTITUDE_PIXELS_PER_DEGREE
+ * @brief Pitch ladder scale.
+ */
+#define ATTITUDE_PIXELS_PER_DEGREE 2.0f
+
+/**
+ * @brief Build the geometry for a gauge of a given size.
+ *
+ * @param size Width and height of the gauge in pixels.
+ * @return 1 on success, 0 on failure (nothing is drawn then).
+ */
+int initAttitudeIndicator(int size);
+
+/**
+ * @brief Drop the geometry (nothing is drawn until the next initAttitudeIndicator()).
+ */
+void destroyAttitudeIndicator(void);
+
+/**
+ * @brief Record the attitude indicator into the render batch (background layer).
+ *
+ * @param area The gauge's rectangle on screen, nothing is drawn outside it.
+ * @param pitch Pitch in degrees, nose up is positive.
+ * @param roll Roll in degrees, right wing down is positive.
+ */
+void drawAttitudeIndicator(const SDL_Rect *area, float pitch, float roll);
+
+#endif // ATTITUDE_INDICATOR_H
@@ -0,0 +1,107 @@
+/**
+ * @file capture.h
+ * @brief Asynchronous capture of the presented HUD frames to a video file.
+ *
+ * captureFrame() reads the frame back into a buffer from a fixed pool and queues it, a writer thread
+ * converts and writes it. The render thread never waits for the disk: if no buffer is free (or the
+ * queue is full) the frame is dropped and the previous one is written again in its place, so the
+ * video keeps its timing. Frames the HUD didn't redraw (nothing changed) are queued as repeats
+ * without reading anything back.
+ *
+ * Formats:
+ * - CAPTURE_Y4M: YUV4MPEG2, 4:4:4, BT.601 limited range, plays in ffplay/mpv/VLC.
+ * - CAPTURE_RAW_RGB: headerless RGB24 frames, width * height * 3 bytes each.
+ * - CAPTURE_RLE: lossless, for visual regression. A 16 byte header ("HCAP", then width, height and
+ *   frame rate as little endian uint32), then per frame a uint32 payload size and the payload: the
+ *   frame XOR the previous one (RGB24, the first frame XOR black), as packets of one control byte c
+ *   followed by either one pixel repeated (c & 0x7F) + 1 times (c & 0x80) or c + 1 literal pixels.
+ */
+
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+// Include necessary libraries
+#include <SDL2/SDL.h>
+
+/**
+ * @def CAPTURE_POOL_FRAMES
+ * @brief Frame buffers read back into, frames waiting for the writer included.
+ */
+#define CAPTURE_POOL_FRAMES 6
+
+/**
+ * @def CAPTURE_QUEUE_LENGTH
+ * @brief Maximum number of queued frames and repeats.
+ */
+#define CAPTURE_QUEUE_LENGTH 32
+
+/**
+ * @enum CaptureFormat
+ * @brief Output file format.
+ */
+typedef enum {
+    CAPTURE_Y4M,        ///< YUV4MPEG2 4:4:4
+    CAPTURE_RAW_RGB,    ///< Headerless RGB24
+    CAPTURE_RLE         ///< Lossless XOR delta + run length encoding
+} CaptureFormat;
+
+/**
+ * @struct CaptureStats
+ * @brief Statistics of the current (or last) capture.
+ */
+typedef struct {
+    int captured;               ///< Frames read back
+    int repeated;               ///< Frames written again because nothing changed
+    int dropped;                ///< Frames lost because the writer was behind
+    int written;                ///< Frames written to the file
+    int queueDepth;             ///< Frames waiting for the writer
+    int maxQueueDepth;          ///< Most frames ever waiting
+    double bytesWritten;        ///< Size of the file so far
+    float averageCaptureMs;     ///< Average render thread time per captured frame
+    float maxCaptureMs;         ///< Worst render thread time for a captured frame
+} CaptureStats;
+
+/**
+ * @brief Start capturing to a file.
+ *
+ * @param path The output file.
+ * @param format The file format.
+ * @param width Width of the frames (the renderer's output size).
+ * @param height Height of the frames.
+ * @param frameRate Frames per second written into the file header.
+ * @return 1 on success, 0 on failure.
+ */
+int startCapture(const char *path, CaptureFormat format, int width, int height, int frameRate);
+
+/**
+ * @brief Write the queued frames, stop the writer thread and close the file.
+ */
+void stopCapture(void);
+
+/**
+ * @brief Check if a capture is running.
+ *
+ * @return 1 if capturing, 0 otherwise.
+ */
+int isCapturing(void);
+
+/**
+ * @brief Read back the frame about to be presented and queue it (render thread, before SDL_RenderPresent()).
+ *
+ * @param renderer The SDL renderer.
+ */
+void captureFrame(SDL_Renderer *renderer);
+
+/**
+ * @brief Queue a repeat of the last frame, for frames that weren't redrawn.
+ */
+void captureRepeatFrame(void);
+
+/**
+ * @brief Get the statistics of the current (or last) capture.
+ *
+ * @return The CaptureStats.
+ */
+CaptureStats getCaptureStats(void);
+
+#endif // CAPTURE_H
@@ -0,0 +1,52 @@
+/**
+ * @file engine.h
+ * @brief Engine spool dynamics.
+ *
+ * The engine doesn't respond to the throttle instantly: the core spools up/down with a
+ * first-order lag and the afterburner lights after a short delay. The thrust and fuel flow
+ * for the resulting spool and afterburner level come from calculateThrust().
+ */
+
+#ifndef ENGINE_H
+#define ENGINE_H
+
+// Include stdbool for EngineState boolean value
+#include <stdbool.h>
+
+// Spool dynamics
+#define ENGINE_SPOOL_UP_TIME 1.5f // s, time constant when the core accelerates
+#define ENGINE_SPOOL_DOWN_TIME 1.0f // s, time constant when the core decelerates
+#define AFTERBURNER_MIN_SPOOL 0.95f // core has to be at least this spooled up for the afterburner to light
+#define AFTERBURNER_LIGHT_OFF_DELAY 0.4f // s, from request to ignition
+#define AFTERBURNER_RAMP_TIME 0.3f // s, time constant of the nozzle/fuel ramp, in once lit and out once cut
+
+/**
+ * @struct EngineState
+ * @brief Per-aircraft engine state integrated every tick.
+ */
+typedef struct EngineState {
+    float spool;            ///< Core spool, 0 (off) to 1 (military power)
+    float afterburnerTimer; ///< Time since the afterburner was requested with the core spooled up (s)
+    float afterburner;      ///< Afterburner level, 0 (off) to 1 (full)
+    bool afterburnerLit;    ///< True once the light-off delay has passed, false as soon as the afterburner is cut
+} EngineState;
+
+/**
+ * @brief Initialize the engine state, already spooled to the given throttle.
+ *
+ * @param engine Pointer to the EngineState structure.
+ * @param throttle The throttle the engine starts at (0.00 - 1.01).
+ */
+void initEngineState(EngineState *engine, float throttle);
+
+/**
+ * @brief Advance the spool and afterburner towards the commanded throttle.
+ *
+ * @param engine Pointer to the EngineState structure.
+ * @param throttle The throttle control (0.00 - 1.01), anything above 1.0 requests the afterburner.
+ * @param hasAfterburner Whether the aircraft has an afterburner at all.
+ * @param deltaTime The time step in seconds.
+ */
+void updateEngineState(EngineState *engine, float throttle, bool hasAfterburner, float deltaTime);
+
+#endif // ENGINE_H
@@ -0,0 +1,81 @@
+/**
+ * @file fontManager.h
+ * @brief Font manager and batched text drawing.
+ *
+ * Every (font file, size) pair is opened once and gets its own glyph atlas. drawText() only queues
+ * textured quads, flushText() hands everything queued to the render batch (renderBatch.h) on its
+ * text layer, one geometry command per font, so text is drawn on top of everything else.
+ *
+ * Glyphs missing from an atlas are rendered by worker threads (glyphWorkers.h, HUD_TEXT_WORKERS=<n>
+ * sets how many, 0 renders them on the main thread). Text is laid out right away, the missing glyphs
+ * are left out until uploadGlyphs() has copied them into their atlas, usually on the next frame.
+ */
+
+#ifndef FONT_MANAGER_H
+#define FONT_MANAGER_H
+
+// Include necessary libraries
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+/**
+ * @def MAX_FONTS
+ * @brief Maximum number of (font file, size) pairs.
+ */
+#define MAX_FONTS 8
+
+/**
+ * @brief Initialize the font manager.
+ *
+ * @param renderer The SDL renderer text is drawn with.
+ */
+void initFontManager(SDL_Renderer *renderer);
+
+/**
+ * @brief Close all fonts and destroy their atlases.
+ */
+void destroyFontManager(void);
+
+/**
+ * @brief Open a font, or get the one already opened with the same file and size.
+ *
+ * @param path Path to the font file.
+ * @param size Point size.
+ * @return Font handle, -1 if the font can't be opened.
+ */
+int loadFont(const char *path, int size);
+
+/**
+ * @brief Queue text for drawing, (x, y) is the top left corner.
+ *
+ * @param font Font handle from loadFont().
+ * @param text UTF-8 text.
+ * @param x The x-coordinate of the text.
+ * @param y The y-coordinate of the text.
+ * @param color The color of the text.
+ */
+void drawText(int font, const char *text, int x, int y, SDL_Color color);
+
+/**
+ * @brief Measure text the way drawText() lays it out.
+ *
+ * @param font Font handle from loadFont().
+ * @param text UTF-8 text.
+ * @param width Pointer to the width in pixels (can be NULL).
+ * @param height Pointer to the height in pixels (can be NULL).
+ */
+void measureText(int font, const char *text, int *width, int *height);
+
+/**
+ * @brief Copy the glyphs the workers finished into their atlases, call once per frame before drawing text.
+ *
+ * @return Number of glyphs uploaded, text drawn since they were requested lacks them and has to be drawn again.
+ */
+int uploadGlyphs(void);
+
+/**
+ * @brief Hand all queued text to the render batch, call before submitting it.
+ */
+void flushText(void);
+
+#endif // FONT_MANAGER_H
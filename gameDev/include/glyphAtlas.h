@@ -0,0 +1,97 @@
+/**
+ * @file glyphAtlas.h
+ * @brief Glyph cache: every glyph of a font is rasterized once, on first use, into one shared texture.
+ *
+ * Glyphs are packed into the texture row by row (shelf packing) and rasterized in white,
+ * the text colour comes from the vertex colours when the glyphs are drawn. A copy of the atlas is
+ * kept in memory for the CPU rasterizer (rasterizer.h). An atlas with a worker font hands the
+ * rendering to the glyph workers (glyphWorkers.h) and gets the glyph back through uploadAtlasGlyph().
+ */
+
+#ifndef GLYPH_ATLAS_H
+#define GLYPH_ATLAS_H
+
+// Include necessary libraries
+#include <stdint.h>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+/**
+ * @def GLYPH_ATLAS_CODEPOINTS
+ * @brief Number of cached codepoints (ASCII and Latin-1), anything above is drawn as '?'.
+ */
+#define GLYPH_ATLAS_CODEPOINTS 256
+
+/**
+ * @struct Glyph
+ * @brief Position of a glyph in the atlas and its metrics.
+ */
+typedef struct {
+    float u0, v0, u1, v1;   ///< Texture coordinates in the atlas
+    int width, height;      ///< Size of the glyph's cell in pixels, 0 if there is nothing to draw
+    int offsetX;            ///< Horizontal offset of the cell from the pen position
+    int advance;            ///< Distance to the next pen position
+    int state;              ///< 0 not rasterized yet, 1 cached, 2 with a worker (only advances until it's uploaded), -1 failed (missing glyph or atlas full)
+} Glyph;
+
+/**
+ * @struct GlyphAtlas
+ * @brief The atlas texture and the glyphs cached in it.
+ */
+typedef struct GlyphAtlas {
+    SDL_Texture *texture;                   ///< Atlas texture (ARGB8888, alpha blended)
+    Uint32 *pixels;                         ///< Copy of the texture's pixels, width * height
+    int width, height;                      ///< Size of the texture in pixels
+    int shelfX, shelfY;                     ///< Where the next glyph goes
+    int shelfHeight;                        ///< Height of the current row
+    int workerFont;                         ///< Font the glyph workers render with, -1 to render on the calling thread
+    Glyph glyphs[GLYPH_ATLAS_CODEPOINTS];   ///< Cached glyphs by codepoint
+} GlyphAtlas;
+
+/**
+ * @brief Create an empty atlas.
+ *
+ * @param atlas Pointer to the GlyphAtlas structure.
+ * @param renderer The SDL renderer the atlas texture is created for.
+ * @param width Width of the atlas texture in pixels.
+ * @param height Height of the atlas texture in pixels.
+ * @return 1 on success, 0 on failure.
+ */
+int initGlyphAtlas(GlyphAtlas *atlas, SDL_Renderer *renderer, int width, int height);
+
+/**
+ * @brief Destroy the atlas texture and free its copy.
+ *
+ * @param atlas Pointer to the GlyphAtlas structure.
+ */
+void freeGlyphAtlas(GlyphAtlas *atlas);
+
+/**
+ * @brief Get a glyph, rasterizing it into the atlas (or queueing it for the workers) if it isn't cached yet.
+ *
+ * @param atlas Pointer to the GlyphAtlas structure.
+ * @param font The font the atlas belongs to.
+ * @param codepoint Unicode codepoint of the glyph.
+ * @return Pointer to the Glyph (width 0 if it can't be drawn, or not yet).
+ */
+const Glyph *getAtlasGlyph(GlyphAtlas *atlas, TTF_Font *font, uint32_t codepoint);
+
+/**
+ * @brief Copy a glyph rendered by a glyph worker into the atlas.
+ *
+ * @param atlas Pointer to the GlyphAtlas structure.
+ * @param codepoint Unicode codepoint of the glyph.
+ * @param surface The glyph from renderGlyph() (freed here), NULL if it failed.
+ */
+void uploadAtlasGlyph(GlyphAtlas *atlas, uint32_t codepoint, SDL_Surface *surface);
+
+/**
+ * @brief Render a glyph in white, safe on any thread as long as the font isn't used by another one.
+ *
+ * @param font The font.
+ * @param codepoint Unicode codepoint of the glyph.
+ * @return ARGB8888 surface, NULL on failure.
+ */
+SDL_Surface *renderGlyph(TTF_Font *font, uint32_t codepoint);
+
+#endif // GLYPH_ATLAS_H
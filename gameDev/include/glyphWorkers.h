@@ -0,0 +1,91 @@
+/**
+ * @file glyphWorkers.h
+ * @brief Worker threads rasterizing glyphs off the main thread.
+ *
+ * A glyph atlas that misses a glyph queues it instead of calling SDL_ttf itself, a worker renders it
+ * into a surface and the main thread only copies finished surfaces into the atlas (fontManager.h,
+ * uploadGlyphs()). Text drawn before that simply lacks the glyph for a frame, nothing ever waits.
+ * SDL_ttf fonts can't be shared between threads, so every worker renders with its own handle of every
+ * font (openWorkerFont()), the main thread keeps using its handle for metrics and kerning only.
+ * Fonts are opened and closed on the main thread only (FreeType wants that serialized).
+ */
+
+#ifndef GLYPH_WORKERS_H
+#define GLYPH_WORKERS_H
+
+// Include necessary libraries
+#include <stdint.h>
+#include <SDL2/SDL.h>
+
+/**
+ * @def MAX_GLYPH_WORKERS
+ * @brief Maximum number of worker threads.
+ */
+#define MAX_GLYPH_WORKERS 4
+
+/**
+ * @def MAX_WORKER_FONTS
+ * @brief Maximum number of fonts every worker has a handle of.
+ */
+#define MAX_WORKER_FONTS 8
+
+/**
+ * @def GLYPH_QUEUE_LENGTH
+ * @brief Glyphs that can be requested and not taken back yet (a power of two).
+ */
+#define GLYPH_QUEUE_LENGTH 1024
+
+struct GlyphAtlas;
+
+/**
+ * @struct GlyphJob
+ * @brief A requested glyph and, once finished, its pixels.
+ */
+typedef struct {
+    struct GlyphAtlas *atlas;   ///< Atlas the glyph goes into
+    int font;                   ///< Worker font from openWorkerFont()
+    uint32_t codepoint;         ///< Unicode codepoint
+    SDL_Surface *surface;       ///< ARGB8888 glyph in white, NULL if it couldn't be rendered
+} GlyphJob;
+
+/**
+ * @brief Start the worker threads.
+ *
+ * @param count Number of workers (at most MAX_GLYPH_WORKERS), 0 starts none.
+ * @return Number of workers running.
+ */
+int startGlyphWorkers(int count);
+
+/**
+ * @brief Stop the workers, drop the glyphs not taken yet and close the worker fonts.
+ */
+void stopGlyphWorkers(void);
+
+/**
+ * @brief Open a font once for every worker.
+ *
+ * @param path Path to the font file.
+ * @param size Point size.
+ * @return Worker font, -1 if there are no workers or the font can't be opened (glyphs are rasterized by the caller then).
+ */
+int openWorkerFont(const char *path, int size);
+
+/**
+ * @brief Queue a glyph for the workers.
+ *
+ * @param atlas Atlas the glyph goes into.
+ * @param font Worker font from openWorkerFont().
+ * @param codepoint Unicode codepoint.
+ * @return 1 if it was queued, 0 if the queue is full.
+ */
+int requestGlyph(struct GlyphAtlas *atlas, int font, uint32_t codepoint);
+
+/**
+ * @brief Take a finished glyph, the caller owns its surface.
+ *
+ * @param job Pointer to the GlyphJob filled in.
+ * @return 1 if a glyph was taken, 0 if none is finished.
+ */
+int takeFinishedGlyph(GlyphJob *job);
+
+#endif // GLYPH_WORKERS_H
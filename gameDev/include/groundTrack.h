@@ -0,0 +1,156 @@
+/**
+ * @file groundTrack.h
+ * @brief Ground track of the aircraft (x/z), stored for the whole session and simplified for the map.
+ *
+ * Points are appended to fixed-size chunks, a chunk is never changed once it's full (sealed). When a chunk
+ * is sealed it's simplified with Douglas-Peucker at two tolerances, and every TRACK_GROUP sealed chunks are
+ * merged into a node of the next tier, simplified again at two coarser tolerances (and so on up to
+ * TRACK_TIERS tiers). Every tolerance is four times the one before, the map picks the coarsest one that is
+ * still below a pixel.
+ *
+ * Every node keeps the bounding box of its points: drawing starts at the top tier and only descends into
+ * nodes inside the view, so the work depends on what is visible at the chosen resolution, not on the length
+ * of the session. Only the raw points grow with the session (8 bytes per point), the simplified versions
+ * are a fraction of that.
+ */
+
+#ifndef GROUND_TRACK_H
+#define GROUND_TRACK_H
+
+/**
+ * @def TRACK_CHUNK_POINTS
+ * @brief Points per chunk (17 s at 60 ticks per second).
+ */
+#define TRACK_CHUNK_POINTS 1024
+
+/**
+ * @def TRACK_GROUP
+ * @brief Nodes of one tier merged into a node of the next one.
+ */
+#define TRACK_GROUP 16
+
+/**
+ * @def TRACK_TIERS
+ * @brief Tiers: chunks, groups of chunks, groups of groups.
+ */
+#define TRACK_TIERS 3
+
+/**
+ * @def TRACK_LEVELS_PER_TIER
+ * @brief Simplified versions kept per node.
+ */
+#define TRACK_LEVELS_PER_TIER 2
+
+/**
+ * @def TRACK_LEVELS
+ * @brief Simplified versions in total, level 0 is the finest.
+ */
+#define TRACK_LEVELS (TRACK_TIERS * TRACK_LEVELS_PER_TIER)
+
+/**
+ * @def TRACK_BASE_TOLERANCE
+ * @brief Douglas-Peucker tolerance of level 0 in m, every level multiplies it by 4 (2 m to 2 km).
+ */
+#define TRACK_BASE_TOLERANCE 2.0f
+
+/**
+ * @struct TrackPoint
+ * @brief A point of the track on the ground.
+ */
+typedef struct {
+    float x;    ///< x position in m
+    float z;    ///< z position in m
+} TrackPoint;
+
+/**
+ * @struct TrackNode
+ * @brief A sealed chunk or a group of nodes: bounding box and simplified versions.
+ */
+typedef struct {
+    float minX, maxX;                               ///< Bounding box
+    float minZ, maxZ;
+    TrackPoint *points;                             ///< The simplified versions back to back
+    int levelStart[TRACK_LEVELS_PER_TIER];          ///< First point of every version
+    int levelCount[TRACK_LEVELS_PER_TIER];          ///< Points of every version
+} TrackNode;
+
+/**
+ * @struct GroundTrack
+ * @brief The chunks and the nodes of all tiers.
+ */
+typedef struct {
+    TrackPoint **chunks;                ///< Raw points, TRACK_CHUNK_POINTS per chunk, the last one is open
+    int chunkCount;                     ///< Chunks allocated
+    int chunkCapacity;                  ///< Room in the chunk list
+    int openCount;                      ///< Points in the open chunk
+    unsigned pointCount;                ///< Points appended so far
+
+    TrackNode *nodes[TRACK_TIERS];      ///< Nodes of every tier, node i of tier 0 is chunk i
+    int nodeCount[TRACK_TIERS];         ///< Nodes per tier
+    int nodeCapacity[TRACK_TIERS];      ///< Room per tier
+} GroundTrack;
+
+/**
+ * @struct TrackView
+ * @brief The part of the ground shown and how big a pixel is.
+ */
+typedef struct {
+    float minX, maxX;       ///< Visible area in m
+    float minZ, maxZ;
+    float pixelSize;        ///< Size of a pixel in m, picks the resolution
+} TrackView;
+
+/**
+ * @brief Called for every run of points to draw, a run continues where the previous one ended unless a node
+ * in between was outside the view.
+ *
+ * @param points The points.
+ * @param count Number of points.
+ * @param user The user pointer given to forEachVisibleTrackRun().
+ */
+typedef void (*TrackRunFunction)(const TrackPoint *points, int count, void *user);
+
+/**
+ * @brief Start an empty track.
+ *
+ * @param track Pointer to the GroundTrack.
+ */
+void initGroundTrack(GroundTrack *track);
+
+/**
+ * @brief Free all chunks and nodes.
+ *
+ * @param track Pointer to the GroundTrack.
+ */
+void freeGroundTrack(GroundTrack *track);
+
+/**
+ * @brief Append a point, seals and simplifies the chunk when it's full.
+ *
+ * @param track Pointer to the GroundTrack.
+ * @param x The x position in m.
+ * @param z The z position in m.
+ * @return 1 on success, 0 if memory ran out (the point is lost).
+ */
+int appendGroundTrack(GroundTrack *track, float x, float z);
+
+/**
+ * @brief Get the Douglas-Peucker tolerance of a level.
+ *
+ * @param level The level, 0 to TRACK_LEVELS - 1.
+ * @return The tolerance in m.
+ */
+float getTrackTolerance(int level);
+
+/**
+ * @brief Visit the runs of points inside the view at the coarsest resolution below a pixel, oldest first.
+ *
+ * @param track Pointer to the GroundTrack.
+ * @param view The view.
+ * @param visit The function to call.
+ * @param user Passed to the function.
+ * @return Number of points visited.
+ */
+int forEachVisibleTrackRun(const GroundTrack *track, const TrackView *view, TrackRunFunction visit, void *user);
+
+#endif // GROUND_TRACK_H
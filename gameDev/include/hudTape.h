@@ -0,0 +1,113 @@
+/**
+ * @file hudTape.h
+ * @brief Scrolling HUD tapes (airspeed, altitude, heading) drawn from pre-rendered strip textures.
+ *
+ * A tape's ticks and numbers over its whole range are rendered once, when it's created, into a strip split
+ * into tiles of at most TAPE_TILE_LENGTH pixels along the tape (one static texture each, registered with the
+ * CPU rasterizer). Drawing a tape only records the tiles' visible windows as textured quads: the quads stay
+ * on whole screen pixels and the texture coordinates are shifted by the fraction of a pixel, so the tape
+ * scrolls smoothly with linear filtering. No text is rendered while flying, the value box is up to the caller.
+ */
+
+#ifndef HUD_TAPE_H
+#define HUD_TAPE_H
+
+// Include necessary libraries
+#include <stddef.h>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+
+/**
+ * @def TAPE_TILE_LENGTH
+ * @brief Longest tile along the tape in pixels (well below every renderer's texture size limit).
+ */
+#define TAPE_TILE_LENGTH 1024
+
+/**
+ * @def MAX_TAPE_TILES
+ * @brief Most tiles per tape.
+ */
+#define MAX_TAPE_TILES 8
+
+/**
+ * @def TAPE_PADDING
+ * @brief Empty pixels before the lowest and after the highest value (room for their numbers), not on circular tapes.
+ */
+#define TAPE_PADDING 10
+
+/**
+ * @brief Formats the number of a major tick.
+ *
+ * @param text The text buffer.
+ * @param size Size of the buffer.
+ * @param value The value of the tick.
+ */
+typedef void (*TapeLabelFunction)(char *text, size_t size, float value);
+
+/**
+ * @struct TapeScale
+ * @brief What a tape shows and what it looks like.
+ */
+typedef struct {
+    float minimum;                  ///< Lowest value
+    float maximum;                  ///< Highest value (on circular tapes the same place as the lowest)
+    float pixelsPerUnit;            ///< Pixels along the tape per unit of the value
+    float minorStep;                ///< Value between ticks
+    float majorStep;                ///< Value between numbered ticks, a multiple of minorStep
+    int thickness;                  ///< Size across the tape in pixels
+    int horizontal;                 ///< 1 for a horizontal tape (values grow to the right), 0 for vertical (values grow upwards)
+    int circular;                   ///< 1 if the tape wraps around (heading)
+    int ticksAtEnd;                 ///< 1 for ticks on the right or bottom edge, 0 for the left or top one
+    SDL_Color color;                ///< Ticks and numbers
+    TapeLabelFunction label;        ///< Number format, NULL for the value without decimals
+} TapeScale;
+
+/**
+ * @struct HudTape
+ * @brief A tape's tiles.
+ */
+typedef struct {
+    TapeScale scale;                        ///< What it shows
+    int length;                             ///< Length of the whole strip in pixels
+    int tileCount;                          ///< Tiles, 0 if the tape couldn't be created
+    SDL_Texture *tiles[MAX_TAPE_TILES];     ///< The strip, TAPE_TILE_LENGTH pixels per tile along the tape
+    Uint32 *tilePixels[MAX_TAPE_TILES];     ///< Copy of every tile for the CPU rasterizer
+} HudTape;
+
+/**
+ * @brief Render a tape's strip into its tiles.
+ *
+ * @param tape Pointer to the HudTape.
+ * @param renderer The SDL renderer.
+ * @param font The font of the numbers.
+ * @param scale What the tape shows.
+ * @return 1 on success, 0 on failure (the tape draws nothing then).
+ */
+int createHudTape(HudTape *tape, SDL_Renderer *renderer, TTF_Font *font, const TapeScale *scale);
+
+/**
+ * @brief Destroy a tape's tiles.
+ *
+ * @param tape Pointer to the HudTape.
+ */
+void freeHudTape(HudTape *tape);
+
+/**
+ * @brief Get where a value is along the strip.
+ *
+ * @param tape Pointer to the HudTape.
+ * @param value The value (clamped to the range, wrapped on circular tapes).
+ * @return Position along the strip in pixels.
+ */
+float getHudTapePosition(const HudTape *tape, float value);
+
+/**
+ * @brief Record the window of the tape centred on a value into the render batch (background layer).
+ *
+ * @param tape Pointer to the HudTape.
+ * @param area The tape's rectangle on screen.
+ * @param value The value in the middle.
+ */
+void drawHudTape(const HudTape *tape, const SDL_Rect *area, float value);
+
+#endif // HUD_TAPE_H
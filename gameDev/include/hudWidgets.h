@@ -0,0 +1,244 @@
+/**
+ * @file hudWidgets.h
+ * @brief Retained widget tree for the HUD.
+ *
+ * The HUD is built once as a tree of panels, labels and gauges. Every label is bound to a value source
+ * and is formatted with a fixed number of decimals, its text is only formatted again when the value
+ * crosses a display-precision boundary (so 101.234 -> 101.236 does nothing for a label showing 2
+ * decimals). Every widget has its own update interval, slow changing or noisy values (FPS, position)
+ * are read less often than the frame rate. Layout is computed once, and again only when a panel is
+ * shown or hidden.
+ */
+
+#ifndef HUD_WIDGETS_H
+#define HUD_WIDGETS_H
+
+// Include necessary libraries
+#include <stddef.h>
+#include <SDL2/SDL.h>
+
+/**
+ * @def MAX_WIDGETS
+ * @brief Maximum number of widgets.
+ */
+#define MAX_WIDGETS 96
+
+/**
+ * @def MAX_WIDGET_TEXT
+ * @brief Size of a label's text buffer.
+ */
+#define MAX_WIDGET_TEXT 96
+
+/**
+ * @enum WidgetType
+ * @brief What a widget is.
+ */
+typedef enum {
+    WIDGET_PANEL,   ///< Holds other widgets, stacks them vertically or leaves them where they are
+    WIDGET_SPACER,  ///< Empty space in a stacked panel
+    WIDGET_LABEL,   ///< One line of text
+    WIDGET_GAUGE,   ///< A gauge or bar, drawn by the owner of the tree
+    WIDGET_CHART    ///< A strip chart, drawn by the owner of the tree from its own data
+} WidgetType;
+
+/**
+ * @brief Value source of a label or gauge.
+ *
+ * @param context The context pointer given when the widget was created.
+ * @return The current value.
+ */
+typedef float (*WidgetValueFunction)(const void *context);
+
+/**
+ * @brief Custom formatting of a label (text that isn't just a number).
+ *
+ * Only called when the value changed at the label's display precision, so everything the text depends
+ * on has to be in the value.
+ *
+ * @param text The label's text buffer.
+ * @param size Size of the buffer.
+ * @param value The new value.
+ * @param color The label's color, can be changed.
+ */
+typedef void (*WidgetFormatFunction)(char *text, size_t size, float value, SDL_Color *color);
+
+/**
+ * @brief Measures a label's text, called only when the text changed.
+ *
+ * @param text The text.
+ * @param width Pointer to the width in pixels.
+ * @param height Pointer to the height in pixels.
+ */
+typedef void (*WidgetMeasureFunction)(const char *text, int *width, int *height);
+
+/**
+ * @struct Widget
+ * @brief One node of the widget tree.
+ */
+typedef struct Widget {
+    WidgetType type;                ///< What the widget is
+    int visible;                    ///< 0 if the widget (and everything under it) is hidden
+    int x, y;                       ///< Screen position (set by the layout in stacked panels)
+    int width, height;              ///< Size, the height is what the widget takes up in a stacked panel
+
+    struct Widget *parent;          ///< Parent panel, NULL for the root
+    struct Widget *firstChild;      ///< Panels only
+    struct Widget *lastChild;       ///< Panels only
+    struct Widget *nextSibling;     ///< Next widget in the same panel
+
+    int stacked;                    ///< Panels: 1 to stack the children vertically
+    int spacing;                    ///< Panels: height of a line in a stacked panel
+
+    WidgetValueFunction value;      ///< Labels and gauges: value source (NULL for fixed text)
+    WidgetValueFunction maxValue;   ///< Gauges: value source of the maximum
+    const void *context;            ///< Passed to the value sources
+    Uint32 interval;                ///< Milliseconds between updates, 0 for every frame
+    Uint64 nextUpdate;              ///< When the value is read again
+
+    const char *prefix;             ///< Labels: text in front of the value
+    const char *suffix;             ///< Labels: text after the value
+    int decimals;                   ///< Labels: decimals shown, the display precision
+    WidgetFormatFunction format;    ///< Labels: custom formatting (NULL for prefix, value, suffix)
+    long long shownValue;           ///< Labels: the value at display precision the text was formatted with
+    int formatted;                  ///< Labels: 0 until the text was formatted the first time
+    char text[MAX_WIDGET_TEXT];     ///< Labels: the text
+    SDL_Color color;                ///< Labels: text color
+    unsigned revision;              ///< Labels: incremented every time the text or color changes, charts: every update
+
+    int style;                      ///< Gauges and charts: which one, up to the owner of the tree
+    int radius;                     ///< Gauges: radius
+    float current;                  ///< Gauges: last value read
+    float maximum;                  ///< Gauges: last maximum read
+} Widget;
+
+/**
+ * @brief Set how label text is measured (the font is up to whoever draws the tree).
+ *
+ * @param measure The measuring function, NULL to leave the size of labels at 0.
+ */
+void setWidgetMeasure(WidgetMeasureFunction measure);
+
+/**
+ * @brief Create a panel.
+ *
+ * @param parent The parent panel, NULL for a root.
+ * @param x The x-coordinate (ignored if the parent is stacked).
+ * @param y The y-coordinate (ignored if the parent is stacked).
+ * @param stacked 1 to stack the children vertically, 0 to leave them at their own positions.
+ * @param spacing Height of a label in a stacked panel.
+ * @return The panel, NULL if there are too many widgets.
+ */
+Widget *createPanel(Widget *parent, int x, int y, int stacked, int spacing);
+
+/**
+ * @brief Create empty space in a stacked panel.
+ *
+ * @param parent The parent panel.
+ * @param height Height of the space.
+ * @return The spacer, NULL if there are too many widgets.
+ */
+Widget *createSpacer(Widget *parent, int height);
+
+/**
+ * @brief Create a label showing prefix, value and suffix, e.g. "TAS: " 1234.57 " km/h".
+ *
+ * @param parent The parent panel.
+ * @param prefix Text in front of the value (not copied, has to outlive the widget).
+ * @param value Value source, NULL for a label that only shows the prefix.
+ * @param context Passed to the value source.
+ * @param decimals Decimals shown.
+ * @param suffix Text after the value (not copied, can be NULL).
+ * @param interval Milliseconds between updates, 0 for every frame.
+ * @param color The text color.
+ * @return The label, NULL if there are too many widgets.
+ */
+Widget *createLabel(Widget *parent, const char *prefix, WidgetValueFunction value, const void *context, int decimals, const char *suffix, Uint32 interval, SDL_Color color);
+
+/**
+ * @brief Format a label with a function instead of prefix, value and suffix.
+ *
+ * @param label The label.
+ * @param format The formatting function.
+ */
+void setLabelFormat(Widget *label, WidgetFormatFunction format);
+
+/**
+ * @brief Create a gauge, what it looks like is up to whoever draws the tree.
+ *
+ * @param parent The parent panel.
+ * @param style Which gauge.
+ * @param x The x-coordinate (ignored if the parent is stacked).
+ * @param y The y-coordinate (ignored if the parent is stacked).
+ * @param radius Radius of the gauge.
+ * @param value Value source.
+ * @param maxValue Value source of the maximum (can be NULL).
+ * @param context Passed to the value sources.
+ * @param interval Milliseconds between updates, 0 for every frame.
+ * @return The gauge, NULL if there are too many widgets.
+ */
+Widget *createGauge(Widget *parent, int style, int x, int y, int radius, WidgetValueFunction value, WidgetValueFunction maxValue, const void *context, Uint32 interval);
+
+/**
+ * @brief Create a chart, the data and what it looks like are up to whoever draws the tree.
+ *
+ * The tree doesn't read anything for a chart, its revision is incremented at every update instead so the
+ * owner knows when to draw it again.
+ *
+ * @param parent The parent panel.
+ * @param style Which chart.
+ * @param x The x-coordinate (ignored if the parent is stacked).
+ * @param y The y-coordinate (ignored if the parent is stacked).
+ * @param width Width of the chart.
+ * @param height Height the chart takes up (in a stacked panel too).
+ * @param interval Milliseconds between updates, 0 for every frame.
+ * @return The chart, NULL if there are too many widgets.
+ */
+Widget *createChart(Widget *parent, int style, int x, int y, int width, int height, Uint32 interval);
+
+/**
+ * @brief Show or hide a widget, the layout is computed again on the next update if it changed.
+ *
+ * @param widget The widget.
+ * @param visible 1 to show, 0 to hide.
+ */
+void setWidgetVisible(Widget *widget, int visible);
+
+/**
+ * @brief Read labels and gauges at most this often, whatever their own interval (quality governor).
+ *
+ * @param labelInterval Shortest interval of a label in milliseconds, 0 for no limit.
+ * @param gaugeInterval Shortest interval of a gauge or chart in milliseconds, 0 for no limit.
+ */
+void setWidgetRateLimits(Uint32 labelInterval, Uint32 gaugeInterval);
+
+/**
+ * @brief Read the values that are due and format the labels whose value changed.
+ *
+ * @param root The root of the tree.
+ * @param now The current time in milliseconds (SDL_GetTicks64()).
+ */
+void updateWidgets(Widget *root, Uint64 now);
+
+/**
+ * @brief Called for every visible label, gauge and chart by forEachVisibleWidget().
+ *
+ * @param widget The widget.
+ * @param user The user pointer given to forEachVisibleWidget().
+ */
+typedef void (*WidgetVisitFunction)(const Widget *widget, void *user);
+
+/**
+ * @brief Visit all visible labels, gauges and charts, in the order they were created.
+ *
+ * @param root The root of the tree.
+ * @param visit The function to call.
+ * @param user Passed to the function.
+ */
+void forEachVisibleWidget(const Widget *root, WidgetVisitFunction visit, void *user);
+
+/**
+ * @brief Destroy all widgets.
+ */
+void destroyWidgets(void);
+
+#endif // HUD_WIDGETS_H
@@ -5,12 +5,14 @@
 #define PI 3.14159265358979323846f
 #define C_D0 0.02f // estimation of the zero lift drag for a jet fighter
 #define OEF 0.8f // Oswald Efficiency Factor (~0.8 for a jet)
+#define SEA_LEVEL_AIR_DENSITY 1.225f // kg/m^3
 
 extern const int PHYSICS_DEBUG;
 
 #include "aircraftData.h"
 #include "controls.h"
 #include "aircraft.h"
+#include "aircraftModel.h"
 
 /**
  * @file physics.h
@@ -77,6 +79,7 @@ typedef struct {
 
     // Aircraft state data
     float thrust;
+    float fuelFlow; // kg/s, computed together with the thrust
     float trueAirspeed; // TAS
     float machNumber;
     float angleOfAttack;
@@ -101,15 +104,20 @@ typedef struct {
     float lastSimulationTime;
 } PhysicsData;
 
-extern PhysicsData globalPhysicsData;
-extern float maxFuelKgs;
-
 /**
- * @brief Fill constants for the aircraft.
- * 
- * @param data Pointer to the AircraftData structure.
+ * @brief Velocity integrators of updatePhysics().
+ *
+ * All of them take the first stage from the current state, every further stage is one more
+ * computeAcceleration() on a temporary copy of the aircraft.
  */
-void fillConstants(AircraftData *data);
+typedef enum PhysicsIntegrator {
+    INTEGRATOR_RK4 = 0,     ///< Classic Runge-Kutta, 4 stages (default)
+    INTEGRATOR_HEUN,        ///< Heun's method (RK2), 2 stages
+    INTEGRATOR_EULER        ///< Explicit Euler, 1 stage
+} PhysicsIntegrator;
+
+extern PhysicsData globalPhysicsData;
+extern float maxFuelKgs;
 
 /*
     #########################################################
@@ -302,12 +310,12 @@ float calculateAspectRatio(float wingspan, float wingArea);
  * @brief Calculate the drag coefficient for the aircraft.
  * 
  * @param speed The speed of the aircraft in m/s.
- * @param maxSpeed The maximum speed of the aircraft in m/s.
  * @param C_d0 The zero-lift drag coefficient.
+ * @param model Pointer to the CompiledAircraftModel (max speed, alpha, kw, Md).
  * @param physicsData Pointer to the PhysicsData structure.
  * @return The drag coefficient.
  */
-float calculateDragCoefficient(float speed, float maxSpeed, float C_d0, PhysicsData *physicsData);
+float calculateDragCoefficient(float speed, float C_d0, const CompiledAircraftModel *model, PhysicsData *physicsData);
 
 /**
  * @brief Calculate the parasitic drag for the aircraft.
@@ -324,22 +332,23 @@ float calculateParasiticDrag(float C_d, float airDensity, float speed, float win
  * @brief Calculate the induced drag for the aircraft.
  * 
  * @param liftCoefficient The lift coefficient.
- * @param aspectRatio The aspect ratio of the wings.
+ * @param inducedDragFactor 1 / (PI * AR * OEF), precomputed in the CompiledAircraftModel.
  * @param airDensity The air density in kg/m^3.
  * @param wingArea The wing area of the aircraft in m^2.
  * @param speed The speed of the aircraft in m/s.
  * @return The induced drag in Newtons.
  */
-float calculateInducedDrag(float liftCoefficient, float aspectRatio, float airDensity, float wingArea, float speed);
+float calculateInducedDrag(float liftCoefficient, float inducedDragFactor, float airDensity, float wingArea, float speed);
 
 /**
  * @brief Calculate the drag divergence around Mach for the aircraft.
  * 
  * @param speed The relative speed of the aircraft in m/s.
+ * @param model Pointer to the CompiledAircraftModel (kw, Md).
  * @param physicsData Pointer to the PhysicsData structure.
  * @return The drag divergence around Mach.
  */
-float calculateDragDivergenceAroundMach(float speed, PhysicsData *physicsData);
+float calculateDragDivergenceAroundMach(float speed, const CompiledAircraftModel *model, PhysicsData *physicsData);
 
 /**
  * @brief Calculate the total drag for the aircraft.
@@ -364,15 +373,17 @@ float calculateTotalDrag(float *parasiticDrag, float *inducedDrag, float *waveDr
 */
 
 /**
- * @brief Calculate the thrust for the aircraft.
+ * @brief Calculate the thrust for the aircraft at its engine spool and afterburner level.
+ *
+ * The fuel flow for that thrust (TSFC * thrust, blended with the afterburner) is stored in
+ * physicsData->fuelFlow, so thrust and fuel burn always come from the same calculation.
  * 
- * @param thrust The thrust value.
- * @param afterburnerThrust The afterburner thrust value.
- * @param percentControl The throttle control percentage.
- * @param physicsData Pointer to the PhysicsData structure.
+ * @param model Pointer to the CompiledAircraftModel (thrusts, fuel burns, derate divisor).
+ * @param engine Pointer to the EngineState (spool and afterburner).
+ * @param physicsData Pointer to the PhysicsData structure (air density and Mach number in, fuel flow out).
  * @return The thrust in Newtons.
  */
-float calculateThrust(int thrust, int afterburnerThrust, int percentControl, PhysicsData *physicsData);
+float calculateThrust(const CompiledAircraftModel *model, const EngineState *engine, PhysicsData *physicsData);
 
 /*
     #########################################################
@@ -403,10 +414,10 @@ Vector3 getDirectionVector(Orientation newOrientation);
  * 
  * @param aircraft Pointer to the AircraftState structure.
  * @param deltaTime The time step in seconds.
- * @param data Pointer to the AircraftData structure.
+ * @param model Pointer to the CompiledAircraftModel structure.
  * @param physicsData Pointer to the PhysicsData structure.
  */
-void updateVelocity(AircraftState *aircraft, float deltaTime, AircraftData *data, PhysicsData *physicsData);
+void updateVelocity(AircraftState *aircraft, float deltaTime, const CompiledAircraftModel *model, PhysicsData *physicsData);
 
 /*
     #########################################################
@@ -538,12 +549,13 @@ float interpolate(float lowerAlt, float upperAlt, float lowerDensity, float uppe
 
 /**
  * @brief Get the current fuel consumption rate for the aircraft.
+ *
+ * Computed together with the thrust (see calculateThrust()).
  * 
- * @param data Pointer to the AircraftData structure.
- * @param throttle The throttle control (0.00 - 1.01)
+ * @param physicsData Pointer to the PhysicsData structure.
  * @returns The fuel consumption rate in kg/s.
  */
-float getFuelBurnRate(AircraftData *data, float throttle);
+float getFuelBurnRate(PhysicsData *physicsData);
 
 /**
  * @brief Update the fuel level for the aircraft.
@@ -558,11 +570,11 @@ void updateFuelLevel(float *fuelKg, float deltaTime, float fuelBurnRate);
  * @brief Update the mass of the aircraft.
  * 
  * @param aircraft Pointer to the AircraftState structure.
- * @param data Pointer to the AircraftData structure.
+ * @param model Pointer to the CompiledAircraftModel structure.
  * @param fuelBurnRate The fuel burn rate in kg/s.
  * @param deltaTime The time step in seconds.
  */
-void updateAircraftMass(AircraftState *aircraft, AircraftData *data, float fuelBurnRate, float deltaTime);
+void updateAircraftMass(AircraftState *aircraft, const CompiledAircraftModel *model, float fuelBurnRate, float deltaTime);
 
 /*
     #########################################################
@@ -572,18 +584,27 @@ void updateAircraftMass(AircraftState *aircraft, AircraftData *data, float fuelB
     #########################################################
 */
 
-void updatePhysicsData(PhysicsData *physics, float altitude, AircraftState *aircraft, AircraftData *data, float simulationTime);
+/**
+ * @brief Fill the PhysicsData cache for the current frame.
+ *
+ * @param physics Pointer to the PhysicsData structure to fill.
+ * @param altitude The altitude of the aircraft in meters.
+ * @param aircraft Pointer to the AircraftState structure.
+ * @param model Pointer to the CompiledAircraftModel structure.
+ * @param simulationTime The current time in the simulation.
+ */
+void updatePhysicsData(PhysicsData *physics, float altitude, AircraftState *aircraft, const CompiledAircraftModel *model, float simulationTime);
 
 /**
  * @brief Computes the acceleration of the aircraft based on its current velocity and state.
  *
  * @param velocity The current velocity of the aircraft.
  * @param aircraft A pointer to the current state of the aircraft.
- * @param aircraftData A pointer to the data specific to the aircraft model.
+ * @param model A pointer to the compiled aircraft model.
  * @param physicsData A pointer to the physics data structure.
  * @return The computed acceleration as a Vector3.
  */
-Vector3 computeAcceleration(Vector3 velocity, AircraftState *aircraft, AircraftData *aircraftData, PhysicsData *physicsData);
+Vector3 computeAcceleration(Vector3 velocity, AircraftState *aircraft, const CompiledAircraftModel *model, PhysicsData *physicsData);
 
 /**
  * @brief Updates the physics state of the aircraft.
@@ -591,7 +612,37 @@ Vector3 computeAcceleration(Vector3 velocity, AircraftState *aircraft, AircraftD
  * @param aircraft A pointer to the current state of the aircraft.
  * @param deltaTime The time step for the update.
  * @param simulationTime The current time in the simulation.
- * @param aircraftData A pointer to the data specific to the aircraft model.
+ * @param model A pointer to the compiled aircraft model.
+ */
+void updatePhysics(AircraftState *aircraft, float deltaTime, float simulationTime, const CompiledAircraftModel *model);
+
+/**
+ * @brief Updates the physics state of one aircraft with its own physics data.
+ *
+ * updatePhysics() with the PhysicsData of this aircraft instead of globalPhysicsData, so several aircraft can be
+ * stepped in the same frame, also on different threads as long as each has its own aircraft and physics data.
+ *
+ * @param physics A pointer to the physics data of this aircraft.
+ * @param aircraft A pointer to the current state of the aircraft.
+ * @param deltaTime The time step for the update.
+ * @param simulationTime The current time in the simulation.
+ * @param model A pointer to the compiled aircraft model.
+ */
+void updateAircraftPhysics(PhysicsData *physics, AircraftState *aircraft, float deltaTime, float simulationTime, const CompiledAircraftModel *model);
+
+/**
+ * @brief Selects the velocity integrator of updatePhysics() and updateAircraftPhysics().
+ *
+ * Not synchronised, set it before the simulation (or any thread stepping aircraft) starts.
+ *
+ * @param integrator The integrator to use.
+ */
+void setPhysicsIntegrator(PhysicsIntegrator integrator);
+
+/**
+ * @brief Returns the velocity integrator of updatePhysics().
+ *
+ * @return The integrator in use, INTEGRATOR_RK4 unless changed with setPhysicsIntegrator().
  */
-void updatePhysics(AircraftState *aircraft, float deltaTime, float simulationTime, AircraftData *aircraftData);
+PhysicsIntegrator getPhysicsIntegrator(void);
 #endif // PHYSICS_H
\ No newline at end of file
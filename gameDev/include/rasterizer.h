@@ -0,0 +1,141 @@
+/**
+ * @file rasterizer.h
+ * @brief CPU rasterizer for the HUD, for machines without a GPU.
+ *
+ * SDL's own software renderer pays a lot per point and per line. When the rasterizer is active the
+ * render batch (renderBatch.h) draws into a framebuffer in memory instead: span fills (SSE2 where
+ * available), Bresenham lines and alpha blended glyph quads. The framebuffer keeps the last frame,
+ * only the regions the HUD redrew are uploaded into one streaming texture, which is then copied to
+ * the screen with a single SDL call per frame.
+ *
+ * Drawing follows SDL's rules: points, lines and rectangles overwrite the pixels (SDL_BLENDMODE_NONE),
+ * textured quads are alpha blended with the texture modulated by the vertex colour. Textured geometry has
+ * to be made of axis aligned quads (two triangles a b c, a c d, like glyphs and batchTexture()), and
+ * textures have to be registered with their pixels first (the glyph atlases do that). Untextured geometry
+ * can be any triangles, each one is filled with the colour of its first vertex.
+ */
+
+#ifndef RASTERIZER_H
+#define RASTERIZER_H
+
+// Include necessary libraries
+#include <SDL2/SDL.h>
+
+/**
+ * @def MAX_RASTER_TEXTURES
+ * @brief Maximum number of registered textures.
+ */
+#define MAX_RASTER_TEXTURES 16
+
+/**
+ * @brief Create the framebuffer and the streaming texture it's uploaded to, and activate the rasterizer.
+ *
+ * @param renderer The SDL renderer the frames are shown with.
+ * @param width Width of the framebuffer (the HUD's size).
+ * @param height Height of the framebuffer.
+ * @return 1 on success, 0 on failure (SDL drawing is used then).
+ */
+int initRasterizer(SDL_Renderer *renderer, int width, int height);
+
+/**
+ * @brief Free the framebuffer and the texture, SDL drawing is used again.
+ */
+void destroyRasterizer(void);
+
+/**
+ * @brief Check if the HUD is drawn by the rasterizer.
+ *
+ * @return 1 if active, 0 otherwise.
+ */
+int isRasterizerActive(void);
+
+/**
+ * @brief Limit drawing to a rectangle.
+ *
+ * @param clip The clip rectangle, NULL for the whole framebuffer.
+ */
+void setRasterClip(const SDL_Rect *clip);
+
+/**
+ * @brief Get the rectangle drawing is limited to.
+ *
+ * @param clip Pointer to the clip rectangle.
+ */
+void getRasterClip(SDL_Rect *clip);
+
+/**
+ * @brief Draw points.
+ *
+ * @param points The points.
+ * @param count Number of points.
+ * @param color The color.
+ */
+void rasterPoints(const SDL_Point *points, int count, SDL_Color color);
+
+/**
+ * @brief Draw a line, both end points included.
+ *
+ * @param x1 The x-coordinate of the start.
+ * @param y1 The y-coordinate of the start.
+ * @param x2 The x-coordinate of the end.
+ * @param y2 The y-coordinate of the end.
+ * @param color The color.
+ */
+void rasterLine(int x1, int y1, int x2, int y2, SDL_Color color);
+
+/**
+ * @brief Draw a rectangle outline.
+ *
+ * @param rect The rectangle.
+ * @param color The color.
+ */
+void rasterRect(const SDL_Rect *rect, SDL_Color color);
+
+/**
+ * @brief Fill a rectangle.
+ *
+ * @param rect The rectangle.
+ * @param color The color.
+ */
+void rasterFillRect(const SDL_Rect *rect, SDL_Color color);
+
+/**
+ * @brief Draw textured quads or untextured triangles, alpha blended.
+ *
+ * @param texture The texture (registered with registerRasterTexture()), NULL for the vertex colour only.
+ * @param vertices The vertices.
+ * @param vertexCount Number of vertices.
+ * @param indices Vertex indices, six per quad (three per triangle without a texture).
+ * @param indexCount Number of indices.
+ */
+void rasterGeometry(SDL_Texture *texture, const SDL_Vertex *vertices, int vertexCount, const int *indices, int indexCount);
+
+/**
+ * @brief Give the rasterizer the pixels of a texture, so geometry using it can be drawn.
+ *
+ * The pixels are read when drawing, not copied: they have to stay valid (and be updated along with
+ * the texture) until unregisterRasterTexture().
+ *
+ * @param texture The SDL texture.
+ * @param pixels Its pixels, ARGB8888, width * height without padding.
+ * @param width Width of the texture.
+ * @param height Height of the texture.
+ */
+void registerRasterTexture(SDL_Texture *texture, const Uint32 *pixels, int width, int height);
+
+/**
+ * @brief Forget a texture's pixels (before freeing them).
+ *
+ * @param texture The SDL texture.
+ */
+void unregisterRasterTexture(SDL_Texture *texture);
+
+/**
+ * @brief Upload the redrawn regions of the framebuffer and copy it to the screen (before presenting).
+ *
+ * @param regions The regions drawn since the last upload.
+ * @param count Number of regions.
+ */
+void presentRasterFrame(const SDL_Rect *regions, int count);
+
+#endif // RASTERIZER_H
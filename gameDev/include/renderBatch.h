@@ -0,0 +1,179 @@
+/**
+ * @file renderBatch.h
+ * @brief Command buffer for the 2D HUD.
+ *
+ * Points, lines, rectangles and textured geometry are recorded during the frame instead of being drawn
+ * right away. On submit the commands are sorted by layer, primitive type and colour/texture, and every
+ * run with the same state is drawn with a single SDL call (SDL_RenderDrawPoints, SDL_RenderDrawLines,
+ * SDL_RenderDrawRects, SDL_RenderFillRects or SDL_RenderGeometry). With the CPU rasterizer active
+ * (rasterizer.h) the runs are drawn into its framebuffer instead.
+ *
+ * Sorting changes the drawing order, so overlapping primitives have to be put on different layers:
+ * lower layers are always drawn first, within a layer nothing should overlap.
+ */
+
+#ifndef RENDER_BATCH_H
+#define RENDER_BATCH_H
+
+// Include necessary libraries
+#include <SDL2/SDL.h>
+
+/**
+ * @enum BatchLayer
+ * @brief Drawing order of the recorded commands, lowest first.
+ */
+typedef enum {
+    BATCH_LAYER_BACKGROUND, ///< Cached gauge backgrounds, panel fills
+    BATCH_LAYER_SHAPES,     ///< Lines, outlines and fills drawn on the backgrounds
+    BATCH_LAYER_TEXT,       ///< Text, always on top
+    BATCH_LAYERS            ///< Number of layers
+} BatchLayer;
+
+/**
+ * @struct RenderBatchStats
+ * @brief What one frame cost in SDL calls.
+ */
+typedef struct {
+    int commands;       ///< Primitives recorded
+    int drawCalls;      ///< SDL draw calls issued
+    int stateChanges;   ///< Draw colour and texture changes
+    int textures;       ///< Textures created (createRenderTexture())
+} RenderBatchStats;
+
+/**
+ * @brief Initialize the command buffer.
+ *
+ * @param renderer The SDL renderer the commands are submitted to.
+ */
+void initRenderBatch(SDL_Renderer *renderer);
+
+/**
+ * @brief Free the command buffer.
+ */
+void destroyRenderBatch(void);
+
+/**
+ * @brief Record a point.
+ *
+ * @param layer Layer to draw on.
+ * @param x The x-coordinate of the point.
+ * @param y The y-coordinate of the point.
+ * @param color The color of the point.
+ */
+void batchPoint(BatchLayer layer, int x, int y, SDL_Color color);
+
+/**
+ * @brief Record a line, lines that continue each other are drawn as one polyline.
+ *
+ * @param layer Layer to draw on.
+ * @param x1 The x-coordinate of the start.
+ * @param y1 The y-coordinate of the start.
+ * @param x2 The x-coordinate of the end.
+ * @param y2 The y-coordinate of the end.
+ * @param color The color of the line.
+ */
+void batchLine(BatchLayer layer, int x1, int y1, int x2, int y2, SDL_Color color);
+
+/**
+ * @brief Record a polyline (like SDL_RenderDrawLines()), drawn with one SDL call unless the batch is full.
+ *
+ * @param layer Layer to draw on.
+ * @param points The points, the line goes through them in order.
+ * @param count Number of points.
+ * @param color The color of the line.
+ */
+void batchLines(BatchLayer layer, const SDL_Point *points, int count, SDL_Color color);
+
+/**
+ * @brief Record a rectangle outline.
+ *
+ * @param layer Layer to draw on.
+ * @param rect The rectangle.
+ * @param color The color of the outline.
+ */
+void batchRect(BatchLayer layer, const SDL_Rect *rect, SDL_Color color);
+
+/**
+ * @brief Record a filled rectangle.
+ *
+ * @param layer Layer to draw on.
+ * @param rect The rectangle.
+ * @param color The fill color.
+ */
+void batchFillRect(BatchLayer layer, const SDL_Rect *rect, SDL_Color color);
+
+/**
+ * @brief Record a whole texture drawn into a rectangle.
+ *
+ * @param layer Layer to draw on.
+ * @param texture The texture.
+ * @param destination Where the texture goes on the screen.
+ */
+void batchTexture(BatchLayer layer, SDL_Texture *texture, const SDL_Rect *destination);
+
+/**
+ * @brief Record textured (or untextured) triangles.
+ *
+ * @param layer Layer to draw on.
+ * @param texture The texture, NULL for plain coloured triangles.
+ * @param vertices The vertices (copied).
+ * @param vertexCount Number of vertices.
+ * @param indices Vertex indices, three per triangle (copied).
+ * @param indexCount Number of indices.
+ */
+void batchGeometry(BatchLayer layer, SDL_Texture *texture, const SDL_Vertex *vertices, int vertexCount, const int *indices, int indexCount);
+
+/**
+ * @brief Record triangles drawn only inside a rectangle (a scissor), e.g. geometry reaching past its gauge.
+ *
+ * Clipped geometry isn't merged with other commands, every call is one SDL_RenderGeometry() call of its own.
+ *
+ * @param layer Layer to draw on.
+ * @param texture The texture, NULL for the vertex colours only.
+ * @param vertices The vertices (copied).
+ * @param vertexCount Number of vertices.
+ * @param indices Three indices per triangle (copied).
+ * @param indexCount Number of indices.
+ * @param clip Nothing is drawn outside this rectangle.
+ */
+void batchClippedGeometry(BatchLayer layer, SDL_Texture *texture, const SDL_Vertex *vertices, int vertexCount, const int *indices, int indexCount, const SDL_Rect *clip);
+
+/**
+ * @brief Draw everything recorded so far and empty the buffer.
+ *
+ * Call before changing the render target, so the commands end up in the right one.
+ */
+void submitRenderBatch(void);
+
+/**
+ * @brief Submit the rest of the frame and close its statistics, call once per frame before presenting.
+ */
+void finishRenderBatchFrame(void);
+
+/**
+ * @brief Get the statistics of the last finished frame.
+ *
+ * @return The RenderBatchStats of the last frame.
+ */
+RenderBatchStats getRenderBatchStats(void);
+
+/**
+ * @brief Get the statistics summed over every frame since initRenderBatch(), the unfinished one included.
+ *
+ * @return The RenderBatchStats so far.
+ */
+RenderBatchStats getRenderBatchTotals(void);
+
+/**
+ * @brief Create a texture, counted in the statistics (the HUD creates all its textures through this).
+ *
+ * @param renderer The SDL renderer.
+ * @param format Pixel format.
+ * @param access Texture access.
+ * @param width Width in pixels.
+ * @param height Height in pixels.
+ * @return The texture, NULL on failure (SDL_GetError() says why).
+ */
+SDL_Texture *createRenderTexture(SDL_Renderer *renderer, Uint32 format, int access, int width, int height);
+
+#endif // RENDER_BATCH_H
@@ -0,0 +1,101 @@
+/**
+ * @file renderGovernor.h
+ * @brief Render quality governor: keeps the HUD within its share of the frame time.
+ *
+ * The main loop reports how long every frame took to render (0 for frames it skipped) and how many
+ * physics ticks started late. The governor averages the render time and compares it to the render
+ * budget. When the HUD stays over budget, or a physics tick was late, it drops one quality level, and
+ * when there is plenty of headroom again for a while it goes back up one level. After every change it
+ * waits for the average to settle before changing again.
+ *
+ * Quality levels, each one includes the ones above it:
+ * - QUALITY_FULL: everything at its own rate.
+ * - QUALITY_SLOW_TEXT: labels are read and formatted at 4 Hz at most.
+ * - QUALITY_NO_DEBUG: the debug panel is hidden.
+ * - QUALITY_STATIC_GAUGES: gauges are read at 10 Hz at most, gauge backgrounds that aren't cached are
+ *   drawn without their numbers.
+ * - QUALITY_HALF_RATE: only every second frame is rendered.
+ */
+
+#ifndef RENDER_GOVERNOR_H
+#define RENDER_GOVERNOR_H
+
+// Include header files
+#include "utils.h"
+
+/**
+ * @def RENDER_BUDGET_MICROSECONDS
+ * @brief Render time per frame the HUD may use on average, the rest is left to events and the simulation thread.
+ */
+#define RENDER_BUDGET_MICROSECONDS (FRAME_TIME_MICROSECONDS / 2)
+
+/**
+ * @enum QualityLevel
+ * @brief How much HUD work is done, lowest is best.
+ */
+typedef enum {
+    QUALITY_FULL,           ///< Everything at its own rate
+    QUALITY_SLOW_TEXT,      ///< Labels at 4 Hz at most
+    QUALITY_NO_DEBUG,       ///< Debug panel hidden
+    QUALITY_STATIC_GAUGES,  ///< Gauges at 10 Hz at most, no numbers on uncached gauge backgrounds
+    QUALITY_HALF_RATE,      ///< Every second frame rendered
+    QUALITY_LEVELS          ///< Number of levels
+} QualityLevel;
+
+/**
+ * @struct GovernorStats
+ * @brief What the governor sees and decided.
+ */
+typedef struct {
+    QualityLevel level;         ///< Current quality level
+    float utilisation;          ///< Average render time / budget (1 = exactly on budget)
+    float averageRenderMs;      ///< Average render time per frame (skipped frames count as 0)
+    int lateTicks;              ///< Physics ticks that started late so far
+    int changes;                ///< Quality changes so far
+} GovernorStats;
+
+/**
+ * @brief Start at full quality.
+ *
+ * @param budgetMicroseconds Render time per frame the HUD may use on average.
+ */
+void initRenderGovernor(long budgetMicroseconds);
+
+/**
+ * @brief Check if this frame should be rendered (every second one at QUALITY_HALF_RATE).
+ *
+ * @return 1 to render, 0 to skip.
+ */
+int shouldRenderFrame(void);
+
+/**
+ * @brief Report a frame, once per main loop iteration.
+ *
+ * @param renderMicroseconds Time the frame took to render, 0 if it was skipped.
+ * @param lateTicks Physics ticks that started late so far (SimulationStats).
+ */
+void updateRenderGovernor(long renderMicroseconds, int lateTicks);
+
+/**
+ * @brief Get the current quality level.
+ *
+ * @return The QualityLevel.
+ */
+QualityLevel getRenderQuality(void);
+
+/**
+ * @brief Get a short name for a quality level.
+ *
+ * @param level The QualityLevel.
+ * @return The name ("full", "slow text", ...).
+ */
+const char *getQualityName(QualityLevel level);
+
+/**
+ * @brief Get the governor's statistics.
+ *
+ * @return The GovernorStats.
+ */
+GovernorStats getRenderGovernorStats(void);
+
+#endif // RENDER_GOVERNOR_H
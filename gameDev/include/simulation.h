@@ -0,0 +1,163 @@
+/**
+ * @file simulation.h
+ * @brief Simulation thread: steps the weather and the physics, publishes snapshots for the renderer.
+ *
+ * The simulation thread owns the aircraft state. Every tick it publishes an immutable snapshot of
+ * everything the HUD shows through a wait-free triple buffer (tripleBuffer.h), the render/event thread
+ * picks up the newest one whenever it draws a frame. Controls go the other way through a second triple
+ * buffer. Neither thread ever waits for the other: a slow frame doesn't delay a physics tick, and a
+ * burst of ticks doesn't delay a frame (the snapshots the renderer didn't get to are skipped).
+ */
+
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+// Include header files
+#include "aircraft.h"
+#include "aircraftModel.h"
+#include "controls.h"
+#include "physics.h"
+#include "utils.h"
+
+/**
+ * @def SIMULATION_RATE
+ * @brief Physics ticks per second.
+ */
+#define SIMULATION_RATE TARGET_FPS
+
+/**
+ * @def SIMULATION_TICK_MICROSECONDS
+ * @brief Time between two physics ticks.
+ */
+#define SIMULATION_TICK_MICROSECONDS (1000000 / SIMULATION_RATE)
+
+/**
+ * @def SIMULATION_HISTORY
+ * @brief Samples the history queue holds (a power of two), about 4 s at 60 ticks per second.
+ */
+#define SIMULATION_HISTORY 256
+
+/**
+ * @struct SimulationSample
+ * @brief What the strip charts and the ground track map plot, recorded every tick.
+ */
+typedef struct {
+    float simulationTime;           ///< Simulation time in s
+    float x;                        ///< x position in m
+    float z;                        ///< z position in m
+    float altitude;                 ///< Altitude in m
+    float trueAirspeed;             ///< TAS in m/s
+    float machNumber;               ///< Mach number
+    float angleOfAttack;            ///< Angle of attack in degrees
+    float thrust;                   ///< Thrust in N
+    float totalDrag;                ///< Total drag in N
+    float fuel;                     ///< Fuel left in kg
+} SimulationSample;
+
+/**
+ * @struct SimulationSnapshot
+ * @brief The state of the simulation after one tick, as the renderer sees it.
+ */
+typedef struct {
+    AircraftState aircraft;         ///< Aircraft state
+    float simulationTime;           ///< Simulation time in s
+    unsigned tick;                  ///< Number of the tick that produced the snapshot
+    int crashed;                    ///< 1 once the aircraft hit the ground, the simulation stops
+
+    // PhysicsData subset shown in the HUD
+    float trueAirspeed;             ///< TAS in m/s
+    float velocityMagnitude;        ///< Speed relative to the ground in m/s
+    float machNumber;               ///< Mach number
+    float thrust;                   ///< Thrust in N
+    float totalDrag;                ///< Total drag in N
+    float dragCoefficient;          ///< Drag coefficient
+    float parasiticDrag;            ///< Parasitic drag in N
+    float inducedDrag;              ///< Induced drag in N
+    float dragDivergence;           ///< Shockwave drag in N
+    Vector3 windVector;             ///< Wind including gusts in m/s
+    float temperatureDeviation;     ///< ISA temperature deviation in K
+} SimulationSnapshot;
+
+/**
+ * @struct SimulationStats
+ * @brief Snapshot counters since the simulation started.
+ */
+typedef struct {
+    int produced;   ///< Snapshots published by the simulation thread
+    int consumed;   ///< Snapshots picked up by the renderer
+    int skipped;    ///< Snapshots replaced by a newer one before the renderer picked them up
+    int late;       ///< Ticks that started more than a whole tick after their scheduled time
+    int dropped;    ///< History samples lost because the queue was full (nobody read it for a while)
+} SimulationStats;
+
+/**
+ * @brief Start the simulation thread.
+ *
+ * The weather has to be initialized first, it's updated from the simulation thread from now on.
+ *
+ * @param aircraft The initial aircraft state (copied).
+ * @param model The compiled aircraft model, has to stay valid until stopSimulation().
+ * @param controls The initial controls (copied).
+ * @return 1 on success, 0 on failure.
+ */
+int startSimulation(const AircraftState *aircraft, const CompiledAircraftModel *model, const AircraftControls *controls);
+
+/**
+ * @brief Stop the simulation thread and wait for it to finish.
+ */
+void stopSimulation(void);
+
+/**
+ * @brief Pause or resume the simulation.
+ *
+ * While paused the simulation thread sleeps (no CPU time) and the simulation time stands still, the last
+ * snapshot stays the newest one.
+ *
+ * @param paused 1 to pause, 0 to resume.
+ */
+void setSimulationPaused(int paused);
+
+/**
+ * @brief Check if the simulation is paused.
+ *
+ * @return 1 if paused, 0 otherwise.
+ */
+int isSimulationPaused(void);
+
+/**
+ * @brief Hand the current controls to the simulation thread (render/event thread only).
+ *
+ * @param controls The controls (copied).
+ */
+void setSimulationControls(const AircraftControls *controls);
+
+/**
+ * @brief Get the newest snapshot (render/event thread only).
+ *
+ * The snapshot stays valid and unchanged until the next call.
+ *
+ * @return Pointer to the newest snapshot.
+ */
+const SimulationSnapshot *acquireSimulationSnapshot(void);
+
+/**
+ * @brief Take the samples recorded since the last call, oldest first (render/event thread only).
+ *
+ * Unlike the snapshots, which the renderer only sees when it draws, every tick is recorded: the
+ * simulation thread writes one sample per tick into a wait-free single producer / single consumer queue
+ * of SIMULATION_HISTORY samples. When nobody reads it for that long, new samples are dropped.
+ *
+ * @param samples Output samples.
+ * @param maxSamples Room in the output.
+ * @return Number of samples taken, call again while it's maxSamples.
+ */
+int readSimulationSamples(SimulationSample *samples, int maxSamples);
+
+/**
+ * @brief Get the snapshot counters.
+ *
+ * @return The SimulationStats.
+ */
+SimulationStats getSimulationStats(void);
+
+#endif // SIMULATION_H
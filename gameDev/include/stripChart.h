@@ -0,0 +1,103 @@
+/**
+ * @file stripChart.h
+ * @brief Strip chart series: a fixed-size ring buffer of samples, decimated to the chart's pixel width.
+ *
+ * A series keeps the last STRIP_CHART_SAMPLES samples (pushed at the physics rate) and never allocates,
+ * however long the session runs. The window is split into one bucket per pixel column, and every bucket
+ * is reduced to one point with Largest-Triangle-Three-Buckets (the sample forming the biggest triangle
+ * with the point chosen for the previous bucket and the average of the next one). Buckets are aligned to
+ * the absolute sample number, so a chosen point stays valid while the window scrolls: each bucket is
+ * decimated once, when the bucket after it is complete. Drawing a chart only reads the chosen points,
+ * its cost depends on the width in pixels, not on the number of samples.
+ *
+ * The newest one or two buckets are still open, the line goes straight from the last chosen point to the
+ * newest sample.
+ */
+
+#ifndef STRIP_CHART_H
+#define STRIP_CHART_H
+
+// Include necessary libraries
+#include <SDL2/SDL.h>
+
+/**
+ * @def STRIP_CHART_SAMPLES
+ * @brief Samples kept per series (34 s at 60 ticks per second).
+ */
+#define STRIP_CHART_SAMPLES 2048
+
+/**
+ * @def MAX_STRIP_CHART_WIDTH
+ * @brief Widest chart in pixels (one chosen point per pixel column).
+ */
+#define MAX_STRIP_CHART_WIDTH 512
+
+/**
+ * @struct StripChart
+ * @brief One series: the raw samples and one chosen point per completed bucket.
+ */
+typedef struct {
+    float samples[STRIP_CHART_SAMPLES];         ///< Ring of raw samples, sample n is at n % STRIP_CHART_SAMPLES
+    unsigned pushed;                            ///< Samples pushed so far
+    int width;                                  ///< Buckets in the window (the chart's width in pixels)
+    int bucketSize;                             ///< Samples per bucket
+
+    unsigned chosenSample[MAX_STRIP_CHART_WIDTH];   ///< Ring: sample number of the point chosen for a bucket
+    float chosenValue[MAX_STRIP_CHART_WIDTH];       ///< Ring: its value
+    float bucketMinimum[MAX_STRIP_CHART_WIDTH];     ///< Ring: smallest sample of the bucket (for the scale)
+    float bucketMaximum[MAX_STRIP_CHART_WIDTH];     ///< Ring: biggest sample of the bucket
+    unsigned decimated;                         ///< Buckets with a chosen point so far
+
+    double bucketSum;                           ///< Sum of the open bucket's samples
+    float nextAverage;                          ///< Average of the last completed bucket
+} StripChart;
+
+/**
+ * @brief Empty a series and set its width.
+ *
+ * @param chart Pointer to the StripChart.
+ * @param width Width of the chart in pixels, 2 to MAX_STRIP_CHART_WIDTH.
+ * @return 1 on success, 0 if the width is out of range.
+ */
+int initStripChart(StripChart *chart, int width);
+
+/**
+ * @brief Add a sample, the oldest one drops out of the window once it's full.
+ *
+ * @param chart Pointer to the StripChart.
+ * @param value The sample.
+ */
+void pushStripChartSample(StripChart *chart, float value);
+
+/**
+ * @brief Get the newest sample.
+ *
+ * @param chart Pointer to the StripChart.
+ * @return The newest sample, 0 if there is none.
+ */
+float getLatestStripChartSample(const StripChart *chart);
+
+/**
+ * @brief Widen a value range to the samples in the window (several series can share one scale).
+ *
+ * @param chart Pointer to the StripChart.
+ * @param minimum Pointer to the smallest value so far, lowered if needed.
+ * @param maximum Pointer to the biggest value so far, raised if needed.
+ */
+void getStripChartRange(const StripChart *chart, float *minimum, float *maximum);
+
+/**
+ * @brief Get the decimated line in screen coordinates, oldest point first.
+ *
+ * The window fills from the left until it's full, then scrolls.
+ *
+ * @param chart Pointer to the StripChart.
+ * @param area The chart's rectangle on screen.
+ * @param minimum Value at the bottom of the area.
+ * @param maximum Value at the top of the area.
+ * @param points Output points, room for width + 1 points.
+ * @return Number of points.
+ */
+int getStripChartPoints(const StripChart *chart, const SDL_Rect *area, float minimum, float maximum, SDL_Point *points);
+
+#endif // STRIP_CHART_H
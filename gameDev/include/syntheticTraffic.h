@@ -0,0 +1,53 @@
+/**
+ * @file syntheticTraffic.h
+ * @brief Synthetic air traffic for the tactical display: aircraft flying gentle turns around a point.
+ *
+ * The simulation only flies one aircraft, this fills the tactical display (tacticalDisplay.h) with as
+ * many others as asked for. Every aircraft has a constant speed, turn rate and altitude drawn from a
+ * seeded random generator, the same seed always gives the same traffic.
+ */
+
+#ifndef SYNTHETIC_TRAFFIC_H
+#define SYNTHETIC_TRAFFIC_H
+
+// Include header files
+#include "tacticalDisplay.h"
+
+/**
+ * @def SYNTHETIC_TRAFFIC_RADIUS
+ * @brief Half the side of the square the traffic starts in, in m.
+ */
+#define SYNTHETIC_TRAFFIC_RADIUS 40000.0f
+
+/**
+ * @brief Create the traffic around a point.
+ *
+ * @param count Number of aircraft.
+ * @param centreX x position of the middle in m.
+ * @param centreZ z position of the middle in m.
+ * @param seed Seed of the random generator (0 is replaced).
+ * @return 1 on success, 0 on failure (no traffic then).
+ */
+int initSyntheticTraffic(int count, float centreX, float centreZ, unsigned seed);
+
+/**
+ * @brief Free the traffic.
+ */
+void destroySyntheticTraffic(void);
+
+/**
+ * @brief Move every aircraft along its turn.
+ *
+ * @param dt Time step in s.
+ */
+void updateSyntheticTraffic(float dt);
+
+/**
+ * @brief Get the traffic as tactical contacts.
+ *
+ * @param count Pointer to the number of contacts.
+ * @return The contacts, NULL if there is no traffic.
+ */
+const TacticalContact *getSyntheticTraffic(int *count);
+
+#endif // SYNTHETIC_TRAFFIC_H
@@ -0,0 +1,98 @@
+/**
+ * @file tacticalDisplay.h
+ * @brief Tactical situation display: every aircraft's position, heading and altitude tag on one scope.
+ *
+ * The contacts are sorted into a uniform grid (counting sort, rebuilt whenever they're set), drawing only
+ * visits the cells inside the view. Every visible aircraft is a triangle pointing along its heading, taken
+ * from a table of pre-rotated symbols (no trig per aircraft), and all of them go into one untextured
+ * geometry batch, one SDL_RenderGeometry() call. Altitude tags are decluttered with a second grid in
+ * screen space with cells of the tag's size: a tag is only drawn if all cells under it are still free.
+ *
+ * The tags are the altitude in hundreds of metres. Every value has its own cell in a label atlas (one
+ * texture, registered with the CPU rasterizer) and is rendered the first time a contact shows it, never
+ * again after that. All tags are one textured geometry batch as well.
+ */
+
+#ifndef TACTICAL_DISPLAY_H
+#define TACTICAL_DISPLAY_H
+
+// Include necessary libraries
+#include <SDL2/SDL.h>
+
+/**
+ * @def MAX_TACTICAL_GRID
+ * @brief Most cells per side of the contact grid.
+ */
+#define MAX_TACTICAL_GRID 128
+
+/**
+ * @def MAX_TACTICAL_LABELS
+ * @brief Altitude tags the label atlas holds (one per value, 0 to 51 km in steps of 100 m).
+ */
+#define MAX_TACTICAL_LABELS 512
+
+/**
+ * @struct TacticalContact
+ * @brief One aircraft on the scope.
+ */
+typedef struct {
+    float x;            ///< x position in m
+    float z;            ///< z position in m
+    float heading;      ///< Heading in radians (the aircraft's yaw, 0 is +x)
+    float altitude;     ///< Altitude in m
+} TacticalContact;
+
+/**
+ * @struct TacticalStats
+ * @brief What the last scope drawn did.
+ */
+typedef struct {
+    int contacts;       ///< Contacts set
+    int visible;        ///< Contacts inside the view
+    int tags;           ///< Altitude tags drawn (the rest was decluttered)
+    int cellsVisited;   ///< Grid cells looked at
+    int tagsRendered;   ///< Tag values rendered into the atlas so far
+} TacticalStats;
+
+/**
+ * @brief Open the tag font and create the label atlas.
+ *
+ * @param renderer The SDL renderer.
+ * @param fontPath Path of the tag font.
+ * @param fontSize Size of the tag font.
+ * @return 1 on success, 0 on failure (the scope draws symbols without tags then).
+ */
+int initTacticalDisplay(SDL_Renderer *renderer, const char *fontPath, int fontSize);
+
+/**
+ * @brief Free the contacts, the grid, the font and the label atlas.
+ */
+void destroyTacticalDisplay(void);
+
+/**
+ * @brief Set the contacts and sort them into the grid.
+ *
+ * @param contacts The contacts (copied).
+ * @param count Number of contacts.
+ * @return 1 on success, 0 if memory ran out (the scope stays empty).
+ */
+int setTacticalContacts(const TacticalContact *contacts, int count);
+
+/**
+ * @brief Record the scope into the render batch, north up.
+ *
+ * @param area The scope's rectangle on screen, nothing is drawn outside it.
+ * @param centreX x position in the middle of the scope in m.
+ * @param centreZ z position in the middle of the scope in m.
+ * @param pixelSize Size of a pixel in m.
+ */
+void drawTacticalDisplay(const SDL_Rect *area, float centreX, float centreZ, float pixelSize);
+
+/**
+ * @brief Get the statistics of the last scope drawn.
+ *
+ * @return The TacticalStats.
+ */
+TacticalStats getTacticalStats(void);
+
+#endif // TACTICAL_DISPLAY_H
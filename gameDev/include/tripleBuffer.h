@@ -0,0 +1,87 @@
+/**
+ * @file tripleBuffer.h
+ * @brief Wait-free single producer / single consumer triple buffer.
+ *
+ * The producer always has a slot to write into and the consumer always has a complete slot to read,
+ * neither ever waits for the other. Publishing and acquiring swap slot indices with one atomic exchange,
+ * the slot contents are never copied.
+ */
+
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+// Include necessary libraries
+#include <stddef.h>
+#include <SDL2/SDL.h>
+
+/**
+ * @struct TripleBuffer
+ * @brief Three equally sized slots, owned by the producer (back), the consumer (front) and neither (middle).
+ */
+typedef struct TripleBuffer {
+    unsigned char *slots[3];    ///< The three slots
+    size_t slotSize;            ///< Size of one slot in bytes
+    SDL_atomic_t middle;        ///< Index of the middle slot, plus TRIPLE_BUFFER_FRESH if it hasn't been read yet
+    int back;                   ///< Slot the producer writes (producer only)
+    int front;                  ///< Slot the consumer reads (consumer only)
+} TripleBuffer;
+
+/**
+ * @brief Allocate the three slots (zeroed).
+ *
+ * @param buffer Pointer to the TripleBuffer structure.
+ * @param slotSize Size of one slot in bytes.
+ * @return 1 on success, 0 on failure.
+ */
+int initTripleBuffer(TripleBuffer *buffer, size_t slotSize);
+
+/**
+ * @brief Free the slots.
+ *
+ * @param buffer Pointer to the TripleBuffer structure.
+ */
+void freeTripleBuffer(TripleBuffer *buffer);
+
+/**
+ * @brief Get the slot the producer writes into.
+ *
+ * @param buffer Pointer to the TripleBuffer structure.
+ * @return Pointer to the back slot.
+ */
+void *getTripleBufferBack(TripleBuffer *buffer);
+
+/**
+ * @brief Publish the back slot, the producer gets a new back slot.
+ *
+ * If the consumer hasn't picked up the previously published slot, that one is dropped.
+ *
+ * @param buffer Pointer to the TripleBuffer structure.
+ * @return 1 if an unread slot was dropped, 0 otherwise.
+ */
+int publishTripleBuffer(TripleBuffer *buffer);
+
+/**
+ * @brief Check whether a slot has been published since the consumer last acquired one.
+ *
+ * @param buffer Pointer to the TripleBuffer structure.
+ * @return 1 if there's a fresh slot, 0 otherwise.
+ */
+int hasFreshTripleBuffer(TripleBuffer *buffer);
+
+/**
+ * @brief Take the most recently published slot if there is a fresh one.
+ *
+ * @param buffer Pointer to the TripleBuffer structure.
+ * @return 1 if the front slot changed, 0 if it's still the same.
+ */
+int acquireTripleBuffer(TripleBuffer *buffer);
+
+/**
+ * @brief Get the slot the consumer reads.
+ *
+ * @param buffer Pointer to the TripleBuffer structure.
+ * @return Pointer to the front slot (zeroed until something has been acquired).
+ */
+const void *getTripleBufferFront(const TripleBuffer *buffer);
+
+#endif // TRIPLE_BUFFER_H
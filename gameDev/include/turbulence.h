@@ -0,0 +1,119 @@
+/**
+ * @file turbulence.h
+ * @brief Dryden turbulence model with per-aircraft shaping-filter state.
+ *
+ * Gusts are produced by driving first-order shaping filters with Gaussian noise, following the
+ * discrete Dryden form of MIL-HDBK-1797. Intensities and scale lengths depend on the altitude
+ * (low altitude model below 1000 ft, medium/high altitude model above 2000 ft, blended in between),
+ * and the filter bandwidth depends on the aircraft's airspeed.
+ *
+ * The filter state is kept as structure of arrays so thousands of aircraft can be updated in one loop,
+ * and all memory is allocated once in initTurbulenceField().
+ */
+
+#ifndef TURBULENCE_H
+#define TURBULENCE_H
+
+// Include physics.h for Vector3 definition
+#include "physics.h"
+
+// Include stdint for the noise generator state
+#include <stdint.h>
+
+/**
+ * @def TURBULENCE_TABLE_POINTS
+ * @brief Altitude nodes of the intensity/scale length profile, 0 m to 25 km every 50 m.
+ */
+#define TURBULENCE_TABLE_POINTS 501
+#define TURBULENCE_TABLE_STEP 50.0f // m
+
+/**
+ * @enum TurbulenceSeverity
+ * @brief Turbulence severity as defined by MIL-HDBK-1797.
+ */
+typedef enum TurbulenceSeverity {
+    TURBULENCE_NONE = 0,    ///< Calm air
+    TURBULENCE_LIGHT,       ///< W20 = 15 kts, probability of exceedance 10^-2
+    TURBULENCE_MODERATE,    ///< W20 = 30 kts, probability of exceedance 10^-3
+    TURBULENCE_SEVERE       ///< W20 = 45 kts, probability of exceedance 10^-5
+} TurbulenceSeverity;
+
+/**
+ * @struct TurbulenceProfile
+ * @brief Gust intensities and inverse scale lengths at one altitude node.
+ *
+ * The inverse scale lengths already contain the factor 2 of the lateral and vertical filters.
+ */
+typedef struct {
+    float sigmaU, sigmaV, sigmaW;   ///< RMS gust intensities in m/s
+    float kU, kV, kW;               ///< 1/Lu, 2/Lv, 2/Lw in 1/m
+} TurbulenceProfile;
+
+/**
+ * @struct TurbulenceField
+ * @brief Shaping-filter state for a group of aircraft, one slot per aircraft.
+ */
+typedef struct TurbulenceField {
+    int capacity;                   ///< Number of aircraft slots, 0 means turbulence is off
+    TurbulenceSeverity severity;    ///< Current severity
+
+    float *u;                       ///< Longitudinal gust (along the flight path) in m/s
+    float *v;                       ///< Lateral gust (to the right) in m/s
+    float *w;                       ///< Vertical gust (up) in m/s
+    uint32_t *rng;                  ///< Noise generator state per aircraft
+
+    TurbulenceProfile profile[TURBULENCE_TABLE_POINTS]; ///< Intensity and scale length over altitude
+} TurbulenceField;
+
+/**
+ * @brief Allocate the filter state and build the profile for a severity.
+ *
+ * @param field Pointer to the TurbulenceField structure.
+ * @param capacity Number of aircraft slots.
+ * @param severity Turbulence severity.
+ * @param seed Seed of the noise generators, each slot gets its own stream.
+ * @return 1 on success, 0 on failure.
+ */
+int initTurbulenceField(TurbulenceField *field, int capacity, TurbulenceSeverity severity, uint32_t seed);
+
+/**
+ * @brief Free the filter state, the field is turned off afterwards.
+ *
+ * @param field Pointer to the TurbulenceField structure.
+ */
+void freeTurbulenceField(TurbulenceField *field);
+
+/**
+ * @brief Change the severity, rebuilds the profile (not meant to be called per tick).
+ *
+ * @param field Pointer to the TurbulenceField structure.
+ * @param severity New turbulence severity.
+ */
+void setTurbulenceSeverity(TurbulenceField *field, TurbulenceSeverity severity);
+
+/**
+ * @brief Advance the shaping filters of a range of aircraft by one time step.
+ *
+ * @param field Pointer to the TurbulenceField structure.
+ * @param first Index of the first slot to update.
+ * @param count Number of slots to update.
+ * @param altitude Array of count altitudes in m.
+ * @param airspeed Array of count true airspeeds in m/s.
+ * @param deltaTime The time step in seconds.
+ */
+void updateTurbulenceField(TurbulenceField *field, int first, int count, const float *altitude, const float *airspeed, float deltaTime);
+
+/**
+ * @brief Get the gust of one aircraft in world coordinates.
+ *
+ * The longitudinal gust is applied along the horizontal direction of travel, the lateral gust
+ * perpendicular to it and the vertical gust along +y.
+ *
+ * @param field Pointer to the TurbulenceField structure.
+ * @param index Slot of the aircraft.
+ * @param velocity Velocity of the aircraft in m/s.
+ * @return The gust vector in m/s, zero if turbulence is off.
+ */
+Vector3 getTurbulenceVector(const TurbulenceField *field, int index, Vector3 velocity);
+
+#endif // TURBULENCE_H
@@ -4,6 +4,7 @@
  *
  * This file contains the declaration of functions related to weather conditions,
  * such as wind vector calculations, which are used in the flight simulator.
+ * Turbulence is handled separately by the Dryden model in turbulence.h.
  */
 
 #ifndef WEATHER_H
@@ -11,18 +12,82 @@
 
 // Include physics.h for Vector3 definition
 #include "physics.h" 
+#include "turbulence.h"
+#include "windField.h"
+#include "weatherSim.h"
 
 /**
-* @brief Calculates the wind vector at a given altitude and time.
+ * @struct WeatherSample
+ * @brief The weather at one position: wind and ISA temperature deviation.
+ */
+typedef struct {
+    Vector3 wind;                   ///< Mean wind (analytic or gridded) plus the simulated weather's wind in m/s, without turbulence
+    float temperatureDeviation;     ///< ISA temperature deviation in K
+} WeatherSample;
+
+/**
+ * @brief Turbulence state of all simulated aircraft, slot 0 is the player's aircraft.
+ */
+extern TurbulenceField globalTurbulence;
+
+/**
+ * @brief Initialize the weather, allocates the turbulence state and starts the weather simulation.
+ *
+ * @param aircraftCount Number of aircraft that get a turbulence slot.
+ * @param severity Turbulence severity.
+ * @return 1 on success, 0 on failure.
+ */
+int initWeather(int aircraftCount, TurbulenceSeverity severity);
+
+/**
+ * @brief Stop the weather simulation and free the weather state (turbulence and the wind field, if one is loaded).
+ */
+void freeWeather(void);
+
+/**
+ * @brief Load a gridded wind field, getWindVector() samples it instead of the analytic wind from then on.
+ *
+ * @param path Path to the wind field file (see windField.h for the format).
+ * @return 1 on success, 0 if the file can't be loaded (the analytic wind stays in use).
+ */
+int loadWindField(const char *path);
+
+/**
+ * @brief Advance the weather to the simulation time, call once per frame.
+ *
+ * Streams the wind field and interpolates the simulated weather for this frame.
+ *
+ * @param simulationTime The simulation time in seconds.
+ * @param focusX x position of the player's aircraft in m, the weather simulation is centred on it.
+ * @param focusZ z position of the player's aircraft in m.
+ */
+void updateWeather(float simulationTime, float focusX, float focusZ);
+
+/**
+* @brief Calculates the wind vector at a given position and time.
 *
-* This function returns a Vector3 representing the wind direction and speed
-* at a specified altitude and time. The wind vector is used in the physics
+* This function returns a Vector3 representing the mean wind direction and speed
+* at a specified position and time. The wind vector is used in the physics
 * calculations of the flight simulator to simulate realistic flight conditions.
+* Gusts are not included, see getTurbulenceVector().
 *
+* @param x The x position at which to calculate the wind vector (in meters).
 * @param altitude The altitude at which to calculate the wind vector (in meters).
+* @param z The z position at which to calculate the wind vector (in meters).
 * @param time The time at which to calculate the wind vector (in seconds).
 * @return A Vector3 representing the wind direction and speed.
 */
-Vector3 getWindVector(float altitude, float time);
+Vector3 getWindVector(float x, float altitude, float z, float time);
+
+/**
+ * @brief Sample the full weather at a position: getWindVector() plus the simulated weather of this frame.
+ *
+ * @param x The x position in meters.
+ * @param altitude The altitude in meters.
+ * @param z The z position in meters.
+ * @param time The simulation time in seconds.
+ * @return The WeatherSample at that position.
+ */
+WeatherSample sampleWeather(float x, float altitude, float z, float time);
 
 #endif // WEATHER_H
\ No newline at end of file
@@ -0,0 +1,115 @@
+/**
+ * @file weatherSim.h
+ * @brief Slowly evolving weather, simulated at a low rate on a worker thread.
+ *
+ * The worker advances pressure systems, wind shear layers, gust fronts and the ISA temperature deviation
+ * in steps of WEATHER_STEP seconds of simulation time and publishes them as immutable snapshots.
+ * Once per frame the main loop interpolates between the two snapshots around the current time,
+ * the physics and the HUD then only read that interpolated snapshot.
+ */
+
+#ifndef WEATHER_SIM_H
+#define WEATHER_SIM_H
+
+// Include physics.h for Vector3 definition
+#include "physics.h"
+
+// Include necessary libraries
+#include <stdint.h>
+
+/**
+ * @def WEATHER_STEP
+ * @brief Simulation time between two weather snapshots in seconds (2 Hz).
+ */
+#define WEATHER_STEP 0.5f
+
+#define WEATHER_PRESSURE_SYSTEMS 4 // pressure systems around the aircraft
+#define WEATHER_SHEAR_LAYERS 3 // wind shear layers
+
+/**
+ * @struct PressureSystem
+ * @brief A high or low pressure system, the wind circulates around its centre.
+ */
+typedef struct {
+    float x, z;             ///< Centre in m
+    float invRadius;        ///< 1 / radius of maximum wind, 1/m
+    float strength;         ///< Maximum wind in m/s, positive for lows, negative for highs
+    float targetStrength;   ///< Strength the system develops towards, 0 while it dissipates
+} PressureSystem;
+
+/**
+ * @struct ShearLayer
+ * @brief A layer over which the wind changes, everything above it gets the extra wind.
+ */
+typedef struct {
+    float baseAltitude;     ///< Bottom of the layer in m
+    float invThickness;     ///< 1 / thickness of the layer, 1/m
+    float windX, windZ;     ///< Wind added above the layer in m/s
+} ShearLayer;
+
+/**
+ * @struct GustFront
+ * @brief Outflow boundary of a thunderstorm moving across the area.
+ */
+typedef struct {
+    float normalX, normalZ; ///< Direction the front moves in (unit vector)
+    float distance;         ///< Position of the front along its normal in m
+    float speed;            ///< Speed of the front in m/s
+    float strength;         ///< Outflow wind behind the front in m/s, 0 when there's no front
+    float targetStrength;   ///< Strength the front develops towards
+    float invDepth;         ///< 1 / height of the outflow, 1/m
+} GustFront;
+
+/**
+ * @struct WeatherSnapshot
+ * @brief The weather at one point in time. Published snapshots are never modified.
+ */
+typedef struct WeatherSnapshot {
+    float time;                                                 ///< Simulation time in s
+    float temperatureDeviation;                                 ///< ISA temperature deviation in K
+    PressureSystem pressureSystems[WEATHER_PRESSURE_SYSTEMS];   ///< Pressure systems, inactive ones have strength 0
+    ShearLayer shearLayers[WEATHER_SHEAR_LAYERS];               ///< Shear layers, lowest first
+    GustFront gustFront;                                        ///< Gust front, strength 0 when inactive
+} WeatherSnapshot;
+
+/**
+ * @brief Create the initial weather and start the worker thread.
+ *
+ * @param seed Seed of the weather's random events.
+ * @return 1 on success, 0 on failure.
+ */
+int startWeatherSimulation(uint32_t seed);
+
+/**
+ * @brief Stop the worker thread.
+ */
+void stopWeatherSimulation(void);
+
+/**
+ * @brief Pick up new snapshots and interpolate the weather for this frame, call once per frame.
+ *
+ * @param simulationTime The simulation time in seconds.
+ * @param focusX x position the weather is centred on (the player's aircraft) in m.
+ * @param focusZ z position the weather is centred on in m.
+ */
+void updateWeatherSimulation(float simulationTime, float focusX, float focusZ);
+
+/**
+ * @brief Get the weather interpolated for the current frame.
+ *
+ * @return Pointer to the snapshot (calm weather if the simulation isn't running).
+ */
+const WeatherSnapshot *getCurrentWeather(void);
+
+/**
+ * @brief Wind from the pressure systems, shear layers and gust front at a position.
+ *
+ * @param weather Pointer to the WeatherSnapshot to sample.
+ * @param x Position along x in m.
+ * @param altitude Altitude in m.
+ * @param z Position along z in m.
+ * @return The wind vector in m/s.
+ */
+Vector3 sampleWeatherWind(const WeatherSnapshot *weather, float x, float altitude, float z);
+
+#endif // WEATHER_SIM_H
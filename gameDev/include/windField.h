@@ -0,0 +1,135 @@
+/**
+ * @file windField.h
+ * @brief Gridded 3D wind field, memory mapped from a binary file.
+ *
+ * The file is mapped instead of read, so only the pages that are actually sampled end up in RAM
+ * and fields of hundreds of MB open instantly. A background thread prefetches the next time slice
+ * while the current one is being flown through, so the physics tick never waits on the disk.
+ *
+ * File format (little endian):
+ * - WindFieldHeader (64 bytes) at offset 0.
+ * - Samples from WIND_FIELD_DATA_OFFSET, one block per time slice, each block laid out as
+ *   [altitude][z][x] of WindFieldSample.
+ */
+
+#ifndef WIND_FIELD_H
+#define WIND_FIELD_H
+
+// Include physics.h for Vector3 definition
+#include "physics.h"
+
+// Include necessary libraries
+#include <stdint.h>
+#include <stddef.h>
+#include <SDL2/SDL.h>
+
+/**
+ * @def WIND_FIELD_MAGIC
+ * @brief First four bytes of a wind field file.
+ */
+#define WIND_FIELD_MAGIC "WFLD"
+#define WIND_FIELD_VERSION 1
+#define WIND_FIELD_DATA_OFFSET 4096 // samples start on a page boundary
+
+/**
+ * @struct WindFieldHeader
+ * @brief Header of a wind field file.
+ */
+typedef struct {
+    char magic[4];          ///< WIND_FIELD_MAGIC
+    uint32_t version;       ///< WIND_FIELD_VERSION
+    uint32_t nx, ny, nz;    ///< Grid points along x, altitude and z (at least 2 each)
+    uint32_t nt;            ///< Number of time slices (at least 1)
+    float originX;          ///< x of the first grid point in m
+    float originY;          ///< Altitude of the first grid point in m
+    float originZ;          ///< z of the first grid point in m
+    float dx, dy, dz;       ///< Grid spacing in m
+    float startTime;        ///< Simulation time of the first slice in s
+    float timeStep;         ///< Time between slices in s
+    uint32_t reserved[2];   ///< Must be 0
+} WindFieldHeader;
+
+/**
+ * @struct WindFieldSample
+ * @brief Wind at one grid point, in the simulator's axes (x forward, y up, z right).
+ */
+typedef struct {
+    float x, y, z; ///< Wind components in m/s
+} WindFieldSample;
+
+/**
+ * @struct WindField
+ * @brief An open wind field.
+ */
+typedef struct WindField {
+    // Mapping
+    const unsigned char *mapping;       ///< Start of the mapped file
+    size_t mappingSize;                 ///< Size of the mapped file in bytes
+    #ifdef _WIN32
+        void *fileHandle;               ///< HANDLE of the file
+        void *mappingHandle;            ///< HANDLE of the file mapping
+    #else
+        int fileDescriptor;             ///< Descriptor of the file
+    #endif
+
+    // Grid, everything the sampler needs without going back to the header
+    const WindFieldSample *samples;     ///< First sample of the first slice
+    size_t sliceSamples;                ///< Samples per time slice
+    int strideZ, strideY;               ///< Samples between neighbours along z and altitude
+    int lastCellX, lastCellY, lastCellZ; ///< Index of the last grid cell along each axis
+    int lastSlice;                      ///< Index of the last time slice
+    float originX, originY, originZ;    ///< Position of the first grid point in m
+    float invDx, invDy, invDz;          ///< 1 / grid spacing
+    float startTime;                    ///< Time of the first slice in s
+    float invTimeStep;                  ///< 1 / time between slices (0 for a single slice)
+
+    // Streaming
+    SDL_Thread *streamThread;           ///< Prefetches time slices
+    SDL_sem *streamRequest;             ///< Posted when the current slice changes
+    SDL_atomic_t requestedSlice;        ///< Slice the simulation is currently in
+    SDL_atomic_t quit;                  ///< Tells the stream thread to exit
+    int currentSlice;                   ///< Last slice passed to the stream thread (simulation thread only)
+} WindField;
+
+/**
+ * @brief Open and map a wind field file, and start streaming its first slices.
+ *
+ * @param field Pointer to the WindField structure.
+ * @param path Path to the wind field file.
+ * @return 1 on success, 0 if the file can't be opened or isn't a valid wind field.
+ */
+int openWindField(WindField *field, const char *path);
+
+/**
+ * @brief Stop streaming and unmap the wind field.
+ *
+ * @param field Pointer to the WindField structure.
+ */
+void closeWindField(WindField *field);
+
+/**
+ * @brief Tell the stream thread which time slice the simulation is in, call once per frame.
+ *
+ * Only wakes the stream thread when the slice changes.
+ *
+ * @param field Pointer to the WindField structure.
+ * @param time Simulation time in s.
+ */
+void updateWindFieldStreaming(WindField *field, float time);
+
+/**
+ * @brief Sample the wind field (trilinear in space, linear in time).
+ *
+ * Positions outside the grid and times outside the slices are clamped to the edge.
+ * Doesn't allocate and doesn't lock, it's meant to be called per aircraft per tick.
+ *
+ * @param field Pointer to the WindField structure.
+ * @param x Position along x in m.
+ * @param altitude Altitude in m.
+ * @param z Position along z in m.
+ * @param time Simulation time in s.
+ * @return The wind vector in m/s.
+ */
+Vector3 sampleWindField(const WindField *field, float x, float altitude, float z, float time);
+
+#endif // WIND_FIELD_H
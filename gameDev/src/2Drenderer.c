@@ -8,11 +8,28 @@
 
 // Include the header file
 #include "2Drenderer.h"
+#include "fontManager.h"
+#include "renderBatch.h"
+#include "hudWidgets.h"
+#include "capture.h"
+#include "rasterizer.h"
+#include "renderGovernor.h"
+#include "stripChart.h"
+#include "groundTrack.h"
+#include "tacticalDisplay.h"
+#include "syntheticTraffic.h"
+#include "hudTape.h"
+#include "attitudeIndicator.h"
+#include "logger.h"
 
 // Include the necessary libraries
 #include <stdlib.h>
 #include <math.h>
 #include <stdio.h>
+#include <stdint.h>
+#include <float.h>
+#include <string.h>
+#include <time.h>
 
 // SCREEN SIZE
 #define SCREEN_WIDTH 1000
@@ -38,7 +55,12 @@
 // SDL2 variables
 static SDL_Window *window = NULL;
 static SDL_Renderer *renderer = NULL;
-static TTF_Font *font = NULL;
+
+// Fonts (handles from the font manager)
+#define FONT_PATH "fonts/Oswald/Oswald-Medium.ttf"
+static int font = -1; // flight info text, size 18
+static int smallFont = -1; // gauge numbers, size 12
+static int bigFont = -1; // gauge readouts, size 50
 
 // Positioning
 #define LEFT_GAP 20
@@ -46,10 +68,195 @@ static TTF_Font *font = NULL;
 #define TOP_GAP 20
 #define GAP 25
 
+// Static part of a gauge (circle, ticks, numbers, labels), rendered once into a target texture
+typedef struct {
+    SDL_Texture *texture;   // NULL until the first frame, or if the renderer can't render to textures
+    int radius;             // parameters the texture was drawn with
+    int numTicks;
+    float maxValue;
+    int labelFont;
+    int valid;              // 0 if it has to be drawn again
+} GaugeLayer;
+
+// Draws the static part of a gauge centred on (cx, cy)
+typedef void (*GaugeBackgroundFunction)(SDL_Renderer *localRenderer, int labelFont, int cx, int cy, int radius, float maxValue);
+
+static GaugeLayer speedGaugeLayer;
+static GaugeLayer fuelGaugeLayer;
+
+// Gauge layouts
+#define SPEED_GAUGE_TICKS 26
+#define SPEED_GAUGE_START_ANGLE -70.0f
+#define SPEED_GAUGE_END_ANGLE 250.0f
+#define FUEL_GAUGE_TICKS 5
+#define FUEL_GAUGE_START_ANGLE -190.0f
+#define FUEL_GAUGE_END_ANGLE 10.0f
+
+// Change detection: everything the HUD shows in a frame is recorded as items, only items that changed are redrawn
+#define MAX_HUD_ITEMS 128
+#define MAX_HUD_TEXT 128
+#define MAX_DIRTY_RECTS 8
+
+typedef enum {
+    HUD_ITEM_TEXT,
+    HUD_ITEM_SPEED_GAUGE,
+    HUD_ITEM_FUEL_GAUGE,
+    HUD_ITEM_THROTTLE,
+    HUD_ITEM_CHART,
+    HUD_ITEM_MAP,
+    HUD_ITEM_SCOPE,
+    HUD_ITEM_SPEED_TAPE,
+    HUD_ITEM_ALTITUDE_TAPE,
+    HUD_ITEM_HEADING_TAPE,
+    HUD_ITEM_ATTITUDE
+} HudItemKind;
+
+typedef struct {
+    HudItemKind kind;
+    SDL_Rect bounds;            // screen area the item covers
+    uint64_t hash;              // everything visible about the item
+    int x, y;                   // text position, gauge centre or bar corner
+    int radius;
+    int chart;                  // charts: which FlightChart, tapes: which HudTape
+    float value, maxValue;
+    SDL_Color color;
+    char text[MAX_HUD_TEXT];
+} HudItem;
+
+static HudItem hudItems[MAX_HUD_ITEMS]; // this frame
+static int hudItemCount = 0;
+static SDL_Rect previousItemBounds[MAX_HUD_ITEMS]; // last drawn frame
+static uint64_t previousItemHashes[MAX_HUD_ITEMS];
+static int previousItemCount = 0;
+static SDL_Texture *hudTexture = NULL; // the last drawn frame, dirty regions are redrawn into it
+static int hudTextureFailed = 0; // set once the texture couldn't be created, so it isn't retried every frame
+static int hudFullRedraw = 1;
+
+static void addHudText(const char *text, int x, int y, SDL_Color color); // renderText() records through it
+
+// Widget tree of the HUD, built on the first frame
+#define RATE_EVERY_FRAME 0  // update intervals in milliseconds
+#define RATE_50HZ 20
+#define RATE_10HZ 100
+#define RATE_4HZ 250
+#define RATE_2HZ 500
+#define RATE_1HZ 1000
+
+static Widget *hudRoot = NULL;
+static Widget *textModePanel = NULL; // aircraft info (text mode)
+static Widget *gaugePanel = NULL; // gauges (visual mode)
+static Widget *controlsPanel = NULL;
+static Widget *debugPanel = NULL;
+static Widget *pausedLabel = NULL; // shown while the simulation is paused
+static char hudTitle[MAX_WIDGET_TEXT]; // "=== <aircraft> INFO ==="
+
+// What the value sources read, set at the start of every frame (the HUD never reads the live simulation)
+static SimulationSnapshot hudSnapshot;
+static const AircraftState *hudAircraft = &hudSnapshot.aircraft;
+static const AircraftData *hudAircraftData = NULL;
+static float hudFps = 0.0f;
+
+// Strip charts (debug view, text mode), fed with every physics tick
+#define CHART_X (RIGHT_GAP - 270)
+#define CHART_Y 110
+#define CHART_WIDTH 256
+#define CHART_HEIGHT 75 // including the space below it
+#define CHART_SPACING 7
+#define CHART_TITLE_HEIGHT 18
+
+typedef enum {
+    CHART_ALTITUDE,
+    CHART_SPEED,
+    CHART_MACH,
+    CHART_AOA,
+    CHART_FORCES,
+    CHART_FUEL,
+    FLIGHT_CHARTS
+} FlightChartKind;
+
+typedef struct {
+    const char *title;
+    const char *unit;
+    int decimals;               // of the readout
+    int seriesCount;            // 1, or 2 lines on the same scale
+    StripChart series[2];       // samples in the unit shown
+    SDL_Color colors[2];
+} FlightChart;
+
+static FlightChart flightCharts[FLIGHT_CHARTS];
+static Widget *chartPanel = NULL;
+
+// Ground track map (visual mode, between the position and the gauges), centred on the aircraft, north up
+#define MAP_X 200
+#define MAP_Y 15
+#define MAP_WIDTH 220
+#define MAP_HEIGHT 200
+#define MAP_MAX_ZOOM 12 // 1 m per pixel * 2^zoom, up to 4 km per pixel
+#define MAP_DEFAULT_ZOOM 4 // 16 m per pixel, 3.5 km across
+#define GROUND_TRACK_MAP FLIGHT_CHARTS // chart style of the map
+
+typedef struct {
+    SDL_Rect clip;          // inside the frame
+    float centreX, centreZ; // aircraft position in m
+    float pixelSize;        // m per pixel
+} MapProjection;
+
+static GroundTrack groundTrack;
+static int mapZoom = MAP_DEFAULT_ZOOM; // '+' and '-'
+static int mapPointsDrawn = 0; // track points visited by the last map drawn
+
+// Tactical display ('t'), the aircraft among synthetic traffic, shares the map's zoom
+#define SCOPE_X LEFT_GAP
+#define SCOPE_Y 180
+#define SCOPE_WIDTH 670
+#define SCOPE_HEIGHT 410
+#define TACTICAL_SCOPE (FLIGHT_CHARTS + 1) // chart style of the scope
+#define DEFAULT_TRAFFIC 1000 // aircraft, HUD_TRAFFIC=<n> changes it
+#define TRAFFIC_SEED 1
+
+static Widget *tacticalPanel = NULL;
+static float trafficTime = 0.0f; // simulation time the traffic was moved to
+
+// Attitude indicator (visual mode, under the heading tape), its geometry is built once at startup
+#define ATTITUDE_X 563 // centre
+#define ATTITUDE_Y 240
+#define ATTITUDE_SIZE 116
+
+// Airspeed, altitude and heading tapes (visual mode, between the throttle and the fuel gauge), rendered once at startup
+#define SPEED_TAPE_X 505
+#define ALTITUDE_TAPE_X 566
+#define VERTICAL_TAPE_Y 304
+#define VERTICAL_TAPE_WIDTH 56
+#define VERTICAL_TAPE_HEIGHT 266
+#define HEADING_TAPE_X 440
+#define HEADING_TAPE_Y 140
+#define HEADING_TAPE_WIDTH 240
+#define HEADING_TAPE_HEIGHT 36
+#define TAPE_BOX_SIZE 24 // height of the value box on vertical tapes
+#define TAPE_BOX_WIDTH 48 // width of the value box on the heading tape
+
+typedef enum {
+    TAPE_SPEED,
+    TAPE_ALTITUDE,
+    TAPE_HEADING,
+    HUD_TAPES
+} HudTapeKind;
+
+static HudTape hudTapes[HUD_TAPES];
+
+// Frame capture ('r' starts and stops it)
+#define CAPTURE_FORMAT CAPTURE_Y4M
+#define CAPTURE_EXTENSION "y4m"
+
 // Toggles for different modes
 static int debugMode = 0; // Toggle for debug mode
 static int controlsMode = 1; // Toggle controls mode
 static int textMode = 1; // Toggle mode (1 = text, 0 = visual)
+static int tacticalMode = 0; // Toggle tactical display (replaces the text or visual mode)
+
+// Set by the render quality governor
+static int uncachedGaugeNumbers = 1; // numbers on gauge backgrounds drawn every time (no cached texture)
+static int skipGaugeNumbers = 0; // drawNumbers() does nothing while set
 
 /*
     #########################################################
@@ -82,6 +289,37 @@ static int textMode = 1; // Toggle mode (1 = text, 0 = visual)
 //     *netForce = *engineOutput - *totalDrag;
 // }
 
+// Numbers of the heading tape: tens of degrees, the cardinal points as letters
+static void formatHeadingTick(char *text, size_t size, float value) {
+    const int heading = (int)lroundf(value) % 360;
+    const char *cardinal[] = {"N", "E", "S", "W"};
+    if (heading % 90 == 0) {
+        snprintf(text, size, "%s", cardinal[heading / 90]);
+    }
+    else {
+        snprintf(text, size, "%02d", heading / 10);
+    }
+}
+
+static void initHudTapes(void) {
+    const SDL_Color green = {GREEN};
+    const TapeScale scales[HUD_TAPES] = {
+        {0.0f, 2500.0f, 2.0f, 10.0f, 50.0f, VERTICAL_TAPE_WIDTH, 0, 0, 1, green, NULL},     // km/h, ticks towards the middle of the screen
+        {0.0f, 32767.0f, 0.2f, 100.0f, 500.0f, VERTICAL_TAPE_WIDTH, 0, 0, 0, green, NULL},  // m
+        {0.0f, 360.0f, 4.0f, 5.0f, 10.0f, HEADING_TAPE_HEIGHT, 1, 1, 1, green, formatHeadingTick} // degrees
+    };
+
+    TTF_Font *tapeFont = TTF_OpenFont(FONT_PATH, 12); // only needed until the strips are rendered
+    if (tapeFont == NULL) {
+        logMessage(LOG_WARNING, "Failed to open the tape font: %s", TTF_GetError());
+        return;
+    }
+    for (int i = 0; i < HUD_TAPES; i++) {
+        createHudTape(&hudTapes[i], renderer, tapeFont, &scales[i]);
+    }
+    TTF_CloseFont(tapeFont);
+}
+
 void initTextRenderer(void) {
     SDL_Init(SDL_INIT_VIDEO); // Initialize SDL2 video subsystem
     TTF_Init(); // Initialize SDL2_ttf library
@@ -91,35 +329,54 @@ void initTextRenderer(void) {
     
     // Create an SDL renderer for the window with hardware acceleration
     renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+    if (renderer == NULL) {
+        renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE); // No GPU, SDL's software renderer
+    }
 
-    // Load the font from the specified path with a size of 18
-    font = TTF_OpenFont("fonts/Oswald/Oswald-Medium.ttf", 18);
+    // Without a GPU the HUD is drawn by our own CPU rasterizer, HUD_RENDERER=cpu or HUD_RENDERER=sdl overrides the choice
+    SDL_RendererInfo rendererInfo;
+    const char *backend = SDL_getenv("HUD_RENDERER");
+    int useRasterizer = (SDL_GetRendererInfo(renderer, &rendererInfo) == 0 && (rendererInfo.flags & SDL_RENDERER_SOFTWARE)); // Software renderer?
+    if (backend != NULL) {
+        useRasterizer = (strcmp(backend, "cpu") == 0);
+    }
+    if (useRasterizer && initRasterizer(renderer, SCREEN_WIDTH, SCREEN_HEIGHT)) {
+        logMessage(LOG_INFO, "The HUD is drawn by the CPU rasterizer.");
+    }
+
+    // Everything is recorded into the command buffer and drawn at the end of the frame
+    initRenderBatch(renderer);
+
+    // Open the fonts once, each one gets its own glyph atlas
+    initFontManager(renderer);
+    font = loadFont(FONT_PATH, 18);
+    smallFont = loadFont(FONT_PATH, 12);
+    bigFont = loadFont(FONT_PATH, 50);
+    initTacticalDisplay(renderer, FONT_PATH, 12); // Altitude tags of the tactical display
+    initHudTapes(); // Render the tapes once
+    initAttitudeIndicator(ATTITUDE_SIZE); // Build the attitude indicator
     
     // Check if the font failed to load
-    if (!font) {
+    if (font < 0 || smallFont < 0 || bigFont < 0) {
         printf("Failed to load font!\n"); // Print error message
         exit(1); // Exit the program with an error code
     }
 }
 
 void renderText(const char *text, int x, int y, SDL_Color color) {
-    // Render the text to an SDL surface using the specified font and color
-    SDL_Surface *surface = TTF_RenderUTF8_Solid(font, text, color);
-    
-    // Create a texture from the rendered surface
-    SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
-    
-    // Define the rectangle where the text will be rendered
-    SDL_Rect rect = {x, y, surface->w, surface->h};
+    // Record the line, it's only drawn at the end of the frame if it changed
+    addHudText(text, x, y, color);
+}
 
-    // Copy the texture to the renderer at the specified rectangle
-    SDL_RenderCopy(renderer, texture, NULL, &rect);
-    
-    // Free the surface as it is no longer needed
-    SDL_FreeSurface(surface);
-    
-    // Destroy the texture to free up resources
-    SDL_DestroyTexture(texture);
+static void toggleCapture(void) {
+    if (isCapturing()) {
+        stopCapture();
+        return;
+    }
+
+    char path[64];
+    snprintf(path, sizeof(path), "capture_%ld.%s", (long)time(NULL), CAPTURE_EXTENSION);
+    startCapture(path, CAPTURE_FORMAT, SCREEN_WIDTH, SCREEN_HEIGHT, TARGET_FPS);
 }
 
 void toggleModes(SDL_Event event) {
@@ -137,11 +394,44 @@ void toggleModes(SDL_Event event) {
         if (event.key.keysym.sym == SDLK_m) {
             textMode = !textMode;
         }
+        // Toggle the tactical display if 't' key is pressed
+        if (event.key.keysym.sym == SDLK_t) {
+            tacticalMode = !tacticalMode;
+        }
+        // Start/stop recording the HUD if 'r' key is pressed
+        if (event.key.keysym.sym == SDLK_r) {
+            toggleCapture();
+        }
+        // Zoom the ground track map in/out with '+' and '-'
+        if ((event.key.keysym.sym == SDLK_EQUALS || event.key.keysym.sym == SDLK_KP_PLUS) && mapZoom > 0) {
+            mapZoom--;
+        }
+        if ((event.key.keysym.sym == SDLK_MINUS || event.key.keysym.sym == SDLK_KP_MINUS) && mapZoom < MAP_MAX_ZOOM) {
+            mapZoom++;
+        }
     }
 }
 
 void destroyTextRenderer(void) {
-    TTF_CloseFont(font); // Close the font
+    stopCapture(); // Write the rest of the recording
+    invalidateGaugeLayers(); // Destroy the cached gauge backgrounds
+    if (hudTexture != NULL) {
+        SDL_DestroyTexture(hudTexture); // Destroy the last frame
+        hudTexture = NULL;
+    }
+    hudTextureFailed = 0;
+    destroyWidgets(); // The HUD is built again on the next frame
+    hudRoot = NULL;
+    freeGroundTrack(&groundTrack); // Free the recorded track
+    destroySyntheticTraffic(); // Free the traffic
+    destroyTacticalDisplay(); // Free the contacts and the label atlas
+    for (int i = 0; i < HUD_TAPES; i++) {
+        freeHudTape(&hudTapes[i]); // Destroy the tape tiles
+    }
+    destroyAttitudeIndicator(); // Drop the attitude indicator geometry
+    destroyFontManager(); // Close the fonts and destroy the glyph atlases
+    destroyRenderBatch(); // Free the command buffer
+    destroyRasterizer(); // Free the framebuffer (if the CPU rasterizer was used)
     SDL_DestroyRenderer(renderer); // Destroy the renderer
     SDL_DestroyWindow(window); // Destroy the window
     TTF_Quit(); // Quit the SDL_ttf library
@@ -157,7 +447,8 @@ void destroyTextRenderer(void) {
 */
 
 void drawCircle(SDL_Renderer *localRenderer, int32_t centreX, int32_t centreY, int32_t radius) {
-    SDL_SetRenderDrawColor(localRenderer, GREEN);  // Set the drawing color to green
+    (void)localRenderer; // recorded into the command buffer
+    const SDL_Color color = {GREEN};  // Draw the circle in green
 
     const int32_t diameter = (radius * 2);  // Calculate the diameter of the circle
 
@@ -169,14 +460,14 @@ void drawCircle(SDL_Renderer *localRenderer, int32_t centreX, int32_t centreY, i
 
     while (x >= y) {  // Loop until x is less than y
         // Each of the following renders an octant of the circle
-        SDL_RenderDrawPoint(localRenderer, centreX + x, centreY - y);  // Draw point in octant 1
-        SDL_RenderDrawPoint(localRenderer, centreX + x, centreY + y);  // Draw point in octant 2
-        SDL_RenderDrawPoint(localRenderer, centreX - x, centreY - y);  // Draw point in octant 3
-        SDL_RenderDrawPoint(localRenderer, centreX - x, centreY + y);  // Draw point in octant 4
-        SDL_RenderDrawPoint(localRenderer, centreX + y, centreY - x);  // Draw point in octant 5
-        SDL_RenderDrawPoint(localRenderer, centreX + y, centreY + x);  // Draw point in octant 6
-        SDL_RenderDrawPoint(localRenderer, centreX - y, centreY - x);  // Draw point in octant 7
-        SDL_RenderDrawPoint(localRenderer, centreX - y, centreY + x);  // Draw point in octant 8
+        batchPoint(BATCH_LAYER_SHAPES, centreX + x, centreY - y, color);  // Draw point in octant 1
+        batchPoint(BATCH_LAYER_SHAPES, centreX + x, centreY + y, color);  // Draw point in octant 2
+        batchPoint(BATCH_LAYER_SHAPES, centreX - x, centreY - y, color);  // Draw point in octant 3
+        batchPoint(BATCH_LAYER_SHAPES, centreX - x, centreY + y, color);  // Draw point in octant 4
+        batchPoint(BATCH_LAYER_SHAPES, centreX + y, centreY - x, color);  // Draw point in octant 5
+        batchPoint(BATCH_LAYER_SHAPES, centreX + y, centreY + x, color);  // Draw point in octant 6
+        batchPoint(BATCH_LAYER_SHAPES, centreX - y, centreY - x, color);  // Draw point in octant 7
+        batchPoint(BATCH_LAYER_SHAPES, centreX - y, centreY + x, color);  // Draw point in octant 8
 
         if (error <= 0) {  // If the error term is non-positive
             ++y;  // Increment y
@@ -196,7 +487,8 @@ void drawTicks(SDL_Renderer *localRenderer, int centerX, int centerY, int radius
     // Calculate the angle step
     float angleStep = (endAngle - startAngle) / (float)(numTicks - 1);
 
-    SDL_SetRenderDrawColor(localRenderer, GREEN);  // Green color for the ticks
+    (void)localRenderer; // recorded into the command buffer
+    const SDL_Color color = {GREEN};  // Green color for the ticks
     for (int i = 0; i < numTicks; i++) {
         float angle = startAngle + (angleStep * (float)i);  // Calculate the angle for each tick
         int tickLength = 20;
@@ -213,17 +505,19 @@ void drawTicks(SDL_Renderer *localRenderer, int centerX, int centerY, int radius
         int tickStartY = (int)((float)centerY + (float)radius * sinf(rad));
 
         // Draw the tick line
-        SDL_RenderDrawLine(localRenderer, tickStartX, tickStartY, tickEndX, tickEndY);
+        batchLine(BATCH_LAYER_SHAPES, tickStartX, tickStartY, tickEndX, tickEndY, color);
     }
 }
 
 void drawNumbers(SDL_Renderer *localRenderer, int centerX, int centerY, int radius, int numTicks, float maxValue, float startAngle, float endAngle) {
-    TTF_Font *localFont = TTF_OpenFont("fonts/Oswald/Oswald-Medium.ttf", 12);
+    if (skipGaugeNumbers) {
+        return; // the render quality governor dropped them
+    }
 
     // Calculate the angle step
     float angleStep = (endAngle - startAngle) / (float)(numTicks - 1);
 
-    SDL_SetRenderDrawColor(localRenderer, GREEN);  // Set the number color to GREEN
+    (void)localRenderer; // text goes through the font manager's batch
     for (int i = 0; i < numTicks; i++) {
         float angle = startAngle + (angleStep * (float)i);  // Calculate the angle for each number
 
@@ -239,37 +533,19 @@ void drawNumbers(SDL_Renderer *localRenderer, int centerX, int centerY, int radi
         char numberStr[10];
         sprintf(numberStr, "%.0f", (float)i * maxValue/(float)(numTicks-1)); // Display 0, maxValue/26, ...
 
-        // Render the text
-        SDL_Color textColor = {GREEN};  // Text color 
-        SDL_Surface* textSurface = TTF_RenderText_Solid(localFont, numberStr, textColor);
-        if (textSurface == NULL) { // Check if the text surface was created successfully
-            printf("Unable to render text surface! SDL_ttf Error: %s\n", TTF_GetError());
-            continue;
-        }
-
-        // Create a texture from the text surface
-        SDL_Texture* textTexture = SDL_CreateTextureFromSurface(localRenderer, textSurface);
-        SDL_FreeSurface(textSurface);
-
         // Get the text's width and height
+        SDL_Color textColor = {GREEN};  // Text color 
         int textWidth = 0;
         int textHeight = 0;
-        SDL_QueryTexture(textTexture, NULL, NULL, &textWidth, &textHeight);
-
-        // Set the destination rectangle (position the number)
-        SDL_Rect renderQuad = {numberPosX - textWidth / 2, numberPosY - textHeight / 2, textWidth, textHeight};
-
-        // Render the number
-        SDL_RenderCopy(localRenderer, textTexture, NULL, &renderQuad);
+        measureText(smallFont, numberStr, &textWidth, &textHeight);
 
-        // Free the texture
-        SDL_DestroyTexture(textTexture);
+        // Render the number, centred on its position
+        drawText(smallFont, numberStr, numberPosX - textWidth / 2, numberPosY - textHeight / 2, textColor);
     }
-
-    TTF_CloseFont(localFont);
 }
 
-void drawNeedle(SDL_Renderer *localRenderer, int cx, int cy, int radius, float val, float maxVal, float startAngle, float endAngle){
+// Where the needle of a gauge ends (the needle only moves on screen when this changes)
+static void getNeedleEnd(int cx, int cy, int radius, float val, float maxVal, float startAngle, float endAngle, int *needleEndX, int *needleEndY){
     // Calculate the angle for the given val
     float angle = startAngle + ((val / maxVal) * (endAngle - startAngle));
 
@@ -280,91 +556,157 @@ void drawNeedle(SDL_Renderer *localRenderer, int cx, int cy, int radius, float v
     int needleLength = radius - 30; // The needle will be a bit shorter than the ticks
     
     // Calculate the end position of the needle
-    int needleEndX = (int)((float)cx + (float)needleLength * cosf(rad));
-    int needleEndY = (int)((float)cy + (float)needleLength * sinf(rad));
+    *needleEndX = (int)((float)cx + (float)needleLength * cosf(rad));
+    *needleEndY = (int)((float)cy + (float)needleLength * sinf(rad));
+}
+
+void drawNeedle(SDL_Renderer *localRenderer, int cx, int cy, int radius, float val, float maxVal, float startAngle, float endAngle){
+    int needleEndX = 0;
+    int needleEndY = 0;
+    getNeedleEnd(cx, cy, radius, val, maxVal, startAngle, endAngle, &needleEndX, &needleEndY);
 
     // Draw the needle (line from the center to the calculated end point)
-    SDL_SetRenderDrawColor(localRenderer, RED);  // Red color for the needle
-    SDL_RenderDrawLine(localRenderer, cx, cy, needleEndX, needleEndY);
+    (void)localRenderer; // recorded into the command buffer
+    batchLine(BATCH_LAYER_SHAPES, cx, cy, needleEndX, needleEndY, (SDL_Color){RED});  // Red color for the needle
 }
 
 void machCounter(SDL_Renderer* localRenderer, int cx, int cy){
     // Convert speed from km/h to Mach number based on altitude
-    float mach = globalPhysicsData.machNumber;
+    float mach = hudSnapshot.machNumber;
 
     // Create a string to hold the Mach number text
     char machText[20];
     sprintf(machText, "%.2f", mach); // Format the Mach number to two decimal places
 
-    // Open the font with size 50
-    TTF_Font *localFont = TTF_OpenFont("fonts/Oswald/Oswald-Medium.ttf", 50);
+    (void)localRenderer; // text goes through the font manager's batch
 
     // Set the text color to white
     SDL_Color textColor = {WHITE};  
-    // Render the Mach number text to a surface
-    SDL_Surface* machSurface = TTF_RenderText_Solid(localFont, machText, textColor);
-    // Create a texture from the rendered surface
-    SDL_Texture* machTexture = SDL_CreateTextureFromSurface(localRenderer, machSurface);
-
-    // Get the width and height of the rendered text
-    int machWidth = machSurface->w;
-    int machHeight = machSurface->h;
+
+    // Get the width and height of the text
+    int machWidth = 0;
+    int machHeight = 0;
+    measureText(bigFont, machText, &machWidth, &machHeight);
     // Calculate the position to center the text
     int machX = cx - machWidth / 2;
     int machY = cy - machHeight - 5;  // Slightly above the center
 
-    // Define the rectangle where the text will be rendered
-    SDL_Rect machRect = {machX, machY, machWidth, machHeight};
-    // Copy the texture to the renderer at the specified rectangle
-    SDL_RenderCopy(localRenderer, machTexture, NULL, &machRect);
+    // Draw the Mach number
+    drawText(bigFont, machText, machX, machY, textColor);
+}
+
+void invalidateGaugeLayers(void) {
+    GaugeLayer *layers[] = {&speedGaugeLayer, &fuelGaugeLayer};
+
+    for (size_t i = 0; i < sizeof(layers) / sizeof(layers[0]); i++) {
+        if (layers[i]->texture != NULL) {
+            SDL_DestroyTexture(layers[i]->texture);
+        }
+        layers[i]->texture = NULL;
+        layers[i]->valid = 0;
+    }
+}
 
-    // Free the Mach texture and surface
-    SDL_DestroyTexture(machTexture);
-    SDL_FreeSurface(machSurface);
-    // Close the font
-    TTF_CloseFont(localFont);
+// Draw the gauge's static part without a cached texture, the numbers (the most text) only if the quality allows
+static void drawUncachedGaugeBackground(SDL_Renderer *localRenderer, GaugeBackgroundFunction drawBackground, int labelFont, int cx, int cy, int radius, float maxValue) {
+    skipGaugeNumbers = !uncachedGaugeNumbers;
+    drawBackground(localRenderer, labelFont, cx, cy, radius, maxValue);
+    skipGaugeNumbers = 0;
 }
 
-void renderSpeedGauge(SDL_Renderer* localRenderer, TTF_Font* localFont, int cx, int cy, int radius, float speed, float maxSpeed) {    
-    // Draw the circle for the gauge
-    drawCircle(localRenderer, cx, cy, radius);
+// Copy the gauge's static part from its texture, drawing it into the texture first if it's out of date
+static void renderGaugeLayer(SDL_Renderer *localRenderer, GaugeLayer *layer, GaugeBackgroundFunction drawBackground, int labelFont, int cx, int cy, int radius, int numTicks, float maxValue) {
+    const int centre = radius + 1; // centre of the gauge in the texture
+    const int size = 2 * centre;
 
-    const int numTicks = 26; // Number of ticks on the gauge
+    if (isRasterizerActive()) {
+        // drawing the circle, ticks and numbers touches fewer pixels than blending a cached copy would
+        drawUncachedGaugeBackground(localRenderer, drawBackground, labelFont, cx, cy, radius, maxValue);
+        return;
+    }
 
-    const float startAngle = -70.0f;
-    const float endAngle = 250.0f;
+    int changed = !layer->valid || layer->radius != radius || layer->numTicks != numTicks || layer->labelFont != labelFont || fabsf(layer->maxValue - maxValue) > 0.0f;
 
-    // Draw the ticks on the gauge
-    drawTicks(localRenderer, cx, cy, radius, numTicks, startAngle, endAngle);
+    if (changed) {
+        if (layer->texture != NULL && layer->radius != radius) {
+            SDL_DestroyTexture(layer->texture); // wrong size
+            layer->texture = NULL;
+        }
+        if (layer->texture == NULL) {
+            layer->texture = createRenderTexture(localRenderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, size, size);
+            if (layer->texture == NULL) {
+                // no render targets, draw it every frame like before
+                drawUncachedGaugeBackground(localRenderer, drawBackground, labelFont, cx, cy, radius, maxValue);
+                return;
+            }
+            SDL_SetTextureBlendMode(layer->texture, SDL_BLENDMODE_BLEND);
+        }
 
-    // Draw the numbers on the gauge
-    drawNumbers(localRenderer, cx, cy, radius, numTicks, maxSpeed, startAngle, endAngle);
+        // what's recorded so far belongs on the screen, not in the texture
+        flushText();
+        submitRenderBatch();
+
+        // the HUD may be drawing into its own texture with a clip rectangle, both are put back afterwards
+        SDL_Texture *previousTarget = SDL_GetRenderTarget(localRenderer);
+        SDL_Rect previousClip;
+        SDL_bool previousClipEnabled = SDL_RenderIsClipEnabled(localRenderer);
+        SDL_RenderGetClipRect(localRenderer, &previousClip);
+
+        SDL_SetRenderTarget(localRenderer, layer->texture);
+        SDL_RenderSetClipRect(localRenderer, NULL);
+        SDL_SetRenderDrawColor(localRenderer, 0, 0, 0, 0); // transparent
+        SDL_RenderClear(localRenderer);
+        drawBackground(localRenderer, labelFont, centre, centre, radius, maxValue);
+        flushText(); // the numbers and labels
+        submitRenderBatch();
+
+        SDL_SetRenderTarget(localRenderer, previousTarget);
+        SDL_RenderSetClipRect(localRenderer, previousClipEnabled ? &previousClip : NULL);
+
+        layer->radius = radius;
+        layer->numTicks = numTicks;
+        layer->maxValue = maxValue;
+        layer->labelFont = labelFont;
+        layer->valid = 1;
+    }
 
-    // Draw the needle indicating the current speed
-    drawNeedle(localRenderer, cx, cy, radius, speed, maxSpeed, startAngle, endAngle);
+    SDL_Rect destination = {cx - centre, cy - centre, size, size};
+    batchTexture(BATCH_LAYER_BACKGROUND, layer->texture, &destination);
+}
 
-    // Print the Mach number on the gauge
-    machCounter(localRenderer, cx, cy);
+static void drawSpeedGaugeBackground(SDL_Renderer *localRenderer, int labelFont, int cx, int cy, int radius, float maxSpeed) {
+    // Draw the circle for the gauge
+    drawCircle(localRenderer, cx, cy, radius);
+
+    // Draw the ticks on the gauge
+    drawTicks(localRenderer, cx, cy, radius, SPEED_GAUGE_TICKS, SPEED_GAUGE_START_ANGLE, SPEED_GAUGE_END_ANGLE);
+
+    // Draw the numbers on the gauge
+    drawNumbers(localRenderer, cx, cy, radius, SPEED_GAUGE_TICKS, maxSpeed, SPEED_GAUGE_START_ANGLE, SPEED_GAUGE_END_ANGLE);
 
     // Draw "km/h" text slightly above the needle center
     char unitText[] = "km/h"; // Unit text
     SDL_Color textColor = {WHITE};  // White text color
-    SDL_Surface* unitSurface = TTF_RenderText_Solid(localFont, unitText, textColor); // Render the unit text to a surface
-    SDL_Texture* unitTexture = SDL_CreateTextureFromSurface(localRenderer, unitSurface); // Create a texture from the surface
 
-    int unitWidth = unitSurface->w; // Get the width of the unit text
-    int unitHeight = unitSurface->h; // Get the height of the unit text
+    int unitWidth = 0; // Width of the unit text
+    int unitHeight = 0; // Height of the unit text
+    measureText(labelFont, unitText, &unitWidth, &unitHeight);
     int unitX = cx - unitWidth / 2; // Calculate the x position to center the text
     int unitY = cy - radius - unitHeight + 50; // Calculate the y position slightly above the needle center
 
-    // Define the rectangle where the unit text will be rendered
-    SDL_Rect unitRect = {unitX, unitY, unitWidth, unitHeight};
-    // Copy the texture to the renderer at the specified rectangle
-    SDL_RenderCopy(localRenderer, unitTexture, NULL, &unitRect);
+    // Draw the unit text
+    drawText(labelFont, unitText, unitX, unitY, textColor);
+}
+
+void renderSpeedGauge(SDL_Renderer* localRenderer, int localFont, int cx, int cy, int radius, float speed, float maxSpeed) {    
+    // Circle, ticks, numbers and unit (only drawn again if the radius or max speed change)
+    renderGaugeLayer(localRenderer, &speedGaugeLayer, drawSpeedGaugeBackground, localFont, cx, cy, radius, SPEED_GAUGE_TICKS, maxSpeed);
+
+    // Draw the needle indicating the current speed
+    drawNeedle(localRenderer, cx, cy, radius, speed, maxSpeed, SPEED_GAUGE_START_ANGLE, SPEED_GAUGE_END_ANGLE);
 
-    // Free the unit texture and surface
-    SDL_DestroyTexture(unitTexture);
-    SDL_FreeSurface(unitSurface);
+    // Print the Mach number on the gauge
+    machCounter(localRenderer, cx, cy);
 }
 
 /*
@@ -390,28 +732,29 @@ void throttleBar(SDL_Renderer *localRenderer, float throttle, int x, int y){
 
     int filledHeight = (int)((displayThrottle / 100.0f) * ((float)barHeight - (float)borderThickness * 2.0f)); // Calculate the filled height based on throttle percentage
 
+    (void)localRenderer; // recorded into the command buffer
+
     // Draw "border"
-    SDL_SetRenderDrawColor(localRenderer, GREEN); // Set color to green
     SDL_Rect border = { x, y, barWidth, barHeight }; // Define the border rectangle
-    SDL_RenderDrawRect(localRenderer, &border); // Draw the border
+    batchRect(BATCH_LAYER_SHAPES, &border, (SDL_Color){GREEN}); // Draw the border in green
 
-    // Fill it in to give the illusion of an empty throttle
-    SDL_SetRenderDrawColor(localRenderer, BLACK); // Set color to black
+    // Fill it in to give the illusion of an empty throttle (below the filled portion)
     SDL_Rect background = { x + borderThickness, y + borderThickness, 
                             barWidth - borderThickness * 2, barHeight - borderThickness * 2 }; // Define the background rectangle
-    SDL_RenderFillRect(localRenderer, &background); // Fill the background
+    batchFillRect(BATCH_LAYER_BACKGROUND, &background, (SDL_Color){BLACK}); // Fill the background in black
 
     // Draw filled portion
+    SDL_Color fillColor;
     if (afterburner){
-        SDL_SetRenderDrawColor(localRenderer, RED); // Set color to red if afterburner is active
+        fillColor = (SDL_Color){RED}; // Set color to red if afterburner is active
     }
     else{
-        SDL_SetRenderDrawColor(localRenderer, GREEN); // Set color to green otherwise
+        fillColor = (SDL_Color){GREEN}; // Set color to green otherwise
     }
 
     SDL_Rect filled = { x + borderThickness, y + barHeight - borderThickness - filledHeight, 
                         barWidth - borderThickness * 2, filledHeight }; // Define the filled rectangle
-    SDL_RenderFillRect(localRenderer, &filled); // Fill the rectangle
+    batchFillRect(BATCH_LAYER_SHAPES, &filled, fillColor); // Fill the rectangle
 
     // Render the throttle percentage or WEP above the bar
     SDL_Color textColor;  // Define text color
@@ -425,23 +768,14 @@ void throttleBar(SDL_Renderer *localRenderer, float throttle, int x, int y){
         sprintf(throttleText, "%.0f%%", throttle * 100); // Set text to throttle percentage
     }
 
-    TTF_Font *localFont = TTF_OpenFont("fonts/Oswald/Oswald-Medium.ttf", 18); // Open the font
-    SDL_Surface* textSurface = TTF_RenderText_Solid(localFont, throttleText, textColor); // Render the text to a surface
-    SDL_Texture* textTexture = SDL_CreateTextureFromSurface(localRenderer, textSurface); // Create a texture from the surface
-
-    int textWidth = textSurface->w; // Get the width of the text
-    int textHeight = textSurface->h; // Get the height of the text
+    int textWidth = 0; // Width of the text
+    int textHeight = 0; // Height of the text
+    measureText(font, throttleText, &textWidth, &textHeight);
     int textX = x + (barWidth - textWidth) / 2; // Calculate the x position to center the text
     int textY = y - textHeight - 5;  // Calculate the y position slightly above the bar
 
     // Render the throttle text
-    SDL_Rect textRect = {textX, textY, textWidth, textHeight}; // Define the text rectangle
-    SDL_RenderCopy(localRenderer, textTexture, NULL, &textRect); // Copy the texture to the renderer
-
-    // Free the text texture and surface
-    SDL_DestroyTexture(textTexture); // Destroy the texture
-    SDL_FreeSurface(textSurface); // Free the surface
-    TTF_CloseFont(localFont); // Close the font
+    drawText(font, throttleText, textX, textY, textColor);
 }
 
 /*
@@ -452,278 +786,900 @@ void throttleBar(SDL_Renderer *localRenderer, float throttle, int x, int y){
     #########################################################
 */
 
-void renderFuelGauge(SDL_Renderer* localRenderer, TTF_Font* localFont, int cx, int cy, int radius, float fuel, float maxFuel){
-    // consts for the drawing
-    const float startAngle = -190.0f;
-    const float endAngle = 10.0f;
-    const int tickCount = 5;
-    
+static void drawFuelGaugeBackground(SDL_Renderer *localRenderer, int labelFont, int cx, int cy, int radius, float maxValue) {
     drawCircle(localRenderer, cx, cy, radius); // Draw the outer circle
 
     // draw the ticks for the fuel gauge
-    drawTicks(localRenderer, cx, cy, radius, tickCount, startAngle, endAngle);
+    drawTicks(localRenderer, cx, cy, radius, FUEL_GAUGE_TICKS, FUEL_GAUGE_START_ANGLE, FUEL_GAUGE_END_ANGLE);
 
     // draw numbers
-    drawNumbers(localRenderer, cx, cy, radius, tickCount, maxFuel/100.0f, startAngle, endAngle);
+    drawNumbers(localRenderer, cx, cy, radius, FUEL_GAUGE_TICKS, maxValue, FUEL_GAUGE_START_ANGLE, FUEL_GAUGE_END_ANGLE);
 
-    // draw the needle
-    drawNeedle(localRenderer, cx, cy, radius, fuel/100.0f, maxFuel/100.0f, startAngle, endAngle);
+    SDL_Color textColor = {WHITE}; // Set text color to white
 
-    TTF_Font *bigFont = TTF_OpenFont("fonts/Oswald/Oswald-Medium.ttf", 50);
+    // draw FUEL text slightly below the top of the gauge
+    char fuelText2[] = "FUEL"; // text to display
+    int fuel2Width = 0; // Width of the text
+    int fuel2Height = 0; // Height of the text
+    measureText(labelFont, fuelText2, &fuel2Width, &fuel2Height);
+    int fuel2X = cx - fuel2Width / 2; // Calculate the x position to center the text
+    int fuel2Y = cy - radius - fuel2Height + 75; // Calculate the y position slightly above the needle center
+    drawText(labelFont, fuelText2, fuel2X, fuel2Y, textColor);
+
+    // draw KGS x 100 text slightly below FUEL
+    char kgsText[] = "KGS x 100"; // Unit text
+    int kgsWidth = 0; // Width of the unit text
+    int kgsHeight = 0; // Height of the unit text
+    measureText(labelFont, kgsText, &kgsWidth, &kgsHeight);
+    int kgsX = cx - kgsWidth / 2; // Calculate the x position to center the text
+    int kgsY = cy - radius - kgsHeight + 100; // Calculate the y position slightly above the needle center
+    drawText(labelFont, kgsText, kgsX, kgsY, textColor);
+}
+
+void renderFuelGauge(SDL_Renderer* localRenderer, int localFont, int cx, int cy, int radius, float fuel, float maxFuel){
+    // circle, ticks, numbers and labels (only drawn again if the radius or max fuel change)
+    renderGaugeLayer(localRenderer, &fuelGaugeLayer, drawFuelGaugeBackground, localFont, cx, cy, radius, FUEL_GAUGE_TICKS, maxFuel/100.0f);
+
+    // draw the needle
+    drawNeedle(localRenderer, cx, cy, radius, fuel/100.0f, maxFuel/100.0f, FUEL_GAUGE_START_ANGLE, FUEL_GAUGE_END_ANGLE);
 
     // print the current fuel amount
     char fuelText[20]; // Buffer for fuel text
     sprintf(fuelText, "%.1f", fuel/100.0f); // Format the fuel text
     SDL_Color textColor = {WHITE}; // Set text color to white
-    SDL_Surface* fuelSurface = TTF_RenderText_Solid(bigFont, fuelText, textColor); // Render the fuel text to a surface
-    SDL_Texture* fuelTexture = SDL_CreateTextureFromSurface(localRenderer, fuelSurface); // Create a texture from the surface
 
-    // Get the width and height of the rendered text
-    int fuelWidth = fuelSurface->w;
-    int fuelHeight = fuelSurface->h;
+    // Get the width and height of the text
+    int fuelWidth = 0;
+    int fuelHeight = 0;
+    measureText(bigFont, fuelText, &fuelWidth, &fuelHeight);
     // Calculate the position to center the text
     int fuelX = cx - fuelWidth / 2;
     int fuelY = cy - fuelHeight + 100;  // Slightly below the center
 
-    // Define the rectangle where the text will be rendered
-    SDL_Rect fuelRect = {fuelX, fuelY, fuelWidth, fuelHeight};
-    // Copy the texture to the renderer at the specified rectangle
-    SDL_RenderCopy(localRenderer, fuelTexture, NULL, &fuelRect);
+    // Draw the fuel amount
+    drawText(bigFont, fuelText, fuelX, fuelY, textColor);
+}
 
-    // draw FUEL text slightly below the top of the gauge
-    char fuelText2[] = "FUEL"; // text to display
-    SDL_Surface* fuelTextSurface = TTF_RenderText_Solid(localFont, fuelText2, textColor); // Render the unit text to a surface
-    SDL_Texture* fuelTexture2 = SDL_CreateTextureFromSurface(localRenderer, fuelTextSurface); // Create a texture from the surface
+/*
+    #########################################################
+    #                                                       #
+    #                   CHANGE DETECTION                    #
+    #                                                       #
+    #########################################################
+*/
 
-    int fuel2Width = fuelTextSurface->w; // Get the width of the unit text
-    int fuel2Height = fuelTextSurface->h; // Get the height of the unit text
-    int fuel2X = cx - fuel2Width / 2; // Calculate the x position to center the text
-    int fuel2Y = cy - radius - fuel2Height + 75; // Calculate the y position slightly above the needle center
+// FNV-1a
+static uint64_t hashBytes(uint64_t hash, const void *data, size_t size){
+    const unsigned char *bytes = data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
 
-    // Define the rectangle where the unit text will be rendered
-    SDL_Rect fuel2Rect = {fuel2X, fuel2Y, fuel2Width, fuel2Height};
-    // Copy the texture to the renderer at the specified rectangle
-    SDL_RenderCopy(localRenderer, fuelTexture2, NULL, &fuel2Rect);
+static uint64_t hashInt(uint64_t hash, int value){
+    return hashBytes(hash, &value, sizeof(value));
+}
 
-    // draw KGS x 100 text slightly below FUEL
-    char kgsText[] = "KGS x 100"; // Unit text
-    SDL_Surface* kgsTextSurface = TTF_RenderText_Solid(localFont, kgsText, textColor); // Render the unit text to a surface
-    SDL_Texture* kgsTextTexture = SDL_CreateTextureFromSurface(localRenderer, kgsTextSurface); // Create a texture from the surface
+void invalidateHUD(void) {
+    hudFullRedraw = 1;
+}
 
-    int kgsWidth = kgsTextSurface->w; // Get the width of the unit text
-    int kgsHeight = kgsTextSurface->h; // Get the height of the unit text
-    int kgsX = cx - kgsWidth / 2; // Calculate the x position to center the text
-    int kgsY = cy - radius - kgsHeight + 100; // Calculate the y position slightly above the needle center
+static void beginHudFrame(void) {
+    hudItemCount = 0;
+}
+
+static HudItem *addHudItem(HudItemKind kind){
+    if (hudItemCount >= MAX_HUD_ITEMS) {
+        return NULL;
+    }
+
+    HudItem *item = &hudItems[hudItemCount++];
+    item->kind = kind;
+    item->hash = 0xCBF29CE484222325ull ^ (uint64_t)kind;
+    return item;
+}
+
+static void addHudText(const char *text, int x, int y, SDL_Color color) {
+    HudItem *item = addHudItem(HUD_ITEM_TEXT);
+    if (item == NULL) {
+        return;
+    }
+
+    snprintf(item->text, sizeof(item->text), "%s", text);
+    item->x = x;
+    item->y = y;
+    item->color = color;
+
+    int width = 0;
+    int height = 0;
+    measureText(font, item->text, &width, &height);
+    item->bounds = (SDL_Rect){x, y, width, height};
+
+    item->hash = hashBytes(item->hash, item->text, strlen(item->text));
+    item->hash = hashBytes(item->hash, &item->bounds, sizeof(item->bounds));
+    item->hash = hashBytes(item->hash, &color, sizeof(color));
+}
+
+// Which tape the item is, and where it is on screen
+static void getTapeLayout(HudItemKind kind, int x, int y, int *tape, SDL_Rect *bounds) {
+    if (kind == HUD_ITEM_HEADING_TAPE) {
+        *tape = TAPE_HEADING;
+        *bounds = (SDL_Rect){x, y, HEADING_TAPE_WIDTH, HEADING_TAPE_HEIGHT};
+        return;
+    }
+    *tape = (kind == HUD_ITEM_SPEED_TAPE) ? TAPE_SPEED : TAPE_ALTITUDE;
+    *bounds = (SDL_Rect){x, y, VERTICAL_TAPE_WIDTH, VERTICAL_TAPE_HEIGHT};
+}
+
+static void formatTapeReadout(int tape, float value, char *text, size_t size) {
+    if (tape == TAPE_HEADING) {
+        snprintf(text, size, "%03ld", ((lroundf(value) % 360) + 360) % 360);
+        return;
+    }
+    snprintf(text, size, "%.0f", (double)value);
+}
+
+// Tapes are hashed by where the strip is, to a quarter of a pixel (it scrolls smoothly), and the value box
+static void addHudTape(HudItem *item, HudItemKind kind) {
+    getTapeLayout(kind, item->x, item->y, &item->chart, &item->bounds);
+
+    char readout[16];
+    formatTapeReadout(item->chart, item->value, readout, sizeof(readout));
+    const long position = lroundf(getHudTapePosition(&hudTapes[item->chart], item->value) * 4.0f);
+
+    item->hash = hashBytes(item->hash, &position, sizeof(position));
+    item->hash = hashBytes(item->hash, readout, strlen(readout));
+    item->hash = hashBytes(item->hash, &item->bounds, sizeof(item->bounds));
+}
+
+// The strip's visible window and a box with the value in the middle (the only text)
+static void drawTape(const HudItem *item) {
+    const SDL_Rect *area = &item->bounds;
+    const SDL_Color green = {GREEN};
+    drawHudTape(&hudTapes[item->chart], area, item->value);
+
+    SDL_Rect box = {area->x, area->y + (area->h - TAPE_BOX_SIZE) / 2, area->w, TAPE_BOX_SIZE};
+    if (item->chart == TAPE_HEADING) {
+        box = (SDL_Rect){area->x + (area->w - TAPE_BOX_WIDTH) / 2, area->y, TAPE_BOX_WIDTH, area->h};
+    }
+    batchRect(BATCH_LAYER_SHAPES, area, (SDL_Color){GRAY});
+    batchFillRect(BATCH_LAYER_SHAPES, &box, (SDL_Color){BLACK});
+    batchRect(BATCH_LAYER_SHAPES, &box, green);
+
+    char readout[16];
+    int width = 0;
+    int height = 0;
+    formatTapeReadout(item->chart, item->value, readout, sizeof(readout));
+    measureText(font, readout, &width, &height);
+    drawText(font, readout, box.x + (box.w - width) / 2, box.y + (box.h - height) / 2, (SDL_Color){WHITE});
+}
+
+// The attitude indicator is hashed by pitch and roll to a tenth of a degree (value and maxValue)
+static void addHudAttitude(HudItem *item) {
+    const long pitch = lroundf(item->value * 10.0f);
+    const long roll = lroundf(item->maxValue * 10.0f);
+    item->bounds = (SDL_Rect){item->x - item->radius, item->y - item->radius, 2 * item->radius, 2 * item->radius};
 
-    // Define the rectangle where the unit text will be rendered
-    SDL_Rect kgsRect = {kgsX, kgsY, kgsWidth, kgsHeight};
-    // Copy the texture to the renderer at the specified rectangle
-    SDL_RenderCopy(localRenderer, kgsTextTexture, NULL, &kgsRect);
+    item->hash = hashBytes(item->hash, &pitch, sizeof(pitch));
+    item->hash = hashBytes(item->hash, &roll, sizeof(roll));
+    item->hash = hashBytes(item->hash, &item->bounds, sizeof(item->bounds));
+}
+
+// Gauges and the throttle bar are hashed by what they show: needle position and readout text
+static void addHudGauge(HudItemKind kind, int x, int y, int radius, float value, float maxValue) {
+    HudItem *item = addHudItem(kind);
+    if (item == NULL) {
+        return;
+    }
+
+    item->x = x;
+    item->y = y;
+    item->radius = radius;
+    item->value = value;
+    item->maxValue = maxValue;
+
+    char readout[32];
+    int needleEndX = 0;
+    int needleEndY = 0;
+
+    switch (kind) {
+        case HUD_ITEM_SPEED_GAUGE:
+            getNeedleEnd(x, y, radius, value, maxValue, SPEED_GAUGE_START_ANGLE, SPEED_GAUGE_END_ANGLE, &needleEndX, &needleEndY);
+            snprintf(readout, sizeof(readout), "%.2f", hudSnapshot.machNumber); // as in machCounter()
+            item->bounds = (SDL_Rect){x - radius - 1, y - radius - 1, 2 * radius + 2, 2 * radius + 2};
+            break;
+        case HUD_ITEM_FUEL_GAUGE:
+            getNeedleEnd(x, y, radius, value/100.0f, maxValue/100.0f, FUEL_GAUGE_START_ANGLE, FUEL_GAUGE_END_ANGLE, &needleEndX, &needleEndY);
+            snprintf(readout, sizeof(readout), "%.1f", value/100.0f); // as in renderFuelGauge()
+            item->bounds = (SDL_Rect){x - radius - 1, y - radius - 1, 2 * radius + 2, 2 * radius + 2};
+            break;
+        case HUD_ITEM_THROTTLE:
+            needleEndX = (int)(fminf(value, 1.0f) * 1000.0f); // the fill height
+            snprintf(readout, sizeof(readout), "%.0f%d", value * 100, value > 1.0f); // percentage or WEP
+            item->bounds = (SDL_Rect){x, y - 40, 100, 350 + 40}; // bar and the text above it
+            break;
+        case HUD_ITEM_SPEED_TAPE:
+        case HUD_ITEM_ALTITUDE_TAPE:
+        case HUD_ITEM_HEADING_TAPE:
+            addHudTape(item, kind);
+            return;
+        case HUD_ITEM_ATTITUDE:
+            addHudAttitude(item);
+            return;
+        case HUD_ITEM_TEXT:
+        case HUD_ITEM_CHART:
+        case HUD_ITEM_MAP:
+        case HUD_ITEM_SCOPE:
+        default:
+            return;
+    }
+
+    item->hash = hashInt(item->hash, needleEndX);
+    item->hash = hashInt(item->hash, needleEndY);
+    item->hash = hashBytes(item->hash, readout, strlen(readout));
+    item->hash = hashBytes(item->hash, &item->bounds, sizeof(item->bounds));
+    item->hash = hashBytes(item->hash, &maxValue, sizeof(maxValue));
+    item->hash = hashInt(item->hash, uncachedGaugeNumbers);
+}
+
+// Charts are hashed by their widget's revision, it changes at the chart's update rate
+static void addHudChart(const Widget *widget) {
+    HudItem *item = addHudItem(HUD_ITEM_CHART);
+    if (item == NULL) {
+        return;
+    }
+
+    item->chart = widget->style;
+    item->bounds = (SDL_Rect){widget->x, widget->y, widget->width, widget->height - CHART_SPACING};
+
+    item->hash = hashBytes(item->hash, &widget, sizeof(widget));
+    item->hash = hashBytes(item->hash, &widget->revision, sizeof(widget->revision));
+    item->hash = hashBytes(item->hash, &item->bounds, sizeof(item->bounds));
+}
+
+// Frame, readout and one polyline per series (one SDL_RenderDrawLines() call each)
+static void drawFlightChart(const FlightChart *chart, const SDL_Rect *area) {
+    SDL_Point points[MAX_STRIP_CHART_WIDTH + 1];
+    const SDL_Rect plot = {area->x + 1, area->y + CHART_TITLE_HEIGHT, area->w - 2, area->h - CHART_TITLE_HEIGHT - 1};
+    char readout[64];
+
+    batchRect(BATCH_LAYER_SHAPES, area, (SDL_Color){GRAY});
+
+    // the series share one scale
+    float minimum = FLT_MAX;
+    float maximum = -FLT_MAX;
+    for (int i = 0; i < chart->seriesCount; i++) {
+        getStripChartRange(&chart->series[i], &minimum, &maximum);
+    }
+
+    for (int i = 0; i < chart->seriesCount; i++) {
+        int count = getStripChartPoints(&chart->series[i], &plot, minimum, maximum, points);
+        batchLines(BATCH_LAYER_SHAPES, points, count, chart->colors[i]);
+    }
+
+    if (chart->seriesCount > 1) {
+        snprintf(readout, sizeof(readout), "%s: %.*f / %.*f %s", chart->title, chart->decimals, (double)getLatestStripChartSample(&chart->series[0]), chart->decimals, (double)getLatestStripChartSample(&chart->series[1]), chart->unit);
+    }
+    else {
+        snprintf(readout, sizeof(readout), "%s: %.*f %s", chart->title, chart->decimals, (double)getLatestStripChartSample(&chart->series[0]), chart->unit);
+    }
+    drawText(smallFont, readout, area->x + 4, area->y + 2, chart->colors[0]);
+}
+
+// The map and the scope are hashed by their widget's revision and the zoom
+static void addHudMap(HudItemKind kind, const Widget *widget) {
+    HudItem *item = addHudItem(kind);
+    if (item == NULL) {
+        return;
+    }
+
+    item->bounds = (SDL_Rect){widget->x, widget->y, widget->width, widget->height};
+
+    item->hash = hashBytes(item->hash, &widget, sizeof(widget));
+    item->hash = hashBytes(item->hash, &widget->revision, sizeof(widget->revision));
+    item->hash = hashBytes(item->hash, &item->bounds, sizeof(item->bounds));
+    item->hash = hashInt(item->hash, mapZoom);
+}
+
+static SDL_Point projectTrackPoint(const MapProjection *map, TrackPoint point) {
+    // far outside the map the coordinates are clamped, the lines are clipped anyway
+    const float x = fminf(fmaxf((point.x - map->centreX) / map->pixelSize, -100000.0f), 100000.0f);
+    const float y = fminf(fmaxf((map->centreZ - point.z) / map->pixelSize, -100000.0f), 100000.0f);
+    return (SDL_Point){map->clip.x + map->clip.w / 2 + (int)lroundf(x), map->clip.y + map->clip.h / 2 + (int)lroundf(y)};
+}
+
+// Record one run of the track, points on the same pixel are skipped and the lines clipped to the map
+static void drawTrackRun(const TrackPoint *points, int count, void *user) {
+    const MapProjection *map = user;
+    const SDL_Color color = {MAGENTA};
+
+    SDL_Point previous = projectTrackPoint(map, points[0]);
+    for (int i = 1; i < count; i++) {
+        SDL_Point next = projectTrackPoint(map, points[i]);
+        if (next.x == previous.x && next.y == previous.y) {
+            continue;
+        }
+
+        int x1 = previous.x;
+        int y1 = previous.y;
+        int x2 = next.x;
+        int y2 = next.y;
+        if (SDL_IntersectRectAndLine(&map->clip, &x1, &y1, &x2, &y2)) {
+            batchLine(BATCH_LAYER_SHAPES, x1, y1, x2, y2, color); // unclipped neighbours join into one polyline
+        }
+        previous = next;
+    }
+}
+
+// Frame, the track at the coarsest resolution below a pixel, the aircraft and the scale
+static void drawGroundTrackMap(const SDL_Rect *area) {
+    MapProjection map;
+    map.clip = (SDL_Rect){area->x + 1, area->y + 1, area->w - 2, area->h - 2};
+    map.centreX = hudAircraft->x;
+    map.centreZ = hudAircraft->z;
+    map.pixelSize = ldexpf(1.0f, mapZoom);
+
+    TrackView view;
+    view.minX = map.centreX - (float)map.clip.w * 0.5f * map.pixelSize;
+    view.maxX = map.centreX + (float)map.clip.w * 0.5f * map.pixelSize;
+    view.minZ = map.centreZ - (float)map.clip.h * 0.5f * map.pixelSize;
+    view.maxZ = map.centreZ + (float)map.clip.h * 0.5f * map.pixelSize;
+    view.pixelSize = map.pixelSize;
+
+    batchRect(BATCH_LAYER_SHAPES, area, (SDL_Color){GRAY});
+    mapPointsDrawn = forEachVisibleTrackRun(&groundTrack, &view, drawTrackRun, &map);
+
+    const int cx = map.clip.x + map.clip.w / 2;
+    const int cy = map.clip.y + map.clip.h / 2;
+    batchLine(BATCH_LAYER_SHAPES, cx - 4, cy, cx + 4, cy, (SDL_Color){YELLOW});
+    batchLine(BATCH_LAYER_SHAPES, cx, cy - 4, cx, cy + 4, (SDL_Color){YELLOW});
+
+    char scale[48];
+    snprintf(scale, sizeof(scale), "Track: %.1f km across", (double)((float)map.clip.w * map.pixelSize / 1000.0f));
+    drawText(smallFont, scale, area->x + 4, area->y + 2, (SDL_Color){WHITE});
+}
+
+// Every contact around the aircraft, the aircraft itself in the middle
+static void drawTacticalScope(const SDL_Rect *area) {
+    const float pixelSize = ldexpf(1.0f, mapZoom);
+    drawTacticalDisplay(area, hudAircraft->x, hudAircraft->z, pixelSize);
+
+    const int cx = area->x + area->w / 2;
+    const int cy = area->y + area->h / 2;
+    batchLine(BATCH_LAYER_SHAPES, cx - 5, cy, cx + 5, cy, (SDL_Color){YELLOW});
+    batchLine(BATCH_LAYER_SHAPES, cx, cy - 5, cx, cy + 5, (SDL_Color){YELLOW});
+
+    char scale[64];
+    snprintf(scale, sizeof(scale), "Traffic: %d, %.1f km across", getTacticalStats().contacts, (double)((float)area->w * pixelSize / 1000.0f));
+    drawText(smallFont, scale, area->x + 4, area->y + 2, (SDL_Color){WHITE});
+}
+
+static void drawHudItem(const HudItem *item) {
+    switch (item->kind) {
+        case HUD_ITEM_TEXT:
+            drawText(font, item->text, item->x, item->y, item->color);
+            break;
+        case HUD_ITEM_SPEED_GAUGE:
+            renderSpeedGauge(renderer, font, item->x, item->y, item->radius, item->value, item->maxValue);
+            break;
+        case HUD_ITEM_FUEL_GAUGE:
+            renderFuelGauge(renderer, font, item->x, item->y, item->radius, item->value, item->maxValue);
+            break;
+        case HUD_ITEM_THROTTLE:
+            throttleBar(renderer, item->value, item->x, item->y);
+            break;
+        case HUD_ITEM_CHART:
+            drawFlightChart(&flightCharts[item->chart], &item->bounds);
+            break;
+        case HUD_ITEM_MAP:
+            drawGroundTrackMap(&item->bounds);
+            break;
+        case HUD_ITEM_SCOPE:
+            drawTacticalScope(&item->bounds);
+            break;
+        case HUD_ITEM_SPEED_TAPE:
+        case HUD_ITEM_ALTITUDE_TAPE:
+        case HUD_ITEM_HEADING_TAPE:
+            drawTape(item);
+            break;
+        case HUD_ITEM_ATTITUDE:
+            drawAttitudeIndicator(&item->bounds, item->value, item->maxValue);
+            batchRect(BATCH_LAYER_SHAPES, &item->bounds, (SDL_Color){GRAY});
+            break;
+        default:
+            break;
+    }
+}
+
+static void addDirtyRect(SDL_Rect *rects, int *count, const SDL_Rect *rect) {
+    if (SDL_RectEmpty(rect)) {
+        return;
+    }
+
+    // merge with a region it overlaps, so nothing is drawn twice
+    for (int i = 0; i < *count; i++) {
+        if (SDL_HasIntersection(&rects[i], rect)) {
+            SDL_UnionRect(&rects[i], rect, &rects[i]);
+            return;
+        }
+    }
+
+    if (*count < MAX_DIRTY_RECTS) {
+        rects[(*count)++] = *rect;
+    }
+    else {
+        SDL_UnionRect(&rects[*count - 1], rect, &rects[*count - 1]); // out of regions, grow the last one
+    }
+}
+
+// Redraw the items inside one region of the current render target
+static void redrawRegion(const SDL_Rect *region) {
+    if (isRasterizerActive()) {
+        setRasterClip(region);
+        rasterFillRect(region, (SDL_Color){BLACK});
+    }
+    else {
+        SDL_RenderSetClipRect(renderer, region);
+        SDL_SetRenderDrawColor(renderer, BLACK);
+        SDL_RenderFillRect(renderer, region);
+    }
+
+    for (int i = 0; i < hudItemCount; i++) {
+        if (SDL_HasIntersection(&hudItems[i].bounds, region)) {
+            drawHudItem(&hudItems[i]);
+        }
+    }
+
+    flushText();
+    submitRenderBatch(); // before the clip rectangle changes
+    if (isRasterizerActive()) {
+        setRasterClip(NULL);
+    }
+    else {
+        SDL_RenderSetClipRect(renderer, NULL);
+    }
+}
 
-    // Free the textures and surfaces
-    SDL_DestroyTexture(fuelTexture2);
-    SDL_FreeSurface(fuelSurface);
-    SDL_DestroyTexture(fuelTexture);
-    SDL_FreeSurface(fuelTextSurface);
-    SDL_DestroyTexture(kgsTextTexture);
-    SDL_FreeSurface(kgsTextSurface);
-    TTF_CloseFont(bigFont);
+static void endHudFrame(void) {
+    SDL_Rect dirty[MAX_DIRTY_RECTS];
+    int dirtyCount = 0;
+
+    // keep the last frame in a texture, so unchanged regions don't have to be drawn again (the rasterizer's framebuffer keeps it already)
+    if (hudTexture == NULL && !hudTextureFailed && !isRasterizerActive()) {
+        hudTexture = createRenderTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, SCREEN_WIDTH, SCREEN_HEIGHT);
+        if (hudTexture == NULL) {
+            hudTextureFailed = 1; // no render targets, try once and fall back to full redraws
+            printf("Failed to create the HUD texture, redrawing the whole HUD on changes: %s\n", SDL_GetError());
+        }
+        hudFullRedraw = 1;
+    }
+
+    if (hudFullRedraw) {
+        dirty[dirtyCount++] = (SDL_Rect){0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+    }
+    else {
+        // items are recorded in the same order every frame, compare them one by one
+        int common = (hudItemCount < previousItemCount) ? hudItemCount : previousItemCount;
+        for (int i = 0; i < common; i++) {
+            if (hudItems[i].hash != previousItemHashes[i]) {
+                addDirtyRect(dirty, &dirtyCount, &previousItemBounds[i]); // where it was
+                addDirtyRect(dirty, &dirtyCount, &hudItems[i].bounds); // where it is now
+            }
+        }
+        for (int i = common; i < previousItemCount; i++) {
+            addDirtyRect(dirty, &dirtyCount, &previousItemBounds[i]); // gone
+        }
+        for (int i = common; i < hudItemCount; i++) {
+            addDirtyRect(dirty, &dirtyCount, &hudItems[i].bounds); // new
+        }
+    }
+
+    for (int i = 0; i < hudItemCount; i++) {
+        previousItemBounds[i] = hudItems[i].bounds;
+        previousItemHashes[i] = hudItems[i].hash;
+    }
+    previousItemCount = hudItemCount;
+
+    if (dirtyCount == 0) {
+        captureRepeatFrame(); // the recording shows the same frame again
+        return; // nothing visible changed, no clear and no present
+    }
+
+    if (isRasterizerActive()) {
+        for (int i = 0; i < dirtyCount; i++) {
+            redrawRegion(&dirty[i]);
+        }
+        presentRasterFrame(dirty, dirtyCount); // upload what was redrawn and copy the frame to the screen
+    }
+    else if (hudTexture != NULL) {
+        SDL_SetRenderTarget(renderer, hudTexture);
+        for (int i = 0; i < dirtyCount; i++) {
+            redrawRegion(&dirty[i]);
+        }
+        SDL_SetRenderTarget(renderer, NULL);
+
+        SDL_RenderCopy(renderer, hudTexture, NULL, NULL);
+    }
+    else {
+        SDL_Rect screen = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+        redrawRegion(&screen); // no render targets, the back buffer isn't kept, draw the whole frame straight to the screen
+    }
+
+    hudFullRedraw = 0;
+    finishRenderBatchFrame(); // close this frame's statistics
+    captureFrame(renderer); // Read the frame back for the recording (only while recording)
+    SDL_RenderPresent(renderer); // Present the renderer
 }
 
 /*
     #########################################################
     #                                                       #
-    #                        RENDERER                       #
+    #                       HUD LAYOUT                      #
     #                                                       #
     #########################################################
 */
 
-void renderFlightInfo(AircraftState *aircraft, AircraftData *aircraftData, float fps, float simulationTime) {
-    char buffer[128]; // Buffer for text rendering
-    int y = TOP_GAP; // Initial y position for text rendering
-
-    SDL_SetRenderDrawColor(renderer, BLACK); // Set the renderer draw color to black
-    SDL_RenderClear(renderer); // Clear the renderer with the current draw color
-
-    SDL_Color color; // Color for text rendering
-
-    // Flight parameter calculations
-    float engineOutput = globalPhysicsData.thrust;
-    float totalDrag = globalPhysicsData.totalDrag;
-    float netForce = globalPhysicsData.thrust - globalPhysicsData.totalDrag;
-    float relativeSpeed = globalPhysicsData.velocityMagnitude;
-    float dragCoefficient = globalPhysicsData.dragCoefficient;
-    float parasiticDrag = globalPhysicsData.parasiticDrag;
-    float inducedDrag = globalPhysicsData.inducedDrag;
-    float shockwaveDrag = globalPhysicsData.dragDivergence;
-    Vector3 relativeVelocity = globalPhysicsData.windVector;
-
-    // // Calculate flight parameters
-    // calculateFlightParameters(aircraft, aircraftData, 
-    //                         &engineOutput, &totalDrag, &netForce, 
-    //                         &relativeSpeed, &relativeVelocity, 
-    //                         &parasiticDrag, &inducedDrag, &shockwaveDrag, 
-    //                         &dragCoefficient, simulationTime);
-
-    color = (SDL_Color){WHITE}; // Set text color to white
-    sprintf(buffer, "FPS: %.2f", fps); // Format FPS text
-    renderText(buffer, LEFT_GAP, y, color); y += GAP; // Render FPS text and update y position
-
-    sprintf(buffer, "Simulated time: %.2fs", simulationTime); // Format simulation time text
-    renderText(buffer, LEFT_GAP, y, color); y += GAP; // Render simulation time text and update y position
-    
-    sprintf(buffer, "----- POSITION -----"); // Format position header text
-    renderText(buffer, LEFT_GAP, y, color); y += GAP; // Render position header text and update y position
-
-    sprintf(buffer, "X: %.2f", aircraft->x); // Format X position text
-    renderText(buffer, LEFT_GAP, y, color); y += GAP; // Render X position text and update y position
-
-    sprintf(buffer, "Y: %.2f", aircraft->y); // Format Y position text
-    renderText(buffer, LEFT_GAP, y, color); y += GAP; // Render Y position text and update y position
-
-    sprintf(buffer, "Z: %.2f", aircraft->z); // Format Z position text
-    renderText(buffer, LEFT_GAP, y, color); y += GAP; // Render Z position text and update y position
-
-    if (textMode) { // Check if text mode is enabled
-        // LEFT SIDE (Main Info)
-        // Aircraft Info
-        color = (SDL_Color){YELLOW}; // Set text color to yellow
-        sprintf(buffer, "============ %s INFO ============", aircraftData->name); // Format aircraft info header text
-        renderText(buffer, LEFT_GAP, y, color); y += GAP; // Render aircraft info header text and update y position
-
-        // Speed Info
-        sprintf(buffer, "----- SPEED -----"); // Format speed header text
-        renderText(buffer, LEFT_GAP, y, color); y += GAP; // Render speed header text and update y position
-
-        color = (SDL_Color){CYAN}; // Set text color to cyan
-        sprintf(buffer, "IAS: %.2f km/h", convertMsToKmh(globalPhysicsData.velocityMagnitude)); // Format IAS text
-        renderText(buffer, LEFT_GAP, y, color); y += GAP; // Render IAS text and update y position
-
-        sprintf(buffer, "TAS: %.2f km/h", convertMsToKmh(globalPhysicsData.trueAirspeed)); // Format TAS text
-        renderText(buffer, LEFT_GAP, y, color); y += GAP; // Render TAS text and update y position
-
-        sprintf(buffer, "Mach: %.2f", convertMsToMach(globalPhysicsData.trueAirspeed, &globalPhysicsData)); // Format Mach text
-        renderText(buffer, LEFT_GAP, y, color); y += GAP; // Render Mach text and update y position
-
-        // Wind Info
-        color = (SDL_Color){YELLOW}; // Set text color to yellow
-        sprintf(buffer, "----- WIND -----"); // Format wind header text
-        renderText(buffer, LEFT_GAP, y, color); y += GAP; // Render wind header text and update y position
-
-        color = (SDL_Color){CYAN}; // Set text color to cyan
-        Vector3 wind = getWindVector(aircraft->y, simulationTime); // Get wind vector
-        sprintf(buffer, "Wind: X: %.1f m/s  Z: %.1f m/s", wind.x, wind.z); // Format wind text
-        renderText(buffer, LEFT_GAP, y, color); y += GAP; // Render wind text and update y position
-
-        // Throttle Info
-        color = (SDL_Color){YELLOW}; // Set text color to yellow
-        sprintf(buffer, "----- THROTTLE -----"); // Format throttle header text
-        renderText(buffer, LEFT_GAP, y, color); y += GAP; // Render throttle header text and update y position
-
-        if (!aircraft->controls.afterburner) { // Check if afterburner is not active
-            color = (SDL_Color){CYAN}; // Set text color to cyan
-            sprintf(buffer, "Throttle: %.0d%%", (int)(aircraft->controls.throttle * 100.0f)); // Format throttle percentage text
-        } else { // Afterburner is active
-            color = (SDL_Color){RED}; // Set text color to red
-            sprintf(buffer, "Throttle: WEP"); // Format throttle WEP text
-        }
-        renderText(buffer, LEFT_GAP, y, color); y += GAP; // Render throttle text and update y position
+// Value sources, the context is unused unless noted
+static float readFloat(const void *context) { return *(const float *)context; } // context points to the value
+static float getAircraftX(const void *context) { (void)context; return hudAircraft->x; }
+static float getAircraftY(const void *context) { (void)context; return hudAircraft->y; }
+static float getAircraftZ(const void *context) { (void)context; return hudAircraft->z; }
+static float getIndicatedSpeed(const void *context) { (void)context; return convertMsToKmh(hudSnapshot.velocityMagnitude); }
+static float getTrueSpeed(const void *context) { (void)context; return convertMsToKmh(hudSnapshot.trueAirspeed); }
+static float getThrottle(const void *context) { (void)context; return hudAircraft->controls.throttle; }
+static float getSpool(const void *context) { (void)context; return hudAircraft->engine.spool * 100.0f; }
+static float getAfterburnerLit(const void *context) { (void)context; return hudAircraft->engine.afterburnerLit ? 1.0f : 0.0f; }
+static float getNetForce(const void *context) { (void)context; return hudSnapshot.thrust - hudSnapshot.totalDrag; }
+static float getYaw(const void *context) { (void)context; return convertRadiansToDeg(hudAircraft->yaw); }
+static float getPitch(const void *context) { (void)context; return convertRadiansToDeg(hudAircraft->pitch); }
+static float getRoll(const void *context) { (void)context; return convertRadiansToDeg(hudAircraft->roll); }
+static float getMaxSpeed(const void *context) { (void)context; return hudAircraftData->maxSpeed; }
+static float getFuel(const void *context) { (void)context; return hudAircraft->fuel; }
+static float getMaxFuel(const void *context) { (void)context; return maxFuelKgs; }
+static float getDrawCalls(const void *context) { (void)context; return (float)getRenderBatchStats().drawCalls; }
+static float getStateChanges(const void *context) { (void)context; return (float)getRenderBatchStats().stateChanges; }
+static float getPrimitives(const void *context) { (void)context; return (float)getRenderBatchStats().commands; }
+static float getSnapshotsProduced(const void *context) { (void)context; return (float)getSimulationStats().produced; }
+static float getSnapshotsConsumed(const void *context) { (void)context; return (float)getSimulationStats().consumed; }
+static float getSnapshotsSkipped(const void *context) { (void)context; return (float)getSimulationStats().skipped; }
+static float getCaptureQueueDepth(const void *context) { (void)context; return (float)getCaptureStats().queueDepth; }
+static float getCaptureDropped(const void *context) { (void)context; return (float)getCaptureStats().dropped; }
+static float getCaptureTime(const void *context) { (void)context; return getCaptureStats().averageCaptureMs; }
+static float getQualityLevel(const void *context) { (void)context; return (float)getRenderQuality(); }
+static float getRenderUtilisation(const void *context) { (void)context; return getRenderGovernorStats().utilisation * 100.0f; }
+static float getLateTicks(const void *context) { (void)context; return (float)getSimulationStats().late; }
+static float getMapPointsDrawn(const void *context) { (void)context; return (float)mapPointsDrawn; }
+static float getVisibleContacts(const void *context) { (void)context; return (float)getTacticalStats().visible; }
+static float getContactTags(const void *context) { (void)context; return (float)getTacticalStats().tags; }
+
+// Throttle percentage, or -1 with the afterburner on
+static float getThrottleState(const void *context) {
+    (void)context;
+    if (hudAircraft->controls.afterburner) {
+        return -1.0f;
+    }
+    return (float)(int)(hudAircraft->controls.throttle * 100.0f);
+}
 
-        color = (SDL_Color){CYAN}; // Set text color to cyan
-        if (aircraft->controls.afterburner) { // Check if afterburner is active
-            sprintf(buffer, "Expected engine output: %dN", aircraftData->afterburnerThrust); // Format expected engine output text for afterburner
-        } else { // Afterburner is not active
-            sprintf(buffer, "Expected engine output: %.0fN", (float)aircraftData->thrust * aircraft->controls.throttle); // Format expected engine output text
-        }
-        renderText(buffer, LEFT_GAP, y, color); y += GAP; // Render expected engine output text and update y position
+static float getExpectedOutput(const void *context) {
+    (void)context;
+    if (hudAircraft->controls.afterburner) {
+        return (float)hudAircraftData->afterburnerThrust;
+    }
+    return (float)hudAircraftData->thrust * hudAircraft->controls.throttle;
+}
 
-        sprintf(buffer, "Actual engine output: %.0fN", engineOutput); // Format actual engine output text
-        renderText(buffer, LEFT_GAP, y, color); y += GAP; // Render actual engine output text and update y position
+static void formatThrottle(char *text, size_t size, float value, SDL_Color *color) {
+    if (value < 0.0f) {
+        *color = (SDL_Color){RED}; // Afterburner is active
+        snprintf(text, size, "Throttle: WEP");
+    }
+    else {
+        *color = (SDL_Color){CYAN};
+        snprintf(text, size, "Throttle: %.0f%%", (double)value);
+    }
+}
 
-        sprintf(buffer, "Net force: %.0fN", netForce); // Format net force text
-        renderText(buffer, LEFT_GAP, y, color); y += GAP; // Render net force text and update y position
+static void formatAfterburner(char *text, size_t size, float value, SDL_Color *color) {
+    (void)color;
+    snprintf(text, size, "Afterburner: %s", (value > 0.5f) ? "LIT" : "OFF");
+}
 
-        color = (SDL_Color){YELLOW}; // Set text color to yellow
+static void formatTemperatureDeviation(char *text, size_t size, float value, SDL_Color *color) {
+    (void)color;
+    snprintf(text, size, "ISA deviation: %+.1f K", (double)value);
+}
 
-        // Orientation Info
-        sprintf(buffer, "----- ORIENTATION -----"); // Format orientation header text
-        renderText(buffer, LEFT_GAP, y, color); y += GAP; // Render orientation header text and update y position
+static void formatQuality(char *text, size_t size, float value, SDL_Color *color) {
+    QualityLevel level = (QualityLevel)(int)value;
+    *color = (level == QUALITY_FULL) ? (SDL_Color){WHITE} : (SDL_Color){ORANGE}; // Degraded
+    snprintf(text, size, "Quality: %s", getQualityName(level));
+}
 
-        color = (SDL_Color){CYAN}; // Set text color to cyan
-        sprintf(buffer, "Yaw: %.2f°", convertRadiansToDeg(aircraft->yaw)); // Format yaw text
-        renderText(buffer, LEFT_GAP, y, color); y += GAP; // Render yaw text and update y position
+static void initFlightChart(FlightChartKind kind, const char *title, const char *unit, int decimals, int seriesCount, SDL_Color color, SDL_Color secondColor) {
+    FlightChart *chart = &flightCharts[kind];
+    chart->title = title;
+    chart->unit = unit;
+    chart->decimals = decimals;
+    chart->seriesCount = seriesCount;
+    chart->colors[0] = color;
+    chart->colors[1] = secondColor;
+    for (int i = 0; i < seriesCount; i++) {
+        initStripChart(&chart->series[i], CHART_WIDTH - 2); // one point per pixel column inside the frame
+    }
+}
 
-        sprintf(buffer, "Pitch: %.2f°", convertRadiansToDeg(aircraft->pitch)); // Format pitch text
-        renderText(buffer, LEFT_GAP, y, color); y += GAP; // Render pitch text and update y position
+// Move every tick recorded since the last frame into the strip charts and the ground track (also while they're hidden)
+static void collectChartSamples(void) {
+    SimulationSample samples[64];
+    int count = 0;
+
+    do {
+        count = readSimulationSamples(samples, 64);
+        for (int i = 0; i < count; i++) {
+            const SimulationSample *sample = &samples[i];
+            pushStripChartSample(&flightCharts[CHART_ALTITUDE].series[0], sample->altitude);
+            pushStripChartSample(&flightCharts[CHART_SPEED].series[0], convertMsToKmh(sample->trueAirspeed));
+            pushStripChartSample(&flightCharts[CHART_MACH].series[0], sample->machNumber);
+            pushStripChartSample(&flightCharts[CHART_AOA].series[0], sample->angleOfAttack);
+            pushStripChartSample(&flightCharts[CHART_FORCES].series[0], sample->thrust / 1000.0f);
+            pushStripChartSample(&flightCharts[CHART_FORCES].series[1], sample->totalDrag / 1000.0f);
+            pushStripChartSample(&flightCharts[CHART_FUEL].series[0], sample->fuel);
+            appendGroundTrack(&groundTrack, sample->x, sample->z);
+        }
+    } while (count == 64);
+}
 
-        sprintf(buffer, "Roll: %.2f°", convertRadiansToDeg(aircraft->roll)); // Format roll text
-        renderText(buffer, LEFT_GAP, y, color); y += GAP; // Render roll text and update y position
-    } else { // Visual mode
-        renderSpeedGauge(renderer, font, 200, SCREEN_HEIGHT - 200, 175, convertMsToKmh(globalPhysicsData.trueAirspeed), aircraftData->maxSpeed); // Render speed gauge
-        throttleBar(renderer, aircraft->controls.throttle, 200 + 200, SCREEN_HEIGHT - 375); // Render throttle bar
-        renderFuelGauge(renderer, font, SCREEN_WIDTH - 200, SCREEN_HEIGHT - 200, 175, aircraft->fuel, maxFuelKgs); // Render fuel gauge
+// Create the traffic around the aircraft, HUD_TRAFFIC=<n> sets the number of aircraft
+static void initTraffic(void) {
+    int count = DEFAULT_TRAFFIC;
+    const char *traffic = SDL_getenv("HUD_TRAFFIC");
+    if (traffic != NULL) {
+        count = atoi(traffic);
     }
 
-    const int controlsX = RIGHT_GAP; // X position for controls text
-    int controlsY = GAP; // Initial y position for controls text
-    
-    color = (SDL_Color){GREEN}; // Set text color to green
+    if (count > 0) {
+        initSyntheticTraffic(count, hudAircraft->x, hudAircraft->z, TRAFFIC_SEED);
+    }
+    trafficTime = hudSnapshot.simulationTime;
+}
 
-    if (controlsMode) { // Check if controls mode is enabled
-        sprintf(buffer, "----- CONTROLS -----"); // Format controls header text
-        renderText(buffer, controlsX, controlsY, color); controlsY += GAP; // Render controls header text and update y position
-        sprintf(buffer, "W / S: Pitch Up / Down"); // Format pitch controls text
-        renderText(buffer, controlsX, controlsY, color); controlsY += GAP; // Render pitch controls text and update y position
-        sprintf(buffer, "A / D: Yaw Left / Right"); // Format yaw controls text
-        renderText(buffer, controlsX, controlsY, color); controlsY += GAP; // Render yaw controls text and update y position
-        sprintf(buffer, "Q / E: Roll Left / Right"); // Format roll controls text
-        renderText(buffer, controlsX, controlsY, color); controlsY += GAP; // Render roll controls text and update y position
-        sprintf(buffer, "Z / W: Throttle Increase / Decrease"); // Format throttle controls text
-        renderText(buffer, controlsX, controlsY, color); controlsY += GAP; // Render throttle controls text and update y position
-        sprintf(buffer, "P: Toggle Debug"); // Format toggle debug text
-        renderText(buffer, controlsX, controlsY, color); controlsY += GAP; // Render toggle debug text and update y position
-        sprintf(buffer, "C: Toggle Controls"); // Format toggle controls text
-        renderText(buffer, controlsX, controlsY, color); controlsY += GAP; // Render toggle controls text and update y position
-        sprintf(buffer, "M: Change Display Mode"); // Format change display mode text
-        renderText(buffer, controlsX, controlsY, color); controlsY += GAP; // Render change display mode text and update y position
+// Fly the traffic up to the snapshot's simulation time and hand it to the tactical display (only while it's shown)
+static void updateTraffic(void) {
+    const float dt = hudSnapshot.simulationTime - trafficTime;
+    trafficTime = hudSnapshot.simulationTime;
+    if (!tacticalMode) {
+        return;
     }
 
-    color = (SDL_Color){RED}; // Set text color to red
+    int count = 0;
+    updateSyntheticTraffic(dt);
+    const TacticalContact *contacts = getSyntheticTraffic(&count);
+    setTacticalContacts(contacts, count);
+}
 
-    int debugY = controlsY + GAP; // Initial y position for debug text
+static void measureHudText(const char *text, int *width, int *height) {
+    measureText(font, text, width, height);
+}
 
-    // RIGHT SIDE (DEBUG INFO)
-    if (debugMode) { // Check if debug mode is enabled
-        sprintf(buffer, "----- DEBUG -----"); // Format debug header text
-        renderText(buffer, RIGHT_GAP, debugY, color); debugY += GAP; // Render debug header text and update y position
+// Build the widget tree, every line with its own update rate
+static void buildHUD(const AircraftData *aircraftData) {
+    const SDL_Color white = {WHITE};
+    const SDL_Color yellow = {YELLOW};
+    const SDL_Color cyan = {CYAN};
+    const SDL_Color green = {GREEN};
+    const SDL_Color red = {RED};
+    const SDL_Color orange = {ORANGE};
+
+    setWidgetMeasure(measureHudText);
+    hudRoot = createPanel(NULL, 0, 0, 0, 0);
+
+    // LEFT SIDE (Main Info)
+    Widget *left = createPanel(hudRoot, LEFT_GAP, TOP_GAP, 1, GAP);
+    createLabel(left, "FPS: ", readFloat, &hudFps, 2, NULL, RATE_2HZ, white);
+    createLabel(left, "Simulated time: ", readFloat, &hudSnapshot.simulationTime, 2, "s", RATE_10HZ, white);
+    createLabel(left, "----- POSITION -----", NULL, NULL, 0, NULL, RATE_EVERY_FRAME, white);
+    createLabel(left, "X: ", getAircraftX, NULL, 2, NULL, RATE_10HZ, white);
+    createLabel(left, "Y: ", getAircraftY, NULL, 2, NULL, RATE_10HZ, white);
+    createLabel(left, "Z: ", getAircraftZ, NULL, 2, NULL, RATE_10HZ, white);
+
+    textModePanel = createPanel(left, 0, 0, 1, GAP);
+
+    // Aircraft Info
+    snprintf(hudTitle, sizeof(hudTitle), "============ %s INFO ============", aircraftData->name);
+    createLabel(textModePanel, hudTitle, NULL, NULL, 0, NULL, RATE_EVERY_FRAME, yellow);
+
+    // Speed Info
+    createLabel(textModePanel, "----- SPEED -----", NULL, NULL, 0, NULL, RATE_EVERY_FRAME, yellow);
+    createLabel(textModePanel, "IAS: ", getIndicatedSpeed, NULL, 2, " km/h", RATE_10HZ, cyan);
+    createLabel(textModePanel, "TAS: ", getTrueSpeed, NULL, 2, " km/h", RATE_10HZ, cyan);
+    createLabel(textModePanel, "Mach: ", readFloat, &hudSnapshot.machNumber, 2, NULL, RATE_10HZ, cyan);
+
+    // Wind Info (mean wind plus turbulence)
+    createLabel(textModePanel, "----- WIND -----", NULL, NULL, 0, NULL, RATE_EVERY_FRAME, yellow);
+    createLabel(textModePanel, "Wind X: ", readFloat, &hudSnapshot.windVector.x, 1, " m/s", RATE_4HZ, cyan);
+    createLabel(textModePanel, "Wind Z: ", readFloat, &hudSnapshot.windVector.z, 1, " m/s", RATE_4HZ, cyan);
+    Widget *temperature = createLabel(textModePanel, NULL, readFloat, &hudSnapshot.temperatureDeviation, 1, NULL, RATE_1HZ, cyan);
+    setLabelFormat(temperature, formatTemperatureDeviation);
+
+    // Throttle Info
+    createLabel(textModePanel, "----- THROTTLE -----", NULL, NULL, 0, NULL, RATE_EVERY_FRAME, yellow);
+    Widget *throttle = createLabel(textModePanel, NULL, getThrottleState, NULL, 0, NULL, RATE_EVERY_FRAME, cyan);
+    setLabelFormat(throttle, formatThrottle);
+    createLabel(textModePanel, "Engine spool: ", getSpool, NULL, 0, "%", RATE_10HZ, cyan);
+    Widget *afterburner = createLabel(textModePanel, NULL, getAfterburnerLit, NULL, 0, NULL, RATE_10HZ, cyan);
+    setLabelFormat(afterburner, formatAfterburner);
+    createLabel(textModePanel, "Expected engine output: ", getExpectedOutput, NULL, 0, "N", RATE_10HZ, cyan);
+    createLabel(textModePanel, "Actual engine output: ", readFloat, &hudSnapshot.thrust, 0, "N", RATE_10HZ, cyan);
+    createLabel(textModePanel, "Net force: ", getNetForce, NULL, 0, "N", RATE_10HZ, cyan);
+
+    // Orientation Info
+    createLabel(textModePanel, "----- ORIENTATION -----", NULL, NULL, 0, NULL, RATE_EVERY_FRAME, yellow);
+    createLabel(textModePanel, "Yaw: ", getYaw, NULL, 2, "°", RATE_50HZ, cyan);
+    createLabel(textModePanel, "Pitch: ", getPitch, NULL, 2, "°", RATE_50HZ, cyan);
+    createLabel(textModePanel, "Roll: ", getRoll, NULL, 2, "°", RATE_50HZ, cyan);
+
+    // Visual mode
+    gaugePanel = createPanel(hudRoot, 0, 0, 0, 0);
+    createGauge(gaugePanel, HUD_ITEM_SPEED_GAUGE, 200, SCREEN_HEIGHT - 200, 175, getTrueSpeed, getMaxSpeed, NULL, RATE_EVERY_FRAME);
+    createGauge(gaugePanel, HUD_ITEM_THROTTLE, 200 + 200, SCREEN_HEIGHT - 375, 0, getThrottle, NULL, NULL, RATE_EVERY_FRAME);
+    createGauge(gaugePanel, HUD_ITEM_FUEL_GAUGE, SCREEN_WIDTH - 200, SCREEN_HEIGHT - 200, 175, getFuel, getMaxFuel, NULL, RATE_4HZ);
+    initGroundTrack(&groundTrack);
+    createChart(gaugePanel, GROUND_TRACK_MAP, MAP_X, MAP_Y, MAP_WIDTH, MAP_HEIGHT, RATE_10HZ);
+    createGauge(gaugePanel, HUD_ITEM_SPEED_TAPE, SPEED_TAPE_X, VERTICAL_TAPE_Y, 0, getIndicatedSpeed, NULL, NULL, RATE_EVERY_FRAME);
+    createGauge(gaugePanel, HUD_ITEM_ALTITUDE_TAPE, ALTITUDE_TAPE_X, VERTICAL_TAPE_Y, 0, getAircraftY, NULL, NULL, RATE_EVERY_FRAME);
+    createGauge(gaugePanel, HUD_ITEM_HEADING_TAPE, HEADING_TAPE_X, HEADING_TAPE_Y, 0, getYaw, NULL, NULL, RATE_EVERY_FRAME);
+    createGauge(gaugePanel, HUD_ITEM_ATTITUDE, ATTITUDE_X, ATTITUDE_Y, ATTITUDE_SIZE / 2, getPitch, getRoll, NULL, RATE_EVERY_FRAME); // pitch as the value, roll as the maximum
+
+    // Render quality (between the two sides, visible in both modes)
+    Widget *qualityPanel = createPanel(hudRoot, RIGHT_GAP - 270, TOP_GAP, 1, GAP);
+    Widget *quality = createLabel(qualityPanel, NULL, getQualityLevel, NULL, 0, NULL, RATE_2HZ, white);
+    setLabelFormat(quality, formatQuality);
+    createLabel(qualityPanel, "Render budget: ", getRenderUtilisation, NULL, 0, "%", RATE_2HZ, white);
+    pausedLabel = createLabel(qualityPanel, "PAUSED", NULL, NULL, 0, NULL, RATE_EVERY_FRAME, orange);
+
+    // RIGHT SIDE (Controls and debug info)
+    Widget *right = createPanel(hudRoot, RIGHT_GAP, GAP, 1, GAP);
+
+    controlsPanel = createPanel(right, 0, 0, 1, GAP);
+    createLabel(controlsPanel, "----- CONTROLS -----", NULL, NULL, 0, NULL, RATE_EVERY_FRAME, green);
+    createLabel(controlsPanel, "W / S: Pitch Up / Down", NULL, NULL, 0, NULL, RATE_EVERY_FRAME, green);
+    createLabel(controlsPanel, "A / D: Yaw Left / Right", NULL, NULL, 0, NULL, RATE_EVERY_FRAME, green);
+    createLabel(controlsPanel, "Q / E: Roll Left / Right", NULL, NULL, 0, NULL, RATE_EVERY_FRAME, green);
+    createLabel(controlsPanel, "Z / W: Throttle Increase / Decrease", NULL, NULL, 0, NULL, RATE_EVERY_FRAME, green);
+    createLabel(controlsPanel, "Space: Pause / Resume", NULL, NULL, 0, NULL, RATE_EVERY_FRAME, green);
+    createLabel(controlsPanel, "P: Toggle Debug", NULL, NULL, 0, NULL, RATE_EVERY_FRAME, green);
+    createLabel(controlsPanel, "C: Toggle Controls", NULL, NULL, 0, NULL, RATE_EVERY_FRAME, green);
+    createLabel(controlsPanel, "M: Change Display Mode", NULL, NULL, 0, NULL, RATE_EVERY_FRAME, green);
+    createLabel(controlsPanel, "T: Tactical Display", NULL, NULL, 0, NULL, RATE_EVERY_FRAME, green);
+    createLabel(controlsPanel, "R: Start / Stop Recording", NULL, NULL, 0, NULL, RATE_EVERY_FRAME, green);
+    createLabel(controlsPanel, "+ / -: Map Zoom In / Out", NULL, NULL, 0, NULL, RATE_EVERY_FRAME, green);
+
+    createSpacer(right, GAP);
+
+    debugPanel = createPanel(right, 0, 0, 1, GAP);
+    createLabel(debugPanel, "----- DEBUG -----", NULL, NULL, 0, NULL, RATE_EVERY_FRAME, red);
+    createLabel(debugPanel, "Drag coefficient: ", readFloat, &hudSnapshot.dragCoefficient, 6, NULL, RATE_4HZ, red);
+    createLabel(debugPanel, "Induced Drag: ", readFloat, &hudSnapshot.inducedDrag, 6, "N", RATE_4HZ, red);
+    createLabel(debugPanel, "Parasitic Drag: ", readFloat, &hudSnapshot.parasiticDrag, 6, "N", RATE_4HZ, red);
+    createLabel(debugPanel, "Shockwave Drag: ", readFloat, &hudSnapshot.dragDivergence, 6, "N", RATE_4HZ, red);
+    createLabel(debugPanel, "Total Drag: ", readFloat, &hudSnapshot.totalDrag, 6, "N", RATE_4HZ, red);
+    createLabel(debugPanel, "Relative velocity: ", readFloat, &hudSnapshot.velocityMagnitude, 6, "m/s", RATE_4HZ, red);
+    createLabel(debugPanel, "Relative velocity x: ", readFloat, &hudSnapshot.windVector.x, 6, "m/s", RATE_4HZ, red);
+    createLabel(debugPanel, "Relative velocity y: ", readFloat, &hudSnapshot.windVector.y, 6, "m/s", RATE_4HZ, red);
+    createLabel(debugPanel, "Relative velocity z: ", readFloat, &hudSnapshot.windVector.z, 6, "m/s", RATE_4HZ, red);
+    createLabel(debugPanel, "Draw calls: ", getDrawCalls, NULL, 0, NULL, RATE_2HZ, red);
+    createLabel(debugPanel, "State changes: ", getStateChanges, NULL, 0, NULL, RATE_2HZ, red);
+    createLabel(debugPanel, "Primitives: ", getPrimitives, NULL, 0, NULL, RATE_2HZ, red);
+    createLabel(debugPanel, "Snapshots produced: ", getSnapshotsProduced, NULL, 0, NULL, RATE_1HZ, red);
+    createLabel(debugPanel, "Snapshots consumed: ", getSnapshotsConsumed, NULL, 0, NULL, RATE_1HZ, red);
+    createLabel(debugPanel, "Snapshots skipped: ", getSnapshotsSkipped, NULL, 0, NULL, RATE_1HZ, red);
+    createLabel(debugPanel, "Late physics ticks: ", getLateTicks, NULL, 0, NULL, RATE_1HZ, red);
+    createLabel(debugPanel, "Capture queue: ", getCaptureQueueDepth, NULL, 0, NULL, RATE_2HZ, red);
+    createLabel(debugPanel, "Capture dropped: ", getCaptureDropped, NULL, 0, NULL, RATE_2HZ, red);
+    createLabel(debugPanel, "Capture time: ", getCaptureTime, NULL, 3, "ms", RATE_2HZ, red);
+    createLabel(debugPanel, "Map points drawn: ", getMapPointsDrawn, NULL, 0, NULL, RATE_2HZ, red);
+    createLabel(debugPanel, "Contacts visible: ", getVisibleContacts, NULL, 0, NULL, RATE_2HZ, red);
+    createLabel(debugPanel, "Contact tags: ", getContactTags, NULL, 0, NULL, RATE_2HZ, red);
+
+    // Strip charts (debug view, where the quality panel is in text mode)
+    initFlightChart(CHART_ALTITUDE, "Altitude", "m", 0, 1, white, white);
+    initFlightChart(CHART_SPEED, "TAS", "km/h", 0, 1, cyan, cyan);
+    initFlightChart(CHART_MACH, "Mach", "", 2, 1, cyan, cyan);
+    initFlightChart(CHART_AOA, "AoA", "°", 1, 1, yellow, yellow);
+    initFlightChart(CHART_FORCES, "Thrust / drag", "kN", 1, 2, green, red);
+    initFlightChart(CHART_FUEL, "Fuel", "kg", 0, 1, orange, orange);
+
+    chartPanel = createPanel(hudRoot, CHART_X, CHART_Y, 1, GAP);
+    for (int i = 0; i < FLIGHT_CHARTS; i++) {
+        createChart(chartPanel, i, 0, 0, CHART_WIDTH, CHART_HEIGHT, RATE_10HZ);
+    }
 
-        sprintf(buffer, "Drag coefficient: %.6f", dragCoefficient); // Format drag coefficient text
-        renderText(buffer, RIGHT_GAP, debugY, color); debugY += GAP; // Render drag coefficient text and update y position
+    // Tactical display (replaces the text or visual mode below the position)
+    tacticalPanel = createPanel(hudRoot, 0, 0, 0, 0);
+    createChart(tacticalPanel, TACTICAL_SCOPE, SCOPE_X, SCOPE_Y, SCOPE_WIDTH, SCOPE_HEIGHT, RATE_EVERY_FRAME);
+    initTraffic();
+}
 
-        sprintf(buffer, "Induced Drag: %.6fN", inducedDrag); // Format induced drag text
-        renderText(buffer, RIGHT_GAP, debugY, color); debugY += GAP; // Render induced drag text and update y position
+// Record one visible label or gauge for this frame
+static void addHudWidget(const Widget *widget, void *user) {
+    (void)user;
 
-        sprintf(buffer, "Parasitic Drag: %.6fN", parasiticDrag); // Format parasitic drag text
-        renderText(buffer, RIGHT_GAP, debugY, color); debugY += GAP; // Render parasitic drag text and update y position
+    if (widget->type == WIDGET_GAUGE) {
+        addHudGauge((HudItemKind)widget->style, widget->x, widget->y, widget->radius, widget->current, widget->maximum);
+        return;
+    }
+    if (widget->type == WIDGET_CHART && widget->style == GROUND_TRACK_MAP) {
+        addHudMap(HUD_ITEM_MAP, widget);
+        return;
+    }
+    if (widget->type == WIDGET_CHART && widget->style == TACTICAL_SCOPE) {
+        addHudMap(HUD_ITEM_SCOPE, widget);
+        return;
+    }
+    if (widget->type == WIDGET_CHART) {
+        addHudChart(widget);
+        return;
+    }
 
-        sprintf(buffer, "Shockwave Drag: %.6fN", shockwaveDrag); // Format shockwave drag text
-        renderText(buffer, RIGHT_GAP, debugY, color); debugY += GAP; // Render shockwave drag text and update y position
+    HudItem *item = addHudItem(HUD_ITEM_TEXT);
+    if (item == NULL) {
+        return;
+    }
 
-        sprintf(buffer, "Total Drag: %.6fN", totalDrag); // Format total drag text
-        renderText(buffer, RIGHT_GAP, debugY, color); debugY += GAP; // Render total drag text and update y position
+    memcpy(item->text, widget->text, sizeof(widget->text)); // MAX_WIDGET_TEXT <= MAX_HUD_TEXT
+    item->x = widget->x;
+    item->y = widget->y;
+    item->color = widget->color;
+    item->bounds = (SDL_Rect){widget->x, widget->y, widget->width, widget->height};
 
-        sprintf(buffer, "Relative velocity: %.6fm/s", relativeSpeed); // Format relative velocity text
-        renderText(buffer, RIGHT_GAP, debugY, color); debugY += GAP; // Render relative velocity text and update y position
+    // the label was measured when its text changed, the revision stands for the text and color
+    item->hash = hashBytes(item->hash, &widget, sizeof(widget));
+    item->hash = hashBytes(item->hash, &widget->revision, sizeof(widget->revision));
+    item->hash = hashBytes(item->hash, &item->bounds, sizeof(item->bounds));
+}
 
-        sprintf(buffer, "Relative velocity x: %.6fm/s", relativeVelocity.x); // Format relative velocity x text
-        renderText(buffer, RIGHT_GAP, debugY, color); debugY += GAP; // Render relative velocity x text and update y position
+/*
+    #########################################################
+    #                                                       #
+    #                        RENDERER                       #
+    #                                                       #
+    #########################################################
+*/
 
-        sprintf(buffer, "Relative velocity y: %.6fm/s", relativeVelocity.y); // Format relative velocity y text
-        renderText(buffer, RIGHT_GAP, debugY, color); debugY += GAP; // Render relative velocity y text and update y position
+void renderFlightInfo(const SimulationSnapshot *snapshot, const AircraftData *aircraftData, float fps) {
+    hudSnapshot = *snapshot; // What the value sources read this frame
+    hudAircraftData = aircraftData;
+    hudFps = fps;
 
-        sprintf(buffer, "Relative velocity z: %.6fm/s", relativeVelocity.z); // Format relative velocity z text
-        renderText(buffer, RIGHT_GAP, debugY, color); debugY += GAP; // Render relative velocity z text and update y position
+    if (hudRoot == NULL) {
+        buildHUD(aircraftData); // Build the widget tree on the first frame
+    }
+    collectChartSamples(); // Every physics tick since the last frame
+    updateTraffic(); // Synthetic traffic for the tactical display
+    if (uploadGlyphs() > 0) { // Glyphs the workers rasterized since the last frame
+        invalidateGaugeLayers(); // The gauge numbers may have been cached without them
+        invalidateHUD(); // So was the text drawn since they were requested
     }
 
-    SDL_RenderPresent(renderer); // Present the renderer
-}
\ No newline at end of file
+    setWidgetVisible(textModePanel, textMode && !tacticalMode); // Aircraft info in text mode
+    setWidgetVisible(gaugePanel, !textMode && !tacticalMode); // Gauges in visual mode
+    setWidgetVisible(tacticalPanel, tacticalMode); // Tactical display instead of either
+    setWidgetVisible(controlsPanel, controlsMode); // Controls
+    setWidgetVisible(pausedLabel, isSimulationPaused()); // Simulation time frozen
+    // Cut HUD work down to what the render quality governor allows
+    QualityLevel quality = getRenderQuality();
+    setWidgetRateLimits((quality >= QUALITY_SLOW_TEXT) ? RATE_4HZ : 0, (quality >= QUALITY_STATIC_GAUGES) ? RATE_10HZ : 0); // Slower labels and gauges
+    uncachedGaugeNumbers = (quality < QUALITY_STATIC_GAUGES); // Gauge numbers
+
+    setWidgetVisible(debugPanel, debugMode && quality < QUALITY_NO_DEBUG); // Debug info
+    setWidgetVisible(chartPanel, debugMode && quality < QUALITY_NO_DEBUG && textMode && !tacticalMode); // Strip charts (the gauges are there in visual mode)
+
+    updateWidgets(hudRoot, SDL_GetTicks64()); // Read the values that are due, format the labels that changed
+
+    beginHudFrame(); // Start recording this frame's items
+    forEachVisibleWidget(hudRoot, addHudWidget, NULL); // Record the labels and gauges
+    endHudFrame(); // Redraw what changed and present, or skip the frame if nothing did
+}
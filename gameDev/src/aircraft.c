@@ -29,6 +29,7 @@ void initAircraft(AircraftState *aircraft, AircraftData *data) {
     aircraft->roll = 0.0f;  // Set initial roll to 0 (level flight)
     aircraft->AoA = 0.0f;  // Set initial Angle of Attack to 0
     aircraft->hasAfterburner = false; // Set afterburner to false by default
+    aircraft->turbulenceSlot = 0; // The player's aircraft always uses the first turbulence slot
 
     // fuel, mass
     getEmptyMassAndMaxFuel(data, &aircraft->currentMass, &aircraft->fuel);
@@ -37,6 +38,9 @@ void initAircraft(AircraftState *aircraft, AircraftData *data) {
 
     // Initialize controls
     controlsInit(); // Call the function to initialize controls
+
+    // Engine starts already spooled to the initial throttle
+    initEngineState(&aircraft->engine, getControls()->throttle);
 }
 
 void updateAircraftState(AircraftState *aircraft, float deltaTime) {
@@ -0,0 +1,56 @@
+/**
+ * @file aircraftModel.c
+ *
+ * @brief This file contains the function that compiles AircraftData into the constants used by the physics kernels.
+ */
+
+// Include header files
+#include "aircraftModel.h"
+#include "physics.h"
+#include "logger.h"
+
+// Include necessary libraries
+#include <stddef.h>
+
+int compileAircraftModel(const AircraftData *data, CompiledAircraftModel *model) {
+    if (data == NULL || model == NULL) { // Check for NULL pointers
+        logMessage(LOG_ERROR, "Pointer passed to compileAircraftModel is NULL.");
+        return 0;
+    }
+
+    if (data->mass < 1e-6f || data->wingArea < 1e-6f) { // Everything below divides by these
+        logMessage(LOG_ERROR, "Aircraft %s has an invalid mass or wing area.", data->name);
+        return 0;
+    }
+
+    // Mass
+    model->mass = data->mass; // kg
+    model->invMass = 1.0f / data->mass; // 1/kg
+    model->weight = GRAVITY * data->mass; // N
+
+    // Wing
+    model->wingArea = data->wingArea; // m^2
+    model->aspectRatio = calculateAspectRatio(data->wingSpan, data->wingArea); // b^2 / S
+    model->inducedDragFactor = (model->aspectRatio > 1e-6f) ? 1.0f / (PI * model->aspectRatio * OEF) : 0.0f; // 1 / (PI * AR * e)
+
+    // Drag
+    model->maxSpeedMs = convertKmhToMs(data->maxSpeed); // m/s
+    model->invMaxSpeedMsSquared = (model->maxSpeedMs > 1e-6f) ? 1.0f / (model->maxSpeedMs * model->maxSpeedMs) : 0.0f;
+    model->alpha = data->alpha;
+    model->kw = data->kw;
+    model->Md = data->Md;
+
+    // Engine
+    model->dryThrust = (float)data->thrust; // N
+    model->wetThrust = (float)data->afterburnerThrust; // N
+    model->invSeaLevelDensity = 1.0f / SEA_LEVEL_AIR_DENSITY; // m^3/kg
+
+    // Fuel
+    model->fuelBurn = data->fuelBurn; // kg/s
+    model->afterburnerFuelBurn = data->afterburnerFuelBurn; // kg/s
+    model->fuelCapacity = (float)data->fuelCapacity; // kg
+
+    model->source = data;
+
+    return 1;
+}
@@ -0,0 +1,199 @@
+/**
+ * @file attitudeIndicator.c
+ *
+ * @brief This file contains the attitude indicator: geometry built once, moved with one 2x2 matrix per frame.
+ */
+
+// Include header files
+#include "attitudeIndicator.h"
+#include "renderBatch.h"
+#include "logger.h"
+
+// Include necessary libraries
+#include <math.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define MAX_ATTITUDE_VERTICES 256
+#define MAX_ATTITUDE_INDICES 384
+#define MAX_PITCH 90.0f         // the ladder ends here
+#define LADDER_STEP 5           // degrees between ladder lines
+#define LINE_WIDTH 2.0f
+
+// Parts moved differently, in the order they're built (and drawn)
+typedef enum {
+    PART_HORIZON,       // sky, ground, horizon line and pitch ladder: rotated and moved by the pitch
+    PART_BANK_SCALE,    // rotated only
+    PART_FIXED,         // bank pointer and aircraft symbol: never move
+    ATTITUDE_PARTS
+} AttitudePart;
+
+static _Alignas(16) float modelPositions[MAX_ATTITUDE_VERTICES * 2]; // x, y around the middle of the gauge
+static SDL_Vertex vertices[MAX_ATTITUDE_VERTICES]; // colours set once, positions every frame
+static int geometryIndices[MAX_ATTITUDE_INDICES];
+static int vertexCount = 0;
+static int indexCount = 0;
+static int partStart[ATTITUDE_PARTS + 1]; // first vertex of every part
+
+/* ##### BUILDING ##### */
+
+static void addVertex(float x, float y, SDL_Color color){
+    modelPositions[vertexCount * 2] = x;
+    modelPositions[vertexCount * 2 + 1] = y;
+    vertices[vertexCount] = (SDL_Vertex){{x, y}, color, {0.0f, 0.0f}};
+    vertexCount++;
+}
+
+static void addTriangle(SDL_FPoint a, SDL_FPoint b, SDL_FPoint c, SDL_Color color){
+    if (vertexCount > MAX_ATTITUDE_VERTICES - 3 || indexCount > MAX_ATTITUDE_INDICES - 3) {
+        return;
+    }
+
+    const int first = vertexCount;
+    addVertex(a.x, a.y, color);
+    addVertex(b.x, b.y, color);
+    addVertex(c.x, c.y, color);
+    geometryIndices[indexCount++] = first;
+    geometryIndices[indexCount++] = first + 1;
+    geometryIndices[indexCount++] = first + 2;
+}
+
+// Four corners in order around the quad
+static void addQuad(SDL_FPoint a, SDL_FPoint b, SDL_FPoint c, SDL_FPoint d, SDL_Color color){
+    if (vertexCount > MAX_ATTITUDE_VERTICES - 4 || indexCount > MAX_ATTITUDE_INDICES - 6) {
+        return;
+    }
+
+    const int first = vertexCount;
+    addVertex(a.x, a.y, color);
+    addVertex(b.x, b.y, color);
+    addVertex(c.x, c.y, color);
+    addVertex(d.x, d.y, color);
+    const int quad[6] = {0, 1, 2, 0, 2, 3};
+    for (int i = 0; i < 6; i++) {
+        geometryIndices[indexCount++] = first + quad[i];
+    }
+}
+
+static void addRectangle(float x0, float y0, float x1, float y1, SDL_Color color){
+    addQuad((SDL_FPoint){x0, y0}, (SDL_FPoint){x1, y0}, (SDL_FPoint){x1, y1}, (SDL_FPoint){x0, y1}, color);
+}
+
+// A tick of the bank scale from radius inner to outer, the angle in degrees clockwise from the top
+static void addBankTick(float angle, float inner, float outer, SDL_Color color){
+    const float rad = angle * (float)M_PI / 180.0f;
+    const SDL_FPoint along = {sinf(rad), -cosf(rad)};
+    const SDL_FPoint side = {-along.y * 0.5f * LINE_WIDTH, along.x * 0.5f * LINE_WIDTH};
+
+    addQuad((SDL_FPoint){along.x * inner - side.x, along.y * inner - side.y},
+            (SDL_FPoint){along.x * outer - side.x, along.y * outer - side.y},
+            (SDL_FPoint){along.x * outer + side.x, along.y * outer + side.y},
+            (SDL_FPoint){along.x * inner + side.x, along.y * inner + side.y}, color);
+}
+
+int initAttitudeIndicator(int size){
+    vertexCount = 0;
+    indexCount = 0;
+    if (size < 32) {
+        logMessage(LOG_ERROR, "Invalid arguments passed to initAttitudeIndicator.");
+        return 0;
+    }
+
+    const SDL_Color sky = {0, 120, 215, 255};
+    const SDL_Color ground = {140, 85, 35, 255};
+    const SDL_Color white = {255, 255, 255, 255};
+    const SDL_Color yellow = {255, 255, 0, 255};
+    const float half = 0.5f * (float)size;
+    const float reach = (float)size + MAX_PITCH * ATTITUDE_PIXELS_PER_DEGREE; // covers the corners at any pitch and roll
+    const float radius = half - 4.0f; // bank scale
+
+    // horizon: sky above, ground below, the line between them and the ladder (nose up is negative y, like the sky)
+    partStart[PART_HORIZON] = vertexCount;
+    addRectangle(-(float)size, -reach, (float)size, 0.0f, sky);
+    addRectangle(-(float)size, 0.0f, (float)size, reach, ground);
+    addRectangle(-(float)size, -0.5f * LINE_WIDTH, (float)size, 0.5f * LINE_WIDTH, white);
+    for (int degrees = -(int)MAX_PITCH; degrees <= (int)MAX_PITCH; degrees += LADDER_STEP) {
+        if (degrees == 0) {
+            continue;
+        }
+        const float y = -(float)degrees * ATTITUDE_PIXELS_PER_DEGREE;
+        const float width = (degrees % 10 == 0) ? 0.18f * (float)size : 0.09f * (float)size;
+        addRectangle(-width, y - 0.5f * LINE_WIDTH, width, y + 0.5f * LINE_WIDTH, white);
+    }
+
+    // bank scale: 10, 20, 30, 45 and 60 degrees each way and the zero mark
+    partStart[PART_BANK_SCALE] = vertexCount;
+    const int bankAngles[] = {10, 20, 30, 45, 60};
+    for (size_t i = 0; i < sizeof(bankAngles) / sizeof(bankAngles[0]); i++) {
+        const float length = (bankAngles[i] % 30 == 0) ? 9.0f : 5.0f;
+        addBankTick((float)bankAngles[i], radius - length, radius, white);
+        addBankTick(-(float)bankAngles[i], radius - length, radius, white);
+    }
+    addTriangle((SDL_FPoint){-5.0f, -radius}, (SDL_FPoint){5.0f, -radius}, (SDL_FPoint){0.0f, -radius + 8.0f}, white);
+
+    // bank pointer (meets the zero mark with the wings level) and the aircraft
+    partStart[PART_FIXED] = vertexCount;
+    addTriangle((SDL_FPoint){0.0f, -radius + 9.0f}, (SDL_FPoint){5.0f, -radius + 17.0f}, (SDL_FPoint){-5.0f, -radius + 17.0f}, yellow);
+    addRectangle(-0.3f * (float)size, -1.5f, -0.1f * (float)size, 1.5f, yellow);
+    addRectangle(0.1f * (float)size, -1.5f, 0.3f * (float)size, 1.5f, yellow);
+    addRectangle(-2.0f, -2.0f, 2.0f, 2.0f, yellow);
+    partStart[ATTITUDE_PARTS] = vertexCount;
+
+    return 1;
+}
+
+void destroyAttitudeIndicator(void){
+    vertexCount = 0;
+    indexCount = 0;
+}
+
+/* ##### DRAWING ##### */
+
+// Screen position = rotation * model position + translation, for the vertices of one part
+static void transformPart(AttitudePart part, float cosine, float sine, float translationX, float translationY){
+    int i = partStart[part];
+    const int end = partStart[part + 1];
+
+#ifdef __SSE2__
+    // two vertices per register: x' = c x - s y, y' = s x + c y
+    const __m128 cosines = _mm_set1_ps(cosine);
+    const __m128 sines = _mm_set_ps(sine, -sine, sine, -sine);
+    const __m128 translation = _mm_set_ps(translationY, translationX, translationY, translationX);
+    for (; i + 1 < end; i += 2) {
+        const __m128 model = _mm_loadu_ps(&modelPositions[i * 2]);
+        const __m128 swapped = _mm_shuffle_ps(model, model, _MM_SHUFFLE(2, 3, 0, 1)); // y, x of both
+        const __m128 screen = _mm_add_ps(_mm_add_ps(_mm_mul_ps(model, cosines), _mm_mul_ps(swapped, sines)), translation);
+        _mm_storel_pi((__m64 *)&vertices[i].position, screen);
+        _mm_storeh_pi((__m64 *)&vertices[i + 1].position, screen);
+    }
+#endif
+
+    for (; i < end; i++) {
+        const float x = modelPositions[i * 2];
+        const float y = modelPositions[i * 2 + 1];
+        vertices[i].position.x = cosine * x - sine * y + translationX;
+        vertices[i].position.y = sine * x + cosine * y + translationY;
+    }
+}
+
+void drawAttitudeIndicator(const SDL_Rect *area, float pitch, float roll){
+    if (vertexCount == 0) {
+        return;
+    }
+
+    // the horizon turns against the roll, nose up moves it down
+    const float angle = -roll * (float)M_PI / 180.0f;
+    const float cosine = cosf(angle);
+    const float sine = sinf(angle);
+    const float shift = fminf(fmaxf(pitch, -MAX_PITCH), MAX_PITCH) * ATTITUDE_PIXELS_PER_DEGREE; // fmaxf drops NaN
+    const float centreX = (float)area->x + 0.5f * (float)area->w;
+    const float centreY = (float)area->y + 0.5f * (float)area->h;
+
+    transformPart(PART_HORIZON, cosine, sine, centreX - sine * shift, centreY + cosine * shift);
+    transformPart(PART_BANK_SCALE, cosine, sine, centreX, centreY);
+    transformPart(PART_FIXED, 1.0f, 0.0f, centreX, centreY);
+
+    batchClippedGeometry(BATCH_LAYER_BACKGROUND, NULL, vertices, vertexCount, geometryIndices, indexCount, area);
+}
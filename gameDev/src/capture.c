@@ -0,0 +1,444 @@
+/**
+ * @file capture.c
+ *
+ * @brief This file contains the HUD frame capture: read back on the render thread, converted and written on a writer thread.
+ */
+
+// Include header files
+#include "capture.h"
+#include "logger.h"
+
+// Include necessary libraries
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CAPTURE_FILE_BUFFER (1 << 20) // stdio buffer of the output file
+#define RLE_MAX_PACKET 128 // pixels per packet
+
+// Shared between the render thread and the writer, only touched with captureLock held
+static SDL_mutex *captureLock = NULL;
+static int freeBuffers[CAPTURE_POOL_FRAMES]; // pool buffers nobody uses
+static int freeCount = 0;
+static int queue[CAPTURE_QUEUE_LENGTH]; // pool buffer per queued frame, -1 for a repeat
+static int queueHead = 0;
+static int queueCount = 0;
+static int quitWriter = 0;
+static CaptureStats stats;
+static double totalCaptureMs = 0.0;
+
+static SDL_sem *captureQueued = NULL; // one post per queued frame
+static SDL_Thread *writerThread = NULL;
+static Uint32 *pool[CAPTURE_POOL_FRAMES]; // ARGB8888 frames as read back
+static int capturing = 0; // render thread only
+
+// Writer only
+static FILE *captureFile = NULL;
+static CaptureFormat captureFormat = CAPTURE_Y4M;
+static int captureWidth = 0;
+static int captureHeight = 0;
+static size_t pixelCount = 0;
+static unsigned char *rgbFrame = NULL; // the last frame as RGB24 (black before the first one)
+static unsigned char *previousFrame = NULL; // RLE: the frame before
+static unsigned char *scratch = NULL; // YUV planes or the XOR delta
+static unsigned char *encoded = NULL; // RLE packets
+static size_t encodedSize = 0;
+
+static void freeCaptureBuffers(void){
+    for (int i = 0; i < CAPTURE_POOL_FRAMES; i++) {
+        free(pool[i]);
+        pool[i] = NULL;
+    }
+    free(rgbFrame);
+    free(previousFrame);
+    free(scratch);
+    free(encoded);
+    rgbFrame = NULL;
+    previousFrame = NULL;
+    scratch = NULL;
+    encoded = NULL;
+}
+
+static void convertToRGB(const Uint32 *pixels){
+    unsigned char *out = rgbFrame;
+    for (size_t i = 0; i < pixelCount; i++) {
+        const Uint32 pixel = pixels[i];
+        out[0] = (unsigned char)(pixel >> 16);
+        out[1] = (unsigned char)(pixel >> 8);
+        out[2] = (unsigned char)pixel;
+        out += 3;
+    }
+}
+
+// BT.601 limited range, 4:4:4 planes
+static void convertToYUV(void){
+    unsigned char *yPlane = scratch;
+    unsigned char *uPlane = scratch + pixelCount;
+    unsigned char *vPlane = scratch + 2 * pixelCount;
+    const unsigned char *in = rgbFrame;
+
+    for (size_t i = 0; i < pixelCount; i++) {
+        const int r = in[0];
+        const int g = in[1];
+        const int b = in[2];
+        in += 3;
+
+        yPlane[i] = (unsigned char)(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+        uPlane[i] = (unsigned char)(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+        vPlane[i] = (unsigned char)(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+    }
+}
+
+static int samePixel(const unsigned char *pixels, size_t a, size_t b){
+    return memcmp(pixels + 3 * a, pixels + 3 * b, 3) == 0;
+}
+
+// XOR with the previous frame and run length encode, returns the payload size
+static size_t encodeRLE(void){
+    unsigned char *delta = scratch;
+    for (size_t i = 0; i < 3 * pixelCount; i++) {
+        delta[i] = rgbFrame[i] ^ previousFrame[i];
+    }
+    memcpy(previousFrame, rgbFrame, 3 * pixelCount);
+
+    size_t out = 0;
+    size_t i = 0;
+    while (i < pixelCount) {
+        size_t run = 1;
+        while (i + run < pixelCount && run < RLE_MAX_PACKET && samePixel(delta, i, i + run)) {
+            run++;
+        }
+
+        if (run >= 2) {
+            encoded[out++] = (unsigned char)(0x80 | (run - 1));
+            memcpy(encoded + out, delta + 3 * i, 3);
+            out += 3;
+            i += run;
+            continue;
+        }
+
+        // literals until the next run starts
+        const size_t start = i;
+        size_t count = 0;
+        while (i < pixelCount && count < RLE_MAX_PACKET) {
+            if (i + 1 < pixelCount && samePixel(delta, i, i + 1)) {
+                break;
+            }
+            i++;
+            count++;
+        }
+        encoded[out++] = (unsigned char)(count - 1);
+        memcpy(encoded + out, delta + 3 * start, 3 * count);
+        out += 3 * count;
+    }
+
+    return out;
+}
+
+static void writeUint32(unsigned char *out, Uint32 value){
+    out[0] = (unsigned char)value;
+    out[1] = (unsigned char)(value >> 8);
+    out[2] = (unsigned char)(value >> 16);
+    out[3] = (unsigned char)(value >> 24);
+}
+
+// Write rgbFrame in the capture format, returns the bytes written
+static size_t writeFrame(void){
+    size_t written = 0;
+
+    switch (captureFormat) {
+        case CAPTURE_Y4M:
+            convertToYUV();
+            written += fwrite("FRAME\n", 1, 6, captureFile);
+            written += fwrite(scratch, 1, 3 * pixelCount, captureFile);
+            break;
+        case CAPTURE_RAW_RGB:
+            written += fwrite(rgbFrame, 1, 3 * pixelCount, captureFile);
+            break;
+        case CAPTURE_RLE: {
+            unsigned char size[4];
+            const size_t payload = encodeRLE();
+            writeUint32(size, (Uint32)payload);
+            written += fwrite(size, 1, sizeof(size), captureFile);
+            written += fwrite(encoded, 1, payload, captureFile);
+            break;
+        }
+        default:
+            break;
+    }
+
+    return written;
+}
+
+static int writerThreadFunction(void *data){
+    (void)data;
+
+    for (;;) {
+        SDL_SemWait(captureQueued);
+
+        SDL_LockMutex(captureLock);
+        if (queueCount == 0) {
+            const int quit = quitWriter;
+            SDL_UnlockMutex(captureLock);
+            if (quit) {
+                break;
+            }
+            continue;
+        }
+        const int buffer = queue[queueHead];
+        queueHead = (queueHead + 1) % CAPTURE_QUEUE_LENGTH;
+        queueCount--;
+        stats.queueDepth = queueCount;
+        SDL_UnlockMutex(captureLock);
+
+        if (buffer >= 0) {
+            convertToRGB(pool[buffer]);
+
+            SDL_LockMutex(captureLock);
+            freeBuffers[freeCount++] = buffer; // the render thread can read into it again
+            SDL_UnlockMutex(captureLock);
+        }
+        // a repeat writes rgbFrame again
+
+        const size_t bytes = writeFrame();
+
+        SDL_LockMutex(captureLock);
+        stats.written++;
+        stats.bytesWritten += (double)bytes;
+        SDL_UnlockMutex(captureLock);
+    }
+
+    return 0;
+}
+
+static int writeHeader(int frameRate){
+    switch (captureFormat) {
+        case CAPTURE_Y4M:
+            return fprintf(captureFile, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C444\n", captureWidth, captureHeight, frameRate) > 0;
+        case CAPTURE_RLE: {
+            unsigned char header[16] = {'H', 'C', 'A', 'P'};
+            writeUint32(header + 4, (Uint32)captureWidth);
+            writeUint32(header + 8, (Uint32)captureHeight);
+            writeUint32(header + 12, (Uint32)frameRate);
+            return fwrite(header, 1, sizeof(header), captureFile) == sizeof(header);
+        }
+        case CAPTURE_RAW_RGB:
+        default:
+            return 1; // no header
+    }
+}
+
+int startCapture(const char *path, CaptureFormat format, int width, int height, int frameRate){
+    if (path == NULL || width <= 0 || height <= 0 || frameRate <= 0) {
+        logMessage(LOG_ERROR, "Invalid arguments passed to startCapture.");
+        return 0;
+    }
+    if (capturing) {
+        return 1;
+    }
+
+    captureFormat = format;
+    captureWidth = width;
+    captureHeight = height;
+    pixelCount = (size_t)width * (size_t)height;
+    encodedSize = 3 * pixelCount + pixelCount / RLE_MAX_PACKET + 1; // all literals, worst case
+
+    int allocated = 1;
+    for (int i = 0; i < CAPTURE_POOL_FRAMES; i++) {
+        pool[i] = malloc(pixelCount * sizeof(Uint32));
+        allocated = allocated && pool[i] != NULL;
+        if (pool[i] != NULL) {
+            memset(pool[i], 0, pixelCount * sizeof(Uint32)); // fault the pages in now, not during the first readbacks
+        }
+    }
+    rgbFrame = calloc(3, pixelCount);
+    previousFrame = calloc(3, pixelCount);
+    scratch = malloc(3 * pixelCount);
+    encoded = malloc(encodedSize);
+    if (!allocated || rgbFrame == NULL || previousFrame == NULL || scratch == NULL || encoded == NULL) {
+        logMessage(LOG_ERROR, "Failed to allocate the capture buffers.");
+        freeCaptureBuffers();
+        return 0;
+    }
+
+    captureFile = fopen(path, "wb");
+    if (captureFile == NULL) {
+        logMessage(LOG_ERROR, "Failed to open %s for the capture.", path);
+        freeCaptureBuffers();
+        return 0;
+    }
+    setvbuf(captureFile, NULL, _IOFBF, CAPTURE_FILE_BUFFER);
+
+    if (!writeHeader(frameRate)) {
+        logMessage(LOG_ERROR, "Failed to write the capture header to %s.", path);
+        fclose(captureFile);
+        captureFile = NULL;
+        freeCaptureBuffers();
+        return 0;
+    }
+
+    for (int i = 0; i < CAPTURE_POOL_FRAMES; i++) {
+        freeBuffers[i] = i;
+    }
+    freeCount = CAPTURE_POOL_FRAMES;
+    queueHead = 0;
+    queueCount = 0;
+    quitWriter = 0;
+    memset(&stats, 0, sizeof(stats));
+    totalCaptureMs = 0.0;
+
+    captureLock = SDL_CreateMutex();
+    captureQueued = SDL_CreateSemaphore(0);
+    if (captureLock != NULL && captureQueued != NULL) {
+        writerThread = SDL_CreateThread(writerThreadFunction, "capture", NULL);
+    }
+    if (writerThread == NULL) {
+        logMessage(LOG_ERROR, "Capture writer thread couldn't be started: %s", SDL_GetError());
+        if (captureQueued != NULL) {
+            SDL_DestroySemaphore(captureQueued);
+            captureQueued = NULL;
+        }
+        if (captureLock != NULL) {
+            SDL_DestroyMutex(captureLock);
+            captureLock = NULL;
+        }
+        fclose(captureFile);
+        captureFile = NULL;
+        freeCaptureBuffers();
+        return 0;
+    }
+
+    capturing = 1;
+    logMessage(LOG_INFO, "Capturing %dx%d at %d fps to %s", width, height, frameRate, path);
+    return 1;
+}
+
+void stopCapture(void){
+    if (!capturing) {
+        return;
+    }
+    capturing = 0;
+
+    SDL_LockMutex(captureLock);
+    quitWriter = 1; // after writing what's queued
+    SDL_UnlockMutex(captureLock);
+    SDL_SemPost(captureQueued);
+    SDL_WaitThread(writerThread, NULL);
+    writerThread = NULL;
+
+    SDL_DestroySemaphore(captureQueued);
+    SDL_DestroyMutex(captureLock);
+    captureQueued = NULL;
+    captureLock = NULL;
+
+    fclose(captureFile);
+    captureFile = NULL;
+    freeCaptureBuffers();
+
+    logMessage(LOG_INFO, "Capture finished: %d frames written (%d read back, %d repeated, %d dropped), max queue depth %d, %.1f MB, %.3f ms per frame on the render thread (max %.3f ms)",
+               stats.written, stats.captured, stats.repeated, stats.dropped, stats.maxQueueDepth,
+               stats.bytesWritten / (1024.0 * 1024.0), (double)stats.averageCaptureMs, (double)stats.maxCaptureMs);
+}
+
+int isCapturing(void){
+    return capturing;
+}
+
+// Queue a pool buffer or a repeat (-1), with captureLock held, returns 0 if the queue is full
+static int enqueueFrame(int buffer){
+    if (queueCount >= CAPTURE_QUEUE_LENGTH) {
+        return 0;
+    }
+
+    queue[(queueHead + queueCount) % CAPTURE_QUEUE_LENGTH] = buffer;
+    queueCount++;
+    stats.queueDepth = queueCount;
+    if (queueCount > stats.maxQueueDepth) {
+        stats.maxQueueDepth = queueCount;
+    }
+    return 1;
+}
+
+void captureFrame(SDL_Renderer *renderer){
+    if (!capturing) {
+        return;
+    }
+
+    const Uint64 start = SDL_GetPerformanceCounter();
+
+    SDL_LockMutex(captureLock);
+    int buffer = -1;
+    if (freeCount > 0 && queueCount < CAPTURE_QUEUE_LENGTH) {
+        buffer = freeBuffers[--freeCount];
+    }
+    SDL_UnlockMutex(captureLock);
+
+    if (buffer >= 0) {
+        const SDL_Rect area = {0, 0, captureWidth, captureHeight}; // never more than the buffer holds
+        if (SDL_RenderReadPixels(renderer, &area, SDL_PIXELFORMAT_ARGB8888, pool[buffer], captureWidth * 4) != 0) {
+            logMessage(LOG_WARNING, "Failed to read back the frame: %s", SDL_GetError());
+            SDL_LockMutex(captureLock);
+            freeBuffers[freeCount++] = buffer;
+            SDL_UnlockMutex(captureLock);
+            buffer = -1;
+        }
+    }
+
+    const float elapsedMs = (float)((double)(SDL_GetPerformanceCounter() - start) * 1000.0 / (double)SDL_GetPerformanceFrequency());
+
+    SDL_LockMutex(captureLock);
+    int queued = 0;
+    if (buffer >= 0) {
+        queued = enqueueFrame(buffer);
+        stats.captured++;
+        totalCaptureMs += (double)elapsedMs;
+        stats.averageCaptureMs = (float)(totalCaptureMs / (double)stats.captured);
+        if (elapsedMs > stats.maxCaptureMs) {
+            stats.maxCaptureMs = elapsedMs;
+        }
+    }
+    else {
+        stats.dropped++;
+        queued = enqueueFrame(-1); // keep the timing, the previous frame is written again
+    }
+    SDL_UnlockMutex(captureLock);
+
+    if (queued) {
+        SDL_SemPost(captureQueued);
+    }
+}
+
+void captureRepeatFrame(void){
+    if (!capturing) {
+        return;
+    }
+
+    SDL_LockMutex(captureLock);
+    int queued = enqueueFrame(-1);
+    if (queued) {
+        stats.repeated++;
+    }
+    else {
+        stats.dropped++;
+    }
+    SDL_UnlockMutex(captureLock);
+
+    if (queued) {
+        SDL_SemPost(captureQueued);
+    }
+}
+
+CaptureStats getCaptureStats(void){
+    CaptureStats copy;
+
+    if (captureLock != NULL) {
+        SDL_LockMutex(captureLock);
+        copy = stats;
+        SDL_UnlockMutex(captureLock);
+    }
+    else {
+        copy = stats; // not capturing, nobody else touches it
+    }
+
+    return copy;
+}
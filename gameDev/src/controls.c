@@ -67,7 +67,8 @@ void handleKeyEvents(SDL_Event *event) {
         adjustValues(event->key.keysym.sym); // Process key press
 
         // Check for mode toggle keys
-        if (event->key.keysym.sym == SDLK_p || event->key.keysym.sym == SDLK_c || event->key.keysym.sym == SDLK_m){
+        if (event->key.keysym.sym == SDLK_p || event->key.keysym.sym == SDLK_c || event->key.keysym.sym == SDLK_m || event->key.keysym.sym == SDLK_r || event->key.keysym.sym == SDLK_t ||
+            event->key.keysym.sym == SDLK_EQUALS || event->key.keysym.sym == SDLK_MINUS || event->key.keysym.sym == SDLK_KP_PLUS || event->key.keysym.sym == SDLK_KP_MINUS){
             toggleModes(*event); // Toggle modes
         }
     }
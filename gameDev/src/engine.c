@@ -0,0 +1,71 @@
+/**
+ * @file engine.c
+ *
+ * @brief This file contains the engine spool dynamics.
+ */
+
+// Include header files
+#include "engine.h"
+#include "logger.h"
+
+// Include necessary libraries
+#include <stddef.h>
+
+/*
+    #########################################################
+    #                                                       #
+    #                    SPOOL DYNAMICS                     #
+    #                                                       #
+    #########################################################
+*/
+
+void initEngineState(EngineState *engine, float throttle){
+    if (engine == NULL) {
+        logMessage(LOG_ERROR, "Pointer engine in function initEngineState is NULL.");
+        return;
+    }
+
+    engine->spool = (throttle > 1.0f) ? 1.0f : (throttle < 0.0f ? 0.0f : throttle); // start already spooled up
+    engine->afterburnerTimer = 0.0f;
+    engine->afterburner = 0.0f; // the afterburner always needs to light first
+    engine->afterburnerLit = false;
+}
+
+// First-order lag step; dt / (tau + dt) is the implicit Euler form, stable for any dt and needs no expf()
+static inline float firstOrderStep(float current, float target, float timeConstant, float deltaTime){
+    return current + (target - current) * (deltaTime / (timeConstant + deltaTime));
+}
+
+void updateEngineState(EngineState *engine, float throttle, bool hasAfterburner, float deltaTime){
+    if (engine == NULL) {
+        logMessage(LOG_ERROR, "Pointer engine in function updateEngineState is NULL.");
+        return;
+    }
+    if (deltaTime <= 0.0f) {
+        return;
+    }
+
+    const bool afterburnerRequested = hasAfterburner && throttle > 1.0f;
+    float commandedSpool = (throttle > 1.0f) ? 1.0f : throttle;
+    if (commandedSpool < 0.0f) commandedSpool = 0.0f;
+
+    // core
+    const float spoolTime = (commandedSpool > engine->spool) ? ENGINE_SPOOL_UP_TIME : ENGINE_SPOOL_DOWN_TIME;
+    engine->spool = firstOrderStep(engine->spool, commandedSpool, spoolTime, deltaTime);
+
+    // afterburner: needs the core spooled up, then lights after a delay and ramps in
+    if (afterburnerRequested && engine->spool >= AFTERBURNER_MIN_SPOOL) {
+        engine->afterburnerTimer += deltaTime;
+        if (engine->afterburnerTimer >= AFTERBURNER_LIGHT_OFF_DELAY) {
+            engine->afterburnerLit = true;
+        }
+    }
+    else {
+        engine->afterburnerTimer = 0.0f;
+        engine->afterburnerLit = false; // the light-off state clears at once, the thrust ramps down below
+    }
+
+    // ramps in once lit and back out over the same AFTERBURNER_RAMP_TIME when cut
+    const float afterburnerTarget = engine->afterburnerLit ? 1.0f : 0.0f;
+    engine->afterburner = firstOrderStep(engine->afterburner, afterburnerTarget, AFTERBURNER_RAMP_TIME, deltaTime);
+}
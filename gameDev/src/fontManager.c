@@ -0,0 +1,285 @@
+/**
+ * @file fontManager.c
+ *
+ * @brief This file contains the font manager and the batched text drawing.
+ */
+
+// Include header files
+#include "fontManager.h"
+#include "glyphAtlas.h"
+#include "glyphWorkers.h"
+#include "renderBatch.h"
+#include "logger.h"
+
+// Include necessary libraries
+#include <stdlib.h>
+#include <string.h>
+
+#define FONT_PATH_LENGTH 256
+#define INITIAL_GLYPH_CAPACITY 256 // quads queued per font before the batch grows
+#define DEFAULT_GLYPH_WORKERS 2 // HUD_TEXT_WORKERS=<n> changes it, 0 rasterizes on the main thread
+#define FIRST_PREFETCHED ' ' // printable ASCII is rendered ahead when a font is opened
+#define LAST_PREFETCHED '~'
+
+// An opened (file, size) pair with its atlas and the quads queued this frame
+typedef struct {
+    char path[FONT_PATH_LENGTH];
+    int size;
+    TTF_Font *font;
+    int lineHeight;
+    GlyphAtlas atlas;
+    SDL_Vertex *vertices;   // 4 per glyph
+    int *indices;           // 6 per glyph
+    int glyphCount;
+    int glyphCapacity;
+} LoadedFont;
+
+static SDL_Renderer *textRenderer = NULL;
+static LoadedFont fonts[MAX_FONTS];
+static int fontCount = 0;
+
+void initFontManager(SDL_Renderer *renderer){
+    textRenderer = renderer;
+    fontCount = 0;
+
+    int workers = DEFAULT_GLYPH_WORKERS;
+    const char *setting = SDL_getenv("HUD_TEXT_WORKERS");
+    if (setting != NULL) {
+        workers = atoi(setting);
+    }
+    const int started = startGlyphWorkers(workers);
+    if (started > 0) {
+        logMessage(LOG_INFO, "Glyphs are rasterized by %d worker threads.", started);
+    }
+}
+
+void destroyFontManager(void){
+    stopGlyphWorkers(); // before the atlases the pending glyphs point to
+    for (int i = 0; i < fontCount; i++) {
+        freeGlyphAtlas(&fonts[i].atlas);
+        TTF_CloseFont(fonts[i].font);
+        free(fonts[i].vertices);
+        free(fonts[i].indices);
+        memset(&fonts[i], 0, sizeof(fonts[i]));
+    }
+    fontCount = 0;
+    textRenderer = NULL;
+}
+
+int loadFont(const char *path, int size){
+    if (path == NULL || size <= 0) {
+        logMessage(LOG_ERROR, "Invalid arguments passed to loadFont.");
+        return -1;
+    }
+
+    for (int i = 0; i < fontCount; i++) {
+        if (fonts[i].size == size && strcmp(fonts[i].path, path) == 0) {
+            return i; // already open
+        }
+    }
+
+    if (fontCount >= MAX_FONTS) {
+        logMessage(LOG_ERROR, "Can't open %s at size %d, already %d fonts open.", path, size, MAX_FONTS);
+        return -1;
+    }
+    if (strlen(path) >= FONT_PATH_LENGTH) {
+        logMessage(LOG_ERROR, "Font path too long: %s", path);
+        return -1;
+    }
+
+    LoadedFont *loaded = &fonts[fontCount];
+    memset(loaded, 0, sizeof(*loaded));
+
+    loaded->font = TTF_OpenFont(path, size);
+    if (loaded->font == NULL) {
+        logMessage(LOG_ERROR, "Failed to open font %s: %s", path, TTF_GetError());
+        return -1;
+    }
+
+    // big sizes get a bigger atlas, so the digits and a bit of text always fit
+    int atlasSize = (size <= 24) ? 256 : 512;
+    if (!initGlyphAtlas(&loaded->atlas, textRenderer, atlasSize, atlasSize)) {
+        TTF_CloseFont(loaded->font);
+        loaded->font = NULL;
+        return -1;
+    }
+
+    strcpy(loaded->path, path);
+    loaded->size = size;
+    loaded->lineHeight = TTF_FontHeight(loaded->font);
+
+    // the workers get their own copy of the font and start on the characters every HUD line uses
+    loaded->atlas.workerFont = openWorkerFont(path, size);
+    if (loaded->atlas.workerFont >= 0) {
+        for (uint32_t codepoint = FIRST_PREFETCHED; codepoint <= LAST_PREFETCHED; codepoint++) {
+            getAtlasGlyph(&loaded->atlas, loaded->font, codepoint);
+        }
+    }
+
+    return fontCount++;
+}
+
+// Decode one UTF-8 character and advance the pointer, invalid bytes become '?'
+static uint32_t decodeUTF8(const unsigned char **text){
+    const unsigned char *s = *text;
+    uint32_t codepoint;
+    int length;
+
+    if (s[0] < 0x80) {
+        codepoint = s[0];
+        length = 1;
+    }
+    else if ((s[0] & 0xE0) == 0xC0 && (s[1] & 0xC0) == 0x80) {
+        codepoint = ((uint32_t)(s[0] & 0x1F) << 6) | (uint32_t)(s[1] & 0x3F);
+        length = 2;
+    }
+    else if ((s[0] & 0xF0) == 0xE0 && (s[1] & 0xC0) == 0x80 && (s[2] & 0xC0) == 0x80) {
+        codepoint = ((uint32_t)(s[0] & 0x0F) << 12) | ((uint32_t)(s[1] & 0x3F) << 6) | (uint32_t)(s[2] & 0x3F);
+        length = 3;
+    }
+    else if ((s[0] & 0xF8) == 0xF0 && (s[1] & 0xC0) == 0x80 && (s[2] & 0xC0) == 0x80 && (s[3] & 0xC0) == 0x80) {
+        codepoint = ((uint32_t)(s[0] & 0x07) << 18) | ((uint32_t)(s[1] & 0x3F) << 12) | ((uint32_t)(s[2] & 0x3F) << 6) | (uint32_t)(s[3] & 0x3F);
+        length = 4;
+    }
+    else {
+        codepoint = '?';
+        length = 1;
+    }
+
+    *text = s + length;
+    return codepoint;
+}
+
+static int reserveGlyphs(LoadedFont *loaded, int count){
+    if (loaded->glyphCount + count <= loaded->glyphCapacity) {
+        return 1;
+    }
+
+    int capacity = (loaded->glyphCapacity > 0) ? loaded->glyphCapacity : INITIAL_GLYPH_CAPACITY;
+    while (capacity < loaded->glyphCount + count) {
+        capacity *= 2;
+    }
+
+    SDL_Vertex *vertices = realloc(loaded->vertices, (size_t)capacity * 4 * sizeof(SDL_Vertex));
+    if (vertices == NULL) {
+        return 0;
+    }
+    loaded->vertices = vertices;
+
+    int *indices = realloc(loaded->indices, (size_t)capacity * 6 * sizeof(int));
+    if (indices == NULL) {
+        return 0;
+    }
+    loaded->indices = indices;
+
+    loaded->glyphCapacity = capacity;
+    return 1;
+}
+
+static void queueGlyph(LoadedFont *loaded, const Glyph *glyph, float x, float y, SDL_Color color){
+    SDL_Vertex *v = &loaded->vertices[loaded->glyphCount * 4];
+    int *index = &loaded->indices[loaded->glyphCount * 6];
+    int first = loaded->glyphCount * 4;
+
+    const float x1 = x + (float)glyph->width;
+    const float y1 = y + (float)glyph->height;
+
+    v[0] = (SDL_Vertex){{x, y}, color, {glyph->u0, glyph->v0}};
+    v[1] = (SDL_Vertex){{x1, y}, color, {glyph->u1, glyph->v0}};
+    v[2] = (SDL_Vertex){{x1, y1}, color, {glyph->u1, glyph->v1}};
+    v[3] = (SDL_Vertex){{x, y1}, color, {glyph->u0, glyph->v1}};
+
+    index[0] = first;
+    index[1] = first + 1;
+    index[2] = first + 2;
+    index[3] = first;
+    index[4] = first + 2;
+    index[5] = first + 3;
+
+    loaded->glyphCount++;
+}
+
+void drawText(int font, const char *text, int x, int y, SDL_Color color){
+    if (font < 0 || font >= fontCount || text == NULL) {
+        return;
+    }
+
+    LoadedFont *loaded = &fonts[font];
+    if (!reserveGlyphs(loaded, (int)strlen(text))) { // at least as many bytes as glyphs
+        logMessage(LOG_ERROR, "Failed to grow the text batch.");
+        return;
+    }
+
+    const unsigned char *s = (const unsigned char *)text;
+    int penX = x;
+    uint32_t previous = 0;
+
+    while (*s != '\0') {
+        uint32_t codepoint = decodeUTF8(&s);
+        const Glyph *glyph = getAtlasGlyph(&loaded->atlas, loaded->font, codepoint);
+
+        if (previous != 0) {
+            penX += TTF_GetFontKerningSizeGlyphs32(loaded->font, previous, codepoint);
+        }
+        if (glyph->width > 0) {
+            queueGlyph(loaded, glyph, (float)(penX + glyph->offsetX), (float)y, color);
+        }
+
+        penX += glyph->advance;
+        previous = codepoint;
+    }
+}
+
+void measureText(int font, const char *text, int *width, int *height){
+    int w = 0;
+    int h = 0;
+
+    if (font >= 0 && font < fontCount && text != NULL) {
+        LoadedFont *loaded = &fonts[font];
+        const unsigned char *s = (const unsigned char *)text;
+        uint32_t previous = 0;
+
+        while (*s != '\0') {
+            uint32_t codepoint = decodeUTF8(&s);
+            const Glyph *glyph = getAtlasGlyph(&loaded->atlas, loaded->font, codepoint);
+
+            if (previous != 0) {
+                w += TTF_GetFontKerningSizeGlyphs32(loaded->font, previous, codepoint);
+            }
+            w += glyph->advance;
+            previous = codepoint;
+        }
+        h = loaded->lineHeight;
+    }
+
+    if (width != NULL) {
+        *width = w;
+    }
+    if (height != NULL) {
+        *height = h;
+    }
+}
+
+int uploadGlyphs(void){
+    GlyphJob job;
+    int uploaded = 0;
+
+    while (takeFinishedGlyph(&job)) {
+        uploadAtlasGlyph(job.atlas, job.codepoint, job.surface);
+        uploaded++;
+    }
+
+    return uploaded;
+}
+
+void flushText(void){
+    for (int i = 0; i < fontCount; i++) {
+        LoadedFont *loaded = &fonts[i];
+        if (loaded->glyphCount == 0) {
+            continue;
+        }
+
+        batchGeometry(BATCH_LAYER_TEXT, loaded->atlas.texture, loaded->vertices, loaded->glyphCount * 4, loaded->indices, loaded->glyphCount * 6);
+        loaded->glyphCount = 0;
+    }
+}
@@ -0,0 +1,183 @@
+/**
+ * @file glyphAtlas.c
+ *
+ * @brief This file contains the glyph atlas: glyphs are rasterized once and packed into one texture.
+ */
+
+// Include header files
+#include "glyphAtlas.h"
+#include "renderBatch.h"
+#include "rasterizer.h"
+#include "glyphWorkers.h"
+#include "logger.h"
+
+// Include necessary libraries
+#include <stdlib.h>
+#include <string.h>
+
+#define GLYPH_PADDING 1 // empty pixels between glyphs, so linear filtering doesn't bleed into the neighbours
+
+int initGlyphAtlas(GlyphAtlas *atlas, SDL_Renderer *renderer, int width, int height){
+    if (atlas == NULL || renderer == NULL || width <= 0 || height <= 0) {
+        logMessage(LOG_ERROR, "Invalid arguments passed to initGlyphAtlas.");
+        return 0;
+    }
+
+    memset(atlas, 0, sizeof(*atlas));
+
+    atlas->texture = createRenderTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, width, height);
+    if (atlas->texture == NULL) {
+        logMessage(LOG_ERROR, "Failed to create a %dx%d glyph atlas: %s", width, height, SDL_GetError());
+        return 0;
+    }
+    SDL_SetTextureBlendMode(atlas->texture, SDL_BLENDMODE_BLEND);
+
+    // start fully transparent, static textures have undefined contents
+    atlas->pixels = calloc((size_t)width * (size_t)height, sizeof(Uint32));
+    if (atlas->pixels == NULL) {
+        logMessage(LOG_ERROR, "Failed to allocate a %dx%d glyph atlas.", width, height);
+        SDL_DestroyTexture(atlas->texture);
+        atlas->texture = NULL;
+        return 0;
+    }
+    SDL_UpdateTexture(atlas->texture, NULL, atlas->pixels, width * 4);
+    registerRasterTexture(atlas->texture, atlas->pixels, width, height); // the CPU rasterizer reads the copy
+
+    atlas->width = width;
+    atlas->height = height;
+    atlas->shelfX = GLYPH_PADDING;
+    atlas->shelfY = GLYPH_PADDING;
+    atlas->workerFont = -1;
+
+    return 1;
+}
+
+void freeGlyphAtlas(GlyphAtlas *atlas){
+    if (atlas == NULL) {
+        return;
+    }
+
+    if (atlas->texture != NULL) {
+        unregisterRasterTexture(atlas->texture);
+        SDL_DestroyTexture(atlas->texture);
+    }
+    free(atlas->pixels);
+    memset(atlas, 0, sizeof(*atlas));
+}
+
+// Find room for a w x h cell, starts a new row when the current one is full
+static int reserveCell(GlyphAtlas *atlas, int w, int h, SDL_Rect *cell){
+    const int paddedWidth = w + GLYPH_PADDING; // the padding right of/below the cell
+    const int paddedHeight = h + GLYPH_PADDING;
+
+    if (atlas->shelfX + paddedWidth > atlas->width) {
+        atlas->shelfX = GLYPH_PADDING;
+        atlas->shelfY += atlas->shelfHeight;
+        atlas->shelfHeight = 0;
+    }
+
+    if (atlas->shelfX + paddedWidth > atlas->width || atlas->shelfY + paddedHeight > atlas->height) {
+        return 0;
+    }
+
+    *cell = (SDL_Rect){atlas->shelfX, atlas->shelfY, w, h};
+    atlas->shelfX += paddedWidth;
+    if (paddedHeight > atlas->shelfHeight) {
+        atlas->shelfHeight = paddedHeight;
+    }
+
+    return 1;
+}
+
+SDL_Surface *renderGlyph(TTF_Font *font, uint32_t codepoint){
+    SDL_Surface *surface = TTF_RenderGlyph32_Blended(font, codepoint, (SDL_Color){255, 255, 255, 255});
+    if (surface == NULL) {
+        logMessage(LOG_WARNING, "Failed to rasterize glyph U+%04X: %s", (unsigned)codepoint, TTF_GetError());
+        return NULL;
+    }
+
+    if (surface->format->format != SDL_PIXELFORMAT_ARGB8888) {
+        SDL_Surface *converted = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+        SDL_FreeSurface(surface);
+        surface = converted;
+    }
+
+    return surface;
+}
+
+// Copy a rendered glyph into the atlas, frees the surface
+static void storeGlyph(GlyphAtlas *atlas, uint32_t codepoint, Glyph *glyph, SDL_Surface *surface){
+    glyph->state = -1; // unless everything below works
+    if (surface == NULL) {
+        return;
+    }
+
+    SDL_Rect cell;
+    if (!reserveCell(atlas, surface->w, surface->h, &cell)) {
+        logMessage(LOG_WARNING, "Glyph atlas (%dx%d) is full, U+%04X won't be drawn.", atlas->width, atlas->height, (unsigned)codepoint);
+        SDL_FreeSurface(surface);
+        return;
+    }
+
+    SDL_UpdateTexture(atlas->texture, &cell, surface->pixels, surface->pitch);
+    for (int row = 0; row < cell.h; row++) {
+        memcpy(&atlas->pixels[(cell.y + row) * atlas->width + cell.x], (const Uint8 *)surface->pixels + row * surface->pitch, (size_t)cell.w * sizeof(Uint32));
+    }
+    SDL_FreeSurface(surface);
+
+    const float invWidth = 1.0f / (float)atlas->width;
+    const float invHeight = 1.0f / (float)atlas->height;
+    glyph->u0 = (float)cell.x * invWidth;
+    glyph->v0 = (float)cell.y * invHeight;
+    glyph->u1 = (float)(cell.x + cell.w) * invWidth;
+    glyph->v1 = (float)(cell.y + cell.h) * invHeight;
+    glyph->width = cell.w;
+    glyph->height = cell.h;
+    glyph->state = 1;
+}
+
+static void rasterizeGlyph(GlyphAtlas *atlas, TTF_Font *font, uint32_t codepoint, Glyph *glyph){
+    int minX = 0, maxX = 0, minY = 0, maxY = 0, advance = 0;
+    if (TTF_GlyphMetrics32(font, codepoint, &minX, &maxX, &minY, &maxY, &advance) != 0) {
+        glyph->state = -1;
+        return;
+    }
+    glyph->advance = advance; // known right away, so text is laid out the same while the glyph is missing
+    glyph->offsetX = (minX < 0) ? minX : 0; // the cell starts left of the pen for overhanging glyphs
+
+    if (maxX <= minX) {
+        glyph->state = 1; // blank (space), only advances
+        return;
+    }
+
+    if (atlas->workerFont >= 0) {
+        if (requestGlyph(atlas, atlas->workerFont, codepoint)) {
+            glyph->state = 2;
+        }
+        return; // queue full: asked again the next time it's drawn
+    }
+
+    storeGlyph(atlas, codepoint, glyph, renderGlyph(font, codepoint));
+}
+
+const Glyph *getAtlasGlyph(GlyphAtlas *atlas, TTF_Font *font, uint32_t codepoint){
+    if (codepoint >= GLYPH_ATLAS_CODEPOINTS) {
+        codepoint = '?';
+    }
+
+    Glyph *glyph = &atlas->glyphs[codepoint];
+    if (glyph->state == 0) {
+        rasterizeGlyph(atlas, font, codepoint, glyph);
+    }
+
+    return glyph;
+}
+
+void uploadAtlasGlyph(GlyphAtlas *atlas, uint32_t codepoint, SDL_Surface *surface){
+    if (codepoint >= GLYPH_ATLAS_CODEPOINTS) {
+        SDL_FreeSurface(surface);
+        return;
+    }
+
+    storeGlyph(atlas, codepoint, &atlas->glyphs[codepoint], surface);
+}
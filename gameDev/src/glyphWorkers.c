@@ -0,0 +1,198 @@
+/**
+ * @file glyphWorkers.c
+ *
+ * @brief This file contains the glyph workers: glyphs requested by the atlases are rendered on worker threads.
+ */
+
+// Include header files
+#include "glyphWorkers.h"
+#include "glyphAtlas.h"
+#include "logger.h"
+
+// Include necessary libraries
+#include <stdint.h>
+
+#define GLYPH_QUEUE_MASK (GLYPH_QUEUE_LENGTH - 1)
+
+// Shared between the main thread and the workers, only touched with queueLock held
+static SDL_mutex *queueLock = NULL;
+static GlyphJob requests[GLYPH_QUEUE_LENGTH];
+static unsigned requestHead = 0;
+static unsigned requestCount = 0;
+static GlyphJob finished[GLYPH_QUEUE_LENGTH];
+static unsigned finishedHead = 0;
+static unsigned finishedCount = 0;
+static unsigned jobsInFlight = 0; // requested and not taken back, so the finished queue never overflows
+static int quitWorkers = 0;
+
+static SDL_sem *glyphsQueued = NULL; // one post per request
+static SDL_Thread *workers[MAX_GLYPH_WORKERS];
+static int workerCount = 0;
+
+// Opened on the main thread before any request can use them, then only read by their worker
+static TTF_Font *workerFonts[MAX_GLYPH_WORKERS][MAX_WORKER_FONTS];
+static int workerFontCount = 0;
+
+static int glyphWorkerFunction(void *data){
+    const int worker = (int)(intptr_t)data;
+
+    while (1) {
+        SDL_SemWait(glyphsQueued);
+
+        SDL_LockMutex(queueLock);
+        if (quitWorkers) {
+            SDL_UnlockMutex(queueLock);
+            break;
+        }
+        GlyphJob job = requests[requestHead];
+        requestHead = (requestHead + 1) & GLYPH_QUEUE_MASK;
+        requestCount--;
+        SDL_UnlockMutex(queueLock);
+
+        job.surface = renderGlyph(workerFonts[worker][job.font], job.codepoint);
+
+        SDL_LockMutex(queueLock);
+        finished[(finishedHead + finishedCount) & GLYPH_QUEUE_MASK] = job;
+        finishedCount++;
+        SDL_UnlockMutex(queueLock);
+    }
+
+    return 0;
+}
+
+int startGlyphWorkers(int count){
+    if (workerCount > 0 || count <= 0) {
+        return workerCount;
+    }
+    if (count > MAX_GLYPH_WORKERS) {
+        count = MAX_GLYPH_WORKERS;
+    }
+
+    requestHead = 0;
+    requestCount = 0;
+    finishedHead = 0;
+    finishedCount = 0;
+    jobsInFlight = 0;
+    quitWorkers = 0;
+    workerFontCount = 0;
+
+    queueLock = SDL_CreateMutex();
+    glyphsQueued = SDL_CreateSemaphore(0);
+    if (queueLock == NULL || glyphsQueued == NULL) {
+        logMessage(LOG_ERROR, "Glyph workers couldn't be started: %s", SDL_GetError());
+        stopGlyphWorkers();
+        return 0;
+    }
+
+    for (int i = 0; i < count; i++) {
+        workers[workerCount] = SDL_CreateThread(glyphWorkerFunction, "glyphs", (void *)(intptr_t)workerCount);
+        if (workers[workerCount] == NULL) {
+            logMessage(LOG_WARNING, "Glyph worker %d couldn't be started: %s", i, SDL_GetError());
+            break;
+        }
+        workerCount++;
+    }
+
+    if (workerCount == 0) {
+        stopGlyphWorkers();
+    }
+    return workerCount;
+}
+
+void stopGlyphWorkers(void){
+    if (workerCount > 0) {
+        SDL_LockMutex(queueLock);
+        quitWorkers = 1; // whatever is still queued is dropped
+        SDL_UnlockMutex(queueLock);
+        for (int i = 0; i < workerCount; i++) {
+            SDL_SemPost(glyphsQueued);
+        }
+        for (int i = 0; i < workerCount; i++) {
+            SDL_WaitThread(workers[i], NULL);
+            workers[i] = NULL;
+        }
+    }
+
+    for (unsigned i = 0; i < finishedCount; i++) {
+        SDL_FreeSurface(finished[(finishedHead + i) & GLYPH_QUEUE_MASK].surface);
+    }
+    finishedCount = 0;
+    requestCount = 0;
+    jobsInFlight = 0;
+
+    for (int i = 0; i < workerCount; i++) {
+        for (int font = 0; font < workerFontCount; font++) {
+            TTF_CloseFont(workerFonts[i][font]);
+            workerFonts[i][font] = NULL;
+        }
+    }
+    workerFontCount = 0;
+    workerCount = 0;
+
+    if (glyphsQueued != NULL) {
+        SDL_DestroySemaphore(glyphsQueued);
+        glyphsQueued = NULL;
+    }
+    if (queueLock != NULL) {
+        SDL_DestroyMutex(queueLock);
+        queueLock = NULL;
+    }
+}
+
+int openWorkerFont(const char *path, int size){
+    if (workerCount == 0 || workerFontCount >= MAX_WORKER_FONTS) {
+        return -1;
+    }
+
+    for (int i = 0; i < workerCount; i++) {
+        workerFonts[i][workerFontCount] = TTF_OpenFont(path, size);
+        if (workerFonts[i][workerFontCount] == NULL) {
+            logMessage(LOG_WARNING, "Failed to open font %s for the glyph workers: %s", path, TTF_GetError());
+            for (int opened = 0; opened < i; opened++) {
+                TTF_CloseFont(workerFonts[opened][workerFontCount]);
+                workerFonts[opened][workerFontCount] = NULL;
+            }
+            return -1;
+        }
+    }
+
+    return workerFontCount++;
+}
+
+int requestGlyph(struct GlyphAtlas *atlas, int font, uint32_t codepoint){
+    if (workerCount == 0 || font < 0 || font >= workerFontCount) {
+        return 0;
+    }
+
+    SDL_LockMutex(queueLock);
+    if (jobsInFlight >= GLYPH_QUEUE_LENGTH) {
+        SDL_UnlockMutex(queueLock);
+        return 0;
+    }
+    requests[(requestHead + requestCount) & GLYPH_QUEUE_MASK] = (GlyphJob){atlas, font, codepoint, NULL};
+    requestCount++;
+    jobsInFlight++;
+    SDL_UnlockMutex(queueLock);
+
+    SDL_SemPost(glyphsQueued);
+    return 1;
+}
+
+int takeFinishedGlyph(GlyphJob *job){
+    if (workerCount == 0) {
+        return 0;
+    }
+
+    int taken = 0;
+    SDL_LockMutex(queueLock);
+    if (finishedCount > 0) {
+        *job = finished[finishedHead];
+        finishedHead = (finishedHead + 1) & GLYPH_QUEUE_MASK;
+        finishedCount--;
+        jobsInFlight--;
+        taken = 1;
+    }
+    SDL_UnlockMutex(queueLock);
+
+    return taken;
+}
@@ -0,0 +1,373 @@
+/**
+ * @file groundTrack.c
+ *
+ * @brief This file contains the ground track: chunked storage, Douglas-Peucker per chunk and per group, and the culled walk for the map.
+ */
+
+// Include header files
+#include "groundTrack.h"
+#include "logger.h"
+
+// Include necessary libraries
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+void initGroundTrack(GroundTrack *track){
+    memset(track, 0, sizeof(*track));
+}
+
+void freeGroundTrack(GroundTrack *track){
+    for (int i = 0; i < track->chunkCount; i++) {
+        free(track->chunks[i]);
+    }
+    free(track->chunks);
+
+    for (int tier = 0; tier < TRACK_TIERS; tier++) {
+        for (int i = 0; i < track->nodeCount[tier]; i++) {
+            free(track->nodes[tier][i].points);
+        }
+        free(track->nodes[tier]);
+    }
+
+    initGroundTrack(track);
+}
+
+float getTrackTolerance(int level){
+    float tolerance = TRACK_BASE_TOLERANCE;
+    for (int i = 0; i < level; i++) {
+        tolerance *= 4.0f;
+    }
+    return tolerance;
+}
+
+/*
+    #########################################################
+    #                                                       #
+    #                     SIMPLIFICATION                    #
+    #                                                       #
+    #########################################################
+*/
+
+// Squared distance of p to the segment a-b (not the infinite line, the track can turn back on itself)
+static float segmentDistanceSquared(TrackPoint p, TrackPoint a, TrackPoint b){
+    const float dx = b.x - a.x;
+    const float dz = b.z - a.z;
+    const float lengthSquared = dx * dx + dz * dz;
+
+    float t = 0.0f;
+    if (lengthSquared > 0.0f) {
+        t = fminf(fmaxf(((p.x - a.x) * dx + (p.z - a.z) * dz) / lengthSquared, 0.0f), 1.0f);
+    }
+
+    const float ex = a.x + t * dx - p.x;
+    const float ez = a.z + t * dz - p.z;
+    return ex * ex + ez * ez;
+}
+
+// Douglas-Peucker without recursion, keeps the first and the last point, returns the number of points written
+static int simplifyPolyline(const TrackPoint *input, int count, float tolerance, TrackPoint *output, unsigned char *keep, int *stack){
+    if (count <= 2) {
+        memcpy(output, input, (size_t)count * sizeof(TrackPoint));
+        return count;
+    }
+
+    const float toleranceSquared = tolerance * tolerance;
+    memset(keep, 0, (size_t)count);
+    keep[0] = 1;
+    keep[count - 1] = 1;
+
+    // every range on the stack has at least one point between its ends, the ranges never overlap
+    int top = 0;
+    stack[top++] = 0;
+    stack[top++] = count - 1;
+
+    while (top > 0) {
+        const int last = stack[--top];
+        const int first = stack[--top];
+
+        int farthest = first;
+        float farthestDistance = toleranceSquared;
+        for (int i = first + 1; i < last; i++) {
+            const float distance = segmentDistanceSquared(input[i], input[first], input[last]);
+            if (distance > farthestDistance) {
+                farthestDistance = distance;
+                farthest = i;
+            }
+        }
+
+        if (farthest == first) {
+            continue; // everything in between is within the tolerance
+        }
+
+        keep[farthest] = 1;
+        if (farthest - first > 1) {
+            stack[top++] = first;
+            stack[top++] = farthest;
+        }
+        if (last - farthest > 1) {
+            stack[top++] = farthest;
+            stack[top++] = last;
+        }
+    }
+
+    int written = 0;
+    for (int i = 0; i < count; i++) {
+        if (keep[i]) {
+            output[written++] = input[i];
+        }
+    }
+    return written;
+}
+
+// Simplify a node's points at the tolerances of its tier, each version from the one before
+static int simplifyNode(TrackNode *node, int firstLevel, const TrackPoint *input, int count){
+    TrackPoint *points = malloc((size_t)count * TRACK_LEVELS_PER_TIER * sizeof(TrackPoint));
+    unsigned char *keep = malloc((size_t)count);
+    int *stack = malloc((size_t)count * 2 * sizeof(int));
+
+    if (points == NULL || keep == NULL || stack == NULL) {
+        logMessage(LOG_ERROR, "Failed to simplify %d track points.", count);
+        free(points);
+        free(keep);
+        free(stack);
+        return 0;
+    }
+
+    const TrackPoint *source = input;
+    int sourceCount = count;
+    int used = 0;
+    for (int level = 0; level < TRACK_LEVELS_PER_TIER; level++) {
+        node->levelStart[level] = used;
+        node->levelCount[level] = simplifyPolyline(source, sourceCount, getTrackTolerance(firstLevel + level), &points[used], keep, stack);
+
+        source = &points[used];
+        sourceCount = node->levelCount[level];
+        used += sourceCount;
+    }
+
+    free(keep);
+    free(stack);
+
+    TrackPoint *shrunk = realloc(points, (size_t)used * sizeof(TrackPoint)); // usually a small fraction of the input
+    node->points = (shrunk != NULL) ? shrunk : points;
+    return 1;
+}
+
+/*
+    #########################################################
+    #                                                       #
+    #                        STORAGE                        #
+    #                                                       #
+    #########################################################
+*/
+
+static TrackNode *addNode(GroundTrack *track, int tier){
+    if (track->nodeCount[tier] >= track->nodeCapacity[tier]) {
+        int capacity = (track->nodeCapacity[tier] > 0) ? track->nodeCapacity[tier] * 2 : 64;
+        TrackNode *grown = realloc(track->nodes[tier], (size_t)capacity * sizeof(TrackNode));
+        if (grown == NULL) {
+            logMessage(LOG_ERROR, "Failed to grow the ground track to %d nodes.", capacity);
+            return NULL;
+        }
+        track->nodes[tier] = grown;
+        track->nodeCapacity[tier] = capacity;
+    }
+
+    TrackNode *node = &track->nodes[tier][track->nodeCount[tier]++];
+    memset(node, 0, sizeof(*node));
+    return node;
+}
+
+static int addChunk(GroundTrack *track){
+    if (track->chunkCount >= track->chunkCapacity) {
+        int capacity = (track->chunkCapacity > 0) ? track->chunkCapacity * 2 : 64;
+        TrackPoint **grown = realloc(track->chunks, (size_t)capacity * sizeof(TrackPoint *));
+        if (grown == NULL) {
+            logMessage(LOG_ERROR, "Failed to grow the ground track to %d chunks.", capacity);
+            return 0;
+        }
+        track->chunks = grown;
+        track->chunkCapacity = capacity;
+    }
+
+    TrackPoint *chunk = malloc(TRACK_CHUNK_POINTS * sizeof(TrackPoint));
+    if (chunk == NULL) {
+        logMessage(LOG_ERROR, "Failed to allocate a ground track chunk.");
+        return 0;
+    }
+
+    track->openCount = 0;
+    if (track->chunkCount > 0) {
+        chunk[track->openCount++] = track->chunks[track->chunkCount - 1][TRACK_CHUNK_POINTS - 1]; // the chunks join up
+    }
+    track->chunks[track->chunkCount++] = chunk;
+    return 1;
+}
+
+// Merge the nodes of a tier into nodes of the next one, TRACK_GROUP at a time
+static void mergeNodes(GroundTrack *track, int tier){
+    while (track->nodeCount[tier] < track->nodeCount[tier - 1] / TRACK_GROUP) {
+        const TrackNode *children = &track->nodes[tier - 1][track->nodeCount[tier] * TRACK_GROUP];
+        const int coarsest = TRACK_LEVELS_PER_TIER - 1;
+
+        int count = 0;
+        for (int i = 0; i < TRACK_GROUP; i++) {
+            count += children[i].levelCount[coarsest];
+        }
+        TrackPoint *joined = malloc((size_t)(count > 0 ? count : 1) * sizeof(TrackPoint));
+        TrackNode *node = (joined != NULL) ? addNode(track, tier) : NULL;
+        if (node == NULL) {
+            free(joined);
+            return; // tried again when the next chunk is sealed
+        }
+
+        // the children's coarsest versions, each one starts where the one before ended
+        int joinedCount = 0;
+        node->minX = children[0].minX;
+        node->maxX = children[0].maxX;
+        node->minZ = children[0].minZ;
+        node->maxZ = children[0].maxZ;
+        for (int i = 0; i < TRACK_GROUP; i++) {
+            const TrackNode *child = &children[i];
+            const int skip = (joinedCount > 0 && child->levelCount[coarsest] > 0) ? 1 : 0;
+            const int copied = child->levelCount[coarsest] - skip;
+            memcpy(&joined[joinedCount], &child->points[child->levelStart[coarsest] + skip], (size_t)copied * sizeof(TrackPoint));
+            joinedCount += copied;
+
+            node->minX = fminf(node->minX, child->minX); // from the children, the simplified points may not reach the edges
+            node->maxX = fmaxf(node->maxX, child->maxX);
+            node->minZ = fminf(node->minZ, child->minZ);
+            node->maxZ = fmaxf(node->maxZ, child->maxZ);
+        }
+
+        simplifyNode(node, tier * TRACK_LEVELS_PER_TIER, joined, joinedCount);
+        free(joined);
+    }
+}
+
+// Simplify a full chunk, returns 0 if its node couldn't be added
+static int sealChunk(GroundTrack *track){
+    const TrackPoint *chunk = track->chunks[track->chunkCount - 1];
+
+    TrackNode *node = addNode(track, 0);
+    if (node == NULL) {
+        return 0;
+    }
+
+    node->minX = node->maxX = chunk[0].x;
+    node->minZ = node->maxZ = chunk[0].z;
+    for (int i = 1; i < TRACK_CHUNK_POINTS; i++) {
+        node->minX = fminf(node->minX, chunk[i].x);
+        node->maxX = fmaxf(node->maxX, chunk[i].x);
+        node->minZ = fminf(node->minZ, chunk[i].z);
+        node->maxZ = fmaxf(node->maxZ, chunk[i].z);
+    }
+    simplifyNode(node, 0, chunk, TRACK_CHUNK_POINTS); // without the versions the chunk is still drawn raw when zoomed in
+
+    for (int tier = 1; tier < TRACK_TIERS; tier++) {
+        mergeNodes(track, tier);
+    }
+    return 1;
+}
+
+int appendGroundTrack(GroundTrack *track, float x, float z){
+    if (track->chunkCount == 0 || track->openCount == TRACK_CHUNK_POINTS) {
+        if (!addChunk(track)) {
+            return 0;
+        }
+    }
+
+    track->chunks[track->chunkCount - 1][track->openCount++] = (TrackPoint){x, z};
+    track->pointCount++;
+
+    if (track->openCount == TRACK_CHUNK_POINTS && !sealChunk(track)) {
+        track->openCount--; // try again with the next point
+        track->pointCount--;
+        return 0;
+    }
+    return 1;
+}
+
+/*
+    #########################################################
+    #                                                       #
+    #                          WALK                         #
+    #                                                       #
+    #########################################################
+*/
+
+typedef struct {
+    const GroundTrack *track;
+    const TrackView *view;
+    int level;              // -1 for the raw points
+    int tier;               // tier the level belongs to
+    TrackRunFunction visit;
+    void *user;
+    int visited;
+} TrackWalk;
+
+static int isNodeVisible(const TrackNode *node, const TrackView *view){
+    return node->maxX >= view->minX && node->minX <= view->maxX && node->maxZ >= view->minZ && node->minZ <= view->maxZ;
+}
+
+static void visitRun(TrackWalk *walk, const TrackPoint *points, int count){
+    if (count > 0) {
+        walk->visit(points, count, walk->user);
+        walk->visited += count;
+    }
+}
+
+static void walkNode(TrackWalk *walk, int tier, int index){
+    const TrackNode *node = &walk->track->nodes[tier][index];
+    if (!isNodeVisible(node, walk->view)) {
+        return;
+    }
+
+    if (tier > walk->tier) {
+        for (int i = 0; i < TRACK_GROUP; i++) {
+            walkNode(walk, tier - 1, index * TRACK_GROUP + i); // finer than this tier, look at the children
+        }
+        return;
+    }
+
+    if (walk->level < 0) {
+        visitRun(walk, walk->track->chunks[index], TRACK_CHUNK_POINTS); // tier 0, zoomed in below the finest tolerance
+        return;
+    }
+
+    // the level, or the coarsest version of a node that isn't merged into the level's tier yet
+    int version = walk->level - tier * TRACK_LEVELS_PER_TIER;
+    if (version >= TRACK_LEVELS_PER_TIER) {
+        version = TRACK_LEVELS_PER_TIER - 1;
+    }
+    visitRun(walk, &node->points[node->levelStart[version]], node->levelCount[version]);
+}
+
+int forEachVisibleTrackRun(const GroundTrack *track, const TrackView *view, TrackRunFunction visit, void *user){
+    TrackWalk walk = {track, view, -1, 0, visit, user, 0};
+
+    // coarsest level whose error stays below a pixel
+    for (int level = TRACK_LEVELS - 1; level >= 0; level--) {
+        if (getTrackTolerance(level) <= view->pixelSize) {
+            walk.level = level;
+            walk.tier = level / TRACK_LEVELS_PER_TIER;
+            break;
+        }
+    }
+
+    // oldest first: the top tier, then the nodes of every tier that aren't merged yet
+    for (int tier = TRACK_TIERS - 1; tier >= 0; tier--) {
+        const int first = (tier == TRACK_TIERS - 1) ? 0 : track->nodeCount[tier + 1] * TRACK_GROUP;
+        for (int i = first; i < track->nodeCount[tier]; i++) {
+            walkNode(&walk, tier, i);
+        }
+    }
+
+    // the open chunk, at most TRACK_CHUNK_POINTS raw points
+    if (track->chunkCount > track->nodeCount[0]) {
+        visitRun(&walk, track->chunks[track->chunkCount - 1], track->openCount);
+    }
+
+    return walk.visited;
+}
@@ -0,0 +1,339 @@
+/**
+ * @file hudTape.c
+ *
+ * @brief This file contains the HUD tapes: their strips are rendered once into tiles, drawing only copies the visible window.
+ */
+
+// Include header files
+#include "hudTape.h"
+#include "renderBatch.h"
+#include "rasterizer.h"
+#include "logger.h"
+
+// Include necessary libraries
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LABEL_GAP 3 // between a major tick and its number
+
+/* ##### POSITIONS ##### */
+
+// Wrap a position into the strip of a circular tape
+static float wrapPosition(float position, int length){
+    position = fmodf(position, (float)length);
+    if (position < 0.0f) {
+        position += (float)length;
+    }
+    return (position < (float)length) ? position : 0.0f; // -0.0001 + length rounds to length
+}
+
+float getHudTapePosition(const HudTape *tape, float value){
+    const TapeScale *scale = &tape->scale;
+    float along = 0.0f;
+
+    if (scale->circular) {
+        along = wrapPosition((value - scale->minimum) * scale->pixelsPerUnit, tape->length);
+    }
+    else {
+        value = fminf(fmaxf(value, scale->minimum), scale->maximum); // fmaxf drops NaN
+        along = (float)TAPE_PADDING + (value - scale->minimum) * scale->pixelsPerUnit;
+    }
+
+    if (!scale->horizontal) {
+        along = (float)tape->length - along; // values grow upwards
+        if (scale->circular) {
+            along = wrapPosition(along, tape->length);
+        }
+    }
+    return along;
+}
+
+/* ##### RENDERING THE STRIP ##### */
+
+// Fill a rectangle of the strip, clipped
+static void fillStrip(Uint32 *pixels, int width, int height, int x, int y, int w, int h, Uint32 color){
+    const int x0 = (x > 0) ? x : 0;
+    const int y0 = (y > 0) ? y : 0;
+    const int x1 = (x + w < width) ? x + w : width;
+    const int y1 = (y + h < height) ? y + h : height;
+
+    for (int row = y0; row < y1; row++) {
+        for (int column = x0; column < x1; column++) {
+            pixels[row * width + column] = color;
+        }
+    }
+}
+
+// Copy a rendered number into the strip, clipped, where pixels overlap the more opaque one wins
+static void blitStrip(Uint32 *pixels, int width, int height, const SDL_Surface *surface, int x, int y){
+    for (int row = 0; row < surface->h; row++) {
+        if (y + row < 0 || y + row >= height) {
+            continue;
+        }
+        const Uint32 *source = (const Uint32 *)((const Uint8 *)surface->pixels + row * surface->pitch);
+        Uint32 *destination = &pixels[(y + row) * width];
+
+        for (int column = 0; column < surface->w; column++) {
+            if (x + column < 0 || x + column >= width) {
+                continue;
+            }
+            if ((source[column] >> 24) > (destination[x + column] >> 24)) {
+                destination[x + column] = source[column];
+            }
+        }
+    }
+}
+
+static SDL_Surface *renderLabel(TTF_Font *font, const TapeScale *scale, float value){
+    char text[32];
+    if (scale->label != NULL) {
+        scale->label(text, sizeof(text), value);
+    }
+    else {
+        snprintf(text, sizeof(text), "%.0f", (double)value);
+    }
+
+    SDL_Surface *surface = TTF_RenderUTF8_Blended(font, text, scale->color);
+    if (surface == NULL) {
+        logMessage(LOG_WARNING, "Failed to render tape number %s: %s", text, TTF_GetError());
+        return NULL;
+    }
+    if (surface->format->format != SDL_PIXELFORMAT_ARGB8888) {
+        SDL_Surface *converted = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+        SDL_FreeSurface(surface);
+        surface = converted;
+    }
+    return surface;
+}
+
+// Ticks along the edge and a number at every major tick, over the whole range
+static void renderStrip(const HudTape *tape, TTF_Font *font, Uint32 *pixels, int width, int height){
+    const TapeScale *scale = &tape->scale;
+    const Uint32 color = ((Uint32)scale->color.a << 24) | ((Uint32)scale->color.r << 16) | ((Uint32)scale->color.g << 8) | (Uint32)scale->color.b;
+    const int majorLength = (scale->thickness / 4 > 6) ? scale->thickness / 4 : 6;
+    const int minorLength = majorLength / 2;
+    const int majorEvery = (int)lroundf(scale->majorStep / scale->minorStep);
+    const int ticks = (int)floorf((scale->maximum - scale->minimum) / scale->minorStep + 0.001f); // no tick past the maximum
+
+    // the edge the ticks stand on
+    if (scale->horizontal) {
+        fillStrip(pixels, width, height, 0, scale->ticksAtEnd ? height - 1 : 0, width, 1, color);
+    }
+    else {
+        fillStrip(pixels, width, height, scale->ticksAtEnd ? width - 1 : 0, 0, 1, height, color);
+    }
+
+    for (int i = 0; i < ticks + (scale->circular ? 0 : 1); i++) { // circular: the last tick is the first one
+        const float value = scale->minimum + (float)i * scale->minorStep;
+        const int along = (int)floorf(getHudTapePosition(tape, value));
+        const int major = (majorEvery <= 0 || i % majorEvery == 0);
+        const int tickLength = major ? majorLength : minorLength;
+
+        if (scale->horizontal) {
+            fillStrip(pixels, width, height, along, scale->ticksAtEnd ? height - tickLength : 0, 1, tickLength, color);
+        }
+        else {
+            fillStrip(pixels, width, height, scale->ticksAtEnd ? width - tickLength : 0, along, tickLength, 1, color);
+        }
+
+        if (!major) {
+            continue;
+        }
+        SDL_Surface *label = renderLabel(font, scale, value);
+        if (label == NULL) {
+            continue;
+        }
+
+        int x = 0;
+        int y = 0;
+        if (scale->horizontal) {
+            x = along - label->w / 2;
+            y = scale->ticksAtEnd ? height - majorLength - LABEL_GAP - label->h : majorLength + LABEL_GAP;
+        }
+        else {
+            x = scale->ticksAtEnd ? width - majorLength - LABEL_GAP - label->w : majorLength + LABEL_GAP;
+            y = along - label->h / 2;
+        }
+        blitStrip(pixels, width, height, label, x, y);
+
+        // numbers cut by the end of a circular strip continue at the other end
+        if (scale->circular && scale->horizontal) {
+            blitStrip(pixels, width, height, label, x - tape->length, y);
+            blitStrip(pixels, width, height, label, x + tape->length, y);
+        }
+        else if (scale->circular) {
+            blitStrip(pixels, width, height, label, x, y - tape->length);
+            blitStrip(pixels, width, height, label, x, y + tape->length);
+        }
+        SDL_FreeSurface(label);
+    }
+}
+
+/* ##### TILES ##### */
+
+// Cut the strip into tiles, one static texture and a copy of its pixels each
+static int createTiles(HudTape *tape, SDL_Renderer *renderer, const Uint32 *pixels, int width){
+    const int thickness = tape->scale.thickness;
+    tape->tileCount = (tape->length + TAPE_TILE_LENGTH - 1) / TAPE_TILE_LENGTH;
+
+    for (int i = 0; i < tape->tileCount; i++) {
+        const int start = i * TAPE_TILE_LENGTH;
+        const int tileLength = (tape->length - start < TAPE_TILE_LENGTH) ? tape->length - start : TAPE_TILE_LENGTH;
+        const int tileWidth = tape->scale.horizontal ? tileLength : thickness;
+        const int tileHeight = tape->scale.horizontal ? thickness : tileLength;
+
+        tape->tilePixels[i] = malloc((size_t)tileWidth * (size_t)tileHeight * sizeof(Uint32));
+        tape->tiles[i] = createRenderTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, tileWidth, tileHeight);
+        if (tape->tilePixels[i] == NULL || tape->tiles[i] == NULL) {
+            logMessage(LOG_ERROR, "Failed to create a %dx%d tape tile: %s", tileWidth, tileHeight, SDL_GetError());
+            return 0;
+        }
+
+        for (int row = 0; row < tileHeight; row++) {
+            const Uint32 *source = tape->scale.horizontal ? &pixels[row * width + start] : &pixels[(start + row) * width];
+            memcpy(&tape->tilePixels[i][row * tileWidth], source, (size_t)tileWidth * sizeof(Uint32));
+        }
+
+        SDL_SetTextureBlendMode(tape->tiles[i], SDL_BLENDMODE_BLEND);
+        SDL_SetTextureScaleMode(tape->tiles[i], SDL_ScaleModeLinear); // sub-pixel scrolling
+        SDL_UpdateTexture(tape->tiles[i], NULL, tape->tilePixels[i], tileWidth * 4);
+        registerRasterTexture(tape->tiles[i], tape->tilePixels[i], tileWidth, tileHeight); // the CPU rasterizer reads the copy
+    }
+
+    return 1;
+}
+
+int createHudTape(HudTape *tape, SDL_Renderer *renderer, TTF_Font *font, const TapeScale *scale){
+    if (tape == NULL) {
+        logMessage(LOG_ERROR, "Invalid arguments passed to createHudTape.");
+        return 0;
+    }
+    memset(tape, 0, sizeof(*tape));
+
+    if (renderer == NULL || font == NULL || scale == NULL || scale->thickness <= 0 || scale->pixelsPerUnit <= 0.0f || scale->minorStep <= 0.0f || !(scale->maximum > scale->minimum)) {
+        logMessage(LOG_ERROR, "Invalid arguments passed to createHudTape.");
+        return 0;
+    }
+    tape->scale = *scale;
+
+    const float range = (scale->maximum - scale->minimum) * scale->pixelsPerUnit;
+    tape->length = scale->circular ? (int)lroundf(range) : (int)ceilf(range) + 2 * TAPE_PADDING;
+    if (tape->length > MAX_TAPE_TILES * TAPE_TILE_LENGTH) {
+        logMessage(LOG_ERROR, "A %d pixel tape needs more than %d tiles.", tape->length, MAX_TAPE_TILES);
+        tape->length = 0;
+        return 0;
+    }
+
+    // the whole strip, cut into tiles afterwards so numbers on tile edges are drawn in one piece
+    const int width = scale->horizontal ? tape->length : scale->thickness;
+    const int height = scale->horizontal ? scale->thickness : tape->length;
+    Uint32 *pixels = calloc((size_t)width * (size_t)height, sizeof(Uint32)); // transparent
+    if (pixels == NULL) {
+        logMessage(LOG_ERROR, "Failed to allocate a %dx%d tape.", width, height);
+        return 0;
+    }
+
+    renderStrip(tape, font, pixels, width, height);
+    const int created = createTiles(tape, renderer, pixels, width);
+    free(pixels);
+
+    if (!created) {
+        freeHudTape(tape);
+        return 0;
+    }
+    return 1;
+}
+
+void freeHudTape(HudTape *tape){
+    if (tape == NULL) {
+        return;
+    }
+
+    for (int i = 0; i < MAX_TAPE_TILES; i++) {
+        if (tape->tiles[i] != NULL) {
+            unregisterRasterTexture(tape->tiles[i]);
+            SDL_DestroyTexture(tape->tiles[i]);
+            tape->tiles[i] = NULL;
+        }
+        free(tape->tilePixels[i]);
+        tape->tilePixels[i] = NULL;
+    }
+    tape->tileCount = 0;
+}
+
+/* ##### DRAWING ##### */
+
+// One textured quad: the part of a tile from along to along + size, on screen from offset to offset + size
+static void drawTilePiece(const HudTape *tape, const SDL_Rect *area, int tile, float along, float offset, float size){
+    const int tileLength = (tape->length - tile * TAPE_TILE_LENGTH < TAPE_TILE_LENGTH) ? tape->length - tile * TAPE_TILE_LENGTH : TAPE_TILE_LENGTH;
+    const float t0 = along / (float)tileLength;
+    const float t1 = (along + size) / (float)tileLength;
+    const SDL_Color white = {255, 255, 255, 255};
+
+    float x0 = (float)area->x;
+    float y0 = (float)area->y;
+    float x1 = (float)(area->x + area->w);
+    float y1 = (float)(area->y + area->h);
+    SDL_FPoint uv0 = {0.0f, t0};
+    SDL_FPoint uv1 = {1.0f, t1};
+
+    if (tape->scale.horizontal) {
+        x0 = (float)area->x + offset;
+        x1 = x0 + size;
+        uv0 = (SDL_FPoint){t0, 0.0f};
+        uv1 = (SDL_FPoint){t1, 1.0f};
+    }
+    else {
+        y0 = (float)area->y + offset;
+        y1 = y0 + size;
+    }
+
+    const SDL_Vertex quad[4] = {
+        {{x0, y0}, white, {uv0.x, uv0.y}},
+        {{x1, y0}, white, {uv1.x, uv0.y}},
+        {{x1, y1}, white, {uv1.x, uv1.y}},
+        {{x0, y1}, white, {uv0.x, uv1.y}}
+    };
+    const int quadIndices[6] = {0, 1, 2, 0, 2, 3};
+
+    batchGeometry(BATCH_LAYER_BACKGROUND, tape->tiles[tile], quad, 4, quadIndices, 6);
+}
+
+void drawHudTape(const HudTape *tape, const SDL_Rect *area, float value){
+    if (tape->tileCount == 0) {
+        return;
+    }
+
+    // the window starts on a fraction of a strip pixel, the screen side stays on whole pixels
+    const float window = (float)(tape->scale.horizontal ? area->w : area->h);
+    const float start = getHudTapePosition(tape, value) - 0.5f * window;
+    float offset = 0.0f;
+
+    while (offset < window) {
+        float along = start + offset;
+        if (tape->scale.circular) {
+            along = wrapPosition(along, tape->length);
+        }
+        else if (along < 0.0f) {
+            offset -= along; // nothing before the strip
+            continue;
+        }
+        else if (along >= (float)tape->length) {
+            break; // nor after it
+        }
+
+        int tile = (int)(along / (float)TAPE_TILE_LENGTH);
+        tile = (tile < tape->tileCount) ? tile : tape->tileCount - 1;
+        const float tileStart = (float)(tile * TAPE_TILE_LENGTH);
+        const float tileEnd = fminf(tileStart + (float)TAPE_TILE_LENGTH, (float)tape->length);
+        const float size = fminf(window - offset, tileEnd - along);
+        if (size <= 0.0f) {
+            break;
+        }
+
+        drawTilePiece(tape, area, tile, along - tileStart, offset, size);
+        offset += size;
+    }
+}
@@ -0,0 +1,308 @@
+/**
+ * @file hudWidgets.c
+ *
+ * @brief This file contains the retained widget tree of the HUD: value bindings, formatting and layout.
+ */
+
+// Include header files
+#include "hudWidgets.h"
+#include "logger.h"
+
+// Include necessary libraries
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define UNKNOWN_VALUE LLONG_MIN // not a number, or too big to compare, always formatted again
+
+static Widget widgets[MAX_WIDGETS];
+static int widgetCount = 0;
+static int layoutDirty = 1;
+static WidgetMeasureFunction measureWidgetText = NULL;
+static Uint32 minimumLabelInterval = 0;
+static Uint32 minimumGaugeInterval = 0;
+
+void setWidgetMeasure(WidgetMeasureFunction measure){
+    measureWidgetText = measure;
+}
+
+void setWidgetRateLimits(Uint32 labelInterval, Uint32 gaugeInterval){
+    minimumLabelInterval = labelInterval;
+    minimumGaugeInterval = gaugeInterval;
+}
+
+static Widget *createWidget(Widget *parent, WidgetType type){
+    if (widgetCount >= MAX_WIDGETS) {
+        logMessage(LOG_ERROR, "Can't create more than %d widgets.", MAX_WIDGETS);
+        return NULL;
+    }
+
+    Widget *widget = &widgets[widgetCount++];
+    memset(widget, 0, sizeof(*widget));
+    widget->type = type;
+    widget->visible = 1;
+    widget->parent = parent;
+
+    if (parent != NULL) {
+        if (parent->lastChild != NULL) {
+            parent->lastChild->nextSibling = widget;
+        }
+        else {
+            parent->firstChild = widget;
+        }
+        parent->lastChild = widget;
+    }
+
+    layoutDirty = 1;
+    return widget;
+}
+
+Widget *createPanel(Widget *parent, int x, int y, int stacked, int spacing){
+    Widget *panel = createWidget(parent, WIDGET_PANEL);
+    if (panel != NULL) {
+        panel->x = x;
+        panel->y = y;
+        panel->stacked = stacked;
+        panel->spacing = spacing;
+    }
+    return panel;
+}
+
+Widget *createSpacer(Widget *parent, int height){
+    Widget *spacer = createWidget(parent, WIDGET_SPACER);
+    if (spacer != NULL) {
+        spacer->height = height;
+    }
+    return spacer;
+}
+
+Widget *createLabel(Widget *parent, const char *prefix, WidgetValueFunction value, const void *context, int decimals, const char *suffix, Uint32 interval, SDL_Color color){
+    Widget *label = createWidget(parent, WIDGET_LABEL);
+    if (label != NULL) {
+        label->prefix = (prefix != NULL) ? prefix : "";
+        label->suffix = (suffix != NULL) ? suffix : "";
+        label->value = value;
+        label->context = context;
+        label->decimals = decimals;
+        label->interval = interval;
+        label->color = color;
+        label->shownValue = UNKNOWN_VALUE;
+    }
+    return label;
+}
+
+void setLabelFormat(Widget *label, WidgetFormatFunction format){
+    if (label != NULL && label->type == WIDGET_LABEL) {
+        label->format = format;
+        label->formatted = 0;
+    }
+}
+
+Widget *createGauge(Widget *parent, int style, int x, int y, int radius, WidgetValueFunction value, WidgetValueFunction maxValue, const void *context, Uint32 interval){
+    Widget *gauge = createWidget(parent, WIDGET_GAUGE);
+    if (gauge != NULL) {
+        gauge->style = style;
+        gauge->x = x;
+        gauge->y = y;
+        gauge->radius = radius;
+        gauge->width = 2 * radius;
+        gauge->height = 2 * radius;
+        gauge->value = value;
+        gauge->maxValue = maxValue;
+        gauge->context = context;
+        gauge->interval = interval;
+    }
+    return gauge;
+}
+
+Widget *createChart(Widget *parent, int style, int x, int y, int width, int height, Uint32 interval){
+    Widget *chart = createWidget(parent, WIDGET_CHART);
+    if (chart != NULL) {
+        chart->style = style;
+        chart->x = x;
+        chart->y = y;
+        chart->width = width;
+        chart->height = height;
+        chart->interval = interval;
+    }
+    return chart;
+}
+
+// Everything under the widget is read again on the next update
+static void expireWidgets(Widget *widget){
+    widget->nextUpdate = 0;
+    for (Widget *child = widget->firstChild; child != NULL; child = child->nextSibling) {
+        expireWidgets(child);
+    }
+}
+
+void setWidgetVisible(Widget *widget, int visible){
+    if (widget == NULL || widget->visible == (visible != 0)) {
+        return;
+    }
+
+    widget->visible = (visible != 0);
+    if (widget->visible) {
+        expireWidgets(widget); // hidden widgets aren't updated, don't show stale values
+    }
+    layoutDirty = 1;
+}
+
+// The value as the label shows it, 12.345 with 2 decimals is 1235
+static long long quantizeValue(float value, int decimals){
+    double scaled = (double)value;
+    for (int i = 0; i < decimals; i++) {
+        scaled *= 10.0;
+    }
+
+    if (!isfinite(scaled) || fabs(scaled) > 9.0e18) {
+        return UNKNOWN_VALUE;
+    }
+    return llround(scaled);
+}
+
+static void updateLabel(Widget *label){
+    char previousText[MAX_WIDGET_TEXT];
+    SDL_Color previousColor = label->color;
+    float value = 0.0f;
+
+    if (label->value != NULL) {
+        value = label->value(label->context);
+
+        long long shown = quantizeValue(value, label->decimals);
+        if (label->formatted && shown == label->shownValue && shown != UNKNOWN_VALUE) {
+            return; // same text as before
+        }
+        label->shownValue = shown;
+    }
+    else if (label->formatted) {
+        return; // fixed text
+    }
+
+    memcpy(previousText, label->text, sizeof(previousText));
+
+    if (label->format != NULL) {
+        label->format(label->text, sizeof(label->text), value, &label->color);
+    }
+    else if (label->value != NULL) {
+        snprintf(label->text, sizeof(label->text), "%s%.*f%s", label->prefix, label->decimals, (double)value, label->suffix);
+    }
+    else {
+        snprintf(label->text, sizeof(label->text), "%s%s", label->prefix, label->suffix);
+    }
+
+    int colorChanged = memcmp(&previousColor, &label->color, sizeof(SDL_Color)) != 0;
+    if (!label->formatted || colorChanged || strcmp(previousText, label->text) != 0) {
+        label->revision++;
+        if (measureWidgetText != NULL) {
+            measureWidgetText(label->text, &label->width, &label->height);
+        }
+    }
+    label->formatted = 1;
+}
+
+static void updateWidget(Widget *widget, Uint64 now){
+    if (!widget->visible) {
+        return;
+    }
+
+    switch (widget->type) {
+        case WIDGET_PANEL:
+            for (Widget *child = widget->firstChild; child != NULL; child = child->nextSibling) {
+                updateWidget(child, now);
+            }
+            break;
+        case WIDGET_LABEL:
+            if (!widget->formatted || now >= widget->nextUpdate) {
+                updateLabel(widget);
+                widget->nextUpdate = now + ((widget->interval > minimumLabelInterval) ? widget->interval : minimumLabelInterval);
+            }
+            break;
+        case WIDGET_GAUGE:
+            if (now >= widget->nextUpdate) {
+                widget->current = (widget->value != NULL) ? widget->value(widget->context) : 0.0f;
+                widget->maximum = (widget->maxValue != NULL) ? widget->maxValue(widget->context) : 0.0f;
+                widget->nextUpdate = now + ((widget->interval > minimumGaugeInterval) ? widget->interval : minimumGaugeInterval);
+            }
+            break;
+        case WIDGET_CHART:
+            if (now >= widget->nextUpdate) {
+                widget->revision++; // new samples to show
+                widget->nextUpdate = now + ((widget->interval > minimumGaugeInterval) ? widget->interval : minimumGaugeInterval);
+            }
+            break;
+        case WIDGET_SPACER:
+        default:
+            break;
+    }
+}
+
+// Place the visible children of stacked panels under each other, returns the height the widget takes up
+static int layoutWidget(Widget *widget){
+    if (widget->type != WIDGET_PANEL) {
+        return widget->height;
+    }
+
+    int cursor = widget->y;
+    for (Widget *child = widget->firstChild; child != NULL; child = child->nextSibling) {
+        if (!child->visible) {
+            continue;
+        }
+
+        if (widget->stacked) {
+            child->x = widget->x;
+            child->y = cursor;
+        }
+
+        int childHeight = layoutWidget(child);
+        if (child->type == WIDGET_LABEL) {
+            childHeight = widget->spacing; // lines, not text heights
+        }
+        cursor += childHeight;
+    }
+
+    if (widget->stacked) {
+        widget->height = cursor - widget->y;
+    }
+    return widget->height;
+}
+
+void updateWidgets(Widget *root, Uint64 now){
+    if (root == NULL) {
+        return;
+    }
+
+    if (layoutDirty) {
+        layoutWidget(root);
+        layoutDirty = 0;
+    }
+    updateWidget(root, now);
+}
+
+static void visitWidget(const Widget *widget, WidgetVisitFunction visit, void *user){
+    if (!widget->visible) {
+        return;
+    }
+
+    if (widget->type == WIDGET_PANEL) {
+        for (const Widget *child = widget->firstChild; child != NULL; child = child->nextSibling) {
+            visitWidget(child, visit, user);
+        }
+    }
+    else if (widget->type == WIDGET_LABEL || widget->type == WIDGET_GAUGE || widget->type == WIDGET_CHART) {
+        visit(widget, user);
+    }
+}
+
+void forEachVisibleWidget(const Widget *root, WidgetVisitFunction visit, void *user){
+    if (root != NULL && visit != NULL) {
+        visitWidget(root, visit, user);
+    }
+}
+
+void destroyWidgets(void){
+    memset(widgets, 0, sizeof(widgets));
+    widgetCount = 0;
+    layoutDirty = 1;
+}
@@ -15,6 +15,11 @@
 #include "2Drenderer.h"
 #include "menu.h"
 #include "aircraftData.h"
+#include "aircraftModel.h"
+#include "weather.h"
+#include "simulation.h"
+#include "renderGovernor.h"
+#include "capture.h"
 
 // Include standard libraries
 #include <stdio.h>
@@ -25,6 +30,9 @@
 #include <SDL2/SDL.h>
 
 #define FILE_PATH "data/aircraftData.txt" // Define file path for aircraft data
+#define WIND_FIELD_PATH "data/windField.wfd" // Optional gridded wind field
+#define IDLE_WAIT_MS 250 // Longest block on the event queue while paused or hidden
+#define BACKGROUND_FRAME_MS 100 // Frame time while the window doesn't have the focus (10 FPS)
 
 #ifdef _WIN32
     #define CLEAR "cls" // Define clear command for Windows
@@ -35,6 +43,10 @@
 // global var to check if the plane is crashed
 static int crashed = 0;
 
+// Window state, nothing is rendered while the window can't be seen
+static int windowVisible = 1;
+static int windowFocused = 1;
+
 // Prototype for message function
 void message(void);
 
@@ -56,16 +68,72 @@ void message(void) {
     printf("\n\n");
 }
 
+// Handle one SDL event
+static void handleEvent(SDL_Event *event, int *running) {
+    if (event->type == SDL_QUIT) { // Check for quit event
+        *running = 0; // Set running to 0 to exit loop
+    }
+    if (event->type == SDL_RENDER_TARGETS_RESET || event->type == SDL_RENDER_DEVICE_RESET) { // Check if the renderer lost its textures
+        invalidateGaugeLayers(); // Draw the gauge backgrounds again
+        invalidateHUD(); // The last frame is gone as well
+    }
+    if (event->type == SDL_WINDOWEVENT) { // Check for the window being exposed, resized, restored, ...
+        switch (event->window.event) {
+            case SDL_WINDOWEVENT_HIDDEN:
+            case SDL_WINDOWEVENT_MINIMIZED:
+                windowVisible = 0; // Stop rendering
+                break;
+            case SDL_WINDOWEVENT_SHOWN:
+            case SDL_WINDOWEVENT_EXPOSED:
+            case SDL_WINDOWEVENT_RESTORED:
+            case SDL_WINDOWEVENT_MAXIMIZED:
+                windowVisible = 1; // Render again
+                break;
+            case SDL_WINDOWEVENT_FOCUS_LOST:
+                windowFocused = 0; // Render at the background rate
+                break;
+            case SDL_WINDOWEVENT_FOCUS_GAINED:
+                windowFocused = 1; // Render at the full rate
+                break;
+            default:
+                break;
+        }
+        invalidateHUD(); // Draw the whole HUD again
+    }
+    if (event->type == SDL_KEYDOWN) { // Check for key down event
+        if (event->key.keysym.sym == SDLK_ESCAPE) { // Check for escape key
+            *running = 0; // Set running to 0 to exit loop
+        }
+        if ((event->key.keysym.sym == SDLK_SPACE || event->key.keysym.sym == SDLK_PAUSE) && !event->key.repeat) { // Check for the pause keys
+            setSimulationPaused(!isSimulationPaused()); // Freeze or resume the simulation time
+        }
+        handleKeyEvents(event); // Handle other key events
+    }
+}
+
+// How long the loop may block on the event queue, 0 while it runs at the full frame rate
+static int getIdleWait(void) {
+    if (isCapturing()) {
+        return 0; // The recording needs every frame
+    }
+    if (!windowVisible || isSimulationPaused()) {
+        return IDLE_WAIT_MS; // Nothing changes on screen, wake up for input (and a crash check)
+    }
+    if (!windowFocused) {
+        return BACKGROUND_FRAME_MS; // Still visible, updated less often
+    }
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
     // Ignore arguments (safer than letting them be)
     (void)argc;
     (void)argv;
 
-    long startTime, elapsedTime, previousTime; // Time tracking variables
+    long startTime, elapsedTime, previousTime, renderTime; // Time tracking variables
     float deltaTime; // Delta time calculation
     float fps; // Frames per second calculation
-    AircraftState aircraft;
-    float simulationTime = 0.0f; // Simulation time
+    AircraftState aircraft; // Initial state, the simulation thread owns the aircraft once it runs
 
     // ----- SELECT AIRCRAFT -----
     Aircraft aircraftList[MAX_AIRCRAFT]; // Array for aircraft names
@@ -82,20 +150,47 @@ int main(int argc, char* argv[]) {
     getAircraftDataByName(FILE_PATH, aircraftList[selectedIndex].name, &aircraftData); // Populate aircraftData
     maxFuelKgs = (float)aircraftData.fuelCapacity; // kgs
 
+    // Compile the per-aircraft constants once, the physics reads these every tick
+    CompiledAircraftModel aircraftModel;
+    if (!compileAircraftModel(&aircraftData, &aircraftModel)) {
+        return 1; // Return error if the aircraft data is unusable
+    }
+
     // Initialize aircraft state using data from file
     initAircraft(&aircraft, &aircraftData); 
     aircraft.fuel = 150.0f; // test
     aircraft.hasAfterburner = (aircraftData.afterburnerThrust != 0); // Update afterburner flag
 
+    // Initialize the weather (one turbulence slot for the player's aircraft)
+    if (!initWeather(1, TURBULENCE_LIGHT)) {
+        return 1; // Return error if the turbulence state can't be allocated
+    }
+
+    // Use the gridded wind field if there is one, otherwise the analytic wind
+    FILE *windFieldFile = fopen(WIND_FIELD_PATH, "rb");
+    if (windFieldFile != NULL) {
+        fclose(windFieldFile);
+        loadWindField(WIND_FIELD_PATH);
+    }
+
     previousTime = getTimeMicroseconds(); // Get initial time
 
     // Initialize SDL2 Text Renderer and input system
     initTextRenderer(); // Initialize text renderer
     startControls(); // Start input thread
 
+    // Physics and weather run on their own thread from now on, the loop below only handles events and renders
+    if (!startSimulation(&aircraft, &aircraftModel, getControls())) {
+        destroyTextRenderer();
+        freeWeather();
+        return 1; // Return error if the simulation thread can't be started
+    }
+
     SDL_Event event; // Variable for SDL events
     int running = 1; // Main loop control
 
+    initRenderGovernor(RENDER_BUDGET_MICROSECONDS); // Start at full HUD quality
+
     system(CLEAR); // Clear console
     printf("===== Robkoo's Flight simulator debug console =====\n"); // Debug message
 
@@ -103,57 +198,63 @@ int main(int argc, char* argv[]) {
     while (running) {
         startTime = getTimeMicroseconds(); // Get start time
 
+        // Get the newest state of the simulation (never waits for the simulation thread)
+        const SimulationSnapshot *snapshot = acquireSimulationSnapshot();
+
         // if the plane is crashed, exit the loop
-        if (aircraft.y <= 0.0f){
+        if (snapshot->crashed){
             running = 0; // crashed
             crashed = 1;
         }
 
         // Event handling (for input)
         while (SDL_PollEvent(&event)) { // Poll for SDL events
-            if (event.type == SDL_QUIT) { // Check for quit event
-                running = 0; // Set running to 0 to exit loop
-            }
-            if (event.type == SDL_KEYDOWN) { // Check for key down event
-                if (event.key.keysym.sym == SDLK_ESCAPE) { // Check for escape key
-                    running = 0; // Set running to 0 to exit loop
-                }
-                handleKeyEvents(&event); // Handle other key events
-            }
+            handleEvent(&event, &running); // Quit, window state, keys
         }
 
         // Calculate delta time
         deltaTime = (float)((double)(startTime - previousTime) / 1000000.0); // Calculate time difference in seconds
-        simulationTime += deltaTime; // Update simulation time
         previousTime = startTime; // Update previous time
 
         // Calculate FPS
         fps = 1.0f / deltaTime; // Calculate frames per second
 
-        // Get controls
-        AircraftControls *controls = getControls(); // Get current controls
-        aircraft.yaw = controls->yaw; // Update aircraft yaw
-        aircraft.pitch = controls->pitch; // Update aircraft pitch
-        aircraft.roll = controls->roll; // Update aircraft roll
-        aircraft.controls.throttle = controls->throttle; // Update aircraft throttle
-        aircraft.controls.afterburner = (aircraft.controls.throttle > 1); // Update afterburner status
-
-        // Update physics
-        updatePhysics(&aircraft, deltaTime, simulationTime, &aircraftData); // Update aircraft physics
-        updateAircraftState(&aircraft, deltaTime); // Update aircraft state
+        // Hand the controls to the simulation thread
+        setSimulationControls(getControls());
 
-        // Render aircraft data using SDL2
-        renderFlightInfo(&aircraft, &aircraftData, fps, simulationTime); // Render flight information
+        // Render aircraft data using SDL2, unless the window can't be seen or the governor halved the render rate
+        int idleWait = getIdleWait(); // Paused, hidden or in the background?
+        renderTime = 0; // Skipped frames cost nothing
+        if (windowVisible && (idleWait > 0 || shouldRenderFrame())) {
+            long renderStart = getTimeMicroseconds(); // Measure what the HUD costs
+            renderFlightInfo(snapshot, &aircraftData, fps); // Render flight information
+            renderTime = getTimeMicroseconds() - renderStart; // Render time of this frame
+        }
+        else {
+            captureRepeatFrame(); // The recording keeps its timing
+        }
+        if (idleWait == 0) {
+            updateRenderGovernor(renderTime, getSimulationStats().late); // Lower or raise the HUD quality
+        }
 
         // Frame rate control
-        elapsedTime = getTimeMicroseconds() - startTime; // Calculate elapsed time
-        if (elapsedTime < FRAME_TIME_MICROSECONDS) { // Check if frame time is less than desired frame time
-            sleepMicroseconds(FRAME_TIME_MICROSECONDS - elapsedTime); // Sleep for remaining time
+        if (idleWait > 0) {
+            if (SDL_WaitEventTimeout(&event, idleWait)) { // Sleep until there is input or the timeout runs out
+                handleEvent(&event, &running); // The rest is polled on the next iteration
+            }
+        }
+        else {
+            elapsedTime = getTimeMicroseconds() - startTime; // Calculate elapsed time
+            if (elapsedTime < FRAME_TIME_MICROSECONDS) { // Check if frame time is less than desired frame time
+                sleepMicroseconds(FRAME_TIME_MICROSECONDS - elapsedTime); // Sleep for remaining time
+            }
         }
     }
 
     // Cleanup
+    stopSimulation(); // Stop the simulation thread
     destroyTextRenderer(); // Destroy text renderer
+    freeWeather(); // Free the weather state
 
     return 0; // Return success
 }
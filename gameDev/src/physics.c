@@ -26,8 +26,11 @@ PhysicsData globalPhysicsData;
 // global max fuel var
 float maxFuelKgs = 0; // 0 base value
 
+// Velocity integrator of updatePhysics(), set before the simulation starts
+static PhysicsIntegrator physicsIntegrator = INTEGRATOR_RK4;
+
 /* Atmospheric Constants */
-const float airDensityAtSeaLevel = 1.225f;        // Sea-level air density in kg/m³
+const float airDensityAtSeaLevel = SEA_LEVEL_AIR_DENSITY; // Sea-level air density in kg/m³
 const float T0 = 288.15f;                         // Sea-level temperature in Kelvin
 const float lapseRate = 6.5f;                     // Temperature lapse rate in K per km
 const float rhoTop = 0.3639f;                     // Air density at the tropopause in kg/m³
@@ -41,15 +44,6 @@ const float Kt = -0.0065f;                        // Temperature lapse rate in t
 /* Speed of Sound Calculation */
 const float baseSpeedOfSoundFactor = 340.29f;     // Factor to compute speed of sound below tropopause
 
-/* Drag Coefficient Constants */
-float alpha, kw, Md;
-
-void fillConstants(AircraftData *data){
-    alpha = data->alpha;
-    kw = data->kw;
-    Md = data->Md;
-}
-
 /* Pressure Calculation */
 const float P0 = 101325.0f;                       // Sea-level atmospheric pressure in Pascals
 
@@ -435,23 +429,24 @@ float calculateAspectRatio(float wingspan, float wingArea) {
     return wingspan * wingspan / wingArea; // calculate and return aspect ratio
 }
 
-float calculateDragCoefficient(float speed, float maxSpeed, float C_d0, PhysicsData *physicsData){
+float calculateDragCoefficient(float speed, float C_d0, const CompiledAircraftModel *model, PhysicsData *physicsData){
     // check for errors or warnings
     CHECK_VAR(convertMsToKmh(speed), "speed", "calculateDragCoefficient", 0.0f);
-    CHECK_VAR(maxSpeed, "maxSpeed", "calculateDragCoefficient", 0.0f);
     CHECK_VAR(C_d0, "C_d0", "calculateDragCoefficient", 0.0f);
+    CHECK_PTR(model, "model", "calculateDragCoefficient", 0.0f);
     CHECK_PTR(physicsData, "physicsData", "calculateDragCoefficient", 0.0f);
 
     float mach = speed / physicsData->speedOfSound; // calculate Mach number
+    float speedRatioSquared = speed * speed * model->invMaxSpeedMsSquared; // (V / Vmax)^2
 
     if (mach < 0.8f) { // Subsonic flight (Mach < 0.8)
-        return C_d0 + 0.05f * powf(speed / maxSpeed, 2); // calculate and return drag coefficient
+        return C_d0 + 0.05f * speedRatioSquared; // calculate and return drag coefficient
     }
     else if (mach < 1.2f) { // Transonic flight (Mach ~ 0.8 to 1.2)
-        return C_d0 + 0.05f * powf(speed / maxSpeed, 2) + alpha * powf((mach - 1), 2); // calculate and return drag coefficient
+        return C_d0 + 0.05f * speedRatioSquared + model->alpha * (mach - 1) * (mach - 1); // calculate and return drag coefficient
     }
     else { // Supersonic flight (Mach > 1.2)
-        return C_d0 + kw * powf((mach - Md), 2); // calculate and return drag coefficient
+        return C_d0 + model->kw * (mach - model->Md) * (mach - model->Md); // calculate and return drag coefficient
     }
 }
 
@@ -466,10 +461,10 @@ float calculateParasiticDrag(float C_d, float airDensity, float speed, float win
     return (0.5f * C_d * airDensity * powf(speed, 2) * wingArea) * M_DRAG_COEFFICIENT; // calculate and return parasitic drag
 }
 
-float calculateInducedDrag(float liftCoefficient, float aspectRatio, float airDensity, float wingArea, float speed) {
+float calculateInducedDrag(float liftCoefficient, float inducedDragFactor, float airDensity, float wingArea, float speed) {
     // check for errors or warnings
     CHECK_VAR(liftCoefficient, "liftCoefficient", "calculateInducedDrag", 0.0f);
-    CHECK_VAR(aspectRatio, "aspectRatio", "calculateInducedDrag", 0.0f);
+    CHECK_VAR(inducedDragFactor, "inducedDragFactor", "calculateInducedDrag", 0.0f);
     CHECK_VAR(airDensity, "airDensity", "calculateInducedDrag", 0.0f);
     CHECK_VAR(wingArea, "wingArea", "calculateInducedDrag", 0.0f);
     CHECK_SPEED_LIMIT(convertMsToKmh(speed), "calculateInducedDrag");
@@ -477,19 +472,21 @@ float calculateInducedDrag(float liftCoefficient, float aspectRatio, float airDe
 
     if (speed < 0.1f) return 0.0f; // Prevent divide-by-zero issues for very low speeds
 
-    return (0.5f * airDensity * powf(speed, 2) * wingArea * ((liftCoefficient * liftCoefficient) / (PI * aspectRatio * OEF))) * M_DRAG_COEFFICIENT; // calculate and return induced drag
+    return (0.5f * airDensity * powf(speed, 2) * wingArea * (liftCoefficient * liftCoefficient) * inducedDragFactor) * M_DRAG_COEFFICIENT; // calculate and return induced drag
 }
 
-float calculateDragDivergenceAroundMach(float speed, PhysicsData *physicsData){
+float calculateDragDivergenceAroundMach(float speed, const CompiledAircraftModel *model, PhysicsData *physicsData){
     // check for errors or warnings
     CHECK_SPEED_LIMIT(convertMsToKmh(speed), "calculateDragDivergenceAroundMach");
     CHECK_VAR(convertMsToKmh(speed), "speed", "calculateDragDivergenceAroundMach", 0.0f);
+    CHECK_PTR(model, "model", "calculateDragDivergenceAroundMach", 0.0f);
     CHECK_PTR(physicsData, "physicsData", "calculateDragDivergenceAroundMach", 0.0f);
 
     float mach = speed / physicsData->speedOfSound; // get current Mach speed
+    float Md = model->Md; // drag divergence Mach number
 
     float Cdw = 0;
-    if (mach > Md) Cdw = C_D0 * kw * powf((mach - Md), 2); // if Mach > Md, calculate additional drag
+    if (mach > Md) Cdw = C_D0 * model->kw * (mach - Md) * (mach - Md); // if Mach > Md, calculate additional drag
 
     return Cdw * M_DRAG_COEFFICIENT; // return drag divergence
 }
@@ -558,53 +555,32 @@ float calculateTotalDrag(float *parasiticDrag, float *inducedDrag, float *waveDr
     #########################################################
 */
 
-float calculateThrust(int thrust, int afterburnerThrust, int percentControl, PhysicsData *physicsData){
+float calculateThrust(const CompiledAircraftModel *model, const EngineState *engine, PhysicsData *physicsData){
     // check for errors or warnings
+    CHECK_PTR(model, "model", "calculateThrust", 0.0f);
+    CHECK_PTR(engine, "engine", "calculateThrust", 0.0f);
     CHECK_PTR(physicsData, "physicsData", "calculateThrust", 0.0f);
 
-    int usedThrust;
-    bool afterBurnerOn;
-
-    if (percentControl > 100) {
-        afterBurnerOn = true;
-        percentControl = 100; // set to 100 so in later calculations its not > 100
-    } else {
-        afterBurnerOn = false;
-    }
-
-    if (afterBurnerOn) { // if the afterburner is on, use the afterburner thrust, if not, use normal
-        usedThrust = afterburnerThrust;
-    } else {
-        usedThrust = thrust;
-    }
-
-    // calculate thrust at altitude
-    float airDensityAtCurrentAltitude = physicsData->airDensity;
-
-    // get derate factor
-    float derateFactor = (airDensityAtCurrentAltitude / airDensityAtSeaLevel);
-
-    if (airDensityAtSeaLevel < 1e-6f) { // Prevent division by zero
-        return 0.0f;
-    }
-    
-    // calculate thrust
-    float calculatedThrust = (float)usedThrust * derateFactor;
+    // derate with the air density already computed this tick, ram recovery with Mach
+    const float ramRecoveryFactor = 0.3f; // estimate for turbojet
+    float derateFactor = physicsData->airDensity * model->invSeaLevelDensity * (1.0f + ramRecoveryFactor * physicsData->machNumber);
 
-    // apply user control
-    calculatedThrust = ((float)percentControl / 100.0f) * calculatedThrust;
+    // the thrust never exceeds the engine's rated thrust, capping the derate caps dry and wet thrust alike
+    derateFactor = (derateFactor > 1.0f) ? 1.0f : derateFactor;
 
-    // modify thrust based on speed of the aircraft
-    float mach = physicsData->machNumber;
-    const float ramRecoveryFactor = 0.3f; // estimate for turbojet 
+    // the core spool scales the dry thrust, the afterburner level (0 without one) blends it up to full afterburner
+    float dryThrust = engine->spool * model->dryThrust;
+    float thrust = (dryThrust + engine->afterburner * (model->wetThrust - dryThrust)) * derateFactor;
 
-    float speedModifiedThrust = calculatedThrust * (1 + ramRecoveryFactor * mach);
+    // fuel flow is TSFC * thrust, i.e. the sea level fuel burn derated and blended exactly like the thrust,
+    // so fuel burn and thrust can't drift apart
+    float dryFuelFlow = engine->spool * model->fuelBurn;
+    float fuelFlow = (dryFuelFlow + engine->afterburner * (model->afterburnerFuelBurn - dryFuelFlow)) * derateFactor;
 
-    // if the modified thrust exceeds the top thrust of the engine, cap it
-    speedModifiedThrust = (speedModifiedThrust > usedThrust) ? (float)usedThrust : speedModifiedThrust;
+    physicsData->fuelFlow = fuelFlow;
 
     // return the calculated thrust
-    return speedModifiedThrust;
+    return thrust;
 }
 
 /*
@@ -638,24 +614,24 @@ Vector3 getDirectionVector(Orientation newOrientation){
     return directionVector; // Return the direction vector
 }
 
-void updateVelocity(AircraftState *aircraft, float deltaTime, AircraftData *data, PhysicsData *physicsData){   
+void updateVelocity(AircraftState *aircraft, float deltaTime, const CompiledAircraftModel *model, PhysicsData *physicsData){   
     // Check for errors or warnings
     CHECK_PTR(aircraft, "aircraft", "updateVelocity", );
-    CHECK_PTR(data, "data", "updateVelocity", );
+    CHECK_PTR(model, "model", "updateVelocity", );
     CHECK_PTR(physicsData, "physicsData", "updateVelocity", );
 
     // UPDATE VX
     const float T = physicsData->thrust;
     const float D = physicsData->totalDrag;
     
-    const float ax = (T - D) / data->mass; // Calculate acceleration in x direction
+    const float ax = (T - D) * model->invMass; // Calculate acceleration in x direction
     aircraft->vx += ax * deltaTime; // Update velocity in x direction
 
     // UPDATE VY
-    const float L = calculateLift(data->wingArea, physicsData); // Calculate lift
-    const float W = GRAVITY * data->mass; // Calculate weight
+    const float L = calculateLift(model->wingArea, physicsData); // Calculate lift
+    const float W = model->weight; // Weight
 
-    const float ay = (L - W) / data->mass; // Calculate acceleration in y direction
+    const float ay = (L - W) * model->invMass; // Calculate acceleration in y direction
     aircraft->vy += ay * deltaTime; // Update velocity in y direction
 
     // // COMPUTE FLIGHT PATH ANGLE (γ)
@@ -829,27 +805,17 @@ float interpolate(float lowerAlt, float upperAlt, float lowerDensity, float uppe
     #########################################################
 */
 
-float getFuelBurnRate(AircraftData *data, float throttle){
+float getFuelBurnRate(PhysicsData *physicsData){
     // Check for errors or warnings
-    CHECK_PTR(data, "data", "getFuelBurnRate", 0.0f);
-    CHECK_VAR(throttle, "throttle", "getFuelBurnRate", 0.0f);
+    CHECK_PTR(physicsData, "physicsData", "getFuelBurnRate", 0.0f);
+    CHECK_VAR(physicsData->fuelFlow, "fuelFlow", "getFuelBurnRate", 0.0f);
 
-    int afterburner = (throttle > 1.0f) ? 1 : 0;
-
-    if (afterburner){
-        if (data->afterburnerFuelBurn < 0.0f) {
-            logMessage(LOG_ERROR, "Invalid afterburner fuel burn rate");
-            return 0.0f;
-        }
-        return data->afterburnerFuelBurn;
-    }
-    else{
-        if (data->fuelBurn < 0.0f) {
-            logMessage(LOG_ERROR, "Invalid fuel burn rate");
-            return 0.0f;
-        }
-        return data->fuelBurn * throttle; // simple linear scaling
+    if (physicsData->fuelFlow < 0.0f) {
+        logMessage(LOG_ERROR, "Invalid fuel burn rate");
+        return 0.0f;
     }
+
+    return physicsData->fuelFlow; // computed with the thrust in calculateThrust()
 }
 
 void updateFuelLevel(float *fuelKg, float deltaTime, float fuelBurnRate){
@@ -858,26 +824,29 @@ void updateFuelLevel(float *fuelKg, float deltaTime, float fuelBurnRate){
     CHECK_VAR(deltaTime, "deltaTime", "updateFuelLevel", );
     CHECK_VAR(fuelBurnRate, "fuelBurnRate", "updateFuelLevel", );
 
+    const float previousFuelKg = *fuelKg;
     *fuelKg -= fuelBurnRate * deltaTime; // Update fuel level
 
     if (*fuelKg < 0.0f){
         *fuelKg = 0.0f; // Prevent negative fuel levels
-        logMessage(LOG_WARNING, "Out of fuel!");
+        if (previousFuelKg > 0.0f) {
+            logMessage(LOG_WARNING, "Out of fuel!"); // once, not every tick with empty tanks
+        }
     }
 }
 
-void updateAircraftMass(AircraftState *aircraft, AircraftData *data, float fuelBurnRate, float deltaTime){
+void updateAircraftMass(AircraftState *aircraft, const CompiledAircraftModel *model, float fuelBurnRate, float deltaTime){
     // Check for errors or warnings
     CHECK_PTR(aircraft, "aircraft", "updateAircraftMass", );
-    CHECK_PTR(data, "data", "updateAircraftMass", );
+    CHECK_PTR(model, "model", "updateAircraftMass", );
     CHECK_VAR(fuelBurnRate, "fuelBurnRate", "updateAircraftMass", );
     CHECK_VAR(deltaTime, "deltaTime", "updateAircraftMass", );
 
     float fuelBurned = fuelBurnRate * deltaTime; // Calculate fuel burned
     (aircraft->currentMass) -= fuelBurned; // Update aircraft mass
 
-    if (aircraft->currentMass < data->mass){
-        aircraft->currentMass = data->mass; // Prevent lower mass than min mass of aircraft
+    if (aircraft->currentMass < model->mass){
+        aircraft->currentMass = model->mass; // Prevent lower mass than min mass of aircraft
     }
 }
 
@@ -889,19 +858,27 @@ void updateAircraftMass(AircraftState *aircraft, AircraftData *data, float fuelB
     #########################################################
 */
 
-void updatePhysicsData(PhysicsData *physics, float altitude, AircraftState *aircraft, AircraftData *data, float simulationTime) {
+void updatePhysicsData(PhysicsData *physics, float altitude, AircraftState *aircraft, const CompiledAircraftModel *model, float simulationTime) {
     // Check for errors or warnings
     CHECK_PTR(physics, "physics", "updatePhysicsData", );
     CHECK_ALT_LIMIT(altitude, "updatePhysicsData");
     CHECK_VAR(altitude, "altitude", "updatePhysicsData", );
     CHECK_PTR(aircraft, "aircraft", "updatePhysicsData", );
-    CHECK_PTR(data, "data", "updatePhysicsData", );
+    CHECK_PTR(model, "model", "updatePhysicsData", );
     CHECK_VAR(simulationTime, "simulationTime", "updatePhysicsData", );
 
+    WeatherSample weather = sampleWeather(aircraft->x, altitude, aircraft->z, simulationTime);
+
     // 1. Atmosphere: update tropopause, temperature, air density, and speed of sound
     physics->tropopauseAltitude = getTropopause();
     physics->temperatureKelvin   = getTemperatureKelvin(altitude, physics);
     physics->airDensity          = getAirDensity(altitude, physics);
+    {
+        // ISA deviation: same pressure, different temperature, so the density scales with 1/T
+        float T = physics->temperatureKelvin + weather.temperatureDeviation;
+        physics->airDensity *= physics->temperatureKelvin / T;
+        physics->temperatureKelvin = T;
+    }
     physics->speedOfSound        = calculateSpeedOfSound(altitude, physics);
     
     // 2. Flight parameters: compute velocity magnitude, true airspeed, Mach, flight path angle, and AoA
@@ -917,7 +894,10 @@ void updatePhysicsData(PhysicsData *physics, float altitude, AircraftState *airc
     physics->rollDegrees  = convertRadiansToDeg(aircraft->roll);
 
     // 4. Orientation vectors: update wind, up, rightWingDirection and lift axis
-    physics->windVector = getWindVector(altitude, simulationTime);
+    {
+        Vector3 gust = getTurbulenceVector(&globalTurbulence, aircraft->turbulenceSlot, (Vector3){aircraft->vx, aircraft->vy, aircraft->vz});
+        physics->windVector = (Vector3){weather.wind.x + gust.x, weather.wind.y + gust.y, weather.wind.z + gust.z};
+    }
     physics->upVector = getUpVector(aircraft);
     physics->rightWingDirection = getRightWingDirection(aircraft, physics);
     {
@@ -926,21 +906,20 @@ void updatePhysicsData(PhysicsData *physics, float altitude, AircraftState *airc
         physics->liftAxisVector = getLiftAxisVector(wingRight, unitVelocity);
     }
     
-    // 5. Aerodynamics: compute lift coefficient, aspect ratio, then lift force
-    physics->liftCoefficient = calculateLiftCoefficient(data->mass, aircraft, data->wingArea, physics);
-    physics->aspectRatio     = calculateAspectRatio(data->wingSpan, data->wingArea);
-    physics->liftForce       = computeLiftForceComponents(aircraft, data->wingArea, physics->liftCoefficient, physics);
+    // 5. Aerodynamics: compute lift coefficient, then lift force (aspect ratio comes precompiled)
+    physics->liftCoefficient = calculateLiftCoefficient(model->mass, aircraft, model->wingArea, physics);
+    physics->aspectRatio     = model->aspectRatio;
+    physics->liftForce       = computeLiftForceComponents(aircraft, model->wingArea, physics->liftCoefficient, physics);
 
     // 6. Aerodynamics: compute drag coefficients and forces
-    float maxSpeedMs = convertKmhToMs(data->maxSpeed);
-    physics->dragCoefficient = calculateDragCoefficient(physics->trueAirspeed, maxSpeedMs, C_D0, physics);
-    physics->parasiticDrag   = calculateParasiticDrag(physics->dragCoefficient, physics->airDensity, physics->trueAirspeed, data->wingArea);
-    physics->inducedDrag     = calculateInducedDrag(physics->liftCoefficient, physics->aspectRatio, physics->airDensity, data->wingArea, physics->trueAirspeed);
-    physics->dragDivergence  = calculateDragDivergenceAroundMach(physics->trueAirspeed, physics);
+    physics->dragCoefficient = calculateDragCoefficient(physics->trueAirspeed, C_D0, model, physics);
+    physics->parasiticDrag   = calculateParasiticDrag(physics->dragCoefficient, physics->airDensity, physics->trueAirspeed, model->wingArea);
+    physics->inducedDrag     = calculateInducedDrag(physics->liftCoefficient, model->inducedDragFactor, physics->airDensity, model->wingArea, physics->trueAirspeed);
+    physics->dragDivergence  = calculateDragDivergenceAroundMach(physics->trueAirspeed, model, physics);
     physics->totalDrag       = physics->parasiticDrag + physics->inducedDrag + physics->dragDivergence;
     
-    // 7. Engine: update thrust
-    physics->thrust = calculateThrust(data->thrust, data->afterburnerThrust, (int)(aircraft->controls.throttle * 100), physics);
+    // 7. Engine: update thrust and fuel flow at the spooled engine state
+    physics->thrust = calculateThrust(model, &aircraft->engine, physics);
     
     // 8. Placeholder for drag force; computed later in computeAcceleration()
     physics->dragForce = (Vector3){0.0f, 0.0f, 0.0f};
@@ -948,11 +927,11 @@ void updatePhysicsData(PhysicsData *physics, float altitude, AircraftState *airc
     physics->lastSimulationTime = simulationTime;
 }
 
-Vector3 computeAcceleration(Vector3 velocity, AircraftState *aircraft, AircraftData *aircraftData, PhysicsData *physicsData){
-    float mass = aircraftData->mass;
+Vector3 computeAcceleration(Vector3 velocity, AircraftState *aircraft, const CompiledAircraftModel *model, PhysicsData *physicsData){
+    float invMass = model->invMass;
 
     // Gravity force remains constant
-    Vector3 gravityForce = { 0, -GRAVITY * mass, 0 };
+    Vector3 gravityForce = { 0, -model->weight, 0 };
 
     // Compute lift with updated velocity
     Vector3 liftForce = physicsData->liftForce;
@@ -983,7 +962,7 @@ Vector3 computeAcceleration(Vector3 velocity, AircraftState *aircraft, AircraftD
     Vector3 thrustForce;
     if (aircraft->fuel <= 0.0f) { // for now simply: if youre out of fuel, engine instantly stops producing thrust. irl it'd slowly go down to zero (i think)
         thrustForce = (Vector3){0, 0, 0};
-        globalPhysicsData.thrust = 0; // 0N
+        physicsData->thrust = 0; // 0N
     } 
     else { // engine not out of fuel
         thrustForce = (Vector3){
@@ -1002,62 +981,95 @@ Vector3 computeAcceleration(Vector3 velocity, AircraftState *aircraft, AircraftD
 
     // Compute acceleration
     Vector3 acceleration = {
-        netForce.x / mass,
-        netForce.y / mass,
-        netForce.z / mass
+        netForce.x * invMass,
+        netForce.y * invMass,
+        netForce.z * invMass
     };
 
     return acceleration;
 }
 
-void updatePhysics(AircraftState *aircraft, float deltaTime, float simulationTime, AircraftData *aircraftData) {
+// One stage of the integrators: the acceleration of a temporary copy of the aircraft with the given velocity,
+// after updating its orientation over stepTime
+static Vector3 accelerationAt(const AircraftState *aircraft, Vector3 velocity, float stepTime, const CompiledAircraftModel *model, PhysicsData *physics) {
+    AircraftState tempAircraft = *aircraft;
+    tempAircraft.vx = velocity.x;
+    tempAircraft.vy = velocity.y;
+    tempAircraft.vz = velocity.z;
+    updateVelocity(&tempAircraft, stepTime, model, physics); // Update orientation for intermediate step
+
+    return computeAcceleration((Vector3){ tempAircraft.vx, tempAircraft.vy, tempAircraft.vz }, &tempAircraft, model, physics);
+}
+
+void setPhysicsIntegrator(PhysicsIntegrator integrator) {
+    physicsIntegrator = integrator;
+}
+
+PhysicsIntegrator getPhysicsIntegrator(void) {
+    return physicsIntegrator;
+}
+
+void updateAircraftPhysics(PhysicsData *physics, AircraftState *aircraft, float deltaTime, float simulationTime, const CompiledAircraftModel *model) {
+    // Spool the engine towards the throttle (no fuel means the engine winds down)
+    float commandedThrottle = (aircraft->fuel > 0.0f) ? aircraft->controls.throttle : 0.0f;
+    updateEngineState(&aircraft->engine, commandedThrottle, aircraft->hasAfterburner, deltaTime);
+
+    // Advance the Dryden filters of this aircraft (uses last frame's airspeed, the gusts only change the next one)
+    if (aircraft->turbulenceSlot < globalTurbulence.capacity) {
+        updateTurbulenceField(&globalTurbulence, aircraft->turbulenceSlot, 1, &aircraft->y, &physics->trueAirspeed, deltaTime);
+    }
+
     // Compute physicsData only once per frame
-    if (fabsf(globalPhysicsData.lastSimulationTime - simulationTime) > 1e-6f) {
-        updatePhysicsData(&globalPhysicsData, aircraft->y, aircraft, aircraftData, simulationTime);
-        globalPhysicsData.lastSimulationTime = simulationTime;
+    if (fabsf(physics->lastSimulationTime - simulationTime) > 1e-6f) {
+        updatePhysicsData(physics, aircraft->y, aircraft, model, simulationTime);
+        physics->lastSimulationTime = simulationTime;
     }
 
     Vector3 v0 = { aircraft->vx, aircraft->vy, aircraft->vz };
 
     // Compute k1 using the current state
-    Vector3 k1 = computeAcceleration(v0, aircraft, aircraftData, &globalPhysicsData);
+    Vector3 k1 = computeAcceleration(v0, aircraft, model, physics);
+
+    switch (physicsIntegrator) {
+        case INTEGRATOR_EULER:
+            aircraft->vx += k1.x * deltaTime;
+            aircraft->vy += k1.y * deltaTime;
+            aircraft->vz += k1.z * deltaTime;
+            break;
+
+        case INTEGRATOR_HEUN: {
+            // Predict with k1 over the whole step, correct with the average of both ends
+            Vector3 k2 = accelerationAt(aircraft, (Vector3){ v0.x + k1.x * deltaTime, v0.y + k1.y * deltaTime, v0.z + k1.z * deltaTime }, deltaTime, model, physics);
+
+            aircraft->vx += (k1.x + k2.x) * (deltaTime / 2.0f);
+            aircraft->vy += (k1.y + k2.y) * (deltaTime / 2.0f);
+            aircraft->vz += (k1.z + k2.z) * (deltaTime / 2.0f);
+            break;
+        }
 
-    // Create temporary aircraft states for RK4 integration
-    AircraftState tempAircraft = *aircraft;
-    
-    // Compute k2
-    tempAircraft.vx = v0.x + 0.5f * k1.x * deltaTime;
-    tempAircraft.vy = v0.y + 0.5f * k1.y * deltaTime;
-    tempAircraft.vz = v0.z + 0.5f * k1.z * deltaTime;
-    updateVelocity(&tempAircraft, deltaTime * 0.5f, aircraftData, &globalPhysicsData); // Update orientation for intermediate step
-    Vector3 k2 = computeAcceleration((Vector3){ tempAircraft.vx, tempAircraft.vy, tempAircraft.vz }, &tempAircraft, aircraftData, &globalPhysicsData);
-
-    // Compute k3
-    tempAircraft = *aircraft; // Reset temp aircraft
-    tempAircraft.vx = v0.x + 0.5f * k2.x * deltaTime;
-    tempAircraft.vy = v0.y + 0.5f * k2.y * deltaTime;
-    tempAircraft.vz = v0.z + 0.5f * k2.z * deltaTime;
-    updateVelocity(&tempAircraft, deltaTime * 0.5f, aircraftData, &globalPhysicsData);
-    Vector3 k3 = computeAcceleration((Vector3){ tempAircraft.vx, tempAircraft.vy, tempAircraft.vz }, &tempAircraft, aircraftData, &globalPhysicsData);
-
-    // Compute k4
-    tempAircraft = *aircraft; // Reset temp aircraft
-    tempAircraft.vx = v0.x + k3.x * deltaTime;
-    tempAircraft.vy = v0.y + k3.y * deltaTime;
-    tempAircraft.vz = v0.z + k3.z * deltaTime;
-    updateVelocity(&tempAircraft, deltaTime, aircraftData, &globalPhysicsData);
-    Vector3 k4 = computeAcceleration((Vector3){ tempAircraft.vx, tempAircraft.vy, tempAircraft.vz }, &tempAircraft, aircraftData, &globalPhysicsData);
-
-    // RK4 final velocity update
-    aircraft->vx += (k1.x + 2.0f * k2.x + 2.0f * k3.x + k4.x) * (deltaTime / 6.0f);
-    aircraft->vy += (k1.y + 2.0f * k2.y + 2.0f * k3.y + k4.y) * (deltaTime / 6.0f);
-    aircraft->vz += (k1.z + 2.0f * k2.z + 2.0f * k3.z + k4.z) * (deltaTime / 6.0f);
+        case INTEGRATOR_RK4:
+        default: {
+            Vector3 k2 = accelerationAt(aircraft, (Vector3){ v0.x + 0.5f * k1.x * deltaTime, v0.y + 0.5f * k1.y * deltaTime, v0.z + 0.5f * k1.z * deltaTime }, deltaTime * 0.5f, model, physics);
+            Vector3 k3 = accelerationAt(aircraft, (Vector3){ v0.x + 0.5f * k2.x * deltaTime, v0.y + 0.5f * k2.y * deltaTime, v0.z + 0.5f * k2.z * deltaTime }, deltaTime * 0.5f, model, physics);
+            Vector3 k4 = accelerationAt(aircraft, (Vector3){ v0.x + k3.x * deltaTime, v0.y + k3.y * deltaTime, v0.z + k3.z * deltaTime }, deltaTime, model, physics);
+
+            // RK4 final velocity update
+            aircraft->vx += (k1.x + 2.0f * k2.x + 2.0f * k3.x + k4.x) * (deltaTime / 6.0f);
+            aircraft->vy += (k1.y + 2.0f * k2.y + 2.0f * k3.y + k4.y) * (deltaTime / 6.0f);
+            aircraft->vz += (k1.z + 2.0f * k2.z + 2.0f * k3.z + k4.z) * (deltaTime / 6.0f);
+            break;
+        }
+    }
 
     // Update aircraft orientation with the new velocity
-    updateVelocity(aircraft, deltaTime, aircraftData, &globalPhysicsData);
+    updateVelocity(aircraft, deltaTime, model, physics);
 
     // Update aircraft fuel level and mass
-    float fuelBurnRate = getFuelBurnRate(aircraftData, aircraft->controls.throttle);
+    float fuelBurnRate = getFuelBurnRate(physics);
     updateFuelLevel(&aircraft->fuel, deltaTime, fuelBurnRate);
-    updateAircraftMass(aircraft, aircraftData, fuelBurnRate, deltaTime);
+    updateAircraftMass(aircraft, model, fuelBurnRate, deltaTime);
+}
+
+void updatePhysics(AircraftState *aircraft, float deltaTime, float simulationTime, const CompiledAircraftModel *model) {
+    updateAircraftPhysics(&globalPhysicsData, aircraft, deltaTime, simulationTime, model);
 }
\ No newline at end of file
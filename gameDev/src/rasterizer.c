@@ -0,0 +1,528 @@
+/**
+ * @file rasterizer.c
+ *
+ * @brief This file contains the CPU rasterizer: the HUD is drawn into a framebuffer in memory and uploaded as one texture.
+ */
+
+// Include header files
+#include "rasterizer.h"
+#include "renderBatch.h"
+#include "logger.h"
+
+// Include necessary libraries
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+typedef struct {
+    SDL_Texture *texture;
+    const Uint32 *pixels;
+    int width, height;
+} RasterTexture;
+
+static SDL_Renderer *rasterRenderer = NULL;
+static SDL_Texture *frameTexture = NULL; // streaming, the framebuffer is uploaded into it
+static Uint32 *framebuffer = NULL; // ARGB8888, width * height
+static int frameWidth = 0, frameHeight = 0;
+
+// Clip rectangle as [x0, x1) x [y0, y1), always inside the framebuffer
+static int clipX0 = 0, clipY0 = 0, clipX1 = 0, clipY1 = 0;
+
+static RasterTexture rasterTextures[MAX_RASTER_TEXTURES];
+static int rasterTextureCount = 0;
+static int warnedUnsupported = 0; // geometry the rasterizer can't draw is reported once
+
+/*
+    #########################################################
+    #                                                       #
+    #                         SETUP                         #
+    #                                                       #
+    #########################################################
+*/
+
+int initRasterizer(SDL_Renderer *renderer, int width, int height){
+    if (renderer == NULL || width <= 0 || height <= 0) {
+        logMessage(LOG_ERROR, "Invalid arguments passed to initRasterizer.");
+        return 0;
+    }
+
+    destroyRasterizer();
+
+    framebuffer = calloc((size_t)width * (size_t)height, sizeof(Uint32));
+    if (framebuffer == NULL) {
+        logMessage(LOG_ERROR, "Failed to allocate a %dx%d framebuffer.", width, height);
+        return 0;
+    }
+
+    frameTexture = createRenderTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, width, height);
+    if (frameTexture == NULL) {
+        logMessage(LOG_ERROR, "Failed to create the framebuffer texture: %s", SDL_GetError());
+        free(framebuffer);
+        framebuffer = NULL;
+        return 0;
+    }
+
+    rasterRenderer = renderer;
+    frameWidth = width;
+    frameHeight = height;
+    warnedUnsupported = 0;
+    setRasterClip(NULL);
+
+    return 1;
+}
+
+void destroyRasterizer(void){
+    if (frameTexture != NULL) {
+        SDL_DestroyTexture(frameTexture);
+    }
+    free(framebuffer);
+
+    frameTexture = NULL;
+    framebuffer = NULL;
+    rasterRenderer = NULL;
+    frameWidth = frameHeight = 0;
+    clipX0 = clipY0 = clipX1 = clipY1 = 0;
+}
+
+int isRasterizerActive(void){
+    return framebuffer != NULL;
+}
+
+void getRasterClip(SDL_Rect *clip){
+    *clip = (SDL_Rect){clipX0, clipY0, clipX1 - clipX0, clipY1 - clipY0};
+}
+
+void setRasterClip(const SDL_Rect *clip){
+    clipX0 = 0;
+    clipY0 = 0;
+    clipX1 = frameWidth;
+    clipY1 = frameHeight;
+
+    if (clip != NULL) {
+        if (clip->x > clipX0) clipX0 = clip->x;
+        if (clip->y > clipY0) clipY0 = clip->y;
+        if (clip->x + clip->w < clipX1) clipX1 = clip->x + clip->w;
+        if (clip->y + clip->h < clipY1) clipY1 = clip->y + clip->h;
+    }
+
+    // an empty clip draws nothing
+    if (clipX1 < clipX0) clipX1 = clipX0;
+    if (clipY1 < clipY0) clipY1 = clipY0;
+}
+
+void registerRasterTexture(SDL_Texture *texture, const Uint32 *pixels, int width, int height){
+    if (texture == NULL || pixels == NULL) {
+        return;
+    }
+
+    for (int i = 0; i < rasterTextureCount; i++) {
+        if (rasterTextures[i].texture == texture) {
+            rasterTextures[i] = (RasterTexture){texture, pixels, width, height};
+            return;
+        }
+    }
+
+    if (rasterTextureCount >= MAX_RASTER_TEXTURES) {
+        logMessage(LOG_WARNING, "Can't register more than %d textures with the rasterizer.", MAX_RASTER_TEXTURES);
+        return;
+    }
+    rasterTextures[rasterTextureCount++] = (RasterTexture){texture, pixels, width, height};
+}
+
+void unregisterRasterTexture(SDL_Texture *texture){
+    for (int i = 0; i < rasterTextureCount; i++) {
+        if (rasterTextures[i].texture == texture) {
+            rasterTextures[i] = rasterTextures[--rasterTextureCount];
+            return;
+        }
+    }
+}
+
+static const RasterTexture *findRasterTexture(const SDL_Texture *texture){
+    for (int i = 0; i < rasterTextureCount; i++) {
+        if (rasterTextures[i].texture == texture) {
+            return &rasterTextures[i];
+        }
+    }
+    return NULL;
+}
+
+/*
+    #########################################################
+    #                                                       #
+    #                       PRIMITIVES                      #
+    #                                                       #
+    #########################################################
+*/
+
+static Uint32 packPixel(SDL_Color color){
+    return ((Uint32)color.a << 24) | ((Uint32)color.r << 16) | ((Uint32)color.g << 8) | (Uint32)color.b;
+}
+
+// a * b / 255, rounded
+static Uint32 multiply255(Uint32 a, Uint32 b){
+    Uint32 x = a * b + 128;
+    return (x + (x >> 8)) >> 8;
+}
+
+static int insideClip(int x, int y){
+    return x >= clipX0 && x < clipX1 && y >= clipY0 && y < clipY1;
+}
+
+// Fill `count` pixels starting at `row`, four at a time with SSE2
+static void fillSpan(Uint32 *row, int count, Uint32 pixel){
+#ifdef __SSE2__
+    const __m128i value = _mm_set1_epi32((int)pixel);
+    while (count >= 4) {
+        _mm_storeu_si128((__m128i *)(void *)row, value);
+        row += 4;
+        count -= 4;
+    }
+#endif
+    while (count > 0) {
+        *row++ = pixel;
+        count--;
+    }
+}
+
+// Horizontal span [x0, x1) on row y, clipped
+static void drawSpan(int x0, int x1, int y, Uint32 pixel){
+    if (y < clipY0 || y >= clipY1) {
+        return;
+    }
+    if (x0 < clipX0) x0 = clipX0;
+    if (x1 > clipX1) x1 = clipX1;
+    if (x1 > x0) {
+        fillSpan(&framebuffer[y * frameWidth + x0], x1 - x0, pixel);
+    }
+}
+
+// Vertical span [y0, y1) in column x, clipped
+static void drawColumn(int x, int y0, int y1, Uint32 pixel){
+    if (x < clipX0 || x >= clipX1) {
+        return;
+    }
+    if (y0 < clipY0) y0 = clipY0;
+    if (y1 > clipY1) y1 = clipY1;
+    for (int y = y0; y < y1; y++) {
+        framebuffer[y * frameWidth + x] = pixel;
+    }
+}
+
+void rasterPoints(const SDL_Point *points, int count, SDL_Color color){
+    if (framebuffer == NULL) {
+        return;
+    }
+
+    const Uint32 pixel = packPixel(color);
+    for (int i = 0; i < count; i++) {
+        if (insideClip(points[i].x, points[i].y)) {
+            framebuffer[points[i].y * frameWidth + points[i].x] = pixel;
+        }
+    }
+}
+
+void rasterLine(int x1, int y1, int x2, int y2, SDL_Color color){
+    if (framebuffer == NULL) {
+        return;
+    }
+
+    const Uint32 pixel = packPixel(color);
+
+    // straight lines are spans
+    if (y1 == y2) {
+        drawSpan((x1 < x2) ? x1 : x2, ((x1 < x2) ? x2 : x1) + 1, y1, pixel);
+        return;
+    }
+    if (x1 == x2) {
+        drawColumn(x1, (y1 < y2) ? y1 : y2, ((y1 < y2) ? y2 : y1) + 1, pixel);
+        return;
+    }
+
+    // nothing to draw if the bounding box misses the clip rectangle
+    if ((x1 < clipX0 && x2 < clipX0) || (x1 >= clipX1 && x2 >= clipX1) || (y1 < clipY0 && y2 < clipY0) || (y1 >= clipY1 && y2 >= clipY1)) {
+        return;
+    }
+
+    // Bresenham
+    const int dx = abs(x2 - x1);
+    const int dy = -abs(y2 - y1);
+    const int stepX = (x1 < x2) ? 1 : -1;
+    const int stepY = (y1 < y2) ? 1 : -1;
+    int error = dx + dy;
+    int x = x1;
+    int y = y1;
+
+    for (;;) {
+        if (insideClip(x, y)) {
+            framebuffer[y * frameWidth + x] = pixel;
+        }
+        if (x == x2 && y == y2) {
+            break;
+        }
+
+        int doubled = 2 * error;
+        if (doubled >= dy) {
+            error += dy;
+            x += stepX;
+        }
+        if (doubled <= dx) {
+            error += dx;
+            y += stepY;
+        }
+    }
+}
+
+void rasterRect(const SDL_Rect *rect, SDL_Color color){
+    if (framebuffer == NULL || rect == NULL || rect->w <= 0 || rect->h <= 0) {
+        return;
+    }
+
+    const Uint32 pixel = packPixel(color);
+    const int right = rect->x + rect->w - 1;
+    const int bottom = rect->y + rect->h - 1;
+
+    drawSpan(rect->x, right + 1, rect->y, pixel);
+    drawSpan(rect->x, right + 1, bottom, pixel);
+    drawColumn(rect->x, rect->y + 1, bottom, pixel);
+    drawColumn(right, rect->y + 1, bottom, pixel);
+}
+
+void rasterFillRect(const SDL_Rect *rect, SDL_Color color){
+    if (framebuffer == NULL || rect == NULL) {
+        return;
+    }
+
+    const Uint32 pixel = packPixel(color);
+    int y0 = (rect->y > clipY0) ? rect->y : clipY0;
+    int y1 = (rect->y + rect->h < clipY1) ? rect->y + rect->h : clipY1;
+
+    for (int y = y0; y < y1; y++) {
+        drawSpan(rect->x, rect->x + rect->w, y, pixel);
+    }
+}
+
+// Alpha blend one source pixel (not premultiplied) over the framebuffer pixel
+static Uint32 blendPixel(Uint32 destination, Uint32 red, Uint32 green, Uint32 blue, Uint32 alpha){
+    if (alpha == 255) {
+        return 0xFF000000u | (red << 16) | (green << 8) | blue;
+    }
+
+    const Uint32 inverse = 255 - alpha;
+    Uint32 a = alpha + multiply255(destination >> 24, inverse);
+    Uint32 r = multiply255(red, alpha) + multiply255((destination >> 16) & 0xFF, inverse);
+    Uint32 g = multiply255(green, alpha) + multiply255((destination >> 8) & 0xFF, inverse);
+    Uint32 b = multiply255(blue, alpha) + multiply255(destination & 0xFF, inverse);
+    return (a << 24) | (r << 16) | (g << 8) | b;
+}
+
+// One axis aligned quad, `first` and `opposite` are diagonal corners, sampled at the pixel centres (nearest texel)
+static void drawQuad(const RasterTexture *texture, const SDL_Vertex *first, const SDL_Vertex *opposite){
+    const float spanX = opposite->position.x - first->position.x;
+    const float spanY = opposite->position.y - first->position.y;
+    if (fabsf(spanX) < 1e-6f || fabsf(spanY) < 1e-6f) {
+        return;
+    }
+
+    // pixels whose centres are inside the quad
+    const float left = fminf(first->position.x, opposite->position.x);
+    const float right = fmaxf(first->position.x, opposite->position.x);
+    const float top = fminf(first->position.y, opposite->position.y);
+    const float bottom = fmaxf(first->position.y, opposite->position.y);
+
+    int x0 = (int)ceilf(left - 0.5f);
+    int x1 = (int)ceilf(right - 0.5f);
+    int y0 = (int)ceilf(top - 0.5f);
+    int y1 = (int)ceilf(bottom - 0.5f);
+    if (x0 < clipX0) x0 = clipX0;
+    if (x1 > clipX1) x1 = clipX1;
+    if (y0 < clipY0) y0 = clipY0;
+    if (y1 > clipY1) y1 = clipY1;
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+
+    const SDL_Color color = first->color;
+
+    // texel coordinates, 16.16 fixed point along x
+    const float textureWidth = (texture != NULL) ? (float)texture->width : 1.0f;
+    const float textureHeight = (texture != NULL) ? (float)texture->height : 1.0f;
+    const float stepU = (opposite->tex_coord.x - first->tex_coord.x) / spanX * textureWidth;
+    const float stepV = (opposite->tex_coord.y - first->tex_coord.y) / spanY * textureHeight;
+    const float startU = first->tex_coord.x * textureWidth + ((float)x0 + 0.5f - first->position.x) * stepU;
+    const Sint32 fixedStartU = (Sint32)(startU * 65536.0f);
+    const Sint32 fixedStepU = (Sint32)(stepU * 65536.0f);
+
+    for (int y = y0; y < y1; y++) {
+        Uint32 *row = &framebuffer[y * frameWidth];
+
+        const Uint32 *texels = NULL;
+        int maxU = 0;
+        if (texture != NULL) {
+            int v = (int)floorf(first->tex_coord.y * textureHeight + ((float)y + 0.5f - first->position.y) * stepV);
+            if (v < 0) v = 0;
+            if (v >= texture->height) v = texture->height - 1;
+            texels = &texture->pixels[v * texture->width];
+            maxU = texture->width - 1;
+        }
+
+        Sint32 fixedU = fixedStartU;
+        for (int x = x0; x < x1; x++, fixedU += fixedStepU) {
+            Uint32 texel = 0xFFFFFFFFu;
+            if (texels != NULL) {
+                int u = fixedU >> 16;
+                if (u < 0) u = 0;
+                if (u > maxU) u = maxU;
+                texel = texels[u];
+            }
+
+            Uint32 alpha = multiply255(texel >> 24, color.a);
+            if (alpha == 0) {
+                continue; // most of a glyph's cell
+            }
+
+            Uint32 red = multiply255((texel >> 16) & 0xFF, color.r);
+            Uint32 green = multiply255((texel >> 8) & 0xFF, color.g);
+            Uint32 blue = multiply255(texel & 0xFF, color.b);
+            row[x] = blendPixel(row[x], red, green, blue, alpha);
+        }
+    }
+}
+
+// Twice the signed area of a-b-p, positive if p is left of a->b (clockwise on screen)
+static float edgeFunction(SDL_FPoint a, SDL_FPoint b, float px, float py){
+    return (b.x - a.x) * (py - a.y) - (b.y - a.y) * (px - a.x);
+}
+
+// One untextured triangle in the colour of its first vertex, pixels whose centres are inside (edges included)
+static void drawTriangle(const SDL_Vertex *a, const SDL_Vertex *b, const SDL_Vertex *c){
+    SDL_FPoint p0 = a->position;
+    SDL_FPoint p1 = b->position;
+    SDL_FPoint p2 = c->position;
+
+    const float area = edgeFunction(p0, p1, p2.x, p2.y);
+    if (fabsf(area) < 1e-6f) {
+        return;
+    }
+    if (area < 0.0f) {
+        SDL_FPoint swap = p1; // same winding for every triangle
+        p1 = p2;
+        p2 = swap;
+    }
+
+    int x0 = (int)ceilf(fminf(p0.x, fminf(p1.x, p2.x)) - 0.5f);
+    int x1 = (int)floorf(fmaxf(p0.x, fmaxf(p1.x, p2.x)) - 0.5f) + 1;
+    int y0 = (int)ceilf(fminf(p0.y, fminf(p1.y, p2.y)) - 0.5f);
+    int y1 = (int)floorf(fmaxf(p0.y, fmaxf(p1.y, p2.y)) - 0.5f) + 1;
+    if (x0 < clipX0) x0 = clipX0;
+    if (x1 > clipX1) x1 = clipX1;
+    if (y0 < clipY0) y0 = clipY0;
+    if (y1 > clipY1) y1 = clipY1;
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+
+    const SDL_Color color = a->color;
+    if (color.a == 0) {
+        return;
+    }
+
+    // the edge functions change by a constant per pixel along a row
+    const float stepX0 = -(p2.y - p1.y);
+    const float stepX1 = -(p0.y - p2.y);
+    const float stepX2 = -(p1.y - p0.y);
+    const float startX = (float)x0 + 0.5f;
+
+    for (int y = y0; y < y1; y++) {
+        Uint32 *row = &framebuffer[y * frameWidth];
+        const float centreY = (float)y + 0.5f;
+        float w0 = edgeFunction(p1, p2, startX, centreY);
+        float w1 = edgeFunction(p2, p0, startX, centreY);
+        float w2 = edgeFunction(p0, p1, startX, centreY);
+
+        for (int x = x0; x < x1; x++, w0 += stepX0, w1 += stepX1, w2 += stepX2) {
+            if (w0 >= 0.0f && w1 >= 0.0f && w2 >= 0.0f) {
+                row[x] = blendPixel(row[x], color.r, color.g, color.b, color.a);
+            }
+        }
+    }
+}
+
+void rasterGeometry(SDL_Texture *texture, const SDL_Vertex *vertices, int vertexCount, const int *indices, int indexCount){
+    if (framebuffer == NULL || vertices == NULL || indices == NULL) {
+        return;
+    }
+
+    const RasterTexture *source = NULL;
+    if (texture != NULL) {
+        source = findRasterTexture(texture);
+        if (source == NULL) {
+            if (!warnedUnsupported) {
+                logMessage(LOG_WARNING, "The rasterizer can't draw a texture it doesn't have the pixels of.");
+                warnedUnsupported = 1;
+            }
+            return;
+        }
+    }
+
+    // untextured geometry is triangles (symbols, the attitude indicator), one flat colour each
+    if (source == NULL) {
+        const int triangleCount = indexCount / 3;
+        for (int i = 0; i < triangleCount; i++) {
+            const int *triangle = &indices[i * 3];
+            if (triangle[0] >= 0 && triangle[0] < vertexCount && triangle[1] >= 0 && triangle[1] < vertexCount && triangle[2] >= 0 && triangle[2] < vertexCount) {
+                drawTriangle(&vertices[triangle[0]], &vertices[triangle[1]], &vertices[triangle[2]]);
+            }
+        }
+        return;
+    }
+
+    const int quadCount = indexCount / 6;
+    for (int i = 0; i < quadCount; i++) {
+        const int *quad = &indices[i * 6];
+
+        // two triangles sharing the diagonal a-c: a b c, a c d
+        int valid = quad[3] == quad[0] && quad[4] == quad[2];
+        for (int j = 0; j < 6; j++) {
+            valid = valid && quad[j] >= 0 && quad[j] < vertexCount;
+        }
+
+        if (!valid) {
+            if (!warnedUnsupported) {
+                logMessage(LOG_WARNING, "The rasterizer only draws quads, other geometry is skipped.");
+                warnedUnsupported = 1;
+            }
+            continue;
+        }
+
+        drawQuad(source, &vertices[quad[0]], &vertices[quad[2]]);
+    }
+}
+
+/*
+    #########################################################
+    #                                                       #
+    #                        UPLOAD                         #
+    #                                                       #
+    #########################################################
+*/
+
+void presentRasterFrame(const SDL_Rect *regions, int count){
+    if (framebuffer == NULL) {
+        return;
+    }
+
+    const SDL_Rect frame = {0, 0, frameWidth, frameHeight};
+    for (int i = 0; i < count; i++) {
+        SDL_Rect region;
+        if (SDL_IntersectRect(&regions[i], &frame, &region)) {
+            SDL_UpdateTexture(frameTexture, &region, &framebuffer[region.y * frameWidth + region.x], frameWidth * (int)sizeof(Uint32));
+        }
+    }
+
+    SDL_RenderCopy(rasterRenderer, frameTexture, NULL, NULL);
+}
@@ -0,0 +1,569 @@
+/**
+ * @file renderBatch.c
+ *
+ * @brief This file contains the HUD command buffer: primitives are recorded, sorted by state and drawn in as few SDL calls as possible.
+ */
+
+// Include header files
+#include "renderBatch.h"
+#include "rasterizer.h"
+#include "logger.h"
+
+// Include necessary libraries
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_BATCH_TEXTURES 64 // different textures per submit
+#define MAX_BATCH_SEQUENCE (1 << 24) // commands per submit (the sequence number has 24 bits in the sort key)
+
+// Sort key: layer | kind | state (colour or texture slot) | sequence, so sorting groups equal state and keeps the recording order inside a group
+#define KEY_LAYER_SHIFT 60
+#define KEY_KIND_SHIFT 56
+#define KEY_STATE_SHIFT 24
+#define KEY_RUN(key) ((key) >> KEY_STATE_SHIFT) // everything but the sequence
+
+// Primitive types, in the order they're drawn within a layer
+typedef enum {
+    COMMAND_FILL_RECT,
+    COMMAND_RECT,
+    COMMAND_LINE,
+    COMMAND_POINT,
+    COMMAND_GEOMETRY,
+    COMMAND_CLIPPED_GEOMETRY    // drawn one command at a time, each with its own clip rectangle
+} CommandKind;
+
+typedef struct {
+    uint64_t key;
+    CommandKind kind;
+    SDL_Color color;
+    SDL_Texture *texture;
+    union {
+        SDL_Point point;
+        SDL_Point line[2];
+        SDL_Rect rect;
+        struct {
+            int firstVertex, vertexCount;
+            int firstIndex, indexCount;
+            SDL_Rect clip;      // clipped geometry only
+        } geometry;
+    } data;
+} BatchCommand;
+
+static SDL_Renderer *batchRenderer = NULL;
+
+// Recorded commands and the geometry they reference
+static BatchCommand *commands = NULL;
+static int commandCount = 0, commandCapacity = 0;
+static SDL_Vertex *vertices = NULL;
+static int vertexCount = 0, vertexCapacity = 0;
+static int *indices = NULL;
+static int indexCount = 0, indexCapacity = 0;
+static SDL_Texture *textures[MAX_BATCH_TEXTURES]; // texture slots used in the sort key
+static int textureCount = 0;
+
+// Gathered runs, passed to the SDL calls
+static SDL_Point *scratchPoints = NULL;
+static int scratchPointCapacity = 0;
+static SDL_Rect *scratchRects = NULL;
+static int scratchRectCapacity = 0;
+static SDL_Vertex *scratchVertices = NULL;
+static int scratchVertexCapacity = 0;
+static int *scratchIndices = NULL;
+static int scratchIndexCapacity = 0;
+
+// Statistics
+static RenderBatchStats frameStats; // current frame
+static RenderBatchStats lastFrameStats; // last finished frame
+static RenderBatchStats totalStats; // finished frames since initRenderBatch()
+
+// Draw state while submitting
+static uint32_t currentColor = 0;
+static int currentColorKnown = 0;
+static SDL_Texture *currentTexture = NULL;
+static int currentTextureKnown = 0;
+
+/*
+    #########################################################
+    #                                                       #
+    #                       RECORDING                       #
+    #                                                       #
+    #########################################################
+*/
+
+// Grow an array to hold at least `needed` elements (doubling)
+static int reserveArray(void **array, int *capacity, int needed, size_t elementSize){
+    if (needed <= *capacity) {
+        return 1;
+    }
+
+    int newCapacity = (*capacity > 0) ? *capacity : 256;
+    while (newCapacity < needed) {
+        newCapacity *= 2;
+    }
+
+    void *grown = realloc(*array, (size_t)newCapacity * elementSize);
+    if (grown == NULL) {
+        logMessage(LOG_ERROR, "Failed to grow the render batch to %d elements.", newCapacity);
+        return 0;
+    }
+
+    *array = grown;
+    *capacity = newCapacity;
+    return 1;
+}
+
+static uint32_t packColor(SDL_Color color){
+    return ((uint32_t)color.r << 24) | ((uint32_t)color.g << 16) | ((uint32_t)color.b << 8) | (uint32_t)color.a;
+}
+
+static BatchCommand *addCommand(BatchLayer layer, CommandKind kind, uint32_t state){
+    if (commandCount >= MAX_BATCH_SEQUENCE) {
+        submitRenderBatch(); // out of sequence numbers
+    }
+    if (!reserveArray((void **)&commands, &commandCapacity, commandCount + 1, sizeof(BatchCommand))) {
+        return NULL;
+    }
+
+    BatchCommand *command = &commands[commandCount];
+    command->key = ((uint64_t)layer << KEY_LAYER_SHIFT) | ((uint64_t)kind << KEY_KIND_SHIFT) | ((uint64_t)state << KEY_STATE_SHIFT) | (uint64_t)commandCount;
+    command->kind = kind;
+    command->texture = NULL;
+    commandCount++;
+    frameStats.commands++;
+
+    return command;
+}
+
+void initRenderBatch(SDL_Renderer *renderer){
+    batchRenderer = renderer;
+    commandCount = 0;
+    vertexCount = 0;
+    indexCount = 0;
+    textureCount = 0;
+    memset(&frameStats, 0, sizeof(frameStats));
+    memset(&lastFrameStats, 0, sizeof(lastFrameStats));
+    memset(&totalStats, 0, sizeof(totalStats));
+}
+
+void destroyRenderBatch(void){
+    free(commands);
+    free(vertices);
+    free(indices);
+    free(scratchPoints);
+    free(scratchRects);
+    free(scratchVertices);
+    free(scratchIndices);
+
+    commands = NULL;
+    vertices = NULL;
+    indices = NULL;
+    scratchPoints = NULL;
+    scratchRects = NULL;
+    scratchVertices = NULL;
+    scratchIndices = NULL;
+    commandCount = commandCapacity = 0;
+    vertexCount = vertexCapacity = 0;
+    indexCount = indexCapacity = 0;
+    scratchPointCapacity = scratchRectCapacity = scratchVertexCapacity = scratchIndexCapacity = 0;
+    textureCount = 0;
+    batchRenderer = NULL;
+}
+
+void batchPoint(BatchLayer layer, int x, int y, SDL_Color color){
+    BatchCommand *command = addCommand(layer, COMMAND_POINT, packColor(color));
+    if (command != NULL) {
+        command->color = color;
+        command->data.point = (SDL_Point){x, y};
+    }
+}
+
+void batchLine(BatchLayer layer, int x1, int y1, int x2, int y2, SDL_Color color){
+    BatchCommand *command = addCommand(layer, COMMAND_LINE, packColor(color));
+    if (command != NULL) {
+        command->color = color;
+        command->data.line[0] = (SDL_Point){x1, y1};
+        command->data.line[1] = (SDL_Point){x2, y2};
+    }
+}
+
+void batchLines(BatchLayer layer, const SDL_Point *points, int count, SDL_Color color){
+    for (int i = 1; i < count; i++) {
+        batchLine(layer, points[i - 1].x, points[i - 1].y, points[i].x, points[i].y, color); // drawLines() joins them again
+    }
+}
+
+void batchRect(BatchLayer layer, const SDL_Rect *rect, SDL_Color color){
+    BatchCommand *command = addCommand(layer, COMMAND_RECT, packColor(color));
+    if (command != NULL) {
+        command->color = color;
+        command->data.rect = *rect;
+    }
+}
+
+void batchFillRect(BatchLayer layer, const SDL_Rect *rect, SDL_Color color){
+    BatchCommand *command = addCommand(layer, COMMAND_FILL_RECT, packColor(color));
+    if (command != NULL) {
+        command->color = color;
+        command->data.rect = *rect;
+    }
+}
+
+// Slot of a texture in this submit, used in the sort key
+static uint32_t getTextureSlot(SDL_Texture *texture){
+    for (int i = 0; i < textureCount; i++) {
+        if (textures[i] == texture) {
+            return (uint32_t)i;
+        }
+    }
+
+    if (textureCount >= MAX_BATCH_TEXTURES) {
+        submitRenderBatch(); // starts over with no slots used
+    }
+    textures[textureCount] = texture;
+    return (uint32_t)textureCount++;
+}
+
+static BatchCommand *addGeometry(BatchLayer layer, CommandKind kind, SDL_Texture *texture, const SDL_Vertex *geometryVertices, int geometryVertexCount, const int *geometryIndices, int geometryIndexCount){
+    if (geometryVertices == NULL || geometryIndices == NULL || geometryVertexCount <= 0 || geometryIndexCount <= 0) {
+        return NULL;
+    }
+
+    uint32_t slot = getTextureSlot(texture);
+    if (!reserveArray((void **)&vertices, &vertexCapacity, vertexCount + geometryVertexCount, sizeof(SDL_Vertex)) ||
+        !reserveArray((void **)&indices, &indexCapacity, indexCount + geometryIndexCount, sizeof(int))) {
+        return NULL;
+    }
+
+    BatchCommand *command = addCommand(layer, kind, slot);
+    if (command == NULL) {
+        return NULL;
+    }
+
+    command->texture = texture;
+    command->data.geometry.firstVertex = vertexCount;
+    command->data.geometry.vertexCount = geometryVertexCount;
+    command->data.geometry.firstIndex = indexCount;
+    command->data.geometry.indexCount = geometryIndexCount;
+
+    memcpy(&vertices[vertexCount], geometryVertices, (size_t)geometryVertexCount * sizeof(SDL_Vertex));
+    memcpy(&indices[indexCount], geometryIndices, (size_t)geometryIndexCount * sizeof(int));
+    vertexCount += geometryVertexCount;
+    indexCount += geometryIndexCount;
+    return command;
+}
+
+void batchGeometry(BatchLayer layer, SDL_Texture *texture, const SDL_Vertex *geometryVertices, int geometryVertexCount, const int *geometryIndices, int geometryIndexCount){
+    addGeometry(layer, COMMAND_GEOMETRY, texture, geometryVertices, geometryVertexCount, geometryIndices, geometryIndexCount);
+}
+
+void batchClippedGeometry(BatchLayer layer, SDL_Texture *texture, const SDL_Vertex *geometryVertices, int geometryVertexCount, const int *geometryIndices, int geometryIndexCount, const SDL_Rect *clip){
+    BatchCommand *command = addGeometry(layer, COMMAND_CLIPPED_GEOMETRY, texture, geometryVertices, geometryVertexCount, geometryIndices, geometryIndexCount);
+    if (command != NULL) {
+        command->data.geometry.clip = *clip;
+    }
+}
+
+void batchTexture(BatchLayer layer, SDL_Texture *texture, const SDL_Rect *destination){
+    const float x0 = (float)destination->x;
+    const float y0 = (float)destination->y;
+    const float x1 = (float)(destination->x + destination->w);
+    const float y1 = (float)(destination->y + destination->h);
+    const SDL_Color white = {255, 255, 255, 255};
+
+    const SDL_Vertex quad[4] = {
+        {{x0, y0}, white, {0.0f, 0.0f}},
+        {{x1, y0}, white, {1.0f, 0.0f}},
+        {{x1, y1}, white, {1.0f, 1.0f}},
+        {{x0, y1}, white, {0.0f, 1.0f}}
+    };
+    const int quadIndices[6] = {0, 1, 2, 0, 2, 3};
+
+    batchGeometry(layer, texture, quad, 4, quadIndices, 6);
+}
+
+/*
+    #########################################################
+    #                                                       #
+    #                      SUBMITTING                       #
+    #                                                       #
+    #########################################################
+*/
+
+static int compareCommands(const void *a, const void *b){
+    uint64_t keyA = ((const BatchCommand *)a)->key;
+    uint64_t keyB = ((const BatchCommand *)b)->key;
+    return (keyA > keyB) - (keyA < keyB);
+}
+
+static void setDrawColor(SDL_Color color){
+    uint32_t packed = packColor(color);
+    if (!currentColorKnown || packed != currentColor) {
+        SDL_SetRenderDrawColor(batchRenderer, color.r, color.g, color.b, color.a);
+        currentColor = packed;
+        currentColorKnown = 1;
+        frameStats.stateChanges++;
+    }
+}
+
+static void drawPoints(const BatchCommand *run, int count){
+    if (!reserveArray((void **)&scratchPoints, &scratchPointCapacity, count, sizeof(SDL_Point))) {
+        return;
+    }
+    for (int i = 0; i < count; i++) {
+        scratchPoints[i] = run[i].data.point;
+    }
+
+    setDrawColor(run[0].color);
+    SDL_RenderDrawPoints(batchRenderer, scratchPoints, count);
+    frameStats.drawCalls++;
+}
+
+// Lines that start where the previous one ended become one polyline
+static void drawLines(const BatchCommand *run, int count){
+    if (!reserveArray((void **)&scratchPoints, &scratchPointCapacity, count * 2, sizeof(SDL_Point))) {
+        return;
+    }
+
+    setDrawColor(run[0].color);
+
+    int pointCount = 0;
+    for (int i = 0; i < count; i++) {
+        const SDL_Point *line = run[i].data.line;
+        int continues = pointCount > 0 && scratchPoints[pointCount - 1].x == line[0].x && scratchPoints[pointCount - 1].y == line[0].y;
+
+        if (!continues) {
+            if (pointCount > 0) {
+                SDL_RenderDrawLines(batchRenderer, scratchPoints, pointCount);
+                frameStats.drawCalls++;
+            }
+            scratchPoints[0] = line[0];
+            pointCount = 1;
+        }
+        scratchPoints[pointCount++] = line[1];
+    }
+
+    SDL_RenderDrawLines(batchRenderer, scratchPoints, pointCount);
+    frameStats.drawCalls++;
+}
+
+static void drawRects(const BatchCommand *run, int count, int filled){
+    if (!reserveArray((void **)&scratchRects, &scratchRectCapacity, count, sizeof(SDL_Rect))) {
+        return;
+    }
+    for (int i = 0; i < count; i++) {
+        scratchRects[i] = run[i].data.rect;
+    }
+
+    setDrawColor(run[0].color);
+    if (filled) {
+        SDL_RenderFillRects(batchRenderer, scratchRects, count);
+    }
+    else {
+        SDL_RenderDrawRects(batchRenderer, scratchRects, count);
+    }
+    frameStats.drawCalls++;
+}
+
+static void drawGeometry(const BatchCommand *run, int count){
+    int totalVertices = 0;
+    int totalIndices = 0;
+    for (int i = 0; i < count; i++) {
+        totalVertices += run[i].data.geometry.vertexCount;
+        totalIndices += run[i].data.geometry.indexCount;
+    }
+
+    if (!reserveArray((void **)&scratchVertices, &scratchVertexCapacity, totalVertices, sizeof(SDL_Vertex)) ||
+        !reserveArray((void **)&scratchIndices, &scratchIndexCapacity, totalIndices, sizeof(int))) {
+        return;
+    }
+
+    // gather the pieces, indices are moved to where their vertices end up
+    int vertexOffset = 0;
+    int indexOffset = 0;
+    for (int i = 0; i < count; i++) {
+        const int first = run[i].data.geometry.firstVertex;
+        const int n = run[i].data.geometry.vertexCount;
+        const int firstIndex = run[i].data.geometry.firstIndex;
+        const int m = run[i].data.geometry.indexCount;
+
+        memcpy(&scratchVertices[vertexOffset], &vertices[first], (size_t)n * sizeof(SDL_Vertex));
+        for (int j = 0; j < m; j++) {
+            scratchIndices[indexOffset + j] = indices[firstIndex + j] + vertexOffset;
+        }
+        vertexOffset += n;
+        indexOffset += m;
+    }
+
+    if (!currentTextureKnown || run[0].texture != currentTexture) {
+        currentTexture = run[0].texture;
+        currentTextureKnown = 1;
+        frameStats.stateChanges++;
+    }
+
+    SDL_RenderGeometry(batchRenderer, run[0].texture, scratchVertices, totalVertices, scratchIndices, totalIndices);
+    frameStats.drawCalls++;
+}
+
+// The same run drawn into the rasterizer's framebuffer, one primitive at a time (no SDL call to save)
+static void rasterizeRun(const BatchCommand *run, int count){
+    switch (run[0].kind) {
+        case COMMAND_POINT:
+            if (!reserveArray((void **)&scratchPoints, &scratchPointCapacity, count, sizeof(SDL_Point))) {
+                return;
+            }
+            for (int i = 0; i < count; i++) {
+                scratchPoints[i] = run[i].data.point;
+            }
+            rasterPoints(scratchPoints, count, run[0].color);
+            break;
+        case COMMAND_LINE:
+            for (int i = 0; i < count; i++) {
+                rasterLine(run[i].data.line[0].x, run[i].data.line[0].y, run[i].data.line[1].x, run[i].data.line[1].y, run[i].color);
+            }
+            break;
+        case COMMAND_RECT:
+            for (int i = 0; i < count; i++) {
+                rasterRect(&run[i].data.rect, run[i].color);
+            }
+            break;
+        case COMMAND_FILL_RECT:
+            for (int i = 0; i < count; i++) {
+                rasterFillRect(&run[i].data.rect, run[i].color);
+            }
+            break;
+        case COMMAND_GEOMETRY:
+            for (int i = 0; i < count; i++) {
+                const BatchCommand *command = &run[i];
+                rasterGeometry(command->texture, &vertices[command->data.geometry.firstVertex], command->data.geometry.vertexCount, &indices[command->data.geometry.firstIndex], command->data.geometry.indexCount);
+            }
+            break;
+        case COMMAND_CLIPPED_GEOMETRY:
+            for (int i = 0; i < count; i++) {
+                const BatchCommand *command = &run[i];
+                SDL_Rect previous;
+                SDL_Rect clip;
+                getRasterClip(&previous);
+                if (SDL_IntersectRect(&previous, &command->data.geometry.clip, &clip)) {
+                    setRasterClip(&clip);
+                    rasterGeometry(command->texture, &vertices[command->data.geometry.firstVertex], command->data.geometry.vertexCount, &indices[command->data.geometry.firstIndex], command->data.geometry.indexCount);
+                    setRasterClip(&previous);
+                }
+            }
+            break;
+        default:
+            break;
+    }
+    frameStats.drawCalls++;
+}
+
+// Every command with its clip rectangle inside the one already set (the redrawn region)
+static void drawClippedGeometry(const BatchCommand *run, int count){
+    SDL_Rect previous;
+    const SDL_bool previousEnabled = SDL_RenderIsClipEnabled(batchRenderer);
+    SDL_RenderGetClipRect(batchRenderer, &previous);
+
+    for (int i = 0; i < count; i++) {
+        SDL_Rect clip = run[i].data.geometry.clip;
+        if (previousEnabled && !SDL_IntersectRect(&previous, &run[i].data.geometry.clip, &clip)) {
+            continue; // nothing of it is in the region
+        }
+
+        SDL_RenderSetClipRect(batchRenderer, &clip);
+        drawGeometry(&run[i], 1);
+        frameStats.stateChanges++;
+    }
+
+    SDL_RenderSetClipRect(batchRenderer, previousEnabled ? &previous : NULL);
+}
+
+static void drawRun(const BatchCommand *run, int count){
+    if (isRasterizerActive()) {
+        rasterizeRun(run, count);
+        return;
+    }
+
+    switch (run[0].kind) {
+        case COMMAND_POINT:
+            drawPoints(run, count);
+            break;
+        case COMMAND_LINE:
+            drawLines(run, count);
+            break;
+        case COMMAND_RECT:
+            drawRects(run, count, 0);
+            break;
+        case COMMAND_FILL_RECT:
+            drawRects(run, count, 1);
+            break;
+        case COMMAND_GEOMETRY:
+            drawGeometry(run, count);
+            break;
+        case COMMAND_CLIPPED_GEOMETRY:
+            drawClippedGeometry(run, count);
+            break;
+        default:
+            break;
+    }
+}
+
+void submitRenderBatch(void){
+    if (commandCount == 0 || batchRenderer == NULL) {
+        commandCount = 0;
+        return;
+    }
+
+    qsort(commands, (size_t)commandCount, sizeof(BatchCommand), compareCommands);
+
+    // the render target or other code may have changed the state since the last submit
+    currentColorKnown = 0;
+    currentTextureKnown = 0;
+
+    int start = 0;
+    while (start < commandCount) {
+        int end = start + 1;
+        while (end < commandCount && KEY_RUN(commands[end].key) == KEY_RUN(commands[start].key)) {
+            end++;
+        }
+
+        drawRun(&commands[start], end - start);
+        start = end;
+    }
+
+    commandCount = 0;
+    vertexCount = 0;
+    indexCount = 0;
+    textureCount = 0;
+}
+
+void finishRenderBatchFrame(void){
+    submitRenderBatch();
+
+    lastFrameStats = frameStats;
+    totalStats.commands += frameStats.commands;
+    totalStats.drawCalls += frameStats.drawCalls;
+    totalStats.stateChanges += frameStats.stateChanges;
+    totalStats.textures += frameStats.textures;
+    memset(&frameStats, 0, sizeof(frameStats));
+}
+
+RenderBatchStats getRenderBatchStats(void){
+    return lastFrameStats;
+}
+
+RenderBatchStats getRenderBatchTotals(void){
+    RenderBatchStats totals = totalStats;
+    totals.commands += frameStats.commands;
+    totals.drawCalls += frameStats.drawCalls;
+    totals.stateChanges += frameStats.stateChanges;
+    totals.textures += frameStats.textures;
+    return totals;
+}
+
+SDL_Texture *createRenderTexture(SDL_Renderer *renderer, Uint32 format, int access, int width, int height){
+    SDL_Texture *texture = SDL_CreateTexture(renderer, format, access, width, height);
+    if (texture != NULL) {
+        frameStats.textures++;
+    }
+    return texture;
+}
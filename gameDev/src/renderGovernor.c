@@ -0,0 +1,110 @@
+/**
+ * @file renderGovernor.c
+ *
+ * @brief This file contains the render quality governor: HUD work is cut down step by step when rendering runs over budget.
+ */
+
+// Include header files
+#include "renderGovernor.h"
+#include "logger.h"
+
+#define SMOOTHING 0.05 // weight of the newest frame in the average render time (about 20 frames)
+#define DEGRADE_FRAMES 15 // frames over budget before the quality drops (0.25 s at 60 FPS)
+#define RESTORE_FRAMES 120 // frames with headroom before the quality goes back up (2 s)
+#define RESTORE_UTILISATION 0.4 // headroom: the next level up costs up to twice as much (half rate)
+#define HOLD_FRAMES 30 // frames after a change before the next one, the average settles first
+
+static QualityLevel qualityLevel = QUALITY_FULL;
+static long renderBudget = RENDER_BUDGET_MICROSECONDS;
+static double averageRender = 0.0; // microseconds
+static int overBudgetFrames = 0;
+static int headroomFrames = 0;
+static int holdFrames = 0;
+static int lastLateTicks = -1; // unknown until the first report
+static unsigned frameCounter = 0;
+static int qualityChanges = 0;
+
+static const char *qualityNames[QUALITY_LEVELS] = {
+    "full",
+    "slow text",
+    "no debug",
+    "static gauges",
+    "half rate"
+};
+
+void initRenderGovernor(long budgetMicroseconds){
+    qualityLevel = QUALITY_FULL;
+    renderBudget = (budgetMicroseconds > 0) ? budgetMicroseconds : RENDER_BUDGET_MICROSECONDS;
+    averageRender = 0.0;
+    overBudgetFrames = 0;
+    headroomFrames = 0;
+    holdFrames = 0;
+    lastLateTicks = -1;
+    frameCounter = 0;
+    qualityChanges = 0;
+}
+
+int shouldRenderFrame(void){
+    if (qualityLevel < QUALITY_HALF_RATE) {
+        return 1;
+    }
+    return (frameCounter & 1u) == 0;
+}
+
+static void setQuality(QualityLevel level, const char *reason){
+    qualityLevel = level;
+    qualityChanges++;
+    overBudgetFrames = 0;
+    headroomFrames = 0;
+    holdFrames = HOLD_FRAMES;
+
+    logMessage(LOG_INFO, "Render quality: %s (%s, %.0f%% of the render budget).", qualityNames[level], reason, averageRender * 100.0 / (double)renderBudget);
+}
+
+void updateRenderGovernor(long renderMicroseconds, int lateTicks){
+    frameCounter++;
+    averageRender += ((double)renderMicroseconds - averageRender) * SMOOTHING;
+
+    const double utilisation = averageRender / (double)renderBudget;
+    const int late = lastLateTicks >= 0 && lateTicks > lastLateTicks;
+    lastLateTicks = lateTicks;
+
+    if (holdFrames > 0) {
+        holdFrames--; // the last change hasn't shown in the average yet
+        return;
+    }
+
+    overBudgetFrames = (utilisation > 1.0) ? overBudgetFrames + 1 : 0;
+    headroomFrames = (utilisation < RESTORE_UTILISATION && !late) ? headroomFrames + 1 : 0;
+
+    if (late && qualityLevel < QUALITY_LEVELS - 1) {
+        setQuality(qualityLevel + 1, "physics tick late"); // the physics comes first, don't wait
+    }
+    else if (overBudgetFrames >= DEGRADE_FRAMES && qualityLevel < QUALITY_LEVELS - 1) {
+        setQuality(qualityLevel + 1, "over budget");
+    }
+    else if (headroomFrames >= RESTORE_FRAMES && qualityLevel > QUALITY_FULL) {
+        setQuality(qualityLevel - 1, "headroom");
+    }
+}
+
+QualityLevel getRenderQuality(void){
+    return qualityLevel;
+}
+
+const char *getQualityName(QualityLevel level){
+    if (level < QUALITY_FULL || level >= QUALITY_LEVELS) {
+        return "unknown";
+    }
+    return qualityNames[level];
+}
+
+GovernorStats getRenderGovernorStats(void){
+    GovernorStats stats;
+    stats.level = qualityLevel;
+    stats.utilisation = (float)(averageRender / (double)renderBudget);
+    stats.averageRenderMs = (float)(averageRender / 1000.0);
+    stats.lateTicks = (lastLateTicks > 0) ? lastLateTicks : 0;
+    stats.changes = qualityChanges;
+    return stats;
+}
@@ -0,0 +1,290 @@
+/**
+ * @file simulation.c
+ *
+ * @brief This file contains the simulation thread and the snapshot hand-off to the renderer.
+ */
+
+// Include header files
+#include "simulation.h"
+#include "tripleBuffer.h"
+#include "weather.h"
+#include "logger.h"
+
+// Include necessary libraries
+#include <SDL2/SDL.h>
+
+#define SIMULATION_MAX_LAG (4 * SIMULATION_TICK_MICROSECONDS) // further behind than this, the tick schedule restarts instead of catching up
+
+// Owned by the simulation thread once it runs
+static AircraftState simulationAircraft;
+static const CompiledAircraftModel *simulationModel = NULL;
+static AircraftControls simulationControls;
+static float simulationTime = 0.0f;
+static unsigned simulationTick = 0;
+
+static SDL_Thread *simulationThread = NULL;
+static SDL_atomic_t quitSimulation;
+static SDL_atomic_t snapshotsProduced;
+static SDL_atomic_t snapshotsSkipped;
+static SDL_atomic_t ticksLate;
+static SDL_atomic_t simulationPaused;
+static SDL_sem *resumeSemaphore = NULL; // posted on resume and on stop, the paused thread blocks on it
+
+static TripleBuffer snapshotBuffer; // simulation thread -> renderer
+static SimulationSample history[SIMULATION_HISTORY]; // simulation thread -> renderer, every tick
+static SDL_atomic_t historyWritten; // samples written so far, wraps (only the difference matters)
+static SDL_atomic_t historyRead; // samples read so far
+static SDL_atomic_t samplesDropped;
+static TripleBuffer controlsBuffer; // renderer -> simulation thread
+static int snapshotsConsumed = 0; // renderer only
+
+static void publishSnapshot(int crashed){
+    SimulationSnapshot *snapshot = getTripleBufferBack(&snapshotBuffer);
+
+    snapshot->aircraft = simulationAircraft;
+    snapshot->simulationTime = simulationTime;
+    snapshot->tick = simulationTick;
+    snapshot->crashed = crashed;
+
+    snapshot->trueAirspeed = globalPhysicsData.trueAirspeed;
+    snapshot->velocityMagnitude = globalPhysicsData.velocityMagnitude;
+    snapshot->machNumber = globalPhysicsData.machNumber;
+    snapshot->thrust = globalPhysicsData.thrust;
+    snapshot->totalDrag = globalPhysicsData.totalDrag;
+    snapshot->dragCoefficient = globalPhysicsData.dragCoefficient;
+    snapshot->parasiticDrag = globalPhysicsData.parasiticDrag;
+    snapshot->inducedDrag = globalPhysicsData.inducedDrag;
+    snapshot->dragDivergence = globalPhysicsData.dragDivergence;
+    snapshot->windVector = globalPhysicsData.windVector;
+    snapshot->temperatureDeviation = getCurrentWeather()->temperatureDeviation;
+
+    SDL_AtomicAdd(&snapshotsProduced, 1);
+    if (publishTripleBuffer(&snapshotBuffer)) {
+        SDL_AtomicAdd(&snapshotsSkipped, 1); // the renderer never saw the previous one
+    }
+}
+
+static void recordSample(void){
+    const unsigned written = (unsigned)SDL_AtomicGet(&historyWritten);
+    const unsigned read = (unsigned)SDL_AtomicGet(&historyRead);
+    if (written - read >= SIMULATION_HISTORY) {
+        SDL_AtomicAdd(&samplesDropped, 1); // the renderer didn't keep up, it keeps the older samples
+        return;
+    }
+
+    SimulationSample *sample = &history[written & (SIMULATION_HISTORY - 1)];
+    sample->simulationTime = simulationTime;
+    sample->x = simulationAircraft.x;
+    sample->z = simulationAircraft.z;
+    sample->altitude = simulationAircraft.y;
+    sample->trueAirspeed = globalPhysicsData.trueAirspeed;
+    sample->machNumber = globalPhysicsData.machNumber;
+    sample->angleOfAttack = globalPhysicsData.angleOfAttack;
+    sample->thrust = globalPhysicsData.thrust;
+    sample->totalDrag = globalPhysicsData.totalDrag;
+    sample->fuel = simulationAircraft.fuel;
+
+    SDL_AtomicAdd(&historyWritten, 1); // publishes the sample
+}
+
+static void stepSimulation(float deltaTime){
+    // Pick up the newest controls
+    acquireTripleBuffer(&controlsBuffer);
+    simulationControls = *(const AircraftControls *)getTripleBufferFront(&controlsBuffer);
+
+    simulationTime += deltaTime; // Update simulation time
+    simulationTick++;
+
+    simulationAircraft.yaw = simulationControls.yaw; // Update aircraft yaw
+    simulationAircraft.pitch = simulationControls.pitch; // Update aircraft pitch
+    simulationAircraft.roll = simulationControls.roll; // Update aircraft roll
+    simulationAircraft.controls.throttle = simulationControls.throttle; // Update aircraft throttle
+    simulationAircraft.controls.afterburner = (simulationAircraft.controls.throttle > 1); // Update afterburner status
+
+    // Update weather
+    updateWeather(simulationTime, simulationAircraft.x, simulationAircraft.z); // Stream the wind field and interpolate the weather
+
+    // Update physics
+    updatePhysics(&simulationAircraft, deltaTime, simulationTime, simulationModel); // Update aircraft physics
+    updateAircraftState(&simulationAircraft, deltaTime); // Update aircraft state
+}
+
+static int simulationThreadFunction(void *data){
+    (void)data;
+
+    // Ahead of the render/event thread when both want the CPU (may be refused without the privileges, it runs anyway)
+    SDL_SetThreadPriority(SDL_THREAD_PRIORITY_HIGH);
+
+    long previousTime = getTimeMicroseconds();
+    long nextTick = previousTime + SIMULATION_TICK_MICROSECONDS;
+
+    while (!SDL_AtomicGet(&quitSimulation)) {
+        if (SDL_AtomicGet(&simulationPaused)) {
+            SDL_SemWait(resumeSemaphore); // Sleep until resumed or stopped
+
+            // Simulation time doesn't move while paused, the schedule starts over
+            previousTime = getTimeMicroseconds();
+            nextTick = previousTime + SIMULATION_TICK_MICROSECONDS;
+            continue;
+        }
+
+        long now = getTimeMicroseconds();
+        if (now < nextTick) {
+            sleepMicroseconds(nextTick - now); // Wait for the next tick
+            continue;
+        }
+
+        // Ticks are scheduled at a fixed rate, after a long stall the schedule restarts (no burst of catch-up ticks)
+        long lag = now - nextTick;
+        if (lag > SIMULATION_TICK_MICROSECONDS) {
+            SDL_AtomicAdd(&ticksLate, 1); // a whole tick behind its schedule
+        }
+        nextTick += SIMULATION_TICK_MICROSECONDS;
+        if (lag > SIMULATION_MAX_LAG) {
+            nextTick = now + SIMULATION_TICK_MICROSECONDS;
+        }
+
+        // if the plane is crashed, stop simulating
+        if (simulationAircraft.y <= 0.0f) {
+            publishSnapshot(1);
+            break;
+        }
+
+        float deltaTime = (float)((double)(now - previousTime) / 1000000.0); // Time since the last tick in seconds
+        previousTime = now;
+
+        stepSimulation(deltaTime);
+        publishSnapshot(0);
+        recordSample();
+    }
+
+    return 0;
+}
+
+int startSimulation(const AircraftState *aircraft, const CompiledAircraftModel *model, const AircraftControls *controls){
+    if (aircraft == NULL || model == NULL || controls == NULL) {
+        logMessage(LOG_ERROR, "Invalid arguments passed to startSimulation.");
+        return 0;
+    }
+    if (simulationThread != NULL) {
+        return 1;
+    }
+
+    if (!initTripleBuffer(&snapshotBuffer, sizeof(SimulationSnapshot))) {
+        return 0;
+    }
+    if (!initTripleBuffer(&controlsBuffer, sizeof(AircraftControls))) {
+        freeTripleBuffer(&snapshotBuffer);
+        return 0;
+    }
+    resumeSemaphore = SDL_CreateSemaphore(0);
+    if (resumeSemaphore == NULL) {
+        logMessage(LOG_ERROR, "Simulation semaphore couldn't be created: %s", SDL_GetError());
+        freeTripleBuffer(&controlsBuffer);
+        freeTripleBuffer(&snapshotBuffer);
+        return 0;
+    }
+
+    simulationAircraft = *aircraft;
+    simulationModel = model;
+    simulationTime = 0.0f;
+    simulationTick = 0;
+
+    SDL_AtomicSet(&quitSimulation, 0);
+    SDL_AtomicSet(&snapshotsProduced, 0);
+    SDL_AtomicSet(&snapshotsSkipped, 0);
+    SDL_AtomicSet(&ticksLate, 0);
+    SDL_AtomicSet(&simulationPaused, 0);
+    SDL_AtomicSet(&historyWritten, 0);
+    SDL_AtomicSet(&historyRead, 0);
+    SDL_AtomicSet(&samplesDropped, 0);
+    snapshotsConsumed = 0;
+
+    // The renderer has something to show and the first tick has controls before the thread runs
+    setSimulationControls(controls);
+    publishSnapshot(0);
+
+    simulationThread = SDL_CreateThread(simulationThreadFunction, "simulation", NULL);
+    if (simulationThread == NULL) {
+        logMessage(LOG_ERROR, "Simulation thread couldn't be started: %s", SDL_GetError());
+        SDL_DestroySemaphore(resumeSemaphore);
+        resumeSemaphore = NULL;
+        freeTripleBuffer(&controlsBuffer);
+        freeTripleBuffer(&snapshotBuffer);
+        return 0;
+    }
+
+    return 1;
+}
+
+void stopSimulation(void){
+    if (simulationThread == NULL) {
+        return;
+    }
+
+    SDL_AtomicSet(&quitSimulation, 1);
+    SDL_SemPost(resumeSemaphore); // Wake it up if it's paused
+    SDL_WaitThread(simulationThread, NULL);
+    simulationThread = NULL;
+
+    SDL_DestroySemaphore(resumeSemaphore);
+    resumeSemaphore = NULL;
+
+    freeTripleBuffer(&controlsBuffer);
+    freeTripleBuffer(&snapshotBuffer);
+}
+
+void setSimulationPaused(int paused){
+    if (simulationThread == NULL) {
+        return;
+    }
+
+    paused = (paused != 0);
+    int wasPaused = SDL_AtomicSet(&simulationPaused, paused);
+    if (wasPaused && !paused) {
+        SDL_SemPost(resumeSemaphore);
+    }
+}
+
+int isSimulationPaused(void){
+    return SDL_AtomicGet(&simulationPaused);
+}
+
+void setSimulationControls(const AircraftControls *controls){
+    *(AircraftControls *)getTripleBufferBack(&controlsBuffer) = *controls;
+    publishTripleBuffer(&controlsBuffer);
+}
+
+const SimulationSnapshot *acquireSimulationSnapshot(void){
+    if (acquireTripleBuffer(&snapshotBuffer)) {
+        snapshotsConsumed++;
+    }
+    return getTripleBufferFront(&snapshotBuffer);
+}
+
+int readSimulationSamples(SimulationSample *samples, int maxSamples){
+    if (samples == NULL || maxSamples <= 0) {
+        return 0;
+    }
+
+    const unsigned read = (unsigned)SDL_AtomicGet(&historyRead);
+    const unsigned available = (unsigned)SDL_AtomicGet(&historyWritten) - read;
+    const int count = (available < (unsigned)maxSamples) ? (int)available : maxSamples;
+
+    for (int i = 0; i < count; i++) {
+        samples[i] = history[(read + (unsigned)i) & (SIMULATION_HISTORY - 1)];
+    }
+
+    SDL_AtomicAdd(&historyRead, count); // the slots can be written again
+    return count;
+}
+
+SimulationStats getSimulationStats(void){
+    SimulationStats stats;
+    stats.produced = SDL_AtomicGet(&snapshotsProduced);
+    stats.consumed = snapshotsConsumed;
+    stats.skipped = SDL_AtomicGet(&snapshotsSkipped);
+    stats.late = SDL_AtomicGet(&ticksLate);
+    stats.dropped = SDL_AtomicGet(&samplesDropped);
+    return stats;
+}
@@ -0,0 +1,156 @@
+/**
+ * @file stripChart.c
+ *
+ * @brief This file contains the strip chart series: ring buffers of samples and their incremental LTTB decimation.
+ */
+
+// Include header files
+#include "stripChart.h"
+#include "logger.h"
+
+// Include necessary libraries
+#include <math.h>
+#include <string.h>
+
+int initStripChart(StripChart *chart, int width){
+    if (chart == NULL || width < 2 || width > MAX_STRIP_CHART_WIDTH) {
+        logMessage(LOG_ERROR, "Invalid arguments passed to initStripChart.");
+        return 0;
+    }
+
+    memset(chart, 0, sizeof(*chart));
+    chart->width = width;
+    chart->bucketSize = STRIP_CHART_SAMPLES / width; // the bucket being decimated and the one after it fit in the ring
+    return 1;
+}
+
+static float getSample(const StripChart *chart, unsigned sample){
+    return chart->samples[sample % STRIP_CHART_SAMPLES];
+}
+
+// Choose the point of a bucket once the bucket after it is complete (LTTB)
+static void decimateBucket(StripChart *chart, unsigned bucket){
+    const unsigned bucketSize = (unsigned)chart->bucketSize;
+    const unsigned first = bucket * bucketSize;
+    const int slot = (int)(bucket % (unsigned)chart->width);
+
+    // Corners of the triangle, x relative to the bucket's first sample: the point chosen before and the next bucket's average
+    double previousX = 0.0;
+    double previousY = (double)getSample(chart, first);
+    if (bucket > 0) {
+        const int previousSlot = (int)((bucket - 1) % (unsigned)chart->width);
+        previousX = -(double)(first - chart->chosenSample[previousSlot]);
+        previousY = (double)chart->chosenValue[previousSlot];
+    }
+    const double nextX = 1.5 * (double)bucketSize; // middle of the next bucket
+    const double nextY = (double)chart->nextAverage;
+
+    unsigned chosen = first;
+    double biggestArea = -1.0;
+    float minimum = getSample(chart, first);
+    float maximum = minimum;
+
+    for (unsigned i = 0; i < bucketSize; i++) {
+        const float value = getSample(chart, first + i);
+        const double area = fabs((previousX - nextX) * ((double)value - previousY) - (previousX - (double)i) * (nextY - previousY));
+
+        if (area > biggestArea) {
+            biggestArea = area;
+            chosen = first + i;
+        }
+        minimum = fminf(minimum, value);
+        maximum = fmaxf(maximum, value);
+    }
+
+    if (bucket == 0) {
+        chosen = 0; // the line starts at the first sample
+    }
+
+    chart->chosenSample[slot] = chosen;
+    chart->chosenValue[slot] = getSample(chart, chosen);
+    chart->bucketMinimum[slot] = minimum;
+    chart->bucketMaximum[slot] = maximum;
+    chart->decimated = bucket + 1;
+}
+
+void pushStripChartSample(StripChart *chart, float value){
+    chart->samples[chart->pushed % STRIP_CHART_SAMPLES] = value;
+    chart->pushed++;
+    chart->bucketSum += (double)value;
+
+    if (chart->pushed % (unsigned)chart->bucketSize != 0) {
+        return; // the bucket is still open
+    }
+
+    const unsigned completed = chart->pushed / (unsigned)chart->bucketSize - 1;
+    chart->nextAverage = (float)(chart->bucketSum / (double)chart->bucketSize);
+    chart->bucketSum = 0.0;
+
+    if (completed > 0) {
+        decimateBucket(chart, completed - 1); // its next bucket is complete now
+    }
+}
+
+float getLatestStripChartSample(const StripChart *chart){
+    return (chart->pushed > 0) ? getSample(chart, chart->pushed - 1) : 0.0f;
+}
+
+// First sample of the window
+static unsigned getWindowStart(const StripChart *chart){
+    const unsigned window = (unsigned)(chart->width * chart->bucketSize);
+    return (chart->pushed > window) ? chart->pushed - window : 0;
+}
+
+// First bucket with a chosen point that is still in the window
+static unsigned getFirstVisibleBucket(const StripChart *chart){
+    const unsigned start = getWindowStart(chart);
+    unsigned bucket = (chart->decimated > (unsigned)chart->width) ? chart->decimated - (unsigned)chart->width : 0;
+
+    while (bucket < chart->decimated && chart->chosenSample[bucket % (unsigned)chart->width] < start) {
+        bucket++;
+    }
+    return bucket;
+}
+
+void getStripChartRange(const StripChart *chart, float *minimum, float *maximum){
+    for (unsigned bucket = getFirstVisibleBucket(chart); bucket < chart->decimated; bucket++) {
+        const int slot = (int)(bucket % (unsigned)chart->width);
+        *minimum = fminf(*minimum, chart->bucketMinimum[slot]);
+        *maximum = fmaxf(*maximum, chart->bucketMaximum[slot]);
+    }
+
+    // the open buckets (at most three buckets of samples)
+    for (unsigned sample = chart->decimated * (unsigned)chart->bucketSize; sample < chart->pushed; sample++) {
+        *minimum = fminf(*minimum, getSample(chart, sample));
+        *maximum = fmaxf(*maximum, getSample(chart, sample));
+    }
+}
+
+static SDL_Point toScreen(const StripChart *chart, const SDL_Rect *area, unsigned sample, float value, float minimum, float maximum){
+    const unsigned window = (unsigned)(chart->width * chart->bucketSize);
+    const unsigned offset = sample - getWindowStart(chart);
+
+    float height = 0.5f; // flat line in the middle if there is no range
+    if (maximum - minimum > 0.0f) {
+        height = fminf(fmaxf((value - minimum) / (maximum - minimum), 0.0f), 1.0f); // fmaxf drops NaN
+    }
+
+    SDL_Point point;
+    point.x = area->x + (int)((unsigned long long)offset * (unsigned long long)(area->w - 1) / window);
+    point.y = area->y + area->h - 1 - (int)lroundf(height * (float)(area->h - 1));
+    return point;
+}
+
+int getStripChartPoints(const StripChart *chart, const SDL_Rect *area, float minimum, float maximum, SDL_Point *points){
+    int count = 0;
+
+    for (unsigned bucket = getFirstVisibleBucket(chart); bucket < chart->decimated; bucket++) {
+        const int slot = (int)(bucket % (unsigned)chart->width);
+        points[count++] = toScreen(chart, area, chart->chosenSample[slot], chart->chosenValue[slot], minimum, maximum);
+    }
+
+    if (chart->pushed > 0) {
+        points[count++] = toScreen(chart, area, chart->pushed - 1, getLatestStripChartSample(chart), minimum, maximum); // the newest sample ends the line
+    }
+    return count;
+}
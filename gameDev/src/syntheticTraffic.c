@@ -0,0 +1,95 @@
+/**
+ * @file syntheticTraffic.c
+ *
+ * @brief This file contains the synthetic air traffic shown on the tactical display.
+ */
+
+// Include header files
+#include "syntheticTraffic.h"
+#include "logger.h"
+
+// Include necessary libraries
+#include <math.h>
+#include <stdlib.h>
+
+typedef struct {
+    float speed;        // m/s
+    float turnRate;     // rad/s
+} TrafficMotion;
+
+static TacticalContact *traffic = NULL;
+static TrafficMotion *motion = NULL;
+static int trafficCount = 0;
+static unsigned randomState = 1;
+
+// xorshift32, the traffic only has to look random
+static unsigned nextRandom(void){
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return randomState;
+}
+
+// Uniform in [minimum, maximum)
+static float randomRange(float minimum, float maximum){
+    return minimum + (maximum - minimum) * (float)(nextRandom() >> 8) / 16777216.0f;
+}
+
+int initSyntheticTraffic(int count, float centreX, float centreZ, unsigned seed){
+    destroySyntheticTraffic();
+
+    if (count <= 0) {
+        logMessage(LOG_ERROR, "Invalid arguments passed to initSyntheticTraffic.");
+        return 0;
+    }
+
+    traffic = malloc((size_t)count * sizeof(TacticalContact));
+    motion = malloc((size_t)count * sizeof(TrafficMotion));
+    if (traffic == NULL || motion == NULL) {
+        logMessage(LOG_ERROR, "Failed to allocate %d synthetic aircraft.", count);
+        destroySyntheticTraffic();
+        return 0;
+    }
+
+    randomState = (seed != 0) ? seed : 2463534242u; // xorshift never leaves 0
+    for (int i = 0; i < count; i++) {
+        traffic[i].x = centreX + randomRange(-SYNTHETIC_TRAFFIC_RADIUS, SYNTHETIC_TRAFFIC_RADIUS);
+        traffic[i].z = centreZ + randomRange(-SYNTHETIC_TRAFFIC_RADIUS, SYNTHETIC_TRAFFIC_RADIUS);
+        traffic[i].heading = randomRange(0.0f, 2.0f * (float)M_PI);
+        traffic[i].altitude = randomRange(300.0f, 12000.0f);
+        motion[i].speed = randomRange(150.0f, 300.0f);
+        motion[i].turnRate = randomRange(-0.02f, 0.02f); // a full circle takes five minutes or more
+    }
+    trafficCount = count;
+
+    logMessage(LOG_INFO, "Synthetic traffic: %d aircraft.", count);
+    return 1;
+}
+
+void destroySyntheticTraffic(void){
+    free(traffic);
+    free(motion);
+    traffic = NULL;
+    motion = NULL;
+    trafficCount = 0;
+}
+
+void updateSyntheticTraffic(float dt){
+    for (int i = 0; i < trafficCount; i++) {
+        float heading = traffic[i].heading + motion[i].turnRate * dt;
+        if (heading >= 2.0f * (float)M_PI) {
+            heading -= 2.0f * (float)M_PI;
+        } else if (heading < 0.0f) {
+            heading += 2.0f * (float)M_PI;
+        }
+
+        traffic[i].heading = heading;
+        traffic[i].x += cosf(heading) * motion[i].speed * dt;
+        traffic[i].z += sinf(heading) * motion[i].speed * dt;
+    }
+}
+
+const TacticalContact *getSyntheticTraffic(int *count){
+    *count = trafficCount;
+    return traffic;
+}
@@ -0,0 +1,506 @@
+/**
+ * @file tacticalDisplay.c
+ *
+ * @brief This file contains the tactical situation display: the contact grid, the symbols and the altitude tags.
+ */
+
+// Include header files
+#include "tacticalDisplay.h"
+#include "renderBatch.h"
+#include "rasterizer.h"
+#include "logger.h"
+
+// Include necessary libraries
+#include <SDL2/SDL_ttf.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SYMBOL_HEADINGS 64      // pre-rotated symbols, 5.6 degrees apart
+#define SYMBOL_NOSE 6.0f        // nose ahead of the position in pixels
+#define SYMBOL_TAIL 4.0f        // tail corners behind and beside it
+#define SYMBOL_MARGIN 7         // symbols closer than this to the scope's edge are culled
+
+#define LABEL_COLUMNS 16        // cells per row of the label atlas
+#define LABEL_WIDTH 32          // cell width in pixels, "511" in the tag font fits
+#define TAG_OFFSET_X 7          // tag right of the symbol
+#define TAG_OFFSET_Y -4         // and a bit above it
+#define MAX_DECLUTTER_CELLS 16384
+
+// Contacts sorted into the grid
+static TacticalContact *contacts = NULL;
+static int *order = NULL;           // contact indices, cell by cell
+static int *contactCell = NULL;     // cell of every contact, while sorting
+static int contactCount = 0;
+static int contactCapacity = 0;
+
+static int cellStart[MAX_TACTICAL_GRID * MAX_TACTICAL_GRID + 1]; // first entry of every cell in order[]
+static int gridWidth = 0;
+static int gridHeight = 0;
+static float gridX = 0.0f;          // corner of cell (0, 0) in m
+static float gridZ = 0.0f;
+static float cellSize = 1.0f;       // in m
+
+// Pre-rotated symbols, the corners relative to the position in screen pixels
+static SDL_FPoint symbols[SYMBOL_HEADINGS][3];
+
+// Geometry of the frame, grown as needed
+static SDL_Vertex *symbolVertices = NULL;
+static SDL_Vertex *tagVertices = NULL;
+static int *geometryIndices = NULL;
+static int geometryCapacity = 0;    // vertices per array (four per contact), indices hold one and a half times as many
+
+// Label atlas: tag value n is in cell n
+static TTF_Font *tagFont = NULL;
+static SDL_Texture *labelTexture = NULL;
+static Uint32 *labelPixels = NULL;
+static int labelHeight = 0;
+static int labelAtlasHeight = 0;
+static int labelWidths[MAX_TACTICAL_LABELS];   // 0 not rendered yet, -1 failed
+
+// Screen grid of the declutter, a cell is taken by the first tag in it
+static unsigned char declutter[MAX_DECLUTTER_CELLS];
+
+static TacticalStats stats = {0};
+
+/* ##### SYMBOLS ##### */
+
+static void buildSymbols(void){
+    for (int i = 0; i < SYMBOL_HEADINGS; i++) {
+        const float heading = (float)i * 2.0f * (float)M_PI / (float)SYMBOL_HEADINGS;
+        const float forwardX = cosf(heading);
+        const float forwardY = -sinf(heading); // north (+z) is up on screen
+        const float sideX = -forwardY;
+        const float sideY = forwardX;
+
+        symbols[i][0] = (SDL_FPoint){forwardX * SYMBOL_NOSE, forwardY * SYMBOL_NOSE};
+        symbols[i][1] = (SDL_FPoint){-forwardX * SYMBOL_TAIL + sideX * SYMBOL_TAIL, -forwardY * SYMBOL_TAIL + sideY * SYMBOL_TAIL};
+        symbols[i][2] = (SDL_FPoint){-forwardX * SYMBOL_TAIL - sideX * SYMBOL_TAIL, -forwardY * SYMBOL_TAIL - sideY * SYMBOL_TAIL};
+    }
+}
+
+static int getSymbolIndex(float heading){
+    const long index = lroundf(heading * (float)SYMBOL_HEADINGS / (2.0f * (float)M_PI)) % SYMBOL_HEADINGS;
+    return (int)((index + SYMBOL_HEADINGS) % SYMBOL_HEADINGS);
+}
+
+static SDL_Color getAltitudeColor(float altitude){
+    if (altitude < 3000.0f) {
+        return (SDL_Color){0, 255, 0, 255};     // low: green
+    }
+    if (altitude < 9000.0f) {
+        return (SDL_Color){0, 255, 255, 255};   // medium: cyan
+    }
+    return (SDL_Color){255, 255, 255, 255};     // high: white
+}
+
+/* ##### LABEL ATLAS ##### */
+
+static int createLabelAtlas(SDL_Renderer *renderer, const char *fontPath, int fontSize){
+    tagFont = TTF_OpenFont(fontPath, fontSize);
+    if (tagFont == NULL) {
+        logMessage(LOG_WARNING, "Failed to open the tag font %s: %s", fontPath, TTF_GetError());
+        return 0;
+    }
+
+    labelHeight = TTF_FontHeight(tagFont);
+    labelAtlasHeight = (MAX_TACTICAL_LABELS / LABEL_COLUMNS) * labelHeight;
+    const int atlasWidth = LABEL_COLUMNS * LABEL_WIDTH;
+
+    labelTexture = createRenderTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, atlasWidth, labelAtlasHeight);
+    if (labelTexture == NULL) {
+        logMessage(LOG_WARNING, "Failed to create a %dx%d label atlas: %s", atlasWidth, labelAtlasHeight, SDL_GetError());
+        return 0;
+    }
+    SDL_SetTextureBlendMode(labelTexture, SDL_BLENDMODE_BLEND);
+
+    // start fully transparent, static textures have undefined contents
+    labelPixels = calloc((size_t)atlasWidth * (size_t)labelAtlasHeight, sizeof(Uint32));
+    if (labelPixels == NULL) {
+        logMessage(LOG_WARNING, "Failed to allocate a %dx%d label atlas.", atlasWidth, labelAtlasHeight);
+        return 0;
+    }
+    SDL_UpdateTexture(labelTexture, NULL, labelPixels, atlasWidth * 4);
+    registerRasterTexture(labelTexture, labelPixels, atlasWidth, labelAtlasHeight); // the CPU rasterizer reads the copy
+
+    return 1;
+}
+
+static void freeLabelAtlas(void){
+    if (labelTexture != NULL) {
+        unregisterRasterTexture(labelTexture);
+        SDL_DestroyTexture(labelTexture);
+        labelTexture = NULL;
+    }
+    free(labelPixels);
+    labelPixels = NULL;
+
+    if (tagFont != NULL) {
+        TTF_CloseFont(tagFont);
+        tagFont = NULL;
+    }
+    memset(labelWidths, 0, sizeof(labelWidths));
+}
+
+static SDL_Rect getLabelCell(int value){
+    return (SDL_Rect){(value % LABEL_COLUMNS) * LABEL_WIDTH, (value / LABEL_COLUMNS) * labelHeight, LABEL_WIDTH, labelHeight};
+}
+
+// Render a tag value into its cell the first time it's needed
+static int getLabelWidth(int value){
+    if (labelWidths[value] != 0) {
+        return labelWidths[value];
+    }
+    labelWidths[value] = -1; // unless everything below works
+
+    char text[12];
+    snprintf(text, sizeof(text), "%d", value);
+    SDL_Surface *surface = TTF_RenderUTF8_Blended(tagFont, text, (SDL_Color){255, 255, 255, 255});
+    if (surface == NULL) {
+        logMessage(LOG_WARNING, "Failed to render tag %s: %s", text, TTF_GetError());
+        return -1;
+    }
+
+    if (surface->format->format != SDL_PIXELFORMAT_ARGB8888) {
+        SDL_Surface *converted = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+        SDL_FreeSurface(surface);
+        surface = converted;
+        if (surface == NULL) {
+            return -1;
+        }
+    }
+
+    SDL_Rect cell = getLabelCell(value);
+    cell.w = (surface->w < LABEL_WIDTH) ? surface->w : LABEL_WIDTH;
+    cell.h = (surface->h < labelHeight) ? surface->h : labelHeight;
+
+    SDL_UpdateTexture(labelTexture, &cell, surface->pixels, surface->pitch);
+    const int atlasWidth = LABEL_COLUMNS * LABEL_WIDTH;
+    for (int row = 0; row < cell.h; row++) {
+        memcpy(&labelPixels[(cell.y + row) * atlasWidth + cell.x], (const Uint8 *)surface->pixels + row * surface->pitch, (size_t)cell.w * sizeof(Uint32));
+    }
+    SDL_FreeSurface(surface);
+
+    labelWidths[value] = cell.w;
+    stats.tagsRendered++;
+    return cell.w;
+}
+
+/* ##### SETUP ##### */
+
+int initTacticalDisplay(SDL_Renderer *renderer, const char *fontPath, int fontSize){
+    buildSymbols();
+
+    if (renderer == NULL || fontPath == NULL || fontSize <= 0) {
+        logMessage(LOG_ERROR, "Invalid arguments passed to initTacticalDisplay.");
+        return 0;
+    }
+
+    if (!createLabelAtlas(renderer, fontPath, fontSize)) {
+        freeLabelAtlas();
+        return 0; // symbols only
+    }
+    return 1;
+}
+
+void destroyTacticalDisplay(void){
+    freeLabelAtlas();
+
+    free(contacts);
+    free(order);
+    free(contactCell);
+    contacts = NULL;
+    order = NULL;
+    contactCell = NULL;
+    contactCount = 0;
+    contactCapacity = 0;
+    gridWidth = 0;
+    gridHeight = 0;
+
+    free(symbolVertices);
+    free(tagVertices);
+    free(geometryIndices);
+    symbolVertices = NULL;
+    tagVertices = NULL;
+    geometryIndices = NULL;
+    geometryCapacity = 0;
+}
+
+static int reserveContacts(int count){
+    if (count <= contactCapacity) {
+        return 1;
+    }
+
+    TacticalContact *newContacts = realloc(contacts, (size_t)count * sizeof(TacticalContact));
+    if (newContacts == NULL) {
+        return 0;
+    }
+    contacts = newContacts;
+
+    int *newOrder = realloc(order, (size_t)count * sizeof(int));
+    if (newOrder == NULL) {
+        return 0;
+    }
+    order = newOrder;
+
+    int *newCells = realloc(contactCell, (size_t)count * sizeof(int));
+    if (newCells == NULL) {
+        return 0;
+    }
+    contactCell = newCells;
+
+    contactCapacity = count;
+    return 1;
+}
+
+/* ##### GRID ##### */
+
+int setTacticalContacts(const TacticalContact *newContacts, int count){
+    contactCount = 0;
+    gridWidth = 0;
+    gridHeight = 0;
+    stats.contacts = 0;
+
+    if (count <= 0 || newContacts == NULL) {
+        return 1;
+    }
+    if (!reserveContacts(count)) {
+        logMessage(LOG_ERROR, "Failed to allocate %d tactical contacts.", count);
+        return 0;
+    }
+    memcpy(contacts, newContacts, (size_t)count * sizeof(TacticalContact));
+    contactCount = count;
+    stats.contacts = count;
+
+    // square cells over the bounding box, the longer side gets MAX_TACTICAL_GRID of them
+    float minX = contacts[0].x, maxX = contacts[0].x;
+    float minZ = contacts[0].z, maxZ = contacts[0].z;
+    for (int i = 1; i < count; i++) {
+        minX = fminf(minX, contacts[i].x);
+        maxX = fmaxf(maxX, contacts[i].x);
+        minZ = fminf(minZ, contacts[i].z);
+        maxZ = fmaxf(maxZ, contacts[i].z);
+    }
+    cellSize = fmaxf(fmaxf(maxX - minX, maxZ - minZ) / (float)MAX_TACTICAL_GRID, 1.0f);
+    gridX = minX;
+    gridZ = minZ;
+    gridWidth = (int)fminf(floorf((maxX - minX) / cellSize) + 1.0f, (float)MAX_TACTICAL_GRID);
+    gridHeight = (int)fminf(floorf((maxZ - minZ) / cellSize) + 1.0f, (float)MAX_TACTICAL_GRID);
+
+    // counting sort by cell
+    const int cells = gridWidth * gridHeight;
+    memset(cellStart, 0, (size_t)(cells + 1) * sizeof(int));
+    for (int i = 0; i < count; i++) {
+        int column = (int)((contacts[i].x - gridX) / cellSize);
+        int row = (int)((contacts[i].z - gridZ) / cellSize);
+        column = (column < gridWidth) ? column : gridWidth - 1; // the far edge is in the last cell
+        row = (row < gridHeight) ? row : gridHeight - 1;
+        contactCell[i] = row * gridWidth + column;
+        cellStart[contactCell[i] + 1]++;
+    }
+    for (int cell = 0; cell < cells; cell++) {
+        cellStart[cell + 1] += cellStart[cell];
+    }
+    for (int i = 0; i < count; i++) {
+        order[cellStart[contactCell[i]]++] = i;
+    }
+    for (int cell = cells; cell > 0; cell--) {
+        cellStart[cell] = cellStart[cell - 1]; // scattering moved every start to the next cell's
+    }
+    cellStart[0] = 0;
+
+    return 1;
+}
+
+/* ##### DRAWING ##### */
+
+static int reserveGeometry(int vertexCount){
+    if (vertexCount <= geometryCapacity) {
+        return 1;
+    }
+
+    int capacity = (geometryCapacity > 0) ? geometryCapacity : 4096;
+    while (capacity < vertexCount) {
+        capacity *= 2;
+    }
+
+    SDL_Vertex *newSymbols = realloc(symbolVertices, (size_t)capacity * sizeof(SDL_Vertex));
+    if (newSymbols == NULL) {
+        return 0;
+    }
+    symbolVertices = newSymbols;
+
+    SDL_Vertex *newTags = realloc(tagVertices, (size_t)capacity * sizeof(SDL_Vertex));
+    if (newTags == NULL) {
+        return 0;
+    }
+    tagVertices = newTags;
+
+    int *newIndices = realloc(geometryIndices, (size_t)capacity * 3 / 2 * sizeof(int));
+    if (newIndices == NULL) {
+        return 0;
+    }
+    geometryIndices = newIndices;
+
+    geometryCapacity = capacity;
+    return 1;
+}
+
+// Claim the declutter cells a tag covers, 0 if one of them is taken
+static int claimTagArea(const SDL_Rect *area, int columns, int rows, int x, int y, int width){
+    const int column0 = (x - area->x) / LABEL_WIDTH;
+    const int column1 = (x + width - 1 - area->x) / LABEL_WIDTH;
+    const int row0 = (y - area->y) / labelHeight;
+    const int row1 = (y + labelHeight - 1 - area->y) / labelHeight;
+    if (x < area->x || y < area->y || column1 >= columns || row1 >= rows) {
+        return 0; // would stick out of the scope
+    }
+
+    for (int row = row0; row <= row1; row++) {
+        for (int column = column0; column <= column1; column++) {
+            if (declutter[row * columns + column]) {
+                return 0;
+            }
+        }
+    }
+    for (int row = row0; row <= row1; row++) {
+        for (int column = column0; column <= column1; column++) {
+            declutter[row * columns + column] = 1;
+        }
+    }
+    return 1;
+}
+
+static void addTag(SDL_Vertex *vertices, int x, int y, int value, int width, SDL_Color color){
+    const SDL_Rect cell = getLabelCell(value);
+    const float invWidth = 1.0f / (float)(LABEL_COLUMNS * LABEL_WIDTH);
+    const float invHeight = 1.0f / (float)labelAtlasHeight;
+    const float u0 = (float)cell.x * invWidth;
+    const float v0 = (float)cell.y * invHeight;
+    const float u1 = (float)(cell.x + width) * invWidth;
+    const float v1 = (float)(cell.y + cell.h) * invHeight;
+    const float x0 = (float)x;
+    const float y0 = (float)y;
+    const float x1 = (float)(x + width);
+    const float y1 = (float)(y + cell.h);
+
+    vertices[0] = (SDL_Vertex){{x0, y0}, color, {u0, v0}};
+    vertices[1] = (SDL_Vertex){{x1, y0}, color, {u1, v0}};
+    vertices[2] = (SDL_Vertex){{x1, y1}, color, {u1, v1}};
+    vertices[3] = (SDL_Vertex){{x0, y1}, color, {u0, v1}};
+}
+
+void drawTacticalDisplay(const SDL_Rect *area, float centreX, float centreZ, float pixelSize){
+    stats.visible = 0;
+    stats.tags = 0;
+    stats.cellsVisited = 0;
+
+    const SDL_Color frameColor = {128, 128, 128, 255};
+    batchRect(BATCH_LAYER_SHAPES, area, frameColor);
+
+    if (contactCount == 0 || gridWidth == 0 || pixelSize <= 0.0f || area->w <= 2 * SYMBOL_MARGIN || area->h <= 2 * SYMBOL_MARGIN) {
+        return;
+    }
+    if (!reserveGeometry(contactCount * 4)) {
+        logMessage(LOG_ERROR, "Failed to allocate the tactical display geometry.");
+        return;
+    }
+
+    const float middleX = (float)area->x + 0.5f * (float)area->w;
+    const float middleY = (float)area->y + 0.5f * (float)area->h;
+    const float scale = 1.0f / pixelSize;
+
+    // symbols must be completely inside the scope
+    const float left = (float)(area->x + SYMBOL_MARGIN);
+    const float right = (float)(area->x + area->w - SYMBOL_MARGIN);
+    const float top = (float)(area->y + SYMBOL_MARGIN);
+    const float bottom = (float)(area->y + area->h - SYMBOL_MARGIN);
+
+    // grid cells under the view
+    const float minX = centreX + (left - middleX) * pixelSize;
+    const float maxX = centreX + (right - middleX) * pixelSize;
+    const float minZ = centreZ - (bottom - middleY) * pixelSize;
+    const float maxZ = centreZ - (top - middleY) * pixelSize;
+    const int column0 = (int)fmaxf(floorf((minX - gridX) / cellSize), 0.0f);
+    const int column1 = (int)fminf(floorf((maxX - gridX) / cellSize), (float)(gridWidth - 1));
+    const int row0 = (int)fmaxf(floorf((minZ - gridZ) / cellSize), 0.0f);
+    const int row1 = (int)fminf(floorf((maxZ - gridZ) / cellSize), (float)(gridHeight - 1));
+
+    // tags are only decluttered if the screen grid fits
+    const int tags = (labelTexture != NULL && labelHeight > 0);
+    const int declutterColumns = area->w / LABEL_WIDTH;
+    const int declutterRows = tags ? area->h / labelHeight : 0;
+    const int declutterTags = tags && declutterColumns * declutterRows <= MAX_DECLUTTER_CELLS;
+    if (declutterTags) {
+        memset(declutter, 0, (size_t)(declutterColumns * declutterRows));
+    }
+
+    int symbolCount = 0;
+    int tagCount = 0;
+
+    for (int row = row0; row <= row1; row++) {
+        for (int column = column0; column <= column1; column++) {
+            const int cell = row * gridWidth + column;
+            stats.cellsVisited++;
+
+            for (int entry = cellStart[cell]; entry < cellStart[cell + 1]; entry++) {
+                const TacticalContact *contact = &contacts[order[entry]];
+                const float x = middleX + (contact->x - centreX) * scale;
+                const float y = middleY - (contact->z - centreZ) * scale;
+                if (x < left || x > right || y < top || y > bottom) {
+                    continue;
+                }
+
+                const SDL_FPoint *symbol = symbols[getSymbolIndex(contact->heading)];
+                const SDL_Color color = getAltitudeColor(contact->altitude);
+                SDL_Vertex *vertex = &symbolVertices[symbolCount * 3];
+                for (int corner = 0; corner < 3; corner++) {
+                    vertex[corner] = (SDL_Vertex){{x + symbol[corner].x, y + symbol[corner].y}, color, {0.0f, 0.0f}};
+                }
+                symbolCount++;
+
+                if (!declutterTags) {
+                    continue;
+                }
+                const int value = (int)fminf(fmaxf(contact->altitude / 100.0f, 0.0f), (float)(MAX_TACTICAL_LABELS - 1));
+                const int tagX = (int)x + TAG_OFFSET_X;
+                const int tagY = (int)y + TAG_OFFSET_Y;
+                if (!claimTagArea(area, declutterColumns, declutterRows, tagX, tagY, LABEL_WIDTH)) {
+                    continue;
+                }
+                const int width = getLabelWidth(value);
+                if (width > 0) {
+                    addTag(&tagVertices[tagCount * 4], tagX, tagY, value, width, color);
+                    tagCount++;
+                }
+            }
+        }
+    }
+
+    stats.visible = symbolCount;
+    stats.tags = tagCount;
+
+    // one call for all symbols, the indices are simply 0 to n - 1
+    for (int i = 0; i < symbolCount * 3; i++) {
+        geometryIndices[i] = i;
+    }
+    batchGeometry(BATCH_LAYER_SHAPES, NULL, symbolVertices, symbolCount * 3, geometryIndices, symbolCount * 3);
+
+    // and one for all tags
+    for (int i = 0; i < tagCount; i++) {
+        int *quad = &geometryIndices[i * 6];
+        const int first = i * 4;
+        quad[0] = first;
+        quad[1] = first + 1;
+        quad[2] = first + 2;
+        quad[3] = first;
+        quad[4] = first + 2;
+        quad[5] = first + 3;
+    }
+    batchGeometry(BATCH_LAYER_TEXT, labelTexture, tagVertices, tagCount * 4, geometryIndices, tagCount * 6);
+}
+
+TacticalStats getTacticalStats(void){
+    return stats;
+}
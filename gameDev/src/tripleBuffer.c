@@ -0,0 +1,87 @@
+/**
+ * @file tripleBuffer.c
+ *
+ * @brief This file contains the wait-free triple buffer used to hand data from a worker thread to the main loop.
+ */
+
+// Include header files
+#include "tripleBuffer.h"
+#include "logger.h"
+
+// Include necessary libraries
+#include <stdlib.h>
+
+#define TRIPLE_BUFFER_FRESH 4 // flag bit next to the middle slot index (0-2)
+#define TRIPLE_BUFFER_INDEX 3 // mask of the slot index
+
+int initTripleBuffer(TripleBuffer *buffer, size_t slotSize){
+    if (buffer == NULL || slotSize == 0) {
+        logMessage(LOG_ERROR, "Invalid arguments passed to initTripleBuffer.");
+        return 0;
+    }
+
+    // one allocation for all three slots
+    unsigned char *block = calloc(3, slotSize);
+    if (block == NULL) {
+        logMessage(LOG_ERROR, "Failed to allocate a triple buffer of %zu bytes.", 3 * slotSize);
+        return 0;
+    }
+
+    for (int i = 0; i < 3; i++) {
+        buffer->slots[i] = block + (size_t)i * slotSize;
+    }
+    buffer->slotSize = slotSize;
+    buffer->back = 0;
+    buffer->front = 1;
+    SDL_AtomicSet(&buffer->middle, 2);
+
+    return 1;
+}
+
+void freeTripleBuffer(TripleBuffer *buffer){
+    if (buffer == NULL) {
+        return;
+    }
+
+    free(buffer->slots[0]); // start of the block
+    for (int i = 0; i < 3; i++) {
+        buffer->slots[i] = NULL;
+    }
+    buffer->slotSize = 0;
+}
+
+void *getTripleBufferBack(TripleBuffer *buffer){
+    return buffer->slots[buffer->back];
+}
+
+int publishTripleBuffer(TripleBuffer *buffer){
+    // hand the back slot over and take whatever was in the middle as the new back slot
+    SDL_MemoryBarrierRelease(); // the slot contents have to be visible before the index is
+    int previous = SDL_AtomicSet(&buffer->middle, buffer->back | TRIPLE_BUFFER_FRESH);
+    SDL_MemoryBarrierAcquire(); // the consumer is done reading the slot we get back
+    buffer->back = previous & TRIPLE_BUFFER_INDEX;
+
+    return (previous & TRIPLE_BUFFER_FRESH) ? 1 : 0;
+}
+
+int hasFreshTripleBuffer(TripleBuffer *buffer){
+    return (SDL_AtomicGet(&buffer->middle) & TRIPLE_BUFFER_FRESH) ? 1 : 0;
+}
+
+int acquireTripleBuffer(TripleBuffer *buffer){
+    if (!hasFreshTripleBuffer(buffer)) {
+        return 0;
+    }
+
+    // hand the front slot back and take the published one
+    SDL_MemoryBarrierRelease(); // we're done reading the front slot before it's handed back
+    int previous = SDL_AtomicSet(&buffer->middle, buffer->front);
+    SDL_MemoryBarrierAcquire(); // pairs with the release in publishTripleBuffer()
+    buffer->front = previous & TRIPLE_BUFFER_INDEX;
+
+    return 1;
+}
+
+const void *getTripleBufferFront(const TripleBuffer *buffer){
+    return buffer->slots[buffer->front];
+}
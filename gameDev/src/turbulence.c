@@ -0,0 +1,312 @@
+/**
+ * @file turbulence.c
+ *
+ * @brief This file contains the Dryden turbulence model: the altitude profile, the noise generator and the shaping filters.
+ */
+
+// Include header files
+#include "turbulence.h"
+#include "logger.h"
+
+// Include necessary libraries
+#include <stdlib.h>
+#include <math.h>
+
+#define FEET_TO_METERS 0.3048f
+#define KNOTS_TO_FEET_PER_SECOND 1.68781f
+#define MIN_TURBULENCE_ALTITUDE_FT 10.0f // the low altitude model isn't defined below 10 ft
+#define LOW_ALTITUDE_LIMIT_FT 1000.0f // low altitude model below this
+#define HIGH_ALTITUDE_LIMIT_FT 2000.0f // medium/high altitude model above this
+#define HIGH_ALTITUDE_SCALE_LENGTH_FT 1750.0f // Dryden scale length above 2000 ft
+#define MIN_TURBULENCE_AIRSPEED 1.0f // m/s, keeps the filters moving when the aircraft is (almost) stopped
+
+// Precomputed reciprocal of the profile step
+static const float invProfileStep = 1.0f / TURBULENCE_TABLE_STEP;
+
+/*
+    #########################################################
+    #                                                       #
+    #                        PROFILE                        #
+    #                                                       #
+    #########################################################
+*/
+
+// Wind speed at 20 ft for each severity (knots)
+static const float windSpeedAt20ft[] = { 0.0f, 15.0f, 30.0f, 45.0f };
+
+// Medium/high altitude RMS intensities (ft/s) over altitude (ft), MIL-HDBK-1797 probability of exceedance curves
+#define POE_POINTS 12
+static const float poeAltitudeFt[POE_POINTS] = { 500.0f, 1750.0f, 3750.0f, 7500.0f, 15000.0f, 25000.0f, 35000.0f, 45000.0f, 55000.0f, 65000.0f, 75000.0f, 80000.0f };
+static const float poeSigmaFps[][POE_POINTS] = {
+    { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f },             // none
+    { 6.6f, 6.9f, 7.4f, 6.7f, 4.6f, 2.7f, 0.4f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f },             // light, 10^-2
+    { 8.6f, 9.6f, 10.6f, 10.1f, 8.0f, 6.6f, 5.0f, 4.2f, 2.7f, 0.0f, 0.0f, 0.0f },           // moderate, 10^-3
+    { 15.6f, 17.6f, 23.0f, 23.6f, 22.1f, 20.0f, 16.0f, 15.1f, 12.1f, 7.9f, 6.2f, 5.1f }     // severe, 10^-5
+};
+
+// Intensities (ft/s) and scale lengths (ft) at one altitude, before conversion to the profile units
+typedef struct {
+    float sigmaU, sigmaV, sigmaW;
+    float lengthU, lengthV, lengthW;
+} DrydenParameters;
+
+// Low altitude model (below 1000 ft)
+static DrydenParameters lowAltitudeParameters(float altitudeFt, TurbulenceSeverity severity){
+    DrydenParameters p;
+    const float factor = 0.177f + 0.000823f * altitudeFt;
+
+    p.lengthW = altitudeFt;
+    p.lengthU = altitudeFt / powf(factor, 1.2f);
+    p.lengthV = p.lengthU;
+
+    p.sigmaW = 0.1f * windSpeedAt20ft[severity] * KNOTS_TO_FEET_PER_SECOND;
+    p.sigmaU = p.sigmaW / powf(factor, 0.4f);
+    p.sigmaV = p.sigmaU;
+
+    return p;
+}
+
+// Medium/high altitude model (above 2000 ft)
+static DrydenParameters highAltitudeParameters(float altitudeFt, TurbulenceSeverity severity){
+    DrydenParameters p;
+    float sigma;
+
+    if (altitudeFt <= poeAltitudeFt[0]) {
+        sigma = poeSigmaFps[severity][0];
+    }
+    else if (altitudeFt >= poeAltitudeFt[POE_POINTS - 1]) {
+        sigma = poeSigmaFps[severity][POE_POINTS - 1];
+    }
+    else {
+        int i = 0;
+        while (altitudeFt > poeAltitudeFt[i + 1]) i++;
+        float t = (altitudeFt - poeAltitudeFt[i]) / (poeAltitudeFt[i + 1] - poeAltitudeFt[i]);
+        sigma = poeSigmaFps[severity][i] + t * (poeSigmaFps[severity][i + 1] - poeSigmaFps[severity][i]);
+    }
+
+    p.sigmaU = p.sigmaV = p.sigmaW = sigma;
+    p.lengthU = p.lengthV = p.lengthW = HIGH_ALTITUDE_SCALE_LENGTH_FT;
+
+    return p;
+}
+
+static DrydenParameters drydenParameters(float altitudeFt, TurbulenceSeverity severity){
+    if (altitudeFt < MIN_TURBULENCE_ALTITUDE_FT) altitudeFt = MIN_TURBULENCE_ALTITUDE_FT;
+
+    if (altitudeFt <= LOW_ALTITUDE_LIMIT_FT) {
+        return lowAltitudeParameters(altitudeFt, severity);
+    }
+    if (altitudeFt >= HIGH_ALTITUDE_LIMIT_FT) {
+        return highAltitudeParameters(altitudeFt, severity);
+    }
+
+    // in between the two models are blended linearly
+    DrydenParameters low = lowAltitudeParameters(LOW_ALTITUDE_LIMIT_FT, severity);
+    DrydenParameters high = highAltitudeParameters(HIGH_ALTITUDE_LIMIT_FT, severity);
+    float t = (altitudeFt - LOW_ALTITUDE_LIMIT_FT) / (HIGH_ALTITUDE_LIMIT_FT - LOW_ALTITUDE_LIMIT_FT);
+
+    DrydenParameters p;
+    p.sigmaU = low.sigmaU + t * (high.sigmaU - low.sigmaU);
+    p.sigmaV = low.sigmaV + t * (high.sigmaV - low.sigmaV);
+    p.sigmaW = low.sigmaW + t * (high.sigmaW - low.sigmaW);
+    p.lengthU = low.lengthU + t * (high.lengthU - low.lengthU);
+    p.lengthV = low.lengthV + t * (high.lengthV - low.lengthV);
+    p.lengthW = low.lengthW + t * (high.lengthW - low.lengthW);
+    return p;
+}
+
+static void buildTurbulenceProfile(TurbulenceField *field){
+    for (int i = 0; i < TURBULENCE_TABLE_POINTS; i++) {
+        const float altitudeFt = (float)i * TURBULENCE_TABLE_STEP / FEET_TO_METERS;
+        const DrydenParameters p = drydenParameters(altitudeFt, field->severity);
+
+        TurbulenceProfile *node = &field->profile[i];
+        node->sigmaU = p.sigmaU * FEET_TO_METERS;
+        node->sigmaV = p.sigmaV * FEET_TO_METERS;
+        node->sigmaW = p.sigmaW * FEET_TO_METERS;
+        node->kU = 1.0f / (p.lengthU * FEET_TO_METERS);
+        node->kV = 2.0f / (p.lengthV * FEET_TO_METERS);
+        node->kW = 2.0f / (p.lengthW * FEET_TO_METERS);
+    }
+}
+
+/*
+    #########################################################
+    #                                                       #
+    #                      INIT / FREE                      #
+    #                                                       #
+    #########################################################
+*/
+
+// Spread the seed so neighbouring slots get unrelated streams (xorshift must never be 0)
+static uint32_t seedSlot(uint32_t seed, int slot){
+    uint32_t x = seed + 0x9E3779B9u * (uint32_t)(slot + 1);
+    x ^= x >> 16; x *= 0x85EBCA6Bu;
+    x ^= x >> 13; x *= 0xC2B2AE35u;
+    x ^= x >> 16;
+    return (x != 0u) ? x : 0x6D2B79F5u;
+}
+
+int initTurbulenceField(TurbulenceField *field, int capacity, TurbulenceSeverity severity, uint32_t seed){
+    if (field == NULL) {
+        logMessage(LOG_ERROR, "Pointer field in function initTurbulenceField is NULL.");
+        return 0;
+    }
+    if (capacity <= 0) {
+        logMessage(LOG_ERROR, "Invalid turbulence capacity %d.", capacity);
+        return 0;
+    }
+
+    // one block for all four arrays, so there's a single allocation per field
+    const size_t n = (size_t)capacity;
+    void *block = malloc(n * (3 * sizeof(float) + sizeof(uint32_t)));
+    if (block == NULL) {
+        logMessage(LOG_ERROR, "Failed to allocate the turbulence state for %d aircraft.", capacity);
+        return 0;
+    }
+
+    field->u = (float *)block;
+    field->v = field->u + n;
+    field->w = field->v + n;
+    field->rng = (uint32_t *)(field->w + n);
+    field->capacity = capacity;
+
+    for (int i = 0; i < capacity; i++) {
+        field->u[i] = 0.0f;
+        field->v[i] = 0.0f;
+        field->w[i] = 0.0f;
+        field->rng[i] = seedSlot(seed, i);
+    }
+
+    field->severity = severity;
+    buildTurbulenceProfile(field);
+
+    return 1;
+}
+
+void freeTurbulenceField(TurbulenceField *field){
+    if (field == NULL) {
+        return;
+    }
+
+    free(field->u); // start of the block
+    field->u = field->v = field->w = NULL;
+    field->rng = NULL;
+    field->capacity = 0;
+}
+
+void setTurbulenceSeverity(TurbulenceField *field, TurbulenceSeverity severity){
+    if (field == NULL) {
+        logMessage(LOG_ERROR, "Pointer field in function setTurbulenceSeverity is NULL.");
+        return;
+    }
+
+    field->severity = severity;
+    buildTurbulenceProfile(field);
+}
+
+/*
+    #########################################################
+    #                                                       #
+    #                        UPDATE                         #
+    #                                                       #
+    #########################################################
+*/
+
+// xorshift32, one multiply-free step
+static inline uint32_t nextRandom(uint32_t x){
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x;
+}
+
+// Approximately standard normal sample from the sum of four 16 bit uniforms (mean 2, variance 1/3),
+// no logf/sinf like Box-Muller, so the update loop stays branch free
+static inline float gaussianNoise(uint32_t *state){
+    uint32_t a = nextRandom(*state);
+    uint32_t b = nextRandom(a);
+    *state = b;
+
+    float sum = (float)((a & 0xFFFFu) + (a >> 16) + (b & 0xFFFFu) + (b >> 16)) * (1.0f / 65536.0f);
+    return (sum - 2.0f) * 1.7320508f; // sqrt(3)
+}
+
+void updateTurbulenceField(TurbulenceField *field, int first, int count, const float *altitude, const float *airspeed, float deltaTime){
+    if (field == NULL || altitude == NULL || airspeed == NULL) {
+        logMessage(LOG_ERROR, "Pointer passed to updateTurbulenceField is NULL.");
+        return;
+    }
+    if (field->capacity == 0 || deltaTime <= 0.0f) { // turbulence is off or the simulation is paused
+        return;
+    }
+    if (first < 0 || count < 0 || first + count > field->capacity) {
+        logMessage(LOG_ERROR, "Turbulence slots %d to %d are out of range (capacity %d).", first, first + count - 1, field->capacity);
+        return;
+    }
+
+    float *restrict u = field->u + first;
+    float *restrict v = field->v + first;
+    float *restrict w = field->w + first;
+    uint32_t *restrict rng = field->rng + first;
+    const TurbulenceProfile *profile = field->profile;
+
+    for (int i = 0; i < count; i++) {
+        // profile at this altitude
+        float h = altitude[i] * invProfileStep;
+        h = fminf(fmaxf(h, 0.0f), (float)(TURBULENCE_TABLE_POINTS - 1));
+        int k = (int)h;
+        k = (k > TURBULENCE_TABLE_POINTS - 2) ? TURBULENCE_TABLE_POINTS - 2 : k;
+        const float t = h - (float)k;
+        const TurbulenceProfile *p0 = &profile[k];
+        const TurbulenceProfile *p1 = &profile[k + 1];
+
+        const float sigmaU = p0->sigmaU + t * (p1->sigmaU - p0->sigmaU);
+        const float sigmaV = p0->sigmaV + t * (p1->sigmaV - p0->sigmaV);
+        const float sigmaW = p0->sigmaW + t * (p1->sigmaW - p0->sigmaW);
+        const float kU = p0->kU + t * (p1->kU - p0->kU);
+        const float kV = p0->kV + t * (p1->kV - p0->kV);
+        const float kW = p0->kW + t * (p1->kW - p0->kW);
+
+        // distance flown this step, the filters are defined over distance, not time
+        const float distance = fmaxf(airspeed[i], MIN_TURBULENCE_AIRSPEED) * deltaTime;
+
+        // x = (1 - a) x + sigma * sqrt(a (2 - a)) * noise keeps the variance at sigma^2 for any step size
+        const float aU = fminf(distance * kU, 1.0f);
+        const float aV = fminf(distance * kV, 1.0f);
+        const float aW = fminf(distance * kW, 1.0f);
+
+        uint32_t state = rng[i];
+        const float noiseU = gaussianNoise(&state);
+        const float noiseV = gaussianNoise(&state);
+        const float noiseW = gaussianNoise(&state);
+        rng[i] = state;
+
+        u[i] = (1.0f - aU) * u[i] + sigmaU * sqrtf(aU * (2.0f - aU)) * noiseU;
+        v[i] = (1.0f - aV) * v[i] + sigmaV * sqrtf(aV * (2.0f - aV)) * noiseV;
+        w[i] = (1.0f - aW) * w[i] + sigmaW * sqrtf(aW * (2.0f - aW)) * noiseW;
+    }
+}
+
+Vector3 getTurbulenceVector(const TurbulenceField *field, int index, Vector3 velocity){
+    if (field == NULL || index < 0 || index >= field->capacity) { // turbulence off (or no slot for this aircraft)
+        return (Vector3){0.0f, 0.0f, 0.0f};
+    }
+
+    // horizontal direction of travel, the gust axes follow it
+    float horizontalSpeed = sqrtf(velocity.x * velocity.x + velocity.z * velocity.z);
+    float forwardX = 1.0f, forwardZ = 0.0f;
+    if (horizontalSpeed > 1e-3f) {
+        forwardX = velocity.x / horizontalSpeed;
+        forwardZ = velocity.z / horizontalSpeed;
+    }
+
+    const float u = field->u[index];
+    const float v = field->v[index];
+
+    return (Vector3){
+        u * forwardX - v * forwardZ,
+        field->w[index],
+        u * forwardZ + v * forwardX
+    };
+}
@@ -6,6 +6,7 @@
 
 // Include the header file
 #include "weather.h" 
+#include "logger.h"
 
 // Include necessary libraries
 #include <stdio.h> 
@@ -15,12 +16,69 @@
 static const float BASE_WIND_SPEED = 2.0f; // m/s at sea level, base wind speed
 static const float ALTITUDE_FACTOR = 0.001f; // m/s increase per meter of altitude, factor for altitude effect on wind speed
 
-// constants for turbulence
-static const float TURBULENCE_AMPLITUDE = 2.0f; // m/s, amplitude of turbulence
-static const float TURBULENCE_FREQUENCY = 0.5f; // radians per second, frequency of turbulence
+// seed of the turbulence noise generators
+static const uint32_t TURBULENCE_SEED = 0x5EEDF00Du;
+
+// seed of the weather simulation
+static const uint32_t WEATHER_SEED = 0x3A7C51E9u;
+
+// turbulence state of all aircraft
+TurbulenceField globalTurbulence = {0};
+
+// gridded wind field, used instead of the analytic wind once loaded
+static WindField windField;
+static int windFieldLoaded = 0;
+
+int initWeather(int aircraftCount, TurbulenceSeverity severity) {
+    if (!initTurbulenceField(&globalTurbulence, aircraftCount, severity, TURBULENCE_SEED)) {
+        return 0;
+    }
+
+    if (!startWeatherSimulation(WEATHER_SEED)) {
+        logMessage(LOG_WARNING, "Weather simulation not running, only the mean wind is used.");
+    }
+
+    return 1;
+}
+
+void freeWeather(void) {
+    stopWeatherSimulation();
+    freeTurbulenceField(&globalTurbulence);
+
+    if (windFieldLoaded) {
+        closeWindField(&windField);
+        windFieldLoaded = 0;
+    }
+}
+
+int loadWindField(const char *path) {
+    if (windFieldLoaded) {
+        closeWindField(&windField);
+        windFieldLoaded = 0;
+    }
+
+    windFieldLoaded = openWindField(&windField, path);
+    return windFieldLoaded;
+}
+
+void updateWeather(float simulationTime, float focusX, float focusZ) {
+    if (windFieldLoaded) {
+        updateWindFieldStreaming(&windField, simulationTime); // Prefetch the next time slice when we enter a new one
+    }
+
+    updateWeatherSimulation(simulationTime, focusX, focusZ); // Interpolate the snapshots from the weather thread
+}
+
+// Function to get the mean wind vector based on position and time
+Vector3 getWindVector(float x, float altitude, float z, float time) {
+    if (windFieldLoaded) {
+        return sampleWindField(&windField, x, altitude, z, time); // Gridded wind field
+    }
+
+    (void)x; // the analytic wind only depends on the altitude
+    (void)z;
+    (void)time;
 
-// Function to get the wind vector based on altitude and time
-Vector3 getWindVector(float altitude, float time) {
     Vector3 wind; // Declare a Vector3 to hold the wind components
 
     // Base wind that increases slightly with altitude, blowing in +x direction
@@ -28,11 +86,19 @@ Vector3 getWindVector(float altitude, float time) {
     wind.y = 0.0f;  // Assume negligible vertical component, set y to 0
     wind.z = 0.0f;  // No base wind in z direction, set z to 0
 
-    // Add turbulence component using a simple sine function
-    float turbulence = TURBULENCE_AMPLITUDE * sinf(TURBULENCE_FREQUENCY * time); // Calculate turbulence component
-    wind.x += turbulence; // Add turbulence to x component
-    // Add a small turbulence component for z or y:
-    wind.z += TURBULENCE_AMPLITUDE * cosf(TURBULENCE_FREQUENCY * time); // Add turbulence to z component
-
     return wind; // Return the wind vector
-}
\ No newline at end of file
+}
+
+// Function to get the mean wind plus the simulated weather at a position
+WeatherSample sampleWeather(float x, float altitude, float z, float time) {
+    const WeatherSnapshot *weather = getCurrentWeather();
+
+    Vector3 meanWind = getWindVector(x, altitude, z, time);
+    Vector3 weatherWind = sampleWeatherWind(weather, x, altitude, z);
+
+    WeatherSample sample;
+    sample.wind = (Vector3){meanWind.x + weatherWind.x, meanWind.y + weatherWind.y, meanWind.z + weatherWind.z};
+    sample.temperatureDeviation = weather->temperatureDeviation;
+
+    return sample;
+}
@@ -0,0 +1,439 @@
+/**
+ * @file weatherSim.c
+ *
+ * @brief This file contains the low-rate weather simulation (worker thread), the snapshot hand-off and the weather wind sampler.
+ */
+
+// Include header files
+#include "weatherSim.h"
+#include "tripleBuffer.h"
+#include "logger.h"
+
+// Include necessary libraries
+#include <math.h>
+#include <string.h>
+#include <SDL2/SDL.h>
+
+// Worker
+#define WEATHER_WORKER_TIMEOUT_MS 1000 // the worker wakes up at least this often to check for quit
+
+// Temperature
+#define TEMPERATURE_DEVIATION_SIGMA 3.0f // K, typical ISA deviation
+#define TEMPERATURE_DEVIATION_TIME 1800.0f // s, how long a deviation persists
+
+// Pressure systems
+#define STEERING_WIND_X 8.0f // m/s, the systems drift with the upper level wind
+#define STEERING_WIND_Z 2.0f // m/s
+#define PRESSURE_DOMAIN_RADIUS 200000.0f // m, systems further away from the aircraft dissipate
+#define PRESSURE_SPAWN_MIN_DISTANCE 30000.0f // m
+#define PRESSURE_SPAWN_MAX_DISTANCE 150000.0f // m
+#define PRESSURE_MIN_RADIUS 20000.0f // m, radius of maximum wind
+#define PRESSURE_MAX_RADIUS 80000.0f // m
+#define PRESSURE_MIN_STRENGTH 4.0f // m/s
+#define PRESSURE_MAX_STRENGTH 15.0f // m/s
+#define PRESSURE_DEVELOP_TIME 600.0f // s, time constant of developing/dissipating
+
+// Shear layers
+#define SHEAR_WIND_SIGMA 4.0f // m/s
+#define SHEAR_WIND_TIME 900.0f // s
+
+// Gust fronts
+#define GUST_FRONT_INTERVAL 900.0f // s, mean time between gust fronts
+#define GUST_FRONT_SPAWN_DISTANCE 8000.0f // m, fronts start this far from the aircraft
+#define GUST_FRONT_PASSED_DISTANCE 30000.0f // m, fronts dissipate after moving this far past the aircraft
+#define GUST_FRONT_SPEED 15.0f // m/s
+#define GUST_FRONT_MIN_STRENGTH 8.0f // m/s
+#define GUST_FRONT_MAX_STRENGTH 15.0f // m/s
+#define GUST_FRONT_DEPTH 2000.0f // m, height of the outflow
+#define GUST_FRONT_WIDTH 1000.0f // m, distance over which the outflow builds up behind the front
+#define GUST_FRONT_UPDRAFT 0.5f // updraft at the leading edge relative to the outflow
+#define GUST_FRONT_DEVELOP_TIME 60.0f // s
+
+#define INACTIVE_STRENGTH 0.05f // m/s, below this a dissipating system/front is removed
+
+// Mean wind added by each shear layer (lowest first)
+static const ShearLayer shearLayerMeans[WEATHER_SHEAR_LAYERS] = {
+    { 1000.0f, 1.0f / 500.0f, 3.0f, 1.0f },     // top of the boundary layer
+    { 4000.0f, 1.0f / 1000.0f, 5.0f, -2.0f },   // mid level
+    { 9000.0f, 1.0f / 2000.0f, 15.0f, 3.0f }    // jet stream
+};
+
+// One slot of the triple buffer: the two snapshots around the current time
+typedef struct {
+    WeatherSnapshot from;
+    WeatherSnapshot to;
+} WeatherSnapshotPair;
+
+// Worker thread state
+static WeatherSnapshot workerState; // only touched by the worker once it runs
+static uint32_t workerRandom;
+static SDL_Thread *weatherThread = NULL;
+static SDL_sem *weatherWake = NULL;
+static SDL_atomic_t requestedTimeMs; // simulation time the worker has to produce snapshots past
+static SDL_atomic_t focusXm, focusZm; // position of the player's aircraft in whole metres
+static SDL_atomic_t quitWeather;
+
+// Hand-off between the worker and the main loop
+static TripleBuffer snapshotBuffer;
+static int weatherRunning = 0;
+
+// Main loop state
+static WeatherSnapshot currentWeather; // calm (all zero) until the simulation runs
+static float requestedForTime = -1.0f; // end time of the pair we already asked a successor for
+
+/*
+    #########################################################
+    #                                                       #
+    #                       EVOLUTION                       #
+    #                                                       #
+    #########################################################
+*/
+
+// xorshift32
+static uint32_t nextRandom(uint32_t *state){
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+// Uniform in [0, 1)
+static float randomUniform(uint32_t *state){
+    return (float)(nextRandom(state) >> 8) * (1.0f / 16777216.0f);
+}
+
+// Standard normal (Box-Muller), the worker runs at a few Hz so the cost doesn't matter here
+static float randomGaussian(uint32_t *state){
+    float u1 = randomUniform(state) + 1e-7f;
+    float u2 = randomUniform(state);
+    return sqrtf(-2.0f * logf(u1)) * cosf(2.0f * PI * u2);
+}
+
+// Ornstein-Uhlenbeck step: drifts back to the mean with time constant tau, standard deviation sigma
+static float stepMeanReverting(float value, float mean, float sigma, float tau, float deltaTime, uint32_t *random){
+    float a = deltaTime / tau;
+    return value + (mean - value) * a + sigma * sqrtf(2.0f * a) * randomGaussian(random);
+}
+
+static void spawnPressureSystem(PressureSystem *system, float focusX, float focusZ, uint32_t *random){
+    float angle = 2.0f * PI * randomUniform(random);
+    float distance = PRESSURE_SPAWN_MIN_DISTANCE + (PRESSURE_SPAWN_MAX_DISTANCE - PRESSURE_SPAWN_MIN_DISTANCE) * randomUniform(random);
+    float radius = PRESSURE_MIN_RADIUS + (PRESSURE_MAX_RADIUS - PRESSURE_MIN_RADIUS) * randomUniform(random);
+    float strength = PRESSURE_MIN_STRENGTH + (PRESSURE_MAX_STRENGTH - PRESSURE_MIN_STRENGTH) * randomUniform(random);
+
+    system->x = focusX + distance * cosf(angle);
+    system->z = focusZ + distance * sinf(angle);
+    system->invRadius = 1.0f / radius;
+    system->strength = 0.0f; // develops from nothing, so the move doesn't show in the interpolation
+    system->targetStrength = (randomUniform(random) < 0.5f) ? strength : -strength; // low or high
+}
+
+static void spawnGustFront(GustFront *front, float focusX, float focusZ, uint32_t *random){
+    float angle = 2.0f * PI * randomUniform(random);
+
+    front->normalX = cosf(angle);
+    front->normalZ = sinf(angle);
+    front->distance = focusX * front->normalX + focusZ * front->normalZ - GUST_FRONT_SPAWN_DISTANCE; // approaching the aircraft
+    front->speed = GUST_FRONT_SPEED;
+    front->strength = 0.0f;
+    front->targetStrength = GUST_FRONT_MIN_STRENGTH + (GUST_FRONT_MAX_STRENGTH - GUST_FRONT_MIN_STRENGTH) * randomUniform(random);
+    front->invDepth = 1.0f / GUST_FRONT_DEPTH;
+}
+
+static void initialWeather(WeatherSnapshot *weather, uint32_t *random){
+    memset(weather, 0, sizeof(*weather));
+
+    weather->temperatureDeviation = TEMPERATURE_DEVIATION_SIGMA * randomGaussian(random);
+
+    for (int i = 0; i < WEATHER_PRESSURE_SYSTEMS; i++) {
+        spawnPressureSystem(&weather->pressureSystems[i], 0.0f, 0.0f, random);
+        weather->pressureSystems[i].strength = weather->pressureSystems[i].targetStrength; // already developed
+    }
+
+    for (int i = 0; i < WEATHER_SHEAR_LAYERS; i++) {
+        weather->shearLayers[i] = shearLayerMeans[i];
+    }
+
+    weather->gustFront.invDepth = 1.0f / GUST_FRONT_DEPTH; // no front yet
+}
+
+static void advanceWeather(WeatherSnapshot *weather, float deltaTime, float focusX, float focusZ, uint32_t *random){
+    weather->time += deltaTime;
+
+    // Temperature
+    weather->temperatureDeviation = stepMeanReverting(weather->temperatureDeviation, 0.0f, TEMPERATURE_DEVIATION_SIGMA, TEMPERATURE_DEVIATION_TIME, deltaTime, random);
+
+    // Pressure systems: drift, develop, dissipate once they're far away and get replaced
+    for (int i = 0; i < WEATHER_PRESSURE_SYSTEMS; i++) {
+        PressureSystem *system = &weather->pressureSystems[i];
+
+        system->x += STEERING_WIND_X * deltaTime;
+        system->z += STEERING_WIND_Z * deltaTime;
+        system->strength += (system->targetStrength - system->strength) * (deltaTime / PRESSURE_DEVELOP_TIME);
+
+        float dx = system->x - focusX;
+        float dz = system->z - focusZ;
+        if (dx * dx + dz * dz > PRESSURE_DOMAIN_RADIUS * PRESSURE_DOMAIN_RADIUS) {
+            system->targetStrength = 0.0f;
+            if (fabsf(system->strength) < INACTIVE_STRENGTH) {
+                spawnPressureSystem(system, focusX, focusZ, random);
+            }
+        }
+    }
+
+    // Shear layers: the wind in each layer wanders around its mean
+    for (int i = 0; i < WEATHER_SHEAR_LAYERS; i++) {
+        ShearLayer *layer = &weather->shearLayers[i];
+        layer->windX = stepMeanReverting(layer->windX, shearLayerMeans[i].windX, SHEAR_WIND_SIGMA, SHEAR_WIND_TIME, deltaTime, random);
+        layer->windZ = stepMeanReverting(layer->windZ, shearLayerMeans[i].windZ, SHEAR_WIND_SIGMA, SHEAR_WIND_TIME, deltaTime, random);
+    }
+
+    // Gust front: occasionally one forms, crosses the area and dies out
+    GustFront *front = &weather->gustFront;
+    if (front->targetStrength > 0.0f || front->strength > 0.0f) {
+        front->distance += front->speed * deltaTime;
+        front->strength += (front->targetStrength - front->strength) * (deltaTime / GUST_FRONT_DEVELOP_TIME);
+
+        float passed = front->distance - (focusX * front->normalX + focusZ * front->normalZ);
+        if (passed > GUST_FRONT_PASSED_DISTANCE) {
+            front->targetStrength = 0.0f;
+            if (front->strength < INACTIVE_STRENGTH) {
+                front->strength = 0.0f; // gone
+            }
+        }
+    }
+    else if (randomUniform(random) < deltaTime / GUST_FRONT_INTERVAL) {
+        spawnGustFront(front, focusX, focusZ, random);
+    }
+}
+
+/*
+    #########################################################
+    #                                                       #
+    #                     WORKER THREAD                     #
+    #                                                       #
+    #########################################################
+*/
+
+static int weatherThreadFunction(void *data){
+    (void)data;
+
+    while (1) {
+        SDL_SemWaitTimeout(weatherWake, WEATHER_WORKER_TIMEOUT_MS);
+        if (SDL_AtomicGet(&quitWeather)) {
+            break;
+        }
+
+        const float target = (float)SDL_AtomicGet(&requestedTimeMs) / 1000.0f;
+        if (workerState.time >= target + WEATHER_STEP) {
+            continue; // already far enough ahead
+        }
+
+        const float focusX = (float)SDL_AtomicGet(&focusXm);
+        const float focusZ = (float)SDL_AtomicGet(&focusZm);
+
+        // catch up (more than one step only if the simulation time jumped)
+        WeatherSnapshot previous = workerState;
+        while (workerState.time < target + WEATHER_STEP) {
+            previous = workerState;
+            advanceWeather(&workerState, WEATHER_STEP, focusX, focusZ, &workerRandom);
+        }
+
+        WeatherSnapshotPair *pair = getTripleBufferBack(&snapshotBuffer);
+        pair->from = previous;
+        pair->to = workerState;
+        publishTripleBuffer(&snapshotBuffer);
+    }
+
+    return 0;
+}
+
+int startWeatherSimulation(uint32_t seed){
+    if (weatherRunning) {
+        return 1;
+    }
+
+    if (!initTripleBuffer(&snapshotBuffer, sizeof(WeatherSnapshotPair))) {
+        return 0;
+    }
+
+    // first pair is made here, so there's weather before the worker has run once
+    workerRandom = (seed != 0u) ? seed : 0x2545F491u;
+    initialWeather(&workerState, &workerRandom);
+
+    WeatherSnapshotPair *pair = getTripleBufferBack(&snapshotBuffer);
+    pair->from = workerState;
+    advanceWeather(&workerState, WEATHER_STEP, 0.0f, 0.0f, &workerRandom);
+    pair->to = workerState;
+    publishTripleBuffer(&snapshotBuffer);
+    acquireTripleBuffer(&snapshotBuffer);
+    currentWeather = pair->from;
+    requestedForTime = -1.0f;
+
+    SDL_AtomicSet(&requestedTimeMs, 0);
+    SDL_AtomicSet(&focusXm, 0);
+    SDL_AtomicSet(&focusZm, 0);
+    SDL_AtomicSet(&quitWeather, 0);
+
+    weatherWake = SDL_CreateSemaphore(0);
+    if (weatherWake != NULL) {
+        weatherThread = SDL_CreateThread(weatherThreadFunction, "weather", NULL);
+    }
+    if (weatherThread == NULL) {
+        logMessage(LOG_ERROR, "Weather thread couldn't be started: %s", SDL_GetError());
+        if (weatherWake != NULL) {
+            SDL_DestroySemaphore(weatherWake);
+            weatherWake = NULL;
+        }
+        freeTripleBuffer(&snapshotBuffer);
+        memset(&currentWeather, 0, sizeof(currentWeather));
+        return 0;
+    }
+
+    weatherRunning = 1;
+    return 1;
+}
+
+void stopWeatherSimulation(void){
+    if (!weatherRunning) {
+        return;
+    }
+
+    SDL_AtomicSet(&quitWeather, 1);
+    SDL_SemPost(weatherWake);
+    SDL_WaitThread(weatherThread, NULL);
+    weatherThread = NULL;
+
+    SDL_DestroySemaphore(weatherWake);
+    weatherWake = NULL;
+
+    freeTripleBuffer(&snapshotBuffer);
+    memset(&currentWeather, 0, sizeof(currentWeather));
+    weatherRunning = 0;
+}
+
+/*
+    #########################################################
+    #                                                       #
+    #                       SAMPLING                        #
+    #                                                       #
+    #########################################################
+*/
+
+static float lerp(float a, float b, float t){
+    return a + t * (b - a);
+}
+
+static void interpolateWeather(const WeatherSnapshot *a, const WeatherSnapshot *b, float t, WeatherSnapshot *out){
+    out->time = lerp(a->time, b->time, t);
+    out->temperatureDeviation = lerp(a->temperatureDeviation, b->temperatureDeviation, t);
+
+    for (int i = 0; i < WEATHER_PRESSURE_SYSTEMS; i++) {
+        const PressureSystem *p0 = &a->pressureSystems[i];
+        const PressureSystem *p1 = &b->pressureSystems[i];
+        PressureSystem *p = &out->pressureSystems[i];
+        p->x = lerp(p0->x, p1->x, t);
+        p->z = lerp(p0->z, p1->z, t);
+        p->invRadius = lerp(p0->invRadius, p1->invRadius, t);
+        p->strength = lerp(p0->strength, p1->strength, t);
+        p->targetStrength = p1->targetStrength;
+    }
+
+    for (int i = 0; i < WEATHER_SHEAR_LAYERS; i++) {
+        const ShearLayer *l0 = &a->shearLayers[i];
+        const ShearLayer *l1 = &b->shearLayers[i];
+        ShearLayer *l = &out->shearLayers[i];
+        l->baseAltitude = lerp(l0->baseAltitude, l1->baseAltitude, t);
+        l->invThickness = lerp(l0->invThickness, l1->invThickness, t);
+        l->windX = lerp(l0->windX, l1->windX, t);
+        l->windZ = lerp(l0->windZ, l1->windZ, t);
+    }
+
+    const GustFront *f0 = &a->gustFront;
+    const GustFront *f1 = &b->gustFront;
+    GustFront *f = &out->gustFront;
+    f->normalX = f1->normalX; // a front never turns, only a new one has a new normal (and starts at strength 0)
+    f->normalZ = f1->normalZ;
+    f->distance = lerp(f0->distance, f1->distance, t);
+    f->speed = f1->speed;
+    f->strength = lerp(f0->strength, f1->strength, t);
+    f->targetStrength = f1->targetStrength;
+    f->invDepth = f1->invDepth;
+}
+
+void updateWeatherSimulation(float simulationTime, float focusX, float focusZ){
+    if (!weatherRunning) {
+        return;
+    }
+
+    SDL_AtomicSet(&focusXm, (int)focusX);
+    SDL_AtomicSet(&focusZm, (int)focusZ);
+
+    // move on to the next pair only once we've flown past the current one
+    const WeatherSnapshotPair *pair = getTripleBufferFront(&snapshotBuffer);
+    if (simulationTime >= pair->to.time && acquireTripleBuffer(&snapshotBuffer)) {
+        pair = getTripleBufferFront(&snapshotBuffer);
+    }
+
+    // halfway through the pair, ask the worker for the next one (once per pair)
+    if (simulationTime >= pair->from.time + 0.5f * WEATHER_STEP && requestedForTime < pair->to.time) {
+        requestedForTime = pair->to.time;
+        SDL_AtomicSet(&requestedTimeMs, (int)(simulationTime * 1000.0f));
+        SDL_SemPost(weatherWake);
+    }
+
+    float span = pair->to.time - pair->from.time;
+    float t = (span > 1e-6f) ? (simulationTime - pair->from.time) / span : 0.0f;
+    t = fminf(fmaxf(t, 0.0f), 1.0f);
+
+    interpolateWeather(&pair->from, &pair->to, t, &currentWeather);
+}
+
+const WeatherSnapshot *getCurrentWeather(void){
+    return &currentWeather;
+}
+
+Vector3 sampleWeatherWind(const WeatherSnapshot *weather, float x, float altitude, float z){
+    Vector3 wind = {0.0f, 0.0f, 0.0f};
+    if (weather == NULL) {
+        return wind;
+    }
+
+    // Pressure systems: tangential wind 2 * S * q / (1 + q^2), q = r / R (maximum S at r = R).
+    // Written with the unrotated offset (-dz, dx) = r * tangent, so there's no square root.
+    for (int i = 0; i < WEATHER_PRESSURE_SYSTEMS; i++) {
+        const PressureSystem *system = &weather->pressureSystems[i];
+        float dx = x - system->x;
+        float dz = z - system->z;
+        float q2 = (dx * dx + dz * dz) * system->invRadius * system->invRadius;
+        float k = 2.0f * system->strength * system->invRadius / (1.0f + q2);
+        wind.x -= dz * k;
+        wind.z += dx * k;
+    }
+
+    // Shear layers: smoothstep through each layer
+    for (int i = 0; i < WEATHER_SHEAR_LAYERS; i++) {
+        const ShearLayer *layer = &weather->shearLayers[i];
+        float t = fminf(fmaxf((altitude - layer->baseAltitude) * layer->invThickness, 0.0f), 1.0f);
+        float s = t * t * (3.0f - 2.0f * t);
+        wind.x += s * layer->windX;
+        wind.z += s * layer->windZ;
+    }
+
+    // Gust front: outflow behind the front, updraft along its leading edge, both fading out with height
+    const GustFront *front = &weather->gustFront;
+    if (front->strength > 0.0f) {
+        float height = fminf(fmaxf(1.0f - altitude * front->invDepth, 0.0f), 1.0f);
+        float d = (x * front->normalX + z * front->normalZ - front->distance) * (1.0f / GUST_FRONT_WIDTH); // < 0 behind the front
+        float behind = fminf(fmaxf(-d, 0.0f), 1.0f);
+        float outflow = front->strength * height * behind * behind * (3.0f - 2.0f * behind);
+
+        wind.x += outflow * front->normalX;
+        wind.z += outflow * front->normalZ;
+        wind.y += GUST_FRONT_UPDRAFT * front->strength * height / (1.0f + d * d);
+    }
+
+    return wind;
+}
@@ -0,0 +1,426 @@
+/**
+ * @file windField.c
+ *
+ * @brief This file contains the wind field loader (memory mapping), the slice streaming thread and the sampler.
+ */
+
+#ifndef _WIN32
+    #define _DEFAULT_SOURCE // Enables madvise() on Linux
+#endif
+
+// Include header files
+#include "windField.h"
+#include "logger.h"
+
+// Include necessary libraries
+#include <string.h>
+#include <math.h>
+
+#ifdef _WIN32
+    #include <windows.h> // CreateFileMapping and MapViewOfFile
+#else
+    #include <sys/mman.h> // mmap and madvise
+    #include <sys/stat.h> // fstat for the file size
+    #include <fcntl.h> // open
+    #include <unistd.h> // close and sysconf
+#endif
+
+#define PREFETCH_STRIDE 4096 // bytes, one read per page is enough to fault it in
+
+/*
+    #########################################################
+    #                                                       #
+    #                       MAPPING                         #
+    #                                                       #
+    #########################################################
+*/
+
+// Map the whole file read only; nothing is read until a page is touched
+static int mapFile(WindField *field, const char *path){
+    #ifdef _WIN32
+        HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE) {
+            return 0;
+        }
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0) {
+            CloseHandle(file);
+            return 0;
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping == NULL) {
+            CloseHandle(file);
+            return 0;
+        }
+
+        void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (view == NULL) {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return 0;
+        }
+
+        field->fileHandle = file;
+        field->mappingHandle = mapping;
+        field->mapping = (const unsigned char *)view;
+        field->mappingSize = (size_t)size.QuadPart;
+    #else
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) {
+            return 0;
+        }
+
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+            close(fd);
+            return 0;
+        }
+
+        void *view = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (view == MAP_FAILED) {
+            close(fd);
+            return 0;
+        }
+
+        field->fileDescriptor = fd;
+        field->mapping = (const unsigned char *)view;
+        field->mappingSize = (size_t)info.st_size;
+    #endif
+
+    return 1;
+}
+
+static void unmapFile(WindField *field){
+    if (field->mapping == NULL) {
+        return;
+    }
+
+    #ifdef _WIN32
+        UnmapViewOfFile(field->mapping);
+        CloseHandle((HANDLE)field->mappingHandle);
+        CloseHandle((HANDLE)field->fileHandle);
+    #else
+        munmap((void *)(uintptr_t)field->mapping, field->mappingSize);
+        close(field->fileDescriptor);
+    #endif
+
+    field->mapping = NULL;
+    field->mappingSize = 0;
+}
+
+/*
+    #########################################################
+    #                                                       #
+    #                      STREAMING                        #
+    #                                                       #
+    #########################################################
+*/
+
+// Byte range of a time slice inside the mapping
+static void sliceRange(const WindField *field, int slice, const unsigned char **start, size_t *size){
+    *size = field->sliceSamples * sizeof(WindFieldSample);
+    *start = (const unsigned char *)(const void *)field->samples + (size_t)slice * *size;
+}
+
+// Fault a slice in, so the sampler finds it in memory
+static void prefetchSlice(const WindField *field, int slice){
+    if (slice < 0 || slice > field->lastSlice) {
+        return;
+    }
+
+    const unsigned char *start;
+    size_t size;
+    sliceRange(field, slice, &start, &size);
+
+    #ifndef _WIN32
+        // let the kernel start reading ahead, then make sure every page is really there
+        long pageSize = sysconf(_SC_PAGESIZE);
+        uintptr_t alignedStart = (uintptr_t)start & ~((uintptr_t)pageSize - 1);
+        madvise((void *)alignedStart, size + ((uintptr_t)start - alignedStart), MADV_WILLNEED);
+    #endif
+
+    const volatile unsigned char *bytes = start;
+    unsigned char sum = 0;
+    for (size_t offset = 0; offset < size; offset += PREFETCH_STRIDE) {
+        sum = (unsigned char)(sum + bytes[offset]);
+    }
+    (void)sum;
+}
+
+// Give the pages of a slice we've flown past back to the OS (they're reread from the file if needed again)
+static void releaseSlice(const WindField *field, int slice){
+    if (slice < 0 || slice > field->lastSlice) {
+        return;
+    }
+
+    #ifndef _WIN32
+        const unsigned char *start;
+        size_t size;
+        sliceRange(field, slice, &start, &size);
+
+        // only whole pages inside the slice, the neighbouring slices share the edge pages
+        long pageSize = sysconf(_SC_PAGESIZE);
+        uintptr_t first = ((uintptr_t)start + (uintptr_t)pageSize - 1) & ~((uintptr_t)pageSize - 1);
+        uintptr_t last = ((uintptr_t)start + size) & ~((uintptr_t)pageSize - 1);
+        if (last > first) {
+            madvise((void *)first, last - first, MADV_DONTNEED);
+        }
+    #else
+        (void)field; // the Windows working set manager trims unused mapped pages by itself
+    #endif
+}
+
+static int streamThreadFunction(void *data){
+    WindField *field = (WindField *)data;
+    int residentSlice = -1;
+
+    while (1) {
+        SDL_SemWait(field->streamRequest);
+        if (SDL_AtomicGet(&field->quit)) {
+            break;
+        }
+
+        int slice = SDL_AtomicGet(&field->requestedSlice);
+        if (slice == residentSlice) {
+            continue;
+        }
+
+        // the sampler reads the current slice and the next one
+        prefetchSlice(field, slice);
+        prefetchSlice(field, slice + 1);
+
+        // drop what's behind (time only goes forward, but a jump back just reads it in again)
+        if (residentSlice >= 0 && residentSlice < slice - 1) {
+            releaseSlice(field, residentSlice);
+        }
+        if (slice > 0) {
+            releaseSlice(field, slice - 1);
+        }
+
+        residentSlice = slice;
+    }
+
+    return 0;
+}
+
+/*
+    #########################################################
+    #                                                       #
+    #                      OPEN / CLOSE                     #
+    #                                                       #
+    #########################################################
+*/
+
+static int validateHeader(const WindFieldHeader *header, size_t fileSize, const char *path){
+    if (memcmp(header->magic, WIND_FIELD_MAGIC, 4) != 0 || header->version != WIND_FIELD_VERSION) {
+        logMessage(LOG_ERROR, "%s is not a version %d wind field file.", path, WIND_FIELD_VERSION);
+        return 0;
+    }
+    if (header->nx < 2 || header->ny < 2 || header->nz < 2 || header->nt < 1) {
+        logMessage(LOG_ERROR, "Wind field %s needs at least 2 grid points per axis and 1 time slice.", path);
+        return 0;
+    }
+    if (header->nx > INT32_MAX / header->nz || header->nx * header->nz > INT32_MAX / header->ny) {
+        logMessage(LOG_ERROR, "Wind field %s has too many grid points per slice.", path);
+        return 0;
+    }
+    if (!(header->dx > 0.0f) || !(header->dy > 0.0f) || !(header->dz > 0.0f) || (header->nt > 1 && !(header->timeStep > 0.0f))) {
+        logMessage(LOG_ERROR, "Wind field %s has an invalid grid spacing or time step.", path);
+        return 0;
+    }
+
+    size_t sliceBytes = (size_t)header->nx * header->ny * header->nz * sizeof(WindFieldSample);
+    if (fileSize < WIND_FIELD_DATA_OFFSET || (fileSize - WIND_FIELD_DATA_OFFSET) / sliceBytes < header->nt) {
+        logMessage(LOG_ERROR, "Wind field %s is truncated.", path);
+        return 0;
+    }
+
+    return 1;
+}
+
+int openWindField(WindField *field, const char *path){
+    if (field == NULL || path == NULL) {
+        logMessage(LOG_ERROR, "Pointer passed to openWindField is NULL.");
+        return 0;
+    }
+
+    memset(field, 0, sizeof(*field));
+
+    if (!mapFile(field, path)) {
+        logMessage(LOG_ERROR, "Failed to map wind field %s.", path);
+        return 0;
+    }
+
+    WindFieldHeader header;
+    if (field->mappingSize < sizeof(header)) {
+        logMessage(LOG_ERROR, "Wind field %s is truncated.", path);
+        unmapFile(field);
+        return 0;
+    }
+    memcpy(&header, field->mapping, sizeof(header));
+
+    if (!validateHeader(&header, field->mappingSize, path)) {
+        unmapFile(field);
+        return 0;
+    }
+
+    field->samples = (const WindFieldSample *)(const void *)(field->mapping + WIND_FIELD_DATA_OFFSET);
+    field->sliceSamples = (size_t)header.nx * header.ny * header.nz;
+    field->strideZ = (int)header.nx;
+    field->strideY = (int)(header.nx * header.nz);
+    field->lastCellX = (int)header.nx - 2;
+    field->lastCellY = (int)header.ny - 2;
+    field->lastCellZ = (int)header.nz - 2;
+    field->lastSlice = (int)header.nt - 1;
+    field->originX = header.originX;
+    field->originY = header.originY;
+    field->originZ = header.originZ;
+    field->invDx = 1.0f / header.dx;
+    field->invDy = 1.0f / header.dy;
+    field->invDz = 1.0f / header.dz;
+    field->startTime = header.startTime;
+    field->invTimeStep = (header.nt > 1) ? 1.0f / header.timeStep : 0.0f;
+
+    // start streaming from the first slice
+    field->currentSlice = 0;
+    SDL_AtomicSet(&field->requestedSlice, 0);
+    SDL_AtomicSet(&field->quit, 0);
+    field->streamRequest = SDL_CreateSemaphore(1); // the first wait returns right away and loads slice 0
+    if (field->streamRequest != NULL) {
+        field->streamThread = SDL_CreateThread(streamThreadFunction, "windFieldStream", field);
+    }
+    if (field->streamThread == NULL) {
+        // the sampler still works, it just faults the pages in itself
+        logMessage(LOG_WARNING, "Wind field streaming thread couldn't be started: %s", SDL_GetError());
+    }
+
+    logMessage(LOG_INFO, "Wind field %s: %ux%ux%u points, %u time slices.", path, header.nx, header.ny, header.nz, header.nt);
+    return 1;
+}
+
+void closeWindField(WindField *field){
+    if (field == NULL) {
+        return;
+    }
+
+    if (field->streamThread != NULL) {
+        SDL_AtomicSet(&field->quit, 1);
+        SDL_SemPost(field->streamRequest);
+        SDL_WaitThread(field->streamThread, NULL);
+        field->streamThread = NULL;
+    }
+    if (field->streamRequest != NULL) {
+        SDL_DestroySemaphore(field->streamRequest);
+        field->streamRequest = NULL;
+    }
+
+    unmapFile(field);
+    field->samples = NULL;
+}
+
+void updateWindFieldStreaming(WindField *field, float time){
+    if (field == NULL || field->samples == NULL || field->streamThread == NULL) {
+        return;
+    }
+
+    int slice = (int)((time - field->startTime) * field->invTimeStep);
+    if (slice < 0) slice = 0;
+    if (slice > field->lastSlice) slice = field->lastSlice;
+
+    if (slice != field->currentSlice) {
+        field->currentSlice = slice;
+        SDL_AtomicSet(&field->requestedSlice, slice);
+        SDL_SemPost(field->streamRequest);
+    }
+}
+
+/*
+    #########################################################
+    #                                                       #
+    #                       SAMPLING                        #
+    #                                                       #
+    #########################################################
+*/
+
+// Split a grid coordinate into a cell index and the fraction inside it, clamped to the grid
+static inline int gridCoordinate(float u, int lastCell, float *fraction){
+    const float maxU = (float)lastCell + 1.0f;
+    u = fminf(fmaxf(u, 0.0f), maxU); // fmaxf drops a NaN, so it can't reach the (int) cast below
+
+    int i = (int)u;
+    if (i > lastCell) i = lastCell;
+
+    *fraction = u - (float)i;
+    return i;
+}
+
+// Trilinear interpolation inside one time slice, base points at the (x, y, z) corner of the cell
+static Vector3 sampleSlice(const WindField *field, const WindFieldSample *base, float fx, float fy, float fz){
+    const WindFieldSample *s000 = base;
+    const WindFieldSample *s001 = base + field->strideZ;
+    const WindFieldSample *s010 = base + field->strideY;
+    const WindFieldSample *s011 = base + field->strideY + field->strideZ;
+
+    // along x
+    float x00 = s000[0].x + fx * (s000[1].x - s000[0].x);
+    float y00 = s000[0].y + fx * (s000[1].y - s000[0].y);
+    float z00 = s000[0].z + fx * (s000[1].z - s000[0].z);
+    float x01 = s001[0].x + fx * (s001[1].x - s001[0].x);
+    float y01 = s001[0].y + fx * (s001[1].y - s001[0].y);
+    float z01 = s001[0].z + fx * (s001[1].z - s001[0].z);
+    float x10 = s010[0].x + fx * (s010[1].x - s010[0].x);
+    float y10 = s010[0].y + fx * (s010[1].y - s010[0].y);
+    float z10 = s010[0].z + fx * (s010[1].z - s010[0].z);
+    float x11 = s011[0].x + fx * (s011[1].x - s011[0].x);
+    float y11 = s011[0].y + fx * (s011[1].y - s011[0].y);
+    float z11 = s011[0].z + fx * (s011[1].z - s011[0].z);
+
+    // along z
+    float x0 = x00 + fz * (x01 - x00);
+    float y0 = y00 + fz * (y01 - y00);
+    float z0 = z00 + fz * (z01 - z00);
+    float x1 = x10 + fz * (x11 - x10);
+    float y1 = y10 + fz * (y11 - y10);
+    float z1 = z10 + fz * (z11 - z10);
+
+    // along altitude
+    return (Vector3){
+        x0 + fy * (x1 - x0),
+        y0 + fy * (y1 - y0),
+        z0 + fy * (z1 - z0)
+    };
+}
+
+Vector3 sampleWindField(const WindField *field, float x, float altitude, float z, float time){
+    if (field == NULL || field->samples == NULL) {
+        return (Vector3){0.0f, 0.0f, 0.0f};
+    }
+
+    float fx, fy, fz;
+    const int i = gridCoordinate((x - field->originX) * field->invDx, field->lastCellX, &fx);
+    const int j = gridCoordinate((altitude - field->originY) * field->invDy, field->lastCellY, &fy);
+    const int k = gridCoordinate((z - field->originZ) * field->invDz, field->lastCellZ, &fz);
+    const size_t cell = (size_t)j * (size_t)field->strideY + (size_t)k * (size_t)field->strideZ + (size_t)i;
+
+    // time slices around the requested time
+    float ft = 0.0f;
+    int slice = 0;
+    if (field->lastSlice > 0) {
+        slice = gridCoordinate((time - field->startTime) * field->invTimeStep, field->lastSlice - 1, &ft);
+    }
+
+    const WindFieldSample *base0 = field->samples + (size_t)slice * field->sliceSamples + cell;
+    Vector3 wind0 = sampleSlice(field, base0, fx, fy, fz);
+    if (ft <= 0.0f) {
+        return wind0;
+    }
+
+    Vector3 wind1 = sampleSlice(field, base0 + field->sliceSamples, fx, fy, fz);
+    return (Vector3){
+        wind0.x + ft * (wind1.x - wind0.x),
+        wind0.y + ft * (wind1.y - wind0.y),
+        wind0.z + ft * (wind1.z - wind0.z)
+    };
+}